@@ -463,6 +463,30 @@ static int decode_interrupt_cb(void *ctx)
 
 const AVIOInterruptCB int_cb = { decode_interrupt_cb, NULL };
 
+static void print_mem_usage(void)
+{
+    static const struct {
+        AVClassCategory category;
+        const char *name;
+    } categories[] = {
+        { AV_CLASS_CATEGORY_NA,      "total"    },
+        { AV_CLASS_CATEGORY_DECODER, "decoders" },
+        { AV_CLASS_CATEGORY_ENCODER, "encoders" },
+        { AV_CLASS_CATEGORY_FILTER,  "filters"  },
+    };
+    int i;
+
+    for (i = 0; i < FF_ARRAY_ELEMS(categories); i++) {
+        AVMemUsage usage;
+
+        av_mem_get_usage(categories[i].category, &usage);
+        if (!usage.peak)
+            continue;
+        av_log(NULL, AV_LOG_INFO, "bench: mem %s current=%"PRId64"kB peak=%"PRId64"kB\n",
+               categories[i].name, usage.current / 1024, usage.peak / 1024);
+    }
+}
+
 static void ffmpeg_cleanup(int ret)
 {
     int i, j;
@@ -470,6 +494,7 @@ static void ffmpeg_cleanup(int ret)
     if (do_benchmark) {
         int maxrss = getmaxrss() / 1024;
         av_log(NULL, AV_LOG_INFO, "bench: maxrss=%ikB\n", maxrss);
+        print_mem_usage();
     }
 
     for (i = 0; i < nb_filtergraphs; i++) {
@@ -4165,6 +4190,11 @@ int main(int argc, char **argv)
 
     setvbuf(stderr,NULL,_IONBF,0); /* win32 runtime needs this */
 
+    /* accounting has to be enabled before anything is allocated */
+    if (locate_option(argc, argv, options, "benchmark") ||
+        locate_option(argc, argv, options, "mem_soft_limit"))
+        av_mem_set_accounting(1);
+
     av_log_set_flags(AV_LOG_SKIP_REPEATED);
     parse_loglevel(argc, argv, options);
 
@@ -2721,6 +2721,23 @@ static int opt_vsync(void *optctx, const char *opt, const char *arg)
     return 0;
 }
 
+static int opt_mem_soft_limit(void *optctx, const char *opt, const char *arg)
+{
+    int64_t limit = parse_number_or_die(opt, arg, OPT_INT64, 0, INT64_MAX);
+
+    if (av_mem_set_accounting(1) < 0)
+        av_log(NULL, AV_LOG_WARNING, "Memory accounting is not supported, ignoring -%s\n", opt);
+    else
+        av_mem_set_soft_limit(limit);
+    return 0;
+}
+
+static int opt_hugepages(void *optctx, const char *opt, const char *arg)
+{
+    av_buffer_set_frame_allocator(av_buffer_alloc_hugepages);
+    return 0;
+}
+
 static int opt_timecode(void *optctx, const char *opt, const char *arg)
 {
     OptionsContext *o = optctx;
@@ -3075,6 +3092,10 @@ const OptionDef options[] = {
         "add timings for benchmarking" },
     { "benchmark_all",  OPT_BOOL | OPT_EXPERT,                       { &do_benchmark_all },
       "add timings for each task" },
+    { "mem_soft_limit", HAS_ARG | OPT_EXPERT,                        { .func_arg = opt_mem_soft_limit },
+      "stop caching frame buffers once the memory usage exceeds limit", "bytes" },
+    { "hugepages",      OPT_EXPERT,                                  { .func_arg = opt_hugepages },
+      "allocate large video frames in huge pages" },
     { "progress",       HAS_ARG | OPT_EXPERT,                        { .func_arg = opt_progress },
       "write program-readable progress information", "url" },
     { "stdin",          OPT_BOOL | OPT_EXPERT,                       { &stdin_interaction },
@@ -482,6 +482,109 @@ static void copy_input_samples(AACEncContext *s, const AVFrame *frame)
     }
 }
 
+typedef struct AACEncElementArg {
+    FFPsyWindowInfo *windows;
+    int start_ch [AAC_MAX_CHANNELS];
+    int tns_mode [AAC_MAX_CHANNELS];
+    int is_mode  [AAC_MAX_CHANNELS];
+    int pred_mode[AAC_MAX_CHANNELS];
+} AACEncElementArg;
+
+/**
+ * Search quantizers and stereo/TNS/prediction tools for one channel element.
+ * Elements are independent once the psychoacoustic analysis has been done,
+ * so this runs as a slice job; each thread works on a copy of the context
+ * for its scratch buffers (scoefs, qcoefs, lpc, cur_channel).
+ */
+static int encode_element(AVCodecContext *avctx, void *argp, int jobnr, int threadnr)
+{
+    AACEncContext *s = avctx->priv_data;
+    AACEncElementArg *arg = argp;
+    int start_ch = arg->start_ch[jobnr];
+    FFPsyWindowInfo *wi = arg->windows + start_ch;
+    ChannelElement *cpe = &s->cpe[jobnr];
+    SingleChannelElement *sce;
+    int tag   = s->chan_map[jobnr+1];
+    int chans = tag == TYPE_CPE ? 2 : 1;
+    int ch, w;
+
+    arg->tns_mode[jobnr] = arg->is_mode[jobnr] = arg->pred_mode[jobnr] = 0;
+
+    if (s->nb_slice_ctx) {
+        AACEncContext *t = &s->slice_ctx[threadnr];
+        LPCContext lpc   = t->lpc;
+        memcpy(t, s, sizeof(*t));
+        t->lpc = lpc;
+        s = t;
+    }
+
+    for (ch = 0; ch < chans; ch++) {
+        s->cur_channel = start_ch + ch;
+        s->coder->search_for_quantizers(avctx, s, &cpe->ch[ch], s->lambda);
+    }
+    if (chans > 1
+        && wi[0].window_type[0] == wi[1].window_type[0]
+        && wi[0].window_shape   == wi[1].window_shape) {
+
+        cpe->common_window = 1;
+        for (w = 0; w < wi[0].num_windows; w++) {
+            if (wi[0].grouping[w] != wi[1].grouping[w]) {
+                cpe->common_window = 0;
+                break;
+            }
+        }
+    }
+    for (ch = 0; ch < chans; ch++) { /* TNS and PNS */
+        sce = &cpe->ch[ch];
+        s->cur_channel = start_ch + ch;
+        if (s->options.pns && s->coder->search_for_pns)
+            s->coder->search_for_pns(s, avctx, sce);
+        if (s->options.tns && s->coder->search_for_tns)
+            s->coder->search_for_tns(s, sce);
+        if (s->options.tns && s->coder->apply_tns_filt)
+            s->coder->apply_tns_filt(s, sce);
+        if (sce->tns.present)
+            arg->tns_mode[jobnr] = 1;
+    }
+    s->cur_channel = start_ch;
+    if (s->options.intensity_stereo) { /* Intensity Stereo */
+        if (s->coder->search_for_is)
+            s->coder->search_for_is(s, avctx, cpe);
+        if (cpe->is_mode) arg->is_mode[jobnr] = 1;
+        apply_intensity_stereo(cpe);
+    }
+    if (s->options.pred) { /* Prediction */
+        for (ch = 0; ch < chans; ch++) {
+            sce = &cpe->ch[ch];
+            s->cur_channel = start_ch + ch;
+            if (s->options.pred && s->coder->search_for_pred)
+                s->coder->search_for_pred(s, sce);
+            if (cpe->ch[ch].ics.predictor_present) arg->pred_mode[jobnr] = 1;
+        }
+        if (s->coder->adjust_common_prediction)
+            s->coder->adjust_common_prediction(s, cpe);
+        for (ch = 0; ch < chans; ch++) {
+            sce = &cpe->ch[ch];
+            s->cur_channel = start_ch + ch;
+            if (s->options.pred && s->coder->apply_main_pred)
+                s->coder->apply_main_pred(s, sce);
+        }
+        s->cur_channel = start_ch;
+    }
+    if (s->options.stereo_mode) { /* Mid/Side stereo */
+        if (s->options.stereo_mode == -1 && s->coder->search_for_ms)
+            s->coder->search_for_ms(s, cpe);
+        else if (cpe->common_window)
+            memset(cpe->ms_mask, 1, sizeof(cpe->ms_mask));
+        for (w = 0; w < 128; w++)
+            cpe->ms_mask[w] = cpe->is_mask[w] ? 0 : cpe->ms_mask[w];
+        apply_mid_side_stereo(cpe);
+    }
+    adjust_frame_information(cpe, chans);
+
+    return 0;
+}
+
 static int aac_encode_frame(AVCodecContext *avctx, AVPacket *avpkt,
                             const AVFrame *frame, int *got_packet_ptr)
 {
@@ -493,6 +596,7 @@ static int aac_encode_frame(AVCodecContext *avctx, AVPacket *avpkt,
     int ms_mode = 0, is_mode = 0, tns_mode = 0, pred_mode = 0;
     int chan_el_counter[4];
     FFPsyWindowInfo windows[AAC_MAX_CHANNELS];
+    AACEncElementArg elem = { windows };
     int k;
 
     if (s->last_frame == 2)
@@ -593,8 +697,9 @@ static int aac_encode_frame(AVCodecContext *avctx, AVPacket *avpkt,
 
         if ((avctx->frame_number & 0xFF)==1 && !(avctx->flags & AV_CODEC_FLAG_BITEXACT))
             put_bitstream_info(s, LIBAVCODEC_IDENT);
+        /* The psychoacoustic model carries state (bit reservoir fill level,
+         * PE history) from one element to the next, so run it in order. */
         start_ch = 0;
-        memset(chan_el_counter, 0, sizeof(chan_el_counter));
         for (i = 0; i < s->chan_map[0]; i++) {
             FFPsyWindowInfo* wi = windows + start_ch;
             const float *coeffs[2];
@@ -604,8 +709,6 @@ static int aac_encode_frame(AVCodecContext *avctx, AVPacket *avpkt,
             cpe->common_window = 0;
             memset(cpe->is_mask, 0, sizeof(cpe->is_mask));
             memset(cpe->ms_mask, 0, sizeof(cpe->ms_mask));
-            put_bits(&s->pb, 3, tag);
-            put_bits(&s->pb, 4, chan_el_counter[tag]++);
             for (ch = 0; ch < chans; ch++) {
                 sce = &cpe->ch[ch];
                 coeffs[ch] = sce->coeffs;
@@ -617,69 +720,23 @@ static int aac_encode_frame(AVCodecContext *avctx, AVPacket *avpkt,
                         sce->band_type[w] = 0;
             }
             s->psy.model->analyze(&s->psy, start_ch, coeffs, wi);
-            for (ch = 0; ch < chans; ch++) {
-                s->cur_channel = start_ch + ch;
-                s->coder->search_for_quantizers(avctx, s, &cpe->ch[ch], s->lambda);
-            }
-            if (chans > 1
-                && wi[0].window_type[0] == wi[1].window_type[0]
-                && wi[0].window_shape   == wi[1].window_shape) {
-
-                cpe->common_window = 1;
-                for (w = 0; w < wi[0].num_windows; w++) {
-                    if (wi[0].grouping[w] != wi[1].grouping[w]) {
-                        cpe->common_window = 0;
-                        break;
-                    }
-                }
-            }
-            for (ch = 0; ch < chans; ch++) { /* TNS and PNS */
-                sce = &cpe->ch[ch];
-                s->cur_channel = start_ch + ch;
-                if (s->options.pns && s->coder->search_for_pns)
-                    s->coder->search_for_pns(s, avctx, sce);
-                if (s->options.tns && s->coder->search_for_tns)
-                    s->coder->search_for_tns(s, sce);
-                if (s->options.tns && s->coder->apply_tns_filt)
-                    s->coder->apply_tns_filt(s, sce);
-                if (sce->tns.present)
-                    tns_mode = 1;
-            }
-            s->cur_channel = start_ch;
-            if (s->options.intensity_stereo) { /* Intensity Stereo */
-                if (s->coder->search_for_is)
-                    s->coder->search_for_is(s, avctx, cpe);
-                if (cpe->is_mode) is_mode = 1;
-                apply_intensity_stereo(cpe);
-            }
-            if (s->options.pred) { /* Prediction */
-                for (ch = 0; ch < chans; ch++) {
-                    sce = &cpe->ch[ch];
-                    s->cur_channel = start_ch + ch;
-                    if (s->options.pred && s->coder->search_for_pred)
-                        s->coder->search_for_pred(s, sce);
-                    if (cpe->ch[ch].ics.predictor_present) pred_mode = 1;
-                }
-                if (s->coder->adjust_common_prediction)
-                    s->coder->adjust_common_prediction(s, cpe);
-                for (ch = 0; ch < chans; ch++) {
-                    sce = &cpe->ch[ch];
-                    s->cur_channel = start_ch + ch;
-                    if (s->options.pred && s->coder->apply_main_pred)
-                        s->coder->apply_main_pred(s, sce);
-                }
-                s->cur_channel = start_ch;
-            }
-            if (s->options.stereo_mode) { /* Mid/Side stereo */
-                if (s->options.stereo_mode == -1 && s->coder->search_for_ms)
-                    s->coder->search_for_ms(s, cpe);
-                else if (cpe->common_window)
-                    memset(cpe->ms_mask, 1, sizeof(cpe->ms_mask));
-                for (w = 0; w < 128; w++)
-                    cpe->ms_mask[w] = cpe->is_mask[w] ? 0 : cpe->ms_mask[w];
-                apply_mid_side_stereo(cpe);
-            }
-            adjust_frame_information(cpe, chans);
+            elem.start_ch[i] = start_ch;
+            start_ch += chans;
+        }
+
+        avctx->execute2(avctx, encode_element, &elem, NULL, s->chan_map[0]);
+
+        start_ch = 0;
+        memset(chan_el_counter, 0, sizeof(chan_el_counter));
+        for (i = 0; i < s->chan_map[0]; i++) {
+            tag      = s->chan_map[i+1];
+            chans    = tag == TYPE_CPE ? 2 : 1;
+            cpe      = &s->cpe[i];
+            tns_mode  |= elem.tns_mode[i];
+            is_mode   |= elem.is_mode[i];
+            pred_mode |= elem.pred_mode[i];
+            put_bits(&s->pb, 3, tag);
+            put_bits(&s->pb, 4, chan_el_counter[tag]++);
             if (chans == 2) {
                 put_bits(&s->pb, 1, cpe->common_window);
                 if (cpe->common_window) {
@@ -746,6 +803,12 @@ static av_cold int aac_encode_end(AVCodecContext *avctx)
     ff_mdct_end(&s->mdct128);
     ff_psy_end(&s->psy);
     ff_lpc_end(&s->lpc);
+    if (s->slice_ctx) {
+        int i;
+        for (i = 0; i < s->nb_slice_ctx; i++)
+            ff_lpc_end(&s->slice_ctx[i].lpc);
+        av_freep(&s->slice_ctx);
+    }
     if (s->psypp)
         ff_psy_preprocess_end(s->psypp);
     av_freep(&s->buffer.samples);
@@ -774,6 +837,12 @@ static av_cold int dsp_init(AVCodecContext *avctx, AACEncContext *s)
     if ((ret = ff_mdct_init(&s->mdct128,   8, 0, 32768.0)) < 0)
         return ret;
 
+    s->abs_pow34   = abs_pow34_v;
+    s->quant_bands = quantize_bands;
+
+    if (ARCH_X86)
+        ff_aac_dsp_init_x86(s);
+
     return 0;
 }
 
@@ -862,6 +931,20 @@ static av_cold int aac_encode_init(AVCodecContext *avctx)
     s->coder = &ff_aac_coders[s->options.aac_coder];
     ff_lpc_init(&s->lpc, 2*avctx->frame_size, TNS_MAX_ORDER, FF_LPC_TYPE_LEVINSON);
 
+    if (avctx->active_thread_type & FF_THREAD_SLICE && avctx->thread_count > 1 &&
+        s->chan_map[0] > 1) {
+        int nb_ctx = avctx->thread_count;
+        s->slice_ctx = av_mallocz_array(nb_ctx, sizeof(*s->slice_ctx));
+        if (!s->slice_ctx) {
+            ret = AVERROR(ENOMEM);
+            goto fail;
+        }
+        s->nb_slice_ctx = nb_ctx;
+        for (i = 0; i < nb_ctx; i++)
+            ff_lpc_init(&s->slice_ctx[i].lpc, 2*avctx->frame_size, TNS_MAX_ORDER,
+                        FF_LPC_TYPE_LEVINSON);
+    }
+
     if (HAVE_MIPSDSPR1)
         ff_aac_coder_init_mips(s);
 
@@ -922,7 +1005,7 @@ AVCodec ff_aac_encoder = {
     .close          = aac_encode_end,
     .supported_samplerates = mpeg4audio_sample_rates,
     .capabilities   = AV_CODEC_CAP_SMALL_LAST_FRAME | AV_CODEC_CAP_DELAY |
-                      AV_CODEC_CAP_EXPERIMENTAL,
+                      AV_CODEC_CAP_EXPERIMENTAL | AV_CODEC_CAP_SLICE_THREADS,
     .sample_fmts    = (const enum AVSampleFormat[]){ AV_SAMPLE_FMT_FLTP,
                                                      AV_SAMPLE_FMT_NONE },
     .priv_class     = &aacenc_class,
@@ -106,8 +106,17 @@ typedef struct AACEncContext {
     struct {
         float *samples;
     } buffer;
+
+    struct AACEncContext *slice_ctx;             ///< per-thread scratch contexts for element slice threading
+    int nb_slice_ctx;
+
+    void (*abs_pow34)(float *out, const float *in, const int size);
+    void (*quant_bands)(int *out, const float *in, const float *scaled,
+                        int size, float Q34, int is_signed, int maxval,
+                        const float rounding);
 } AACEncContext;
 
 void ff_aac_coder_init_mips(AACEncContext *c);
+void ff_aac_dsp_init_x86(AACEncContext *s);
 
 #endif /* AVCODEC_AACENC_H */
@@ -27,9 +27,6 @@
 #include "get_bits.h"
 
 
-#define AC3_HEADER_SIZE 7
-
-
 static const uint8_t eac3_blocks[4] = {
     1, 2, 3, 6
 };
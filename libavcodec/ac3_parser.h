@@ -26,6 +26,9 @@
 #include "ac3.h"
 #include "get_bits.h"
 
+/** Number of bytes needed to parse the frame header */
+#define AC3_HEADER_SIZE 7
+
 /**
  * Parse AC-3 frame header.
  * Parse the header up to the lfeon element, which is the first 52 or 54 bits
@@ -202,6 +202,14 @@ static av_cold int ac3_decode_init(AVCodecContext *avctx)
     ff_ac3dsp_init(&s->ac3dsp, avctx->flags & AV_CODEC_FLAG_BITEXACT);
     av_lfg_init(&s->dith_state, 0);
 
+    s->frame.f      = av_frame_alloc();
+    s->prev_frame.f = av_frame_alloc();
+    if (!s->frame.f || !s->prev_frame.f)
+        return AVERROR(ENOMEM);
+    s->state_buf      = NULL;
+    s->prev_state_buf = NULL;
+    avctx->internal->allocate_progress = 1;
+
     if (USE_FIXED)
         avctx->sample_fmt = AV_SAMPLE_FMT_S16P;
     else
@@ -224,10 +232,8 @@ FF_ENABLE_DEPRECATION_WARNINGS
         avctx->channels = 2;
     s->downmixed = 1;
 
-    for (i = 0; i < AC3_MAX_CHANNELS; i++) {
-        s->xcfptr[i] = s->transform_coeffs[i];
+    for (i = 0; i < AC3_MAX_CHANNELS; i++)
         s->dlyptr[i] = s->delay[i];
-    }
 
     return 0;
 }
@@ -515,9 +521,11 @@ static void ac3_decode_transform_coeffs_ch(AC3DecodeContext *s, int ch_index, ma
         switch (bap) {
         case 0:
             /* random noise with approximate range of -0.707 to 0.707 */
-            if (dither)
+            if (dither) {
+                if (s->dither_pending)
+                    ff_ac3_sync_dither(s);
                 mantissa = (((av_lfg_get(&s->dith_state)>>8)*181)>>8) - 5931008;
-            else
+            } else
                 mantissa = 0;
             break;
         case 1:
@@ -672,12 +680,12 @@ static void do_rematrixing(AC3DecodeContext *s)
  * Convert frequency domain coefficients to time-domain audio samples.
  * reference: Section 7.9.4 Transformation Equations
  */
-static inline void do_imdct(AC3DecodeContext *s, int channels)
+static inline void do_imdct(AC3DecodeContext *s, int blk, int channels)
 {
     int ch;
 
     for (ch = 1; ch <= channels; ch++) {
-        if (s->block_switch[ch]) {
+        if (s->block_switch[blk][ch]) {
             int i;
             FFTSample *x = s->tmp_output + 128;
             for (i = 0; i < 128; i++)
@@ -809,20 +817,16 @@ static int decode_audio_block(AC3DecodeContext *s, int blk)
     int fbw_channels = s->fbw_channels;
     int channel_mode = s->channel_mode;
     int i, bnd, seg, ch;
-    int different_transforms;
-    int downmix_output;
     int cpl_in_use;
     GetBitContext *gbc = &s->gbc;
     uint8_t bit_alloc_stages[AC3_MAX_CHANNELS] = { 0 };
 
+    s->transform_coeffs = s->block_coeffs[blk];
+
     /* block switch flags */
-    different_transforms = 0;
     if (s->block_switch_syntax) {
-        for (ch = 1; ch <= fbw_channels; ch++) {
-            s->block_switch[ch] = get_bits1(gbc);
-            if (ch > 1 && s->block_switch[ch] != s->block_switch[1])
-                different_transforms = 1;
-        }
+        for (ch = 1; ch <= fbw_channels; ch++)
+            s->block_switch[blk][ch] = get_bits1(gbc);
     }
 
     /* dithering flags */
@@ -1361,6 +1365,28 @@ static int decode_audio_block(AC3DecodeContext *s, int blk)
         ff_eac3_apply_spectral_extension(s);
     }
 
+    return 0;
+}
+
+/**
+ * Transform the coefficients of a decoded audio block to output samples.
+ * Unlike decode_audio_block() this depends on the state left by the
+ * previous block, so blocks must be passed in order.
+ */
+static void output_audio_block(AC3DecodeContext *s, int blk)
+{
+    int ch;
+    int different_transforms = 0;
+    int downmix_output;
+
+    s->transform_coeffs = s->block_coeffs[blk];
+    for (ch = 0; ch < AC3_MAX_CHANNELS; ch++)
+        s->xcfptr[ch] = s->transform_coeffs[ch];
+
+    for (ch = 2; ch <= s->fbw_channels; ch++)
+        if (s->block_switch[blk][ch] != s->block_switch[blk][1])
+            different_transforms = 1;
+
     /* downmix and MDCT. order depends on whether block switching is used for
        any channel in this block. this is because coefficients for the long
        and short transforms cannot be mixed. */
@@ -1375,7 +1401,7 @@ static int decode_audio_block(AC3DecodeContext *s, int blk)
             ac3_upmix_delay(s);
         }
 
-        do_imdct(s, s->channels);
+        do_imdct(s, blk, s->channels);
 
         if (downmix_output) {
 #if USE_FIXED
@@ -1398,10 +1424,181 @@ static int decode_audio_block(AC3DecodeContext *s, int blk)
                                           s->out_channels, s->fbw_channels, 128);
         }
 
-        do_imdct(s, s->out_channels);
+        do_imdct(s, blk, s->out_channels);
     }
+}
 
-    return 0;
+/**
+ * Overlap state carried from one packet to the next, passed between frame
+ * threads in AC3DecodeContext.state_buf.
+ */
+typedef struct AC3OverlapState {
+    int downmixed;
+    AVLFG dith_state;
+    INTFLOAT delay[AC3_MAX_CHANNELS][AC3_BLOCK_SIZE];
+    SHORTFLOAT output[AC3_MAX_CHANNELS][AC3_BLOCK_SIZE];
+} AC3OverlapState;
+
+static void ff_ac3_sync_dither(AC3DecodeContext *s)
+{
+    ff_thread_await_progress(&s->prev_frame, 1, 0);
+    if (s->prev_state_buf)
+        s->dith_state = ((const AC3OverlapState *)s->prev_state_buf->data)->dith_state;
+    else
+        av_lfg_init(&s->dith_state, 0);
+    s->dither_pending = 0;
+}
+
+static void load_overlap_state(AC3DecodeContext *s)
+{
+    if (s->dither_pending)
+        ff_ac3_sync_dither(s);
+    if (s->prev_state_buf) {
+        const AC3OverlapState *st = (const AC3OverlapState *)s->prev_state_buf->data;
+        s->downmixed = st->downmixed;
+        memcpy(s->delay,  st->delay,  sizeof(s->delay));
+        memcpy(s->output, st->output, sizeof(s->output));
+    } else {
+        s->downmixed = 1;
+        memset(s->delay,  0, sizeof(s->delay));
+        memset(s->output, 0, sizeof(s->output));
+    }
+}
+
+static void store_overlap_state(AC3DecodeContext *s)
+{
+    AC3OverlapState *st = (AC3OverlapState *)s->state_buf->data;
+    st->downmixed  = s->downmixed;
+    st->dith_state = s->dith_state;
+    memcpy(st->delay,  s->delay,  sizeof(s->delay));
+    memcpy(st->output, s->output, sizeof(s->output));
+}
+
+/**
+ * Set the output channel configuration and downmix coefficients
+ * for the current frame header.
+ */
+static void set_output_mode(AC3DecodeContext *s)
+{
+    s->out_channels = s->channels;
+    s->output_mode  = s->channel_mode;
+    if (s->lfe_on)
+        s->output_mode |= AC3_OUTPUT_LFEON;
+    if (s->channels > 1 &&
+        s->avctx->request_channel_layout == AV_CH_LAYOUT_MONO) {
+        s->out_channels = 1;
+        s->output_mode  = AC3_CHMODE_MONO;
+    } else if (s->channels > 2 &&
+               s->avctx->request_channel_layout == AV_CH_LAYOUT_STEREO) {
+        s->out_channels = 2;
+        s->output_mode  = AC3_CHMODE_STEREO;
+    }
+
+    s->loro_center_mix_level   = gain_levels[s->  center_mix_level];
+    s->loro_surround_mix_level = gain_levels[s->surround_mix_level];
+    s->ltrt_center_mix_level   = LEVEL_MINUS_3DB;
+    s->ltrt_surround_mix_level = LEVEL_MINUS_3DB;
+    /* set downmixing coefficients if needed */
+    if (s->channels != s->out_channels && !((s->output_mode & AC3_OUTPUT_LFEON) &&
+            s->fbw_channels == s->out_channels)) {
+        set_downmix_coeffs(s);
+    }
+}
+
+/**
+ * Decode the audio blocks of the current frame up to the first damaged one.
+ * @return number of blocks decoded
+ */
+static int decode_audio_blocks(AC3DecodeContext *s)
+{
+    int blk;
+
+    for (blk = 0; blk < s->num_blocks; blk++) {
+        if (decode_audio_block(s, blk)) {
+            av_log(s->avctx, AV_LOG_ERROR, "error decoding the audio block\n");
+            break;
+        }
+    }
+    return blk;
+}
+
+/**
+ * Write num_blocks blocks of the current frame to out, starting at sample
+ * offset. Blocks from good_blocks on are concealed by repeating the last
+ * good block.
+ */
+static void output_audio_blocks(AC3DecodeContext *s, AVFrame *out, int offset,
+                                int num_blocks, int good_blocks)
+{
+    const uint8_t *channel_map = ff_ac3_dec_channel_map[s->output_mode & ~AC3_OUTPUT_LFEON][s->lfe_on];
+    const SHORTFLOAT *output[AC3_MAX_CHANNELS];
+    int blk, ch;
+
+    for (ch = 0; ch < AC3_MAX_CHANNELS; ch++) {
+        output[ch] = s->output[ch];
+        s->outptr[ch] = s->output[ch];
+    }
+    for (ch = 0; ch < s->channels; ch++) {
+        if (ch < s->out_channels)
+            s->outptr[channel_map[ch]] = (SHORTFLOAT *)out->data[ch] + offset;
+    }
+    for (blk = 0; blk < num_blocks; blk++) {
+        if (blk < good_blocks)
+            output_audio_block(s, blk);
+        else
+            for (ch = 0; ch < s->out_channels; ch++)
+                memcpy(((SHORTFLOAT*)out->data[ch]) + offset + AC3_BLOCK_SIZE*blk, output[ch], AC3_BLOCK_SIZE*sizeof(SHORTFLOAT));
+        for (ch = 0; ch < s->out_channels; ch++)
+            output[ch] = s->outptr[channel_map[ch]];
+        for (ch = 0; ch < s->out_channels; ch++) {
+            if (!ch || channel_map[ch])
+                s->outptr[channel_map[ch]] += AC3_BLOCK_SIZE;
+        }
+    }
+
+    /* keep last block for error concealment in next frame */
+    for (ch = 0; ch < s->out_channels; ch++)
+        memcpy(s->output[ch], output[ch], AC3_BLOCK_SIZE*sizeof(SHORTFLOAT));
+}
+
+/**
+ * Find further independent frames following the current one in the packet.
+ * They are decoded into the same output frame, so they must have the same
+ * audio parameters.
+ * @return number of frames found or a negative error code
+ */
+static int scan_extra_frames(AC3DecodeContext *s, const uint8_t *buf, int buf_size,
+                             int *frame_pos, int *frame_blocks)
+{
+    AC3HeaderInfo hdr, *phdr = &hdr;
+    GetBitContext gbc;
+    int pos = s->frame_size, n = 0;
+
+    while (buf_size - pos >= AC3_HEADER_SIZE) {
+        init_get_bits8(&gbc, buf + pos, buf_size - pos);
+        if (avpriv_ac3_parse_header2(&gbc, &phdr) < 0 ||
+            hdr.frame_size > buf_size - pos)
+            break;
+        if (hdr.frame_type != EAC3_FRAME_TYPE_DEPENDENT && !hdr.substreamid) {
+            if (hdr.sample_rate  != s->sample_rate  ||
+                hdr.channel_mode != s->channel_mode ||
+                hdr.lfe_on       != s->lfe_on) {
+                avpriv_request_sample(s->avctx, "Parameter change within a "
+                                      "packet with frame threading");
+                return AVERROR_PATCHWELCOME;
+            }
+            if (n == AC3_MAX_EXTRA_FRAMES) {
+                avpriv_request_sample(s->avctx, "More than %d frames in a "
+                                      "packet with frame threading",
+                                      AC3_MAX_EXTRA_FRAMES + 1);
+                return AVERROR_PATCHWELCOME;
+            }
+            frame_pos[n]      = pos;
+            frame_blocks[n++] = hdr.num_blocks;
+        }
+        pos += hdr.frame_size;
+    }
+    return n;
 }
 
 /**
@@ -1411,15 +1608,21 @@ static int ac3_decode_frame(AVCodecContext * avctx, void *data,
                             int *got_frame_ptr, AVPacket *avpkt)
 {
     AVFrame *frame     = data;
+    AVFrame *out;
     const uint8_t *buf = avpkt->data;
     int buf_size = avpkt->size;
     AC3DecodeContext *s = avctx->priv_data;
-    int blk, ch, err, ret;
-    const uint8_t *channel_map;
-    const SHORTFLOAT *output[AC3_MAX_CHANNELS];
+    int frame_threading = avctx->active_thread_type & FF_THREAD_FRAME;
+    int i, err, ret, offset, nb_samples, good_blocks = 0;
+    int num_frames = 1, extra_pos[AC3_MAX_EXTRA_FRAMES], extra_blocks[AC3_MAX_EXTRA_FRAMES];
     enum AVMatrixEncoding matrix_encoding;
     AVDownmixInfo *downmix_info;
 
+    if (frame_threading) {
+        ff_thread_release_buffer(avctx, &s->frame);
+        av_buffer_unref(&s->state_buf);
+    }
+
     /* copy input buffer to decoder context to avoid reading past the end
        of the buffer, which can be caused by a damaged input stream. */
     if (buf_size >= 2 && AV_RB16(buf) == 0x770B) {
@@ -1495,29 +1698,7 @@ static int ac3_decode_frame(AVCodecContext * avctx, void *data,
 
     /* channel config */
     if (!err || (s->channels && s->out_channels != s->channels)) {
-        s->out_channels = s->channels;
-        s->output_mode  = s->channel_mode;
-        if (s->lfe_on)
-            s->output_mode |= AC3_OUTPUT_LFEON;
-        if (s->channels > 1 &&
-            avctx->request_channel_layout == AV_CH_LAYOUT_MONO) {
-            s->out_channels = 1;
-            s->output_mode  = AC3_CHMODE_MONO;
-        } else if (s->channels > 2 &&
-                   avctx->request_channel_layout == AV_CH_LAYOUT_STEREO) {
-            s->out_channels = 2;
-            s->output_mode  = AC3_CHMODE_STEREO;
-        }
-
-        s->loro_center_mix_level   = gain_levels[s->  center_mix_level];
-        s->loro_surround_mix_level = gain_levels[s->surround_mix_level];
-        s->ltrt_center_mix_level   = LEVEL_MINUS_3DB;
-        s->ltrt_surround_mix_level = LEVEL_MINUS_3DB;
-        /* set downmixing coefficients if needed */
-        if (s->channels != s->out_channels && !((s->output_mode & AC3_OUTPUT_LFEON) &&
-                s->fbw_channels == s->out_channels)) {
-            set_downmix_coeffs(s);
-        }
+        set_output_mode(s);
     } else if (!s->channels) {
         av_log(avctx, AV_LOG_ERROR, "unable to determine channel mode\n");
         return AVERROR_INVALIDDATA;
@@ -1533,41 +1714,82 @@ static int ac3_decode_frame(AVCodecContext * avctx, void *data,
         avctx->audio_service_type = AV_AUDIO_SERVICE_TYPE_KARAOKE;
 
     /* get output buffer */
-    frame->nb_samples = s->num_blocks * AC3_BLOCK_SIZE;
-    if ((ret = ff_get_buffer(avctx, frame, 0)) < 0)
-        return ret;
+    /* A frame thread has to consume the whole packet, so further frames the
+       parser left in it are decoded into the same output frame. Without
+       threads they are returned one per call, as usual. */
+    if (frame_threading && !err) {
+        ret = scan_extra_frames(s, buf, FFMIN(buf_size, AC3_FRAME_BUFFER_SIZE),
+                                extra_pos, extra_blocks);
+        if (ret < 0)
+            return ret;
+        num_frames += ret;
+    }
+    nb_samples = s->num_blocks * AC3_BLOCK_SIZE;
+    for (i = 0; i < num_frames - 1; i++)
+        nb_samples += extra_blocks[i] * AC3_BLOCK_SIZE;
+    if (frame_threading) {
+        /* Only the transform overlap, the concealment block and the dither
+           generator depend on the previous packet; they are handed over in
+           state_buf once the previous thread reports progress on its frame. */
+        s->state_buf = av_buffer_alloc(sizeof(AC3OverlapState));
+        if (!s->state_buf)
+            return AVERROR(ENOMEM);
+        s->frame.f->nb_samples = nb_samples;
+        if ((ret = ff_thread_get_buffer(avctx, &s->frame, 0)) < 0) {
+            av_buffer_unref(&s->state_buf);
+            return ret;
+        }
+        ff_thread_finish_setup(avctx);
+        out = s->frame.f;
+        s->dither_pending = 1;
+    } else {
+        frame->nb_samples = nb_samples;
+        if ((ret = ff_get_buffer(avctx, frame, 0)) < 0)
+            return ret;
+        out = frame;
+    }
 
     /* decode the audio blocks */
-    channel_map = ff_ac3_dec_channel_map[s->output_mode & ~AC3_OUTPUT_LFEON][s->lfe_on];
-    for (ch = 0; ch < AC3_MAX_CHANNELS; ch++) {
-        output[ch] = s->output[ch];
-        s->outptr[ch] = s->output[ch];
+    if (!err) {
+        good_blocks = decode_audio_blocks(s);
+        if (good_blocks < s->num_blocks)
+            err = 1;
     }
-    for (ch = 0; ch < s->channels; ch++) {
-        if (ch < s->out_channels)
-            s->outptr[channel_map[ch]] = (SHORTFLOAT *)frame->data[ch];
+
+    /* transform them, this needs the overlap left by the previous packet */
+    if (frame_threading) {
+        ff_thread_await_progress(&s->prev_frame, 1, 0);
+        load_overlap_state(s);
     }
-    for (blk = 0; blk < s->num_blocks; blk++) {
-        if (!err && decode_audio_block(s, blk)) {
-            av_log(avctx, AV_LOG_ERROR, "error decoding the audio block\n");
-            err = 1;
-        }
-        if (err)
-            for (ch = 0; ch < s->out_channels; ch++)
-                memcpy(((SHORTFLOAT*)frame->data[ch]) + AC3_BLOCK_SIZE*blk, output[ch], AC3_BLOCK_SIZE*sizeof(SHORTFLOAT));
-        for (ch = 0; ch < s->out_channels; ch++)
-            output[ch] = s->outptr[channel_map[ch]];
-        for (ch = 0; ch < s->out_channels; ch++) {
-            if (!ch || channel_map[ch])
-                s->outptr[channel_map[ch]] += AC3_BLOCK_SIZE;
+    output_audio_blocks(s, out, 0, s->num_blocks, good_blocks);
+    offset = s->num_blocks * AC3_BLOCK_SIZE;
+
+    for (i = 0; i < num_frames - 1; i++) {
+        const uint8_t *frame_buf = buf + extra_pos[i];
+        int frame_size_max = FFMIN(buf_size, AC3_FRAME_BUFFER_SIZE) - extra_pos[i];
+
+        init_get_bits8(&s->gbc, frame_buf, frame_size_max);
+        good_blocks = 0;
+        if (!parse_frame_header(s) &&
+            !((avctx->err_recognition & (AV_EF_CRCCHECK|AV_EF_CAREFUL)) &&
+              av_crc(av_crc_get_table(AV_CRC_16_ANSI), 0, &frame_buf[2], s->frame_size - 2))) {
+            set_output_mode(s);
+            good_blocks = decode_audio_blocks(s);
         }
+        if (good_blocks < extra_blocks[i])
+            err = 1;
+        output_audio_blocks(s, out, offset, extra_blocks[i], good_blocks);
+        offset += extra_blocks[i] * AC3_BLOCK_SIZE;
     }
 
-    av_frame_set_decode_error_flags(frame, err ? FF_DECODE_ERROR_INVALID_BITSTREAM : 0);
+    av_frame_set_decode_error_flags(out, err ? FF_DECODE_ERROR_INVALID_BITSTREAM : 0);
 
-    /* keep last block for error concealment in next frame */
-    for (ch = 0; ch < s->out_channels; ch++)
-        memcpy(s->output[ch], output[ch], AC3_BLOCK_SIZE*sizeof(SHORTFLOAT));
+    if (frame_threading) {
+        store_overlap_state(s);
+        ff_thread_report_progress(&s->frame, 1, 0);
+        if ((ret = av_frame_ref(frame, s->frame.f)) < 0)
+            return ret;
+    }
 
     /*
      * AVMatrixEncoding
@@ -1595,8 +1817,10 @@ static int ac3_decode_frame(AVCodecContext * avctx, void *data,
             break;
         }
     }
-    if ((ret = ff_side_data_update_matrix_encoding(frame, matrix_encoding)) < 0)
+    if ((ret = ff_side_data_update_matrix_encoding(frame, matrix_encoding)) < 0) {
+        av_frame_unref(frame);
         return ret;
+    }
 
     /* AVDownmixInfo */
     if ((downmix_info = av_downmix_info_update_side_data(frame))) {
@@ -1622,12 +1846,14 @@ static int ac3_decode_frame(AVCodecContext * avctx, void *data,
             downmix_info->lfe_mix_level       = gain_levels_lfe[s->lfe_mix_level];
         else
             downmix_info->lfe_mix_level       = 0.0; // -inf dB
-    } else
+    } else {
+        av_frame_unref(frame);
         return AVERROR(ENOMEM);
+    }
 
     *got_frame_ptr = 1;
 
-    return FFMIN(buf_size, s->frame_size);
+    return frame_threading ? buf_size : FFMIN(buf_size, s->frame_size);
 }
 
 /**
@@ -1640,6 +1866,57 @@ static av_cold int ac3_decode_end(AVCodecContext *avctx)
     ff_mdct_end(&s->imdct_256);
     av_freep(&s->fdsp);
 
+    ff_thread_release_buffer(avctx, &s->frame);
+    ff_thread_release_buffer(avctx, &s->prev_frame);
+    av_frame_free(&s->frame.f);
+    av_frame_free(&s->prev_frame.f);
+    av_buffer_unref(&s->state_buf);
+    av_buffer_unref(&s->prev_state_buf);
+
+    return 0;
+}
+
+#define copy_fields(to, from, start_field, end_field)                         \
+    memcpy(&(to)->start_field, &(from)->start_field,                          \
+           (char *)&(to)->end_field - (char *)&(to)->start_field)
+
+static int ac3_update_thread_context(AVCodecContext *dst, const AVCodecContext *src)
+{
+    AC3DecodeContext *s = dst->priv_data, *s1 = src->priv_data;
+    ThreadFrame *prev_frame;
+    AVBufferRef *prev_state;
+    int ret;
+
+    if (dst == src)
+        return 0;
+
+    /* a packet that failed before getting a buffer leaves the overlap
+       state untouched, so pass on the one it was given */
+    if (s1->state_buf) {
+        prev_frame = &s1->frame;
+        prev_state = s1->state_buf;
+    } else {
+        prev_frame = &s1->prev_frame;
+        prev_state = s1->prev_state_buf;
+    }
+
+    ff_thread_release_buffer(dst, &s->prev_frame);
+    av_buffer_unref(&s->prev_state_buf);
+    if (prev_frame->f->buf[0] &&
+        (ret = ff_thread_ref_frame(&s->prev_frame, prev_frame)) < 0)
+        return ret;
+    if (prev_state && !(s->prev_state_buf = av_buffer_ref(prev_state)))
+        return AVERROR(ENOMEM);
+
+    /* damaged headers fall back to the previous channel configuration */
+    copy_fields(s, s1, frame_type, preferred_stereo_downmix);
+    s->fbw_channels = s1->fbw_channels;
+    s->channels     = s1->channels;
+    s->lfe_ch       = s1->lfe_ch;
+    s->output_mode  = s1->output_mode;
+    s->out_channels = s1->out_channels;
+    memcpy(s->downmix_coeffs, s1->downmix_coeffs, sizeof(s->downmix_coeffs));
+
     return 0;
 }
 
@@ -59,6 +59,7 @@
 #include "get_bits.h"
 #include "fft.h"
 #include "fmtconvert.h"
+#include "thread.h"
 
 #define AC3_OUTPUT_LFEON  8
 
@@ -67,6 +68,9 @@
 /** Large enough for maximum possible frame size when the specification limit is ignored */
 #define AC3_FRAME_BUFFER_SIZE 32768
 
+/** Maximum number of further frames decoded from one packet with frame threading */
+#define AC3_MAX_EXTRA_FRAMES 8
+
 typedef struct AC3DecodeContext {
     AVClass        *class;                  ///< class for AVOptions
     AVCodecContext *avctx;                  ///< parent context
@@ -207,10 +211,11 @@ typedef struct AC3DecodeContext {
 ///@name Zero-mantissa dithering
     int dither_flag[AC3_MAX_CHANNELS];      ///< dither flags                           (dithflg)
     AVLFG dith_state;                       ///< for dither generation
+    int dither_pending;                     ///< dith_state still has to be taken from the previous packet
 ///@}
 
 ///@name IMDCT
-    int block_switch[AC3_MAX_CHANNELS];     ///< block switch flags                     (blksw)
+    int block_switch[AC3_MAX_BLOCKS][AC3_MAX_CHANNELS]; ///< block switch flags         (blksw)
     FFTContext imdct_512;                   ///< for 512 sample IMDCT
     FFTContext imdct_256;                   ///< for 256 sample IMDCT
 ///@}
@@ -229,10 +234,18 @@ typedef struct AC3DecodeContext {
     SHORTFLOAT *outptr[AC3_MAX_CHANNELS];
     INTFLOAT *xcfptr[AC3_MAX_CHANNELS];
     INTFLOAT *dlyptr[AC3_MAX_CHANNELS];
+    INTFLOAT (*transform_coeffs)[AC3_MAX_COEFS];   ///< transform coefficients of the current block
+
+///@name Frame threading
+    ThreadFrame frame;                      ///< output of the current packet, carries the overlap progress
+    ThreadFrame prev_frame;                 ///< output of the previous packet
+    AVBufferRef *state_buf;                 ///< overlap state after the current packet
+    AVBufferRef *prev_state_buf;            ///< overlap state after the previous packet, NULL at start
+///@}
 
 ///@name Aligned arrays
     DECLARE_ALIGNED(16, int,   fixed_coeffs)[AC3_MAX_CHANNELS][AC3_MAX_COEFS];       ///< fixed-point transform coefficients
-    DECLARE_ALIGNED(32, INTFLOAT, transform_coeffs)[AC3_MAX_CHANNELS][AC3_MAX_COEFS];   ///< transform coefficients
+    DECLARE_ALIGNED(32, INTFLOAT, block_coeffs)[AC3_MAX_BLOCKS][AC3_MAX_CHANNELS][AC3_MAX_COEFS]; ///< transform coefficients of all blocks
     DECLARE_ALIGNED(32, INTFLOAT, delay)[AC3_MAX_CHANNELS][AC3_BLOCK_SIZE];             ///< delay - added to the next block
     DECLARE_ALIGNED(32, INTFLOAT, window)[AC3_BLOCK_SIZE];                              ///< window coefficients
     DECLARE_ALIGNED(32, INTFLOAT, tmp_output)[AC3_BLOCK_SIZE];                          ///< temporary storage for output before windowing
@@ -260,4 +273,11 @@ static void ff_eac3_decode_transform_coeffs_aht_ch(AC3DecodeContext *s, int ch);
  */
 static void ff_eac3_apply_spectral_extension(AC3DecodeContext *s);
 
+/**
+ * Continue the dither generator from where the previous packet left it.
+ * With frame threads this waits for the previous packet, so it is only
+ * called once the first dithered value of a packet is needed.
+ */
+static void ff_ac3_sync_dither(AC3DecodeContext *s);
+
 #endif /* AVCODEC_AC3DEC_H */
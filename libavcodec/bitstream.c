@@ -360,3 +360,48 @@ void ff_free_vlc(VLC *vlc)
 {
     av_freep(&vlc->table);
 }
+
+int ff_init_vlc_multi(VLC_MULTI *multi, const VLC *vlc)
+{
+    const int size = 1 << vlc->bits;
+    const int mask = size - 1;
+    int i;
+
+    if (multi->table_allocated < size) {
+        av_freep(&multi->table);
+        multi->table = av_malloc_array(size, sizeof(*multi->table));
+        if (!multi->table) {
+            multi->table_allocated = 0;
+            return AVERROR(ENOMEM);
+        }
+        multi->table_allocated = size;
+    }
+
+    for (i = 0; i < size; i++) {
+        VLC_MULTI_ELEM *e = &multi->table[i];
+        int pos = 0, num = 0;
+
+        /* the low pos bits of the index are unknown and left as zero, so a
+         * code is only usable if the known bits determine it */
+        while (num < VLC_MULTI_MAX_SYMBOLS) {
+            int idx  = (i << pos) & mask;
+            int code = vlc->table[idx][0];
+            int len  = vlc->table[idx][1];
+
+            if (len <= 0 || len > vlc->bits - pos || code < 0 || code > 255)
+                break;
+            e->val[num++] = code;
+            pos          += len;
+        }
+        e->num = num;
+        e->len = pos;
+    }
+
+    return 0;
+}
+
+void ff_free_vlc_multi(VLC_MULTI *multi)
+{
+    av_freep(&multi->table);
+    multi->table_allocated = 0;
+}
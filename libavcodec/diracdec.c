@@ -150,6 +150,7 @@ typedef struct DiracContext {
     int zero_res;               /* zero residue flag                         */
     int is_arith;               /* whether coeffs use arith or golomb coding */
     int low_delay;              /* use the low delay syntax                  */
+    int hq_picture;             /* use the VC-2 high quality slice syntax    */
     int globalmc_flag;          /* use global motion compensation            */
     int num_refs;               /* number of reference pictures              */
 
@@ -173,9 +174,15 @@ typedef struct DiracContext {
         unsigned num_x;         /* number of horizontal slices               */
         unsigned num_y;         /* number of vertical slices                 */
         AVRational bytes;       /* average bytes per slice                   */
+        int slice_count;        /* slices present in the current picture     */
         uint8_t quant[MAX_DWT_LEVELS][4]; /* [DIRAC_STD] E.1 */
     } lowdelay;
 
+    struct {
+        unsigned prefix_bytes;  /* bytes skipped at the start of each slice  */
+        unsigned size_scaler;   /* multiplier of the slice component lengths */
+    } highquality;
+
     struct {
         int pan_tilt[2];        /* pan/tilt vector                           */
         int zrs[2][2];          /* zoom/rotate/shear matrix                  */
@@ -731,10 +738,8 @@ struct lowdelay_slice {
  * Dirac Specification ->
  * 13.5.2 Slices. slice(sx,sy)
  */
-static int decode_lowdelay_slice(AVCodecContext *avctx, void *arg)
+static void decode_lowdelay_slice(DiracContext *s, struct lowdelay_slice *slice)
 {
-    DiracContext *s = avctx->priv_data;
-    struct lowdelay_slice *slice = arg;
     GetBitContext *gb = &slice->gb;
     enum dirac_subband orientation;
     int level, quant, chroma_bits, chroma_end;
@@ -765,7 +770,52 @@ static int decode_lowdelay_slice(AVCodecContext *avctx, void *arg)
                              &s->plane[1].band[level][orientation],
                              &s->plane[2].band[level][orientation]);
         }
+}
+
+/**
+ * VC-2 high quality profile slice (SMPTE 2042-1 13.5.4 hq_slice()).
+ * Unlike low delay slices, the three components are coded one after
+ * the other, each with its own length scaled by size_scaler.
+ */
+static void decode_hq_slice(DiracContext *s, struct lowdelay_slice *slice)
+{
+    GetBitContext *gb = &slice->gb;
+    enum dirac_subband orientation;
+    int level, comp, quant, quant_base, bits_end;
+
+    skip_bits_long(gb, 8 * s->highquality.prefix_bytes);
+    quant_base = get_bits(gb, 8);
+
+    for (comp = 0; comp < 3; comp++) {
+        int64_t bits = 8LL * s->highquality.size_scaler * get_bits(gb, 8);
+
+        bits_end = get_bits_count(gb) + FFMIN(bits, get_bits_left(gb));
+        for (level = 0; level < s->wavelet_depth; level++)
+            for (orientation = !!level; orientation < 4; orientation++) {
+                quant = FFMAX(quant_base - s->lowdelay.quant[level][orientation], 0);
+                lowdelay_subband(s, gb, quant, slice->slice_x, slice->slice_y, bits_end,
+                                 &s->plane[comp].band[level][orientation], NULL);
+            }
 
+        /* the next component starts right after the coded length */
+        skip_bits_long(gb, bits_end - get_bits_count(gb));
+    }
+}
+
+static int decode_lowdelay_slice_row(AVCodecContext *avctx, void *arg,
+                                     int jobnr, int threadnr)
+{
+    DiracContext *s = avctx->priv_data;
+    struct lowdelay_slice *slices = arg;
+    int i   = jobnr * s->lowdelay.num_x;
+    int end = FFMIN(i + s->lowdelay.num_x, s->lowdelay.slice_count);
+
+    for (; i < end; i++) {
+        if (s->hq_picture)
+            decode_hq_slice(s, &slices[i]);
+        else
+            decode_lowdelay_slice(s, &slices[i]);
+    }
     return 0;
 }
 
@@ -792,8 +842,17 @@ static int decode_lowdelay(DiracContext *s)
 
     for (slice_y = 0; bufsize > 0 && slice_y < s->lowdelay.num_y; slice_y++)
         for (slice_x = 0; bufsize > 0 && slice_x < s->lowdelay.num_x; slice_x++) {
-            bytes = (slice_num+1) * s->lowdelay.bytes.num / s->lowdelay.bytes.den
-                - slice_num    * s->lowdelay.bytes.num / s->lowdelay.bytes.den;
+            if (s->hq_picture) {
+                /* the slice size is the sum of the three component lengths */
+                int64_t len = s->highquality.prefix_bytes + 1;
+                int i;
+                for (i = 0; i < 3 && len < bufsize/8; i++)
+                    len += buf[len] * (int64_t)s->highquality.size_scaler + 1;
+                bytes = FFMIN(len, INT_MAX);
+            } else {
+                bytes = (slice_num+1) * s->lowdelay.bytes.num / s->lowdelay.bytes.den
+                    - slice_num    * s->lowdelay.bytes.num / s->lowdelay.bytes.den;
+            }
 
             slices[slice_num].bytes   = bytes;
             slices[slice_num].slice_x = slice_x;
@@ -808,11 +867,17 @@ static int decode_lowdelay(DiracContext *s)
                 bufsize = 0;
         }
 
-    avctx->execute(avctx, decode_lowdelay_slice, slices, NULL, slice_num,
-                   sizeof(struct lowdelay_slice)); /* [DIRAC_STD] 13.5.2 Slices */
-    intra_dc_prediction(&s->plane[0].band[0][0]);  /* [DIRAC_STD] 13.3 intra_dc_prediction() */
-    intra_dc_prediction(&s->plane[1].band[0][0]);  /* [DIRAC_STD] 13.3 intra_dc_prediction() */
-    intra_dc_prediction(&s->plane[2].band[0][0]);  /* [DIRAC_STD] 13.3 intra_dc_prediction() */
+    /* [DIRAC_STD] 13.5.2 Slices, one job per row of slices */
+    s->lowdelay.slice_count = slice_num;
+    if (slice_num)
+        avctx->execute2(avctx, decode_lowdelay_slice_row, slices, NULL,
+                        slices[slice_num - 1].slice_y + 1);
+    /* high quality pictures have no DC prediction */
+    if (!s->hq_picture) {
+        intra_dc_prediction(&s->plane[0].band[0][0]);  /* [DIRAC_STD] 13.3 intra_dc_prediction() */
+        intra_dc_prediction(&s->plane[1].band[0][0]);  /* [DIRAC_STD] 13.3 intra_dc_prediction() */
+        intra_dc_prediction(&s->plane[2].band[0][0]);  /* [DIRAC_STD] 13.3 intra_dc_prediction() */
+    }
     av_free(slices);
     return 0;
 }
@@ -1042,12 +1107,22 @@ static int dirac_unpack_idwt_params(DiracContext *s)
             return AVERROR_INVALIDDATA;
         }
 
-        s->lowdelay.bytes.num = svq3_get_ue_golomb(gb);
-        s->lowdelay.bytes.den = svq3_get_ue_golomb(gb);
+        if (s->hq_picture) {
+            s->highquality.prefix_bytes = svq3_get_ue_golomb(gb);
+            s->highquality.size_scaler  = svq3_get_ue_golomb(gb);
 
-        if (s->lowdelay.bytes.den <= 0) {
-            av_log(s->avctx,AV_LOG_ERROR,"Invalid lowdelay.bytes.den\n");
-            return AVERROR_INVALIDDATA;
+            if (s->highquality.prefix_bytes >= INT_MAX / 8) {
+                av_log(s->avctx,AV_LOG_ERROR,"Invalid slice prefix bytes\n");
+                return AVERROR_INVALIDDATA;
+            }
+        } else {
+            s->lowdelay.bytes.num = svq3_get_ue_golomb(gb);
+            s->lowdelay.bytes.den = svq3_get_ue_golomb(gb);
+
+            if (s->lowdelay.bytes.den <= 0) {
+                av_log(s->avctx,AV_LOG_ERROR,"Invalid lowdelay.bytes.den\n");
+                return AVERROR_INVALIDDATA;
+            }
         }
 
         /* [DIRAC_STD] 11.3.5 Quantisation matrices (low-delay syntax). quant_matrix() */
@@ -1616,6 +1691,31 @@ static int interpolate_refplane(DiracContext *s, DiracFrame *ref, int plane, int
  * Dirac Specification ->
  * 13.0 Transform data syntax. transform_data()
  */
+/**
+ * Inverse transform of one intra plane straight into the output picture.
+ * The planes don't share any state, so they are run as separate jobs.
+ */
+static int idwt_intra_plane(AVCodecContext *avctx, void *arg, int comp, int threadnr)
+{
+    DiracContext *s = avctx->priv_data;
+    Plane *p        = &s->plane[comp];
+    uint8_t *frame  = s->current_picture->avframe->data[comp];
+    DWTContext d;
+    int y, ret;
+
+    ret = ff_spatial_idwt_init2(&d, p->idwt_buf, p->idwt_width, p->idwt_height, p->idwt_stride,
+                                s->wavelet_idx+2, s->wavelet_depth, p->idwt_tmp);
+    if (ret < 0)
+        return ret;
+
+    for (y = 0; y < p->height; y += 16) {
+        ff_spatial_idwt_slice2(&d, y+16); /* decode */
+        s->diracdsp.put_signed_rect_clamped(frame + y*p->stride, p->stride,
+                                            p->idwt_buf + y*p->idwt_stride, p->idwt_stride, p->width, 16);
+    }
+    return 0;
+}
+
 static int dirac_decode_frame_internal(DiracContext *s)
 {
     DWTContext d;
@@ -1634,9 +1734,28 @@ static int dirac_decode_frame_internal(DiracContext *s)
         }
     }
 
+    if (!s->num_refs) { /* intra */
+        int rets[3];
+
+        if (!s->low_delay) {
+            for (comp = 0; comp < 3; comp++) {
+                Plane *p = &s->plane[comp];
+                memset(p->idwt_buf, 0, p->idwt_stride * p->idwt_height * sizeof(IDWTELEM));
+                decode_component(s, comp); /* [DIRAC_STD] 13.4.1 core_transform_data() */
+            }
+        }
+
+        s->avctx->execute2(s->avctx, idwt_intra_plane, NULL, rets, 3);
+        for (comp = 0; comp < 3; comp++)
+            if (rets[comp] < 0)
+                return rets[comp];
+        return 0;
+    }
+
     for (comp = 0; comp < 3; comp++) {
         Plane *p       = &s->plane[comp];
         uint8_t *frame = s->current_picture->avframe->data[comp];
+        int rowheight  = p->ybsep*p->stride;
 
         /* FIXME: small resolutions */
         for (i = 0; i < 4; i++)
@@ -1652,51 +1771,41 @@ static int dirac_decode_frame_internal(DiracContext *s)
         if (ret < 0)
             return ret;
 
-        if (!s->num_refs) { /* intra */
-            for (y = 0; y < p->height; y += 16) {
-                ff_spatial_idwt_slice2(&d, y+16); /* decode */
-                s->diracdsp.put_signed_rect_clamped(frame + y*p->stride, p->stride,
-                                                    p->idwt_buf + y*p->idwt_stride, p->idwt_stride, p->width, 16);
-            }
-        } else { /* inter */
-            int rowheight = p->ybsep*p->stride;
-
-            select_dsp_funcs(s, p->width, p->height, p->xblen, p->yblen);
+        select_dsp_funcs(s, p->width, p->height, p->xblen, p->yblen);
 
-            for (i = 0; i < s->num_refs; i++) {
-                int ret = interpolate_refplane(s, s->ref_pics[i], comp, p->width, p->height);
-                if (ret < 0)
-                    return ret;
-            }
+        for (i = 0; i < s->num_refs; i++) {
+            int ret = interpolate_refplane(s, s->ref_pics[i], comp, p->width, p->height);
+            if (ret < 0)
+                return ret;
+        }
 
-            memset(s->mctmp, 0, 4*p->yoffset*p->stride);
+        memset(s->mctmp, 0, 4*p->yoffset*p->stride);
 
-            dsty = -p->yoffset;
-            for (y = 0; y < s->blheight; y++) {
-                int h     = 0,
-                    start = FFMAX(dsty, 0);
-                uint16_t *mctmp    = s->mctmp + y*rowheight;
-                DiracBlock *blocks = s->blmotion + y*s->blwidth;
+        dsty = -p->yoffset;
+        for (y = 0; y < s->blheight; y++) {
+            int h     = 0,
+                start = FFMAX(dsty, 0);
+            uint16_t *mctmp    = s->mctmp + y*rowheight;
+            DiracBlock *blocks = s->blmotion + y*s->blwidth;
 
-                init_obmc_weights(s, p, y);
+            init_obmc_weights(s, p, y);
 
-                if (y == s->blheight-1 || start+p->ybsep > p->height)
-                    h = p->height - start;
-                else
-                    h = p->ybsep - (start - dsty);
-                if (h < 0)
-                    break;
+            if (y == s->blheight-1 || start+p->ybsep > p->height)
+                h = p->height - start;
+            else
+                h = p->ybsep - (start - dsty);
+            if (h < 0)
+                break;
 
-                memset(mctmp+2*p->yoffset*p->stride, 0, 2*rowheight);
-                mc_row(s, blocks, mctmp, comp, dsty);
+            memset(mctmp+2*p->yoffset*p->stride, 0, 2*rowheight);
+            mc_row(s, blocks, mctmp, comp, dsty);
 
-                mctmp += (start - dsty)*p->stride + p->xoffset;
-                ff_spatial_idwt_slice2(&d, start + h); /* decode */
-                s->diracdsp.add_rect_clamped(frame + start*p->stride, mctmp, p->stride,
-                                             p->idwt_buf + start*p->idwt_stride, p->idwt_stride, p->width, h);
+            mctmp += (start - dsty)*p->stride + p->xoffset;
+            ff_spatial_idwt_slice2(&d, start + h); /* decode */
+            s->diracdsp.add_rect_clamped(frame + start*p->stride, mctmp, p->stride,
+                                         p->idwt_buf + start*p->idwt_stride, p->idwt_stride, p->width, h);
 
-                dsty += p->ybsep;
-            }
+            dsty += p->ybsep;
         }
     }
 
@@ -1922,6 +2031,7 @@ static int dirac_decode_data_unit(AVCodecContext *avctx, const uint8_t *buf, int
         s->num_refs    = tmp;
         s->is_arith    = (parse_code & 0x48) == 0x08;          /* [DIRAC_STD] using_ac()      */
         s->low_delay   = (parse_code & 0x88) == 0x88;          /* [DIRAC_STD] is_low_delay()  */
+        s->hq_picture  = (parse_code & 0xF8) == 0xE8;          /* VC-2 is_hq_picture()        */
         pic->reference = (parse_code & 0x0C) == 0x0C;  /* [DIRAC_STD]  is_reference() */
         pic->avframe->key_frame = s->num_refs == 0;             /* [DIRAC_STD] is_intra()      */
         pic->avframe->pict_type = s->num_refs + 1;              /* Definition of AVPictureType in avutil.h */
@@ -2054,6 +2164,6 @@ AVCodec ff_dirac_decoder = {
     .init           = dirac_decode_init,
     .close          = dirac_decode_end,
     .decode         = dirac_decode_frame,
-    .capabilities   = AV_CODEC_CAP_DELAY,
+    .capabilities   = AV_CODEC_CAP_DELAY | AV_CODEC_CAP_SLICE_THREADS,
     .flush          = dirac_decode_flush,
 };
@@ -22,6 +22,8 @@
  * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
  */
 
+#define CACHED_BITSTREAM_READER
+
 #include "libavutil/imgutils.h"
 #include "libavutil/timer.h"
 #include "avcodec.h"
@@ -106,6 +106,8 @@ static void ff_eac3_apply_spectral_extension(AC3DecodeContext *s)
         }
 
         /* Calculate RMS energy for each SPX band. */
+        if (s->dither_pending)
+            ff_ac3_sync_dither(s);
         bin = s->spx_src_start_freq;
         for (bnd = 0; bnd < s->num_spx_bands; bnd++) {
             int bandsize = s->spx_band_sizes[bnd];
@@ -138,6 +140,8 @@ static void ff_eac3_apply_spectral_extension(AC3DecodeContext *s)
         /* Apply noise-blended coefficient scaling based on previously
            calculated RMS energy, blending factors, and SPX coordinates for
            each band. */
+        if (s->dither_pending)
+            ff_ac3_sync_dither(s);
         bin = s->spx_src_start_freq;
         for (bnd = 0; bnd < s->num_spx_bands; bnd++) {
             float nscale = s->spx_noise_blend[ch][bnd] * rms_energy[bnd] * (1.0f / INT32_MIN);
@@ -245,6 +249,8 @@ static void ff_eac3_decode_transform_coeffs_aht_ch(AC3DecodeContext *s, int ch)
         int bits = ff_eac3_bits_vs_hebap[hebap];
         if (!hebap) {
             /* zero-mantissa dithering */
+            if (s->dither_pending)
+                ff_ac3_sync_dither(s);
             for (blk = 0; blk < 6; blk++) {
                 s->pre_mantissa[ch][bin][blk] = (av_lfg_get(&s->dith_state) & 0x7FFFFF) - 0x400000;
             }
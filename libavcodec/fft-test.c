@@ -214,7 +214,7 @@ static int check_diff(FFTSample *tab1, FFTSample *tab2, int n, double scale)
 static void help(void)
 {
     av_log(NULL, AV_LOG_INFO,
-           "usage: fft-test [-h] [-s] [-i] [-n b]\n"
+           "usage: fft-test [-h] [-s] [-i] [-n b] [-c f]\n"
            "-h     print this help\n"
            "-s     speed test\n"
            "-m     (I)MDCT test\n"
@@ -222,7 +222,8 @@ static void help(void)
            "-r     (I)RDFT test\n"
            "-i     inverse transform test\n"
            "-n b   set the transform size to 2^b\n"
-           "-f x   set scale factor for output data of (I)MDCT to x\n");
+           "-f x   set scale factor for output data of (I)MDCT to x\n"
+           "-c f   override the CPU flags, e.g. -c -avx2 or -c 0\n");
 }
 
 enum tf_transform {
@@ -480,6 +481,10 @@ int main(int argc, char **argv)
                (double) duration / nb_its,
                (double) duration / 1000000.0,
                nb_its);
+        av_log(NULL, AV_LOG_INFO,
+               "size %d cpuflags 0x%08x: %0.0f ns/transform\n",
+               fft_size, av_get_cpu_flags(),
+               (double) duration * 1000.0 / nb_its);
     }
 
     switch (transform) {
@@ -57,6 +57,8 @@ av_cold int ff_ffv1_common_init(AVCodecContext *avctx)
     s->width  = avctx->width;
     s->height = avctx->height;
 
+    ff_ffv1dsp_init(&s->dsp);
+
     // defaults
     s->num_h_slices = 1;
     s->num_v_slices = 1;
@@ -144,7 +146,10 @@ av_cold int ff_ffv1_init_slice_contexts(FFV1Context *f)
 
         fs->sample_buffer = av_malloc_array((fs->width + 6), 3 * MAX_PLANES *
                                       sizeof(*fs->sample_buffer));
-        if (!fs->sample_buffer) {
+        fs->line_buffer   = av_malloc_array(fs->width, 2 * sizeof(*fs->line_buffer));
+        if (!fs->sample_buffer || !fs->line_buffer) {
+            av_freep(&fs->sample_buffer);
+            av_freep(&fs->line_buffer);
             av_freep(&f->slice_context[i]);
             goto memfail;
         }
@@ -154,6 +159,7 @@ av_cold int ff_ffv1_init_slice_contexts(FFV1Context *f)
 memfail:
     while(--i >= 0) {
         av_freep(&f->slice_context[i]->sample_buffer);
+        av_freep(&f->slice_context[i]->line_buffer);
         av_freep(&f->slice_context[i]);
     }
     return AVERROR(ENOMEM);
@@ -224,6 +230,7 @@ av_cold int ff_ffv1_close(AVCodecContext *avctx)
             av_freep(&p->vlc_state);
         }
         av_freep(&fs->sample_buffer);
+        av_freep(&fs->line_buffer);
     }
 
     av_freep(&avctx->stats_out);
@@ -35,6 +35,7 @@
 #include "libavutil/pixdesc.h"
 #include "libavutil/timer.h"
 #include "avcodec.h"
+#include "ffv1dsp.h"
 #include "get_bits.h"
 #include "internal.h"
 #include "mathops.h"
@@ -104,6 +105,7 @@ typedef struct FFV1Context {
     int run_index;
     int colorspace;
     int16_t *sample_buffer;
+    int32_t *line_buffer;                ///< contexts and residuals of the current line
 
     int ec;
     int intra;
@@ -129,6 +131,8 @@ typedef struct FFV1Context {
     int slice_coding_mode;
     int slice_rct_by_coef;
     int slice_rct_ry_coef;
+
+    FFV1DSPContext dsp;
 } FFV1Context;
 
 int ff_ffv1_common_init(AVCodecContext *avctx);
@@ -183,6 +187,18 @@ static inline int get_context(PlaneContext *p, int16_t *src,
                p->quant_table[2][(T - RT) & 0xFF];
 }
 
+/**
+ * Golomb-Rice parameter of a VLC state, the smallest k with
+ * count << k >= error_sum.
+ */
+static inline int get_vlc_k(const VlcState *state)
+{
+    int count = state->count;
+    int k     = FFMAX(av_log2(state->error_sum) - av_log2(count), 0);
+
+    return k + ((count << k) < state->error_sum);
+}
+
 static inline void update_vlc_state(VlcState *const state, const int v)
 {
     int drift = state->drift;
@@ -71,14 +71,9 @@ static av_noinline int get_symbol(RangeCoder *c, uint8_t *state, int is_signed)
 static inline int get_vlc_symbol(GetBitContext *gb, VlcState *const state,
                                  int bits)
 {
-    int k, i, v, ret;
+    int k, v, ret;
 
-    i = state->count;
-    k = 0;
-    while (i < state->error_sum) { // FIXME: optimize
-        k++;
-        i += i;
-    }
+    k = get_vlc_k(state);
 
     v = get_sr_golomb(gb, k, 12, bits);
     ff_dlog(NULL, "v:%d bias:%d error:%d drift:%d count:%d k:%d",
@@ -104,6 +99,8 @@ static av_always_inline void decode_line(FFV1Context *s, int w,
 {
     PlaneContext *const p = &s->plane[plane_index];
     RangeCoder *const c   = &s->c;
+    int32_t *const ctx    = s->line_buffer;
+    const int large       = p->quant_table[3][127];
     int x;
     int run_count = 0;
     int run_mode  = 0;
@@ -122,10 +119,16 @@ static av_always_inline void decode_line(FFV1Context *s, int w,
         return;
     }
 
+    /* sample[1] still holds the line above sample[0] here */
+    s->dsp.context_top(ctx, sample[0], sample[1], p->quant_table, w, large);
+
     for (x = 0; x < w; x++) {
         int diff, context, sign;
+        const int L = sample[1][x - 1];
 
-        context = get_context(p, sample[1] + x, sample[0] + x, sample[1] + x);
+        context = ctx[x] + p->quant_table[0][(L - sample[0][x - 1]) & 0xFF];
+        if (large)
+            context += p->quant_table[3][(sample[1][x - 2] - L) & 0xFF];
         if (context < 0) {
             context = -context;
             sign    = 1;
@@ -1036,6 +1039,7 @@ static int init_thread_copy(AVCodecContext *avctx)
     f->picture.f      = NULL;
     f->last_picture.f = NULL;
     f->sample_buffer  = NULL;
+    f->line_buffer    = NULL;
     f->max_slice_count = 0;
     f->slice_count = 0;
 
@@ -1110,6 +1114,7 @@ static int update_thread_context(AVCodecContext *dst, const AVCodecContext *src)
         }
         av_assert0(!fdst->plane[0].state);
         av_assert0(!fdst->sample_buffer);
+        av_assert0(!fdst->line_buffer);
     }
 
     av_assert1(fdst->max_slice_count == fsrc->max_slice_count);
@@ -0,0 +1,68 @@
+/*
+ * This file is part of FFmpeg.
+ *
+ * FFmpeg is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * FFmpeg is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with FFmpeg; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+
+#ifndef AVCODEC_FFV1DSP_H
+#define AVCODEC_FFV1DSP_H
+
+#include <stdint.h>
+
+/**
+ * Whole line versions of the FFV1 predictor and context model.
+ * src is the line being coded, last the one above it and last2 the one
+ * above that; src[-2], src[-1], last[-1] and last[w] must be valid.
+ */
+typedef struct FFV1DSPContext {
+    /**
+     * Part of the context which only depends on the lines above:
+     * context[x] = q[1][LT - T] + q[2][T - RT] (+ q[4][TT - T] if large)
+     * last2 is only read if large is set.
+     */
+    void (*context_top)(int32_t *context, const int16_t *last,
+                        const int16_t *last2, int16_t (*quant_table)[256],
+                        int w, int large);
+    /**
+     * Add the part of the context which depends on the current line:
+     * context[x] += q[0][L - LT] (+ q[3][LL - L] if large)
+     */
+    void (*context_left)(int32_t *context, const int16_t *src,
+                         const int16_t *last, int16_t (*quant_table)[256],
+                         int w, int large);
+    /**
+     * Median prediction residual:
+     * diff[x] = src[x] - mid_pred(L, L + T - LT, T)
+     */
+    void (*predict_residual)(int32_t *diff, const int16_t *src,
+                             const int16_t *last, int w);
+} FFV1DSPContext;
+
+void ff_ffv1dsp_init(FFV1DSPContext *c);
+
+/* C versions, also used for the tails of the SIMD versions */
+void ff_ffv1_context_top_c(int32_t *context, const int16_t *last,
+                           const int16_t *last2, int16_t (*quant_table)[256],
+                           int w, int large);
+void ff_ffv1_context_left_c(int32_t *context, const int16_t *src,
+                            const int16_t *last, int16_t (*quant_table)[256],
+                            int w, int large);
+void ff_ffv1_predict_residual_c(int32_t *diff, const int16_t *src,
+                                const int16_t *last, int w);
+
+/* for internal use only */
+void ff_ffv1dsp_init_x86(FFV1DSPContext *c);
+
+#endif /* AVCODEC_FFV1DSP_H */
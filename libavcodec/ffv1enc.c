@@ -235,15 +235,10 @@ static av_noinline void put_symbol(RangeCoder *c, uint8_t *state,
 static inline void put_vlc_symbol(PutBitContext *pb, VlcState *const state,
                                   int v, int bits)
 {
-    int i, k, code;
+    int k, code;
     v = fold(v - state->bias, bits);
 
-    i = state->count;
-    k = 0;
-    while (i < state->error_sum) { // FIXME: optimize
-        k++;
-        i += i;
-    }
+    k = get_vlc_k(state);
 
     av_assert2(k <= 13);
 
@@ -269,6 +264,9 @@ static av_always_inline int encode_line(FFV1Context *s, int w,
 {
     PlaneContext *const p = &s->plane[plane_index];
     RangeCoder *const c   = &s->c;
+    int32_t *const ctx    = s->line_buffer;
+    int32_t *const res    = s->line_buffer + w;
+    const int large       = p->quant_table[3][127];
     int x;
     int run_index = s->run_index;
     int run_count = 0;
@@ -298,11 +296,13 @@ static av_always_inline int encode_line(FFV1Context *s, int w,
         return 0;
     }
 
-    for (x = 0; x < w; x++) {
-        int diff, context;
+    s->dsp.context_top(ctx, sample[1], sample[2], p->quant_table, w, large);
+    s->dsp.context_left(ctx, sample[0], sample[1], p->quant_table, w, large);
+    s->dsp.predict_residual(res, sample[0], sample[1], w);
 
-        context = get_context(p, sample[0] + x, sample[1] + x, sample[2] + x);
-        diff    = sample[0][x] - predict(sample[0] + x, sample[1] + x);
+    for (x = 0; x < w; x++) {
+        int diff    = res[x];
+        int context = ctx[x];
 
         if (context < 0) {
             context = -context;
@@ -124,6 +124,16 @@ typedef struct FlacEncodeContext {
 
     int flushed;
     int64_t next_pts;
+
+    /* frame threading: frames are queued into per-thread slots, encoded in
+     * parallel once all slots are filled and then returned in order */
+    struct FlacEncodeContext *slots;
+    int nb_slots;
+    int nb_queued;              ///< number of slots holding an input frame
+    int nb_encoded;             ///< number of slots holding an encoded packet
+    int next_output;            ///< index of the next slot to return
+    AVFrame *in_frame;          ///< queued input (slot contexts only)
+    AVPacket out_pkt;           ///< encoded output (slot contexts only)
 } FlacEncodeContext;
 
 
@@ -439,6 +449,31 @@ static av_cold int flac_encode_init(AVCodecContext *avctx)
 
     dprint_compression_options(s);
 
+    if (ret >= 0 && avctx->active_thread_type & FF_THREAD_SLICE &&
+        avctx->thread_count > 1) {
+        int i;
+
+        s->slots = av_malloc_array(avctx->thread_count, sizeof(*s->slots));
+        if (!s->slots)
+            return AVERROR(ENOMEM);
+        for (i = 0; i < avctx->thread_count; i++) {
+            FlacEncodeContext *slot = &s->slots[i];
+
+            memcpy(slot, s, sizeof(*slot));
+            slot->slots    = NULL;
+            slot->in_frame = NULL;
+            av_init_packet(&slot->out_pkt);
+            slot->out_pkt.data = NULL;
+            slot->out_pkt.size = 0;
+            ret = ff_lpc_init(&slot->lpc_ctx, avctx->frame_size,
+                              s->options.max_prediction_order,
+                              FF_LPC_TYPE_LEVINSON);
+            if (ret < 0)
+                return ret;
+            s->nb_slots++;
+        }
+    }
+
     return ret;
 }
 
@@ -1296,10 +1331,11 @@ static int write_frame(FlacEncodeContext *s, AVPacket *avpkt)
 }
 
 
-static int update_md5_sum(FlacEncodeContext *s, const void *samples)
+static int update_md5_sum(FlacEncodeContext *s, const void *samples,
+                          int nb_samples)
 {
     const uint8_t *buf;
-    int buf_size = s->frame.blocksize * s->channels *
+    int buf_size = nb_samples * s->channels *
                    ((s->avctx->bits_per_raw_sample + 7) / 8);
 
     if (s->avctx->bits_per_raw_sample > 16 || HAVE_BIGENDIAN) {
@@ -1320,7 +1356,7 @@ static int update_md5_sum(FlacEncodeContext *s, const void *samples)
         const int32_t *samples0 = samples;
         uint8_t *tmp            = s->md5_buffer;
 
-        for (i = 0; i < s->frame.blocksize * s->channels; i++) {
+        for (i = 0; i < nb_samples * s->channels; i++) {
             int32_t v = samples0[i] >> 8;
             AV_WL24(tmp + 3*i, v);
         }
@@ -1332,6 +1368,147 @@ static int update_md5_sum(FlacEncodeContext *s, const void *samples)
 }
 
 
+/**
+ * Analyze and encode one block of samples into s->frame.
+ * @return size of the encoded frame in bytes, or a negative error code
+ */
+static int encode_block(FlacEncodeContext *s, const void *samples, int nb_samples)
+{
+    int frame_bytes;
+
+    init_frame(s, nb_samples);
+
+    copy_samples(s, samples);
+
+    channel_decorrelation(s);
+
+    remove_wasted_bits(s);
+
+    frame_bytes = encode_frame(s);
+
+    /* Fall back on verbatim mode if the compressed frame is larger than it
+       would be if encoded uncompressed. */
+    if (frame_bytes < 0 || frame_bytes > s->max_framesize) {
+        s->frame.verbatim_only = 1;
+        frame_bytes = encode_frame(s);
+        if (frame_bytes < 0) {
+            av_log(s->avctx, AV_LOG_ERROR, "Bad frame count\n");
+            return frame_bytes;
+        }
+    }
+
+    return frame_bytes;
+}
+
+
+static int encode_slot(AVCodecContext *avctx, void *arg, int jobnr, int threadnr)
+{
+    FlacEncodeContext *s = avctx->priv_data;
+    FlacEncodeContext *slot = &s->slots[jobnr];
+    const AVFrame *frame = slot->in_frame;
+    int frame_bytes, ret;
+
+    frame_bytes = encode_block(slot, frame->data[0], frame->nb_samples);
+    if (frame_bytes < 0)
+        return frame_bytes;
+
+    if ((ret = av_new_packet(&slot->out_pkt, frame_bytes)) < 0)
+        return ret;
+    slot->out_pkt.size = write_frame(slot, &slot->out_pkt);
+
+    return 0;
+}
+
+
+static void update_frame_sizes(FlacEncodeContext *s, int out_bytes)
+{
+    if (out_bytes > s->max_encoded_framesize)
+        s->max_encoded_framesize = out_bytes;
+    if (out_bytes < s->min_framesize)
+        s->min_framesize = out_bytes;
+}
+
+
+/**
+ * Frame threaded encoding: queue the input frame, encode all queued frames
+ * in parallel once every slot is filled (or on flush), and return the
+ * encoded frames in input order, one per call.
+ * Frame numbers and the MD5 sum depend on the input order only, so they are
+ * assigned when queueing and the output is identical to the serial path.
+ */
+static int encode_frame_threaded(AVCodecContext *avctx, AVPacket *avpkt,
+                                 const AVFrame *frame, int *got_packet_ptr)
+{
+    FlacEncodeContext *s = avctx->priv_data;
+    FlacEncodeContext *slot;
+    int i, ret;
+
+    if (frame) {
+        slot = &s->slots[s->nb_queued];
+
+        /* change max_framesize for small final frame */
+        if (frame->nb_samples < s->max_blocksize) {
+            s->max_framesize = ff_flac_get_max_frame_size(frame->nb_samples,
+                                                          s->channels,
+                                                          avctx->bits_per_raw_sample);
+        }
+
+        slot->in_frame = av_frame_clone(frame);
+        if (!slot->in_frame)
+            return AVERROR(ENOMEM);
+        slot->frame_count   = s->frame_count;
+        slot->max_framesize = s->max_framesize;
+        s->nb_queued++;
+
+        s->frame_count++;
+        s->sample_count += frame->nb_samples;
+        if ((ret = update_md5_sum(s, frame->data[0], frame->nb_samples)) < 0) {
+            av_log(avctx, AV_LOG_ERROR, "Error updating MD5 checksum\n");
+            return ret;
+        }
+    }
+
+    if (s->next_output == s->nb_encoded &&
+        (s->nb_queued == s->nb_slots || (!frame && s->nb_queued))) {
+        int *rets = av_malloc_array(s->nb_queued, sizeof(*rets));
+        if (!rets)
+            return AVERROR(ENOMEM);
+
+        avctx->execute2(avctx, encode_slot, NULL, rets, s->nb_queued);
+
+        ret = 0;
+        for (i = 0; i < s->nb_queued && !ret; i++)
+            ret = FFMIN(rets[i], 0);
+        av_free(rets);
+        s->nb_encoded  = s->nb_queued;
+        s->next_output = 0;
+        s->nb_queued   = 0;
+        if (ret < 0)
+            return ret;
+    }
+
+    if (s->next_output == s->nb_encoded)
+        return 0;
+
+    slot = &s->slots[s->next_output++];
+    if ((ret = ff_alloc_packet2(avctx, avpkt, slot->out_pkt.size, 0)) < 0)
+        return ret;
+    memcpy(avpkt->data, slot->out_pkt.data, slot->out_pkt.size);
+    update_frame_sizes(s, slot->out_pkt.size);
+
+    avpkt->pts      = slot->in_frame->pts;
+    avpkt->duration = ff_samples_to_time_base(avctx, slot->in_frame->nb_samples);
+    avpkt->size     = slot->out_pkt.size;
+    av_packet_unref(&slot->out_pkt);
+    av_frame_free(&slot->in_frame);
+
+    s->next_pts = avpkt->pts + avpkt->duration;
+
+    *got_packet_ptr = 1;
+    return 0;
+}
+
+
 static int flac_encode_frame(AVCodecContext *avctx, AVPacket *avpkt,
                              const AVFrame *frame, int *got_packet_ptr)
 {
@@ -1340,6 +1517,12 @@ static int flac_encode_frame(AVCodecContext *avctx, AVPacket *avpkt,
 
     s = avctx->priv_data;
 
+    if (s->nb_slots) {
+        ret = encode_frame_threaded(avctx, avpkt, frame, got_packet_ptr);
+        if (ret < 0 || *got_packet_ptr || frame)
+            return ret;
+    }
+
     /* when the last block is reached, update the header in extradata */
     if (!frame) {
         s->max_framesize = s->max_encoded_framesize;
@@ -1369,26 +1552,9 @@ static int flac_encode_frame(AVCodecContext *avctx, AVPacket *avpkt,
                                                       avctx->bits_per_raw_sample);
     }
 
-    init_frame(s, frame->nb_samples);
-
-    copy_samples(s, frame->data[0]);
-
-    channel_decorrelation(s);
-
-    remove_wasted_bits(s);
-
-    frame_bytes = encode_frame(s);
-
-    /* Fall back on verbatim mode if the compressed frame is larger than it
-       would be if encoded uncompressed. */
-    if (frame_bytes < 0 || frame_bytes > s->max_framesize) {
-        s->frame.verbatim_only = 1;
-        frame_bytes = encode_frame(s);
-        if (frame_bytes < 0) {
-            av_log(avctx, AV_LOG_ERROR, "Bad frame count\n");
-            return frame_bytes;
-        }
-    }
+    frame_bytes = encode_block(s, frame->data[0], frame->nb_samples);
+    if (frame_bytes < 0)
+        return frame_bytes;
 
     if ((ret = ff_alloc_packet2(avctx, avpkt, frame_bytes, 0)) < 0)
         return ret;
@@ -1397,14 +1563,11 @@ static int flac_encode_frame(AVCodecContext *avctx, AVPacket *avpkt,
 
     s->frame_count++;
     s->sample_count += frame->nb_samples;
-    if ((ret = update_md5_sum(s, frame->data[0])) < 0) {
+    if ((ret = update_md5_sum(s, frame->data[0], frame->nb_samples)) < 0) {
         av_log(avctx, AV_LOG_ERROR, "Error updating MD5 checksum\n");
         return ret;
     }
-    if (out_bytes > s->max_encoded_framesize)
-        s->max_encoded_framesize = out_bytes;
-    if (out_bytes < s->min_framesize)
-        s->min_framesize = out_bytes;
+    update_frame_sizes(s, out_bytes);
 
     avpkt->pts      = frame->pts;
     avpkt->duration = ff_samples_to_time_base(avctx, frame->nb_samples);
@@ -1421,6 +1584,13 @@ static av_cold int flac_encode_close(AVCodecContext *avctx)
 {
     if (avctx->priv_data) {
         FlacEncodeContext *s = avctx->priv_data;
+        int i;
+        for (i = 0; i < s->nb_slots; i++) {
+            av_frame_free(&s->slots[i].in_frame);
+            av_packet_unref(&s->slots[i].out_pkt);
+            ff_lpc_end(&s->slots[i].lpc_ctx);
+        }
+        av_freep(&s->slots);
         av_freep(&s->md5ctx);
         av_freep(&s->md5_buffer);
         ff_lpc_end(&s->lpc_ctx);
@@ -1475,7 +1645,8 @@ AVCodec ff_flac_encoder = {
     .init           = flac_encode_init,
     .encode2        = flac_encode_frame,
     .close          = flac_encode_close,
-    .capabilities   = AV_CODEC_CAP_SMALL_LAST_FRAME | AV_CODEC_CAP_DELAY | AV_CODEC_CAP_LOSSLESS,
+    .capabilities   = AV_CODEC_CAP_SMALL_LAST_FRAME | AV_CODEC_CAP_DELAY | AV_CODEC_CAP_LOSSLESS |
+                      AV_CODEC_CAP_SLICE_THREADS,
     .sample_fmts    = (const enum AVSampleFormat[]){ AV_SAMPLE_FMT_S16,
                                                      AV_SAMPLE_FMT_S32,
                                                      AV_SAMPLE_FMT_NONE },
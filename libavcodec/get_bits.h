@@ -52,6 +52,21 @@
 #define UNCHECKED_BITSTREAM_READER !CONFIG_SAFE_BITSTREAM_READER
 #endif
 
+/*
+ * Cached bitstream reading:
+ * decoders which read long runs of codes inside a single
+ * OPEN_READER/CLOSE_READER block can "#define CACHED_BITSTREAM_READER"
+ * before including this header. The reader then keeps a 64 bit cache and
+ * a count of the valid bits in it, UPDATE_CACHE only reloads it when fewer
+ * than MIN_CACHE_BITS are left and LAST_SKIP_BITS also advances the cache.
+ * Code which changes name_index directly must not use it.
+ * It is ignored by little endian readers and without fast 64 bit
+ * arithmetic.
+ */
+#if defined(CACHED_BITSTREAM_READER) && (!HAVE_FAST_64BIT || defined(BITSTREAM_READER_LE))
+#undef CACHED_BITSTREAM_READER
+#endif
+
 typedef struct GetBitContext {
     const uint8_t *buffer, *buffer_end;
     int index;
@@ -73,6 +88,23 @@ typedef struct RL_VLC_ELEM {
     uint8_t run;
 } RL_VLC_ELEM;
 
+#define VLC_MULTI_MAX_SYMBOLS 6
+
+/**
+ * Entry of a table decoding several consecutive codes with a single
+ * lookup, see ff_init_vlc_multi().
+ */
+typedef struct VLC_MULTI_ELEM {
+    uint8_t val[VLC_MULTI_MAX_SYMBOLS];
+    int8_t len;     ///< number of bits used by all the num codes
+    uint8_t num;    ///< number of codes, 0 if the first one needs the VLC
+} VLC_MULTI_ELEM;
+
+typedef struct VLC_MULTI {
+    VLC_MULTI_ELEM *table;
+    int table_allocated;
+} VLC_MULTI;
+
 /* Bitstream reader API docs:
  * name
  *   arbitrary name which is used as prefix for the internal variables
@@ -120,15 +152,22 @@ typedef struct RL_VLC_ELEM {
  * For examples see get_bits, show_bits, skip_bits, get_vlc.
  */
 
-#ifdef LONG_BITSTREAM_READER
+#if defined(LONG_BITSTREAM_READER) || defined(CACHED_BITSTREAM_READER)
 #   define MIN_CACHE_BITS 32
 #else
 #   define MIN_CACHE_BITS 25
 #endif
 
+#ifdef CACHED_BITSTREAM_READER
+#define OPEN_READER_NOSIZE(name, gb)            \
+    unsigned int name ## _index = (gb)->index;  \
+    uint64_t av_unused name ## _cache = 0;      \
+    int av_unused name ## _avail = 0
+#else
 #define OPEN_READER_NOSIZE(name, gb)            \
     unsigned int name ## _index = (gb)->index;  \
     unsigned int av_unused name ## _cache
+#endif
 
 #if UNCHECKED_BITSTREAM_READER
 #define OPEN_READER(name, gb) OPEN_READER_NOSIZE(name, gb)
@@ -144,7 +183,21 @@ typedef struct RL_VLC_ELEM {
 
 #define CLOSE_READER(name, gb) (gb)->index = name ## _index
 
-# ifdef LONG_BITSTREAM_READER
+# ifdef CACHED_BITSTREAM_READER
+
+# define UPDATE_CACHE_LE(name, gb) name ## _cache = \
+      AV_RL32((gb)->buffer + (name ## _index >> 3)) >> (name ## _index & 7)
+
+# define UPDATE_CACHE_BE(name, gb)                                          \
+    do {                                                                    \
+        if (name ## _avail < MIN_CACHE_BITS) {                              \
+            name ## _cache = AV_RB64((gb)->buffer + (name ## _index >> 3))  \
+                             << (name ## _index & 7);                       \
+            name ## _avail = 64 - (name ## _index & 7);                     \
+        }                                                                   \
+    } while (0)
+
+# elif defined(LONG_BITSTREAM_READER)
 
 # define UPDATE_CACHE_LE(name, gb) name ## _cache = \
       AV_RL64((gb)->buffer + (name ## _index >> 3)) >> (name ## _index & 7)
@@ -173,7 +226,15 @@ typedef struct RL_VLC_ELEM {
 
 # define UPDATE_CACHE(name, gb) UPDATE_CACHE_BE(name, gb)
 
+# ifdef CACHED_BITSTREAM_READER
+# define SKIP_CACHE(name, gb, num)              \
+    do {                                        \
+        name ## _cache <<= (num);               \
+        name ## _avail  -= (num);               \
+    } while (0)
+# else
 # define SKIP_CACHE(name, gb, num) name ## _cache <<= (num)
+# endif
 
 #endif
 
@@ -192,13 +253,22 @@ typedef struct RL_VLC_ELEM {
         SKIP_COUNTER(name, gb, num);            \
     } while (0)
 
+#ifdef CACHED_BITSTREAM_READER
+#define LAST_SKIP_BITS(name, gb, num) SKIP_BITS(name, gb, num)
+#else
 #define LAST_SKIP_BITS(name, gb, num) SKIP_COUNTER(name, gb, num)
+#endif
 
 #define SHOW_UBITS_LE(name, gb, num) zero_extend(name ## _cache, num)
 #define SHOW_SBITS_LE(name, gb, num) sign_extend(name ## _cache, num)
 
+#ifdef CACHED_BITSTREAM_READER
+#define SHOW_UBITS_BE(name, gb, num) NEG_USR32(name ## _cache >> 32, num)
+#define SHOW_SBITS_BE(name, gb, num) NEG_SSR32(name ## _cache >> 32, num)
+#else
 #define SHOW_UBITS_BE(name, gb, num) NEG_USR32(name ## _cache, num)
 #define SHOW_SBITS_BE(name, gb, num) NEG_SSR32(name ## _cache, num)
+#endif
 
 #ifdef BITSTREAM_READER_LE
 #   define SHOW_UBITS(name, gb, num) SHOW_UBITS_LE(name, gb, num)
@@ -208,7 +278,11 @@ typedef struct RL_VLC_ELEM {
 #   define SHOW_SBITS(name, gb, num) SHOW_SBITS_BE(name, gb, num)
 #endif
 
+#ifdef CACHED_BITSTREAM_READER
+#define GET_CACHE(name, gb) ((uint32_t)(name ## _cache >> 32))
+#else
 #define GET_CACHE(name, gb) ((uint32_t) name ## _cache)
+#endif
 
 static inline int get_bits_count(const GetBitContext *s)
 {
@@ -475,6 +549,16 @@ int ff_init_vlc_sparse(VLC *vlc, int nb_bits, int nb_codes,
                        int flags);
 void ff_free_vlc(VLC *vlc);
 
+/**
+ * Build a table for get_vlc_multi() from the first level of vlc.
+ * Each entry holds the codes which fit completely in the vlc->bits bits
+ * of its index, up to VLC_MULTI_MAX_SYMBOLS of them. Symbols must fit in
+ * 8 bits, entries starting with a longer code or symbol fall back to vlc.
+ * The table is reallocated only if it is too small.
+ */
+int ff_init_vlc_multi(VLC_MULTI *multi, const VLC *vlc);
+void ff_free_vlc_multi(VLC_MULTI *multi);
+
 #define INIT_VLC_LE             2
 #define INIT_VLC_USE_NEW_STATIC 4
 
@@ -573,6 +657,39 @@ static av_always_inline int get_vlc2(GetBitContext *s, VLC_TYPE (*table)[2],
     return code;
 }
 
+/**
+ * Parse one or more vlc codes with a table built by ff_init_vlc_multi().
+ * @param dst where the symbols are written, 8 bytes are always written
+ * @param bits must be the bits of the VLC the table was built from
+ * @returns the number of symbols parsed or -1 if no vlc matches
+ */
+static av_always_inline int get_vlc_multi(GetBitContext *s, uint8_t *dst,
+                                          const VLC_MULTI_ELEM *const multi,
+                                          VLC_TYPE (*table)[2], int bits,
+                                          int max_depth)
+{
+    unsigned int index;
+    int code, ret;
+
+    OPEN_READER(re, s);
+    UPDATE_CACHE(re, s);
+
+    index = SHOW_UBITS(re, s, bits);
+    ret   = multi[index].num;
+    if (ret) {
+        AV_COPY64U(dst, multi[index].val);
+        LAST_SKIP_BITS(re, s, multi[index].len);
+    } else {
+        GET_VLC(code, re, s, table, bits, max_depth);
+        dst[0] = code;
+        ret    = code < 0 ? -1 : 1;
+    }
+
+    CLOSE_READER(re, s);
+
+    return ret;
+}
+
 static inline int decode012(GetBitContext *gb)
 {
     int n;
@@ -370,6 +370,9 @@ void ff_h264_free_tables(H264Context *h)
     av_freep(&h->mb2b_xy);
     av_freep(&h->mb2br_xy);
 
+    av_freep(&h->pipeline_mbs);
+    h->pipeline_mbs_size = 0;
+
     av_buffer_pool_uninit(&h->qscale_table_pool);
     av_buffer_pool_uninit(&h->mb_type_pool);
     av_buffer_pool_uninit(&h->motion_val_pool);
@@ -613,6 +616,11 @@ static int h264_init_context(AVCodecContext *avctx, H264Context *h)
     for (i = 0; i < MAX_DELAYED_PIC_COUNT; i++)
         h->last_pocs[i] = INT_MIN;
 
+#if HAVE_THREADS
+    pthread_mutex_init(&h->pipeline_mutex, NULL);
+    pthread_cond_init(&h->pipeline_cond, NULL);
+#endif
+
     ff_h264_reset_sei(h);
 
     avctx->chroma_sample_location = AVCHROMA_LOC_LEFT;
@@ -1984,6 +1992,11 @@ static av_cold int h264_decode_end(AVCodecContext *avctx)
     ff_h264_unref_picture(h, &h->last_pic_for_ec);
     av_frame_free(&h->last_pic_for_ec.f);
 
+#if HAVE_THREADS
+    pthread_mutex_destroy(&h->pipeline_mutex);
+    pthread_cond_destroy(&h->pipeline_cond);
+#endif
+
     return 0;
 }
 
@@ -1993,6 +2006,7 @@ static const AVOption h264_options[] = {
     {"is_avc", "is avc", offsetof(H264Context, is_avc), AV_OPT_TYPE_INT, {.i64 = 0}, 0, 1, 0},
     {"nal_length_size", "nal_length_size", offsetof(H264Context, nal_length_size), AV_OPT_TYPE_INT, {.i64 = 0}, 0, 4, 0},
     { "enable_er", "Enable error resilience on damaged frames (unsafe)", OFFSET(enable_er), AV_OPT_TYPE_INT, { .i64 = -1 }, -1, 1, VD },
+    { "cabac_pipeline", "Reconstruct macroblocks in a separate thread from CABAC decoding with slice threads", OFFSET(cabac_pipeline), AV_OPT_TYPE_INT, { .i64 = 0 }, 0, 1, VD },
     { NULL },
 };
 
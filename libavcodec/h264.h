@@ -29,6 +29,7 @@
 #define AVCODEC_H264_H
 
 #include "libavutil/intreadwrite.h"
+#include "libavutil/thread.h"
 #include "cabac.h"
 #include "error_resilience.h"
 #include "get_bits.h"
@@ -509,8 +510,41 @@ typedef struct H264SliceContext {
     // rbsp buffer used for this slice
     uint8_t *rbsp_buffer;
     unsigned int rbsp_buffer_size;
+
+    /**
+     * 1 if the macroblocks decoded with this context are reconstructed and
+     * deblocked by another thread, see H264Context.cabac_pipeline
+     */
+    int pipelined;
 } H264SliceContext;
 
+/**
+ * State of a CABAC decoded macroblock needed by ff_h264_hl_decode_mb(),
+ * passed from the entropy decoding to the reconstruction thread when the
+ * cabac_pipeline option is used.
+ */
+typedef struct H264PipelineMB {
+    int mb_x, mb_y;
+    int mb_xy;
+    int qscale;
+    int chroma_qp[2];
+    int cbp;
+    int chroma_pred_mode;
+    int intra16x16_pred_mode;
+    int top_type;
+    unsigned int topleft_samples_available;
+    unsigned int topright_samples_available;
+    const uint8_t *intra_pcm_ptr;
+
+    int8_t intra4x4_pred_mode_cache[5 * 8];
+    DECLARE_ALIGNED(8, uint8_t, non_zero_count_cache)[15 * 8];
+    DECLARE_ALIGNED(16, int16_t, mv_cache)[2][5 * 8][2];
+    DECLARE_ALIGNED(8,  int8_t, ref_cache)[2][5 * 8];
+    DECLARE_ALIGNED(8, uint16_t, sub_mb_type)[4];
+    DECLARE_ALIGNED(16, int16_t, mb)[16 * 48 * 2];
+    DECLARE_ALIGNED(16, int16_t, mb_luma_dc)[3][16 * 2];
+} H264PipelineMB;
+
 /**
  * H264Context
  */
@@ -840,6 +874,34 @@ typedef struct H264Context {
     /*Green Metadata */
     GreenMetaData sei_green_metadata;
 
+    /**
+     * Pipeline CABAC decoding and reconstruction of pictures decoded with
+     * a single slice context when slice threading is used.
+     */
+    int cabac_pipeline;
+    /**
+     * Ring of macroblocks decoded by the CABAC thread and not yet
+     * reconstructed, pipeline_count entries.
+     */
+    H264PipelineMB *pipeline_mbs;
+    unsigned int pipeline_mbs_size;
+    int pipeline_count;
+    int pipeline_decoded;           ///< number of macroblocks put in the ring
+    int pipeline_reconstructed;     ///< number of macroblocks taken from it
+    /**
+     * Number of macroblock rows whose last macroblock passed the end of
+     * slice and error checks of the CABAC thread.
+     */
+    int pipeline_rows;
+    /**
+     * Set once the CABAC thread is done: 1 if the slice ended normally and
+     * the last partial macroblock row is to be deblocked, -1 on error.
+     */
+    int pipeline_end;
+#if HAVE_THREADS
+    pthread_mutex_t pipeline_mutex;
+    pthread_cond_t  pipeline_cond;
+#endif
 } H264Context;
 
 extern const uint8_t ff_h264_chroma_qp[7][QP_MAX_NUM + 1]; ///< One chroma qp table for each possible bit depth (8-14).
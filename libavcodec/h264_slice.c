@@ -2347,6 +2347,169 @@ static void er_add_slice(H264SliceContext *sl,
     }
 }
 
+static int slice_is_complex(const H264Context *h)
+{
+    return FRAME_MBAFF(h) || h->picture_structure != PICT_FRAME ||
+           h->avctx->codec_id != AV_CODEC_ID_H264 ||
+           (CONFIG_GRAY && (h->flags & AV_CODEC_FLAG_GRAY));
+}
+
+/**
+ * Pass the macroblock just decoded by a pipelined slice context to the
+ * reconstruction thread, waiting for a free entry in the ring.
+ */
+static void pipeline_put_mb(H264Context *h, H264SliceContext *sl)
+{
+#if HAVE_THREADS
+    H264PipelineMB *mb;
+    int coeff_size = 16 * 48 * sizeof(int16_t) << h->pixel_shift;
+
+    pthread_mutex_lock(&h->pipeline_mutex);
+    while (h->pipeline_decoded - h->pipeline_reconstructed >= h->pipeline_count)
+        pthread_cond_wait(&h->pipeline_cond, &h->pipeline_mutex);
+    pthread_mutex_unlock(&h->pipeline_mutex);
+
+    mb = &h->pipeline_mbs[h->pipeline_decoded % h->pipeline_count];
+
+    mb->mb_x                       = sl->mb_x;
+    mb->mb_y                       = sl->mb_y;
+    mb->mb_xy                      = sl->mb_xy;
+    mb->qscale                     = sl->qscale;
+    mb->chroma_qp[0]               = sl->chroma_qp[0];
+    mb->chroma_qp[1]               = sl->chroma_qp[1];
+    mb->cbp                        = sl->cbp;
+    mb->chroma_pred_mode           = sl->chroma_pred_mode;
+    mb->intra16x16_pred_mode       = sl->intra16x16_pred_mode;
+    mb->top_type                   = sl->top_type;
+    mb->topleft_samples_available  = sl->topleft_samples_available;
+    mb->topright_samples_available = sl->topright_samples_available;
+    mb->intra_pcm_ptr              = sl->intra_pcm_ptr;
+
+    memcpy(mb->intra4x4_pred_mode_cache, sl->intra4x4_pred_mode_cache,
+           sizeof(mb->intra4x4_pred_mode_cache));
+    memcpy(mb->non_zero_count_cache, sl->non_zero_count_cache,
+           sizeof(mb->non_zero_count_cache));
+    memcpy(mb->mv_cache,    sl->mv_cache,    sizeof(mb->mv_cache));
+    memcpy(mb->ref_cache,   sl->ref_cache,   sizeof(mb->ref_cache));
+    memcpy(mb->sub_mb_type, sl->sub_mb_type, sizeof(mb->sub_mb_type));
+    memcpy(mb->mb_luma_dc,  sl->mb_luma_dc,  sizeof(mb->mb_luma_dc));
+
+    /* the residual decoding expects the coefficients to be cleared, which
+     * is normally done by the IDCTs */
+    memcpy(mb->mb, sl->mb, coeff_size);
+    memset(sl->mb, 0, coeff_size);
+
+    pthread_mutex_lock(&h->pipeline_mutex);
+    h->pipeline_decoded++;
+    pthread_cond_broadcast(&h->pipeline_cond);
+    pthread_mutex_unlock(&h->pipeline_mutex);
+#endif
+}
+
+/**
+ * Tell the reconstruction thread that the last macroblock of a row passed
+ * the checks after which the serial loop deblocks and reports the row.
+ */
+static void pipeline_finish_row(H264Context *h)
+{
+#if HAVE_THREADS
+    pthread_mutex_lock(&h->pipeline_mutex);
+    h->pipeline_rows++;
+    pthread_cond_broadcast(&h->pipeline_cond);
+    pthread_mutex_unlock(&h->pipeline_mutex);
+#endif
+}
+
+/**
+ * Reconstruct and deblock the macroblocks of a pipelined slice as they are
+ * decoded by the CABAC thread, until it reports the end of the slice.
+ */
+static int reconstruct_pipelined_slice(H264Context *h, H264SliceContext *sl)
+{
+#if HAVE_THREADS
+    int coeff_size = 16 * 48 * sizeof(int16_t) << h->pixel_shift;
+    int lf_x_start = sl->mb_x;
+    int rows       = 0;
+
+    for (;;) {
+        const H264PipelineMB *mb;
+        int end;
+
+        pthread_mutex_lock(&h->pipeline_mutex);
+        while (h->pipeline_reconstructed == h->pipeline_decoded && !h->pipeline_end)
+            pthread_cond_wait(&h->pipeline_cond, &h->pipeline_mutex);
+        end = h->pipeline_reconstructed == h->pipeline_decoded;
+        pthread_mutex_unlock(&h->pipeline_mutex);
+
+        if (end) {
+            if (h->pipeline_end > 0 && sl->mb_x > lf_x_start)
+                loop_filter(h, sl, lf_x_start, sl->mb_x);
+            return 0;
+        }
+
+        mb = &h->pipeline_mbs[h->pipeline_reconstructed % h->pipeline_count];
+
+        sl->mb_x                       = mb->mb_x;
+        sl->mb_y                       = mb->mb_y;
+        sl->mb_xy                      = mb->mb_xy;
+        sl->qscale                     = mb->qscale;
+        sl->chroma_qp[0]               = mb->chroma_qp[0];
+        sl->chroma_qp[1]               = mb->chroma_qp[1];
+        sl->cbp                        = mb->cbp;
+        sl->chroma_pred_mode           = mb->chroma_pred_mode;
+        sl->intra16x16_pred_mode       = mb->intra16x16_pred_mode;
+        sl->top_type                   = mb->top_type;
+        sl->topleft_samples_available  = mb->topleft_samples_available;
+        sl->topright_samples_available = mb->topright_samples_available;
+        sl->intra_pcm_ptr              = mb->intra_pcm_ptr;
+
+        memcpy(sl->intra4x4_pred_mode_cache, mb->intra4x4_pred_mode_cache,
+               sizeof(mb->intra4x4_pred_mode_cache));
+        memcpy(sl->non_zero_count_cache, mb->non_zero_count_cache,
+               sizeof(mb->non_zero_count_cache));
+        memcpy(sl->mv_cache,    mb->mv_cache,    sizeof(mb->mv_cache));
+        memcpy(sl->ref_cache,   mb->ref_cache,   sizeof(mb->ref_cache));
+        memcpy(sl->sub_mb_type, mb->sub_mb_type, sizeof(mb->sub_mb_type));
+        memcpy(sl->mb_luma_dc,  mb->mb_luma_dc,  sizeof(mb->mb_luma_dc));
+        memcpy(sl->mb,          mb->mb,          coeff_size);
+
+        ff_h264_hl_decode_mb(h, sl);
+
+        pthread_mutex_lock(&h->pipeline_mutex);
+        h->pipeline_reconstructed++;
+        pthread_cond_broadcast(&h->pipeline_cond);
+        pthread_mutex_unlock(&h->pipeline_mutex);
+
+        if (++sl->mb_x >= h->mb_width) {
+            int finished;
+
+            pthread_mutex_lock(&h->pipeline_mutex);
+            while (h->pipeline_rows == rows && !h->pipeline_end)
+                pthread_cond_wait(&h->pipeline_cond, &h->pipeline_mutex);
+            finished = h->pipeline_rows > rows;
+            end      = h->pipeline_end;
+            pthread_mutex_unlock(&h->pipeline_mutex);
+
+            /* The slice ended on this macroblock before the row was done:
+             * a truncated slice still deblocks the row, an erroneous one
+             * leaves it alone, and neither reports it, like decode_slice(). */
+            if (!finished) {
+                if (end > 0)
+                    loop_filter(h, sl, lf_x_start, sl->mb_x);
+                return 0;
+            }
+            rows++;
+
+            loop_filter(h, sl, lf_x_start, sl->mb_x);
+            sl->mb_x = lf_x_start = 0;
+            decode_finish_row(h, sl);
+        }
+    }
+#else
+    return 0;
+#endif
+}
+
 static int decode_slice(struct AVCodecContext *avctx, void *arg)
 {
     H264SliceContext *sl = arg;
@@ -2365,9 +2528,7 @@ static int decode_slice(struct AVCodecContext *avctx, void *arg)
 
     av_assert0(h->block_offset[15] == (4 * ((scan8[15] - scan8[0]) & 7) << h->pixel_shift) + 4 * sl->linesize * ((scan8[15] - scan8[0]) >> 3));
 
-    sl->is_complex = FRAME_MBAFF(h) || h->picture_structure != PICT_FRAME ||
-                     avctx->codec_id != AV_CODEC_ID_H264 ||
-                     (CONFIG_GRAY && (h->flags & AV_CODEC_FLAG_GRAY));
+    sl->is_complex = slice_is_complex(h);
 
     if (!(h->avctx->active_thread_type & FF_THREAD_SLICE) && h->picture_structure == PICT_FRAME && h->slice_ctx[0].er.error_status_table) {
         const int start_i  = av_clip(sl->resync_mb_x + sl->resync_mb_y * h->mb_width, 0, h->mb_num - 1);
@@ -2406,8 +2567,12 @@ static int decode_slice(struct AVCodecContext *avctx, void *arg)
             ret = ff_h264_decode_mb_cabac(h, sl);
             // STOP_TIMER("decode_mb_cabac")
 
-            if (ret >= 0)
-                ff_h264_hl_decode_mb(h, sl);
+            if (ret >= 0) {
+                if (sl->pipelined)
+                    pipeline_put_mb(sl->h264, sl);
+                else
+                    ff_h264_hl_decode_mb(h, sl);
+            }
 
             // FIXME optimal? or let mb_decode decode 16x32 ?
             if (ret >= 0 && FRAME_MBAFF(h)) {
@@ -2425,7 +2590,7 @@ static int decode_slice(struct AVCodecContext *avctx, void *arg)
                 sl->cabac.bytestream > sl->cabac.bytestream_end + 2) {
                 er_add_slice(sl, sl->resync_mb_x, sl->resync_mb_y, sl->mb_x - 1,
                              sl->mb_y, ER_MB_END);
-                if (sl->mb_x >= lf_x_start)
+                if (sl->mb_x >= lf_x_start && !sl->pipelined)
                     loop_filter(h, sl, lf_x_start, sl->mb_x + 1);
                 return 0;
             }
@@ -2441,10 +2606,15 @@ static int decode_slice(struct AVCodecContext *avctx, void *arg)
                 return AVERROR_INVALIDDATA;
             }
 
+            if (sl->pipelined && sl->mb_x + 1 >= h->mb_width)
+                pipeline_finish_row(sl->h264);
+
             if (++sl->mb_x >= h->mb_width) {
-                loop_filter(h, sl, lf_x_start, sl->mb_x);
+                if (!sl->pipelined)
+                    loop_filter(h, sl, lf_x_start, sl->mb_x);
                 sl->mb_x = lf_x_start = 0;
-                decode_finish_row(h, sl);
+                if (!sl->pipelined)
+                    decode_finish_row(h, sl);
                 ++sl->mb_y;
                 if (FIELD_OR_MBAFF_PICTURE(h)) {
                     ++sl->mb_y;
@@ -2458,7 +2628,7 @@ static int decode_slice(struct AVCodecContext *avctx, void *arg)
                         get_bits_count(&sl->gb), sl->gb.size_in_bits);
                 er_add_slice(sl, sl->resync_mb_x, sl->resync_mb_y, sl->mb_x - 1,
                              sl->mb_y, ER_MB_END);
-                if (sl->mb_x > lf_x_start)
+                if (sl->mb_x > lf_x_start && !sl->pipelined)
                     loop_filter(h, sl, lf_x_start, sl->mb_x);
                 return 0;
             }
@@ -2549,6 +2719,77 @@ static int decode_slice(struct AVCodecContext *avctx, void *arg)
     }
 }
 
+static int decode_slice_pipelined(AVCodecContext *avctx, void *arg,
+                                  int jobnr, int threadnr)
+{
+    H264Context *h = arg;
+    int ret;
+
+    if (jobnr)
+        return reconstruct_pipelined_slice(h, &h->slice_ctx[1]);
+
+    ret = decode_slice(avctx, &h->slice_ctx[0]);
+
+#if HAVE_THREADS
+    pthread_mutex_lock(&h->pipeline_mutex);
+    h->pipeline_end = ret < 0 ? -1 : 1;
+    pthread_cond_broadcast(&h->pipeline_cond);
+    pthread_mutex_unlock(&h->pipeline_mutex);
+#endif
+
+    return ret;
+}
+
+/**
+ * Prepare the reconstruction of the slice in the first slice context to
+ * be pipelined behind its CABAC decoding, using the second slice context.
+ *
+ * @return 1 if the slice is to be pipelined, 0 if not, <0 on error
+ */
+static int init_slice_pipeline(H264Context *h)
+{
+    H264SliceContext *sl  = &h->slice_ctx[0];
+    H264SliceContext *sl2 = &h->slice_ctx[1];
+    int ret;
+
+    /* both jobs must run concurrently */
+    if (!HAVE_THREADS || !h->cabac_pipeline || !h->pps.cabac ||
+        FRAME_MBAFF(h) || h->slice_context_count < 2 ||
+        !(h->avctx->active_thread_type & FF_THREAD_SLICE) ||
+        h->avctx->thread_count < 2)
+        return 0;
+
+    h->pipeline_count = 2 * h->mb_width;
+    av_fast_malloc(&h->pipeline_mbs, &h->pipeline_mbs_size,
+                   h->pipeline_count * sizeof(*h->pipeline_mbs));
+    if (!h->pipeline_mbs) {
+        h->pipeline_mbs_size = 0;
+        return AVERROR(ENOMEM);
+    }
+
+    sl2->linesize   = h->cur_pic_ptr->f->linesize[0];
+    sl2->uvlinesize = h->cur_pic_ptr->f->linesize[1];
+    ret = alloc_scratch_buffers(sl2, sl2->linesize);
+    if (ret < 0)
+        return ret;
+
+    copy_fields(sl2, sl, slice_num, prev_mb_skipped);
+    copy_fields(sl2, sl, ref_count, intra_pcm_ptr);
+    sl2->mb_x                   = sl->mb_x;
+    sl2->mb_y                   = sl->mb_y;
+    sl2->mb_field_decoding_flag = sl->mb_field_decoding_flag;
+    sl2->mb_mbaff               = sl->mb_mbaff;
+    sl2->is_complex             = slice_is_complex(h);
+
+    h->pipeline_decoded       = 0;
+    h->pipeline_reconstructed = 0;
+    h->pipeline_rows          = 0;
+    h->pipeline_end           = 0;
+    sl->pipelined             = 1;
+
+    return 1;
+}
+
 /**
  * Call decode_slice() for each context.
  *
@@ -2576,7 +2817,16 @@ int ff_h264_execute_decode_slices(H264Context *h, unsigned context_count)
 
         h->slice_ctx[0].next_slice_idx = h->mb_width * h->mb_height;
 
-        ret = decode_slice(avctx, &h->slice_ctx[0]);
+        ret = init_slice_pipeline(h);
+        if (ret > 0) {
+            int rets[2];
+
+            avctx->execute2(avctx, decode_slice_pipelined, h, rets, 2);
+            h->slice_ctx[0].pipelined = 0;
+            ret = FFMIN(rets[0], rets[1]);
+        } else if (!ret) {
+            ret = decode_slice(avctx, &h->slice_ctx[0]);
+        }
         h->mb_y = h->slice_ctx[0].mb_y;
         return ret;
     } else {
@@ -762,13 +762,12 @@ static int hls_slice_header(HEVCContext *s)
                 unsigned val = get_bits_long(gb, offset_len);
                 sh->entry_point_offset[i] = val + 1; // +1; // +1 to get the size
             }
-            if (s->threads_number > 1 && (s->ps.pps->num_tile_rows > 1 || s->ps.pps->num_tile_columns > 1)) {
-                s->enable_parallel_tiles = 0; // TODO: you can enable tiles in parallel here
+            /* Tiles combined with WPP are not decoded in parallel, the
+             * entry points then mix tile and CTB row starts. */
+            if (s->threads_number > 1 && s->ps.pps->entropy_coding_sync_enabled_flag &&
+                (s->ps.pps->num_tile_rows > 1 || s->ps.pps->num_tile_columns > 1))
                 s->threads_number = 1;
-            } else
-                s->enable_parallel_tiles = 0;
-        } else
-            s->enable_parallel_tiles = 0;
+        }
     }
 
     if (s->ps.pps->slice_header_extension_present_flag) {
@@ -2297,9 +2296,47 @@ static void hls_decode_neighbour(HEVCContext *s, int x_ctb, int y_ctb,
     lc->ctb_up_left_flag = ((x_ctb > 0) && (y_ctb > 0)  && (ctb_addr_in_slice-1 >= s->ps.sps->ctb_width) && (s->ps.pps->tile_id[ctb_addr_ts] == s->ps.pps->tile_id[s->ps.pps->ctb_addr_rs_to_ts[ctb_addr_rs-1 - s->ps.sps->ctb_width]]));
 }
 
-static int hls_decode_entry(AVCodecContext *avctxt, void *isFilterThread)
+static int hls_decode_ctb(HEVCContext *s, int x_ctb, int y_ctb, int ctb_addr_ts)
+{
+    int ctb_addr_rs = s->ps.pps->ctb_addr_ts_to_rs[ctb_addr_ts];
+    int more_data;
+
+    hls_decode_neighbour(s, x_ctb, y_ctb, ctb_addr_ts);
+
+    ff_hevc_cabac_init(s, ctb_addr_ts);
+
+    hls_sao_param(s, x_ctb >> s->ps.sps->log2_ctb_size, y_ctb >> s->ps.sps->log2_ctb_size);
+
+    s->deblock[ctb_addr_rs].beta_offset = s->sh.beta_offset;
+    s->deblock[ctb_addr_rs].tc_offset   = s->sh.tc_offset;
+    s->deblock[ctb_addr_rs].disable     = s->sh.disable_deblocking_filter_flag;
+    s->filter_slice_edges[ctb_addr_rs]  = s->sh.slice_loop_filter_across_slices_enabled_flag;
+
+    more_data = hls_coding_quadtree(s, x_ctb, y_ctb, s->ps.sps->log2_ctb_size, 0);
+    if (more_data < 0)
+        s->tab_slice_address[ctb_addr_rs] = -1;
+
+    return more_data;
+}
+
+/**
+ * Publish the address of the next CTB to be decoded by a slice group to the
+ * pipelined filter pass, INT_MAX once the group is done.
+ */
+static void report_group_progress(HEVCContext *s, int group, int ctb_addr_rs)
+{
+#if HAVE_THREADS
+    HEVCContext *s0 = s->avctx->priv_data;
+
+    pthread_mutex_lock(&s0->progress_mutex);
+    s0->group_progress[group] = ctb_addr_rs;
+    pthread_cond_broadcast(&s0->progress_cond);
+    pthread_mutex_unlock(&s0->progress_mutex);
+#endif
+}
+
+static int hls_decode_slice_segment(HEVCContext *s)
 {
-    HEVCContext *s  = avctxt->priv_data;
     int ctb_size    = 1 << s->ps.sps->log2_ctb_size;
     int more_data   = 1;
     int x_ctb       = 0;
@@ -2324,35 +2361,32 @@ static int hls_decode_entry(AVCodecContext *avctxt, void *isFilterThread)
 
         x_ctb = (ctb_addr_rs % ((s->ps.sps->width + ctb_size - 1) >> s->ps.sps->log2_ctb_size)) << s->ps.sps->log2_ctb_size;
         y_ctb = (ctb_addr_rs / ((s->ps.sps->width + ctb_size - 1) >> s->ps.sps->log2_ctb_size)) << s->ps.sps->log2_ctb_size;
-        hls_decode_neighbour(s, x_ctb, y_ctb, ctb_addr_ts);
-
-        ff_hevc_cabac_init(s, ctb_addr_ts);
-
-        hls_sao_param(s, x_ctb >> s->ps.sps->log2_ctb_size, y_ctb >> s->ps.sps->log2_ctb_size);
-
-        s->deblock[ctb_addr_rs].beta_offset = s->sh.beta_offset;
-        s->deblock[ctb_addr_rs].tc_offset   = s->sh.tc_offset;
-        s->filter_slice_edges[ctb_addr_rs]  = s->sh.slice_loop_filter_across_slices_enabled_flag;
 
-        more_data = hls_coding_quadtree(s, x_ctb, y_ctb, s->ps.sps->log2_ctb_size, 0);
-        if (more_data < 0) {
-            s->tab_slice_address[ctb_addr_rs] = -1;
+        more_data = hls_decode_ctb(s, x_ctb, y_ctb, ctb_addr_ts);
+        if (more_data < 0)
             return more_data;
-        }
-
 
         ctb_addr_ts++;
         ff_hevc_save_states(s, ctb_addr_ts);
-        ff_hevc_hls_filters(s, x_ctb, y_ctb, ctb_size);
+        if (!s->deferred_filter)
+            ff_hevc_hls_filters(s, x_ctb, y_ctb, ctb_size);
+        else if (s->pipelined_filter)
+            report_group_progress(s, s->slice_group, ctb_addr_ts);
     }
 
-    if (x_ctb + ctb_size >= s->ps.sps->width &&
+    if (!s->deferred_filter &&
+        x_ctb + ctb_size >= s->ps.sps->width &&
         y_ctb + ctb_size >= s->ps.sps->height)
         ff_hevc_hls_filter(s, x_ctb, y_ctb, ctb_size);
 
     return ctb_addr_ts;
 }
 
+static int hls_decode_entry(AVCodecContext *avctxt, void *isFilterThread)
+{
+    return hls_decode_slice_segment(avctxt->priv_data);
+}
+
 static int hls_slice_data(HEVCContext *s)
 {
     int arg[2];
@@ -2364,6 +2398,34 @@ static int hls_slice_data(HEVCContext *s)
     s->avctx->execute(s->avctx, hls_decode_entry, arg, ret , 1, sizeof(int));
     return ret[0];
 }
+
+static int init_slice_contexts(HEVCContext *s)
+{
+    int i;
+
+    for (i = 1; i < s->threads_number; i++) {
+        if (s->sList[i])
+            continue;
+        s->sList[i]      = av_malloc(sizeof(HEVCContext));
+        s->HEVClcList[i] = av_mallocz(sizeof(HEVCLocalContext));
+        if (!s->sList[i] || !s->HEVClcList[i])
+            return AVERROR(ENOMEM);
+        memcpy(s->sList[i], s, sizeof(HEVCContext));
+        s->sList[i]->HEVClc = s->HEVClcList[i];
+    }
+
+    return 0;
+}
+
+static void sync_local_context(HEVCLocalContext *dst, const HEVCLocalContext *src)
+{
+    memcpy(dst->cabac_state, src->cabac_state, sizeof(dst->cabac_state));
+    memcpy(dst->stat_coeff,  src->stat_coeff,  sizeof(dst->stat_coeff));
+    dst->qPy_pred       = src->qPy_pred;
+    dst->qp_y           = src->qp_y;
+    dst->end_of_tiles_x = src->end_of_tiles_x;
+}
+
 static int hls_decode_entry_wpp(AVCodecContext *avctxt, void *input_ctb_row, int job, int self_id)
 {
     HEVCContext *s1  = avctxt->priv_data, *s;
@@ -2403,6 +2465,12 @@ static int hls_decode_entry_wpp(AVCodecContext *avctxt, void *input_ctb_row, int
 
         ff_hevc_cabac_init(s, ctb_addr_ts);
         hls_sao_param(s, x_ctb >> s->ps.sps->log2_ctb_size, y_ctb >> s->ps.sps->log2_ctb_size);
+
+        s->deblock[ctb_addr_rs].beta_offset = s->sh.beta_offset;
+        s->deblock[ctb_addr_rs].tc_offset   = s->sh.tc_offset;
+        s->deblock[ctb_addr_rs].disable     = s->sh.disable_deblocking_filter_flag;
+        s->filter_slice_edges[ctb_addr_rs]  = s->sh.slice_loop_filter_across_slices_enabled_flag;
+
         more_data = hls_coding_quadtree(s, x_ctb, y_ctb, s->ps.sps->log2_ctb_size, 0);
 
         if (more_data < 0) {
@@ -2414,7 +2482,8 @@ static int hls_decode_entry_wpp(AVCodecContext *avctxt, void *input_ctb_row, int
 
         ff_hevc_save_states(s, ctb_addr_ts);
         ff_thread_report_progress2(s->avctx, ctb_row, thread, 1);
-        ff_hevc_hls_filters(s, x_ctb, y_ctb, ctb_size);
+        if (!s->deferred_filter)
+            ff_hevc_hls_filters(s, x_ctb, y_ctb, ctb_size);
 
         if (!more_data && (x_ctb+ctb_size) < s->ps.sps->width && ctb_row != s->sh.num_entry_point_offsets) {
             avpriv_atomic_int_set(&s1->wpp_err,  1);
@@ -2423,7 +2492,8 @@ static int hls_decode_entry_wpp(AVCodecContext *avctxt, void *input_ctb_row, int
         }
 
         if ((x_ctb+ctb_size) >= s->ps.sps->width && (y_ctb+ctb_size) >= s->ps.sps->height ) {
-            ff_hevc_hls_filter(s, x_ctb, y_ctb, ctb_size);
+            if (!s->deferred_filter)
+                ff_hevc_hls_filter(s, x_ctb, y_ctb, ctb_size);
             ff_thread_report_progress2(s->avctx, ctb_row , thread, SHIFT_CTB_WPP);
             return ctb_addr_ts;
         }
@@ -2439,6 +2509,61 @@ static int hls_decode_entry_wpp(AVCodecContext *avctxt, void *input_ctb_row, int
     return 0;
 }
 
+/**
+ * Decode one tile of a slice whose tiles are decoded in parallel, job n
+ * decoding the tile starting at entry point n. The loop filters are left
+ * to the deferred filter pass.
+ */
+static int hls_decode_entry_tile(AVCodecContext *avctxt, void *input_arg, int job, int self_id)
+{
+    HEVCContext *s1     = avctxt->priv_data, *s;
+    const HEVCPPS *pps  = s1->ps.pps;
+    HEVCLocalContext *lc;
+    int *arg            = input_arg;
+    int log2_ctb_size   = s1->ps.sps->log2_ctb_size;
+    int more_data       = 1;
+    int ctb_addr_ts     = pps->ctb_addr_rs_to_ts[s1->sh.slice_ctb_addr_rs];
+    int tile, ret;
+
+    s  = s1->sList[self_id];
+    lc = s->HEVClc;
+
+    if (job) {
+        tile        = pps->tile_id[ctb_addr_ts] + job;
+        ctb_addr_ts = pps->ctb_addr_rs_to_ts[pps->tile_pos_rs[tile]];
+
+        ret = init_get_bits8(&lc->gb, s->data + s->sh.offset[job - 1], s->sh.size[job - 1]);
+        if (ret < 0)
+            return ret;
+    }
+    tile = pps->tile_id[ctb_addr_ts];
+
+    while (more_data && ctb_addr_ts < s->ps.sps->ctb_size &&
+           pps->tile_id[ctb_addr_ts] == tile) {
+        int ctb_addr_rs = pps->ctb_addr_ts_to_rs[ctb_addr_ts];
+        int x_ctb       = (ctb_addr_rs % s->ps.sps->ctb_width) << log2_ctb_size;
+        int y_ctb       = (ctb_addr_rs / s->ps.sps->ctb_width) << log2_ctb_size;
+
+        more_data = hls_decode_ctb(s, x_ctb, y_ctb, ctb_addr_ts);
+        if (more_data < 0)
+            return more_data;
+
+        ctb_addr_ts++;
+    }
+
+    if (job < s->sh.num_entry_point_offsets) {
+        if (!more_data) {
+            av_log(s->avctx, AV_LOG_ERROR, "Slice ended before its last tile.\n");
+            return AVERROR_INVALIDDATA;
+        }
+        return 0;
+    }
+
+    /* let the caller pick up the entropy state at the end of the slice */
+    arg[job] = self_id;
+    return ctb_addr_ts;
+}
+
 static int hls_slice_data_wpp(HEVCContext *s, const HEVCNAL *nal)
 {
     const uint8_t *data = nal->data;
@@ -2456,7 +2581,8 @@ static int hls_slice_data_wpp(HEVCContext *s, const HEVCNAL *nal)
         return AVERROR(ENOMEM);
     }
 
-    if (s->sh.slice_ctb_addr_rs + s->sh.num_entry_point_offsets * s->ps.sps->ctb_width >= s->ps.sps->ctb_width * s->ps.sps->ctb_height) {
+    if (s->ps.pps->entropy_coding_sync_enabled_flag &&
+        s->sh.slice_ctb_addr_rs + s->sh.num_entry_point_offsets * s->ps.sps->ctb_width >= s->ps.sps->ctb_width * s->ps.sps->ctb_height) {
         av_log(s->avctx, AV_LOG_ERROR, "WPP ctb addresses are wrong (%d %d %d %d)\n",
             s->sh.slice_ctb_addr_rs, s->sh.num_entry_point_offsets,
             s->ps.sps->ctb_width, s->ps.sps->ctb_height
@@ -2465,16 +2591,20 @@ static int hls_slice_data_wpp(HEVCContext *s, const HEVCNAL *nal)
         goto error;
     }
 
+    if (!s->ps.pps->entropy_coding_sync_enabled_flag &&
+        s->ps.pps->tile_id[s->ps.pps->ctb_addr_rs_to_ts[s->sh.slice_ctb_addr_rs]] + s->sh.num_entry_point_offsets >=
+        s->ps.pps->num_tile_columns * s->ps.pps->num_tile_rows) {
+        av_log(s->avctx, AV_LOG_ERROR, "Tile entry points are wrong (%d %d)\n",
+               s->sh.slice_ctb_addr_rs, s->sh.num_entry_point_offsets);
+        res = AVERROR_INVALIDDATA;
+        goto error;
+    }
+
     ff_alloc_entries(s->avctx, s->sh.num_entry_point_offsets + 1);
 
-    if (!s->sList[1]) {
-        for (i = 1; i < s->threads_number; i++) {
-            s->sList[i] = av_malloc(sizeof(HEVCContext));
-            memcpy(s->sList[i], s, sizeof(HEVCContext));
-            s->HEVClcList[i] = av_mallocz(sizeof(HEVCLocalContext));
-            s->sList[i]->HEVClc = s->HEVClcList[i];
-        }
-    }
+    res = init_slice_contexts(s);
+    if (res < 0)
+        goto error;
 
     offset = (lc->gb.index >> 3);
 
@@ -2510,6 +2640,7 @@ static int hls_slice_data_wpp(HEVCContext *s, const HEVCNAL *nal)
 
     }
     s->data = data;
+    s->enable_parallel_tiles = !s->ps.pps->entropy_coding_sync_enabled_flag;
 
     for (i = 1; i < s->threads_number; i++) {
         s->sList[i]->HEVClc->first_qp_group = 1;
@@ -2528,15 +2659,356 @@ static int hls_slice_data_wpp(HEVCContext *s, const HEVCNAL *nal)
 
     if (s->ps.pps->entropy_coding_sync_enabled_flag)
         s->avctx->execute2(s->avctx, (void *) hls_decode_entry_wpp, arg, ret, s->sh.num_entry_point_offsets + 1);
+    else
+        s->avctx->execute2(s->avctx, hls_decode_entry_tile, arg, ret, s->sh.num_entry_point_offsets + 1);
 
-    for (i = 0; i <= s->sh.num_entry_point_offsets; i++)
+    s->enable_parallel_tiles = 0;
+
+    for (i = 0; i <= s->sh.num_entry_point_offsets; i++) {
+        if (ret[i] < 0) {
+            res = ret[i];
+            break;
+        }
         res += ret[i];
+    }
+
+    if (res >= 0 && !s->ps.pps->entropy_coding_sync_enabled_flag) {
+        HEVCLocalContext *last = s->HEVClcList[arg[s->sh.num_entry_point_offsets]];
+        if (last != lc)
+            sync_local_context(lc, last);
+    }
 error:
     av_free(ret);
     av_free(arg);
     return res;
 }
 
+/**
+ * Queue the current slice segment, to be decoded in parallel with the other
+ * independent slices of the picture. Dependent slice segments are decoded
+ * in the same job as the segments preceding them.
+ */
+static int queue_slice_segment(HEVCContext *s)
+{
+    HEVCLocalContext *lc = s->HEVClc;
+    HEVCSliceSegment *seg;
+
+    if (s->nb_queued_slices >= s->slice_queue_size) {
+        int size = 2 * s->slice_queue_size + 4;
+        int *groups;
+
+        seg = av_realloc_array(s->slice_queue, size, sizeof(*seg));
+        if (!seg)
+            return AVERROR(ENOMEM);
+        memset(seg + s->slice_queue_size, 0,
+               (size - s->slice_queue_size) * sizeof(*seg));
+        s->slice_queue      = seg;
+        s->slice_queue_size = size;
+
+        groups = av_realloc_array(s->slice_groups, size + 1, sizeof(*groups));
+        if (!groups)
+            return AVERROR(ENOMEM);
+        s->slice_groups = groups;
+
+        groups = av_realloc_array(s->group_progress, size, sizeof(*groups));
+        if (!groups)
+            return AVERROR(ENOMEM);
+        s->group_progress = groups;
+    }
+
+    seg = &s->slice_queue[s->nb_queued_slices];
+    if (!seg->ctx) {
+        seg->ctx = av_malloc(sizeof(*seg->ctx));
+        if (!seg->ctx)
+            return AVERROR(ENOMEM);
+    }
+    memcpy(seg->ctx, s, sizeof(*seg->ctx));
+    seg->ctx->sh.entry_point_offset = NULL;
+    seg->ctx->sh.offset             = NULL;
+    seg->ctx->sh.size               = NULL;
+    seg->ref = *s->ref;
+    seg->gb  = lc->gb;
+    seg->lc  = NULL;
+
+    if (!s->sh.dependent_slice_segment_flag || !s->nb_queued_slices) {
+        if (s->sh.dependent_slice_segment_flag) {
+            memcpy(seg->cabac_state, lc->cabac_state, sizeof(seg->cabac_state));
+            memcpy(seg->stat_coeff,  lc->stat_coeff,  sizeof(seg->stat_coeff));
+            seg->qPy_pred = lc->qPy_pred;
+            seg->qp_y     = lc->qp_y;
+        }
+        s->slice_groups[s->nb_slice_groups++] = s->nb_queued_slices;
+    }
+    s->nb_queued_slices++;
+
+    return 0;
+}
+
+/**
+ * Wait until all the CTBs up to ctb_addr_rs in raster order are decoded,
+ * i.e. until the point where the serial decoder would filter it.
+ */
+static void await_group_progress(HEVCContext *s, int ctb_addr_rs)
+{
+#if HAVE_THREADS
+    HEVCContext *s0 = s->avctx->priv_data;
+    int i;
+
+    pthread_mutex_lock(&s0->progress_mutex);
+    for (i = 0; i < s0->nb_slice_groups; i++) {
+        HEVCContext *s1 = s0->slice_queue[s0->slice_groups[i]].ctx;
+
+        if (s1->sh.slice_segment_addr > ctb_addr_rs)
+            continue;
+        while (s0->group_progress[i] <= ctb_addr_rs)
+            pthread_cond_wait(&s0->progress_cond, &s0->progress_mutex);
+    }
+    pthread_mutex_unlock(&s0->progress_mutex);
+#endif
+}
+
+static int hls_decode_slice_group(AVCodecContext *avctxt, void *arg, int job, int self_id)
+{
+    HEVCContext *s       = avctxt->priv_data;
+    HEVCLocalContext *lc = s->HEVClcList[self_id];
+    int *groups          = arg;
+    int i, ret = 0;
+
+    for (i = groups[job]; i < groups[job + 1]; i++) {
+        HEVCSliceSegment *seg = &s->slice_queue[i];
+        HEVCContext *s1       = seg->ctx;
+
+        s1->HEVClc           = lc;
+        s1->ref              = &seg->ref;
+        s1->pipelined_filter = s->pipelined_filter;
+        s1->slice_group      = job;
+        seg->lc              = lc;
+
+        if (i == groups[job]) {
+            if (s1->sh.dependent_slice_segment_flag) {
+                memcpy(lc->cabac_state, seg->cabac_state, sizeof(lc->cabac_state));
+                memcpy(lc->stat_coeff,  seg->stat_coeff,  sizeof(lc->stat_coeff));
+                lc->qPy_pred = seg->qPy_pred;
+                lc->qp_y     = seg->qp_y;
+            }
+            if (s1->ps.pps->tiles_enabled_flag) {
+                int idxX = s1->ps.pps->col_idxX[s1->sh.slice_ctb_addr_rs % s1->ps.sps->ctb_width];
+                lc->end_of_tiles_x = s1->ps.pps->col_bd[idxX + 1] << s1->ps.sps->log2_ctb_size;
+            }
+        }
+
+        lc->gb             = seg->gb;
+        lc->first_qp_group = !s1->sh.dependent_slice_segment_flag;
+        if (!s1->ps.pps->cu_qp_delta_enabled_flag)
+            lc->qp_y = s1->sh.slice_qp;
+        lc->tu.cu_qp_offset_cb = 0;
+        lc->tu.cu_qp_offset_cr = 0;
+
+        ret = hls_decode_slice_segment(s1);
+        if (ret < 0)
+            break;
+    }
+
+    if (s->pipelined_filter)
+        report_group_progress(s, job, INT_MAX);
+
+    return ret;
+}
+
+/**
+ * Run the deblocking filter and SAO on one CTB row of the picture, staying
+ * two CTBs behind the row above so that every CTB is filtered after all the
+ * CTBs it depends on, as in the serial raster order.
+ */
+static int hls_filter_ctb_row(AVCodecContext *avctxt, void *arg, int ctb_row, int self_id)
+{
+    HEVCContext *s    = ((HEVCContext *)avctxt->priv_data)->sList[self_id];
+    int log2_ctb_size = s->ps.sps->log2_ctb_size;
+    int ctb_size      = 1 << log2_ctb_size;
+    int ctb_width     = s->ps.sps->ctb_width;
+    int sync          = s->threads_number > 1;
+    int thread        = ctb_row % avctxt->thread_count;
+    int y_ctb         = ctb_row << log2_ctb_size;
+    int x;
+
+    for (x = 0; x < ctb_width; x++) {
+        int x_ctb = x << log2_ctb_size;
+
+        if (sync)
+            ff_thread_await_progress2(avctxt, ctb_row, thread, SHIFT_CTB_WPP);
+        if (s->pipelined_filter)
+            await_group_progress(s, ctb_row * ctb_width + x);
+        if (s->tab_slice_address[ctb_row * ctb_width + x] >= 0) {
+            ff_hevc_deblocking_boundary_strengths_ctb(s, x_ctb, y_ctb);
+            ff_hevc_hls_filters(s, x_ctb, y_ctb, ctb_size);
+        }
+        if (sync)
+            ff_thread_report_progress2(avctxt, ctb_row, thread, 1);
+    }
+
+    if (ctb_row == s->ps.sps->ctb_height - 1 &&
+        s->tab_slice_address[ctb_row * ctb_width + ctb_width - 1] >= 0)
+        ff_hevc_hls_filter(s, (ctb_width - 1) << log2_ctb_size, y_ctb, ctb_size);
+
+    if (sync)
+        ff_thread_report_progress2(avctxt, ctb_row, thread, SHIFT_CTB_WPP);
+
+    return 0;
+}
+
+static int init_filter_threads(HEVCContext *s)
+{
+    int i, ret;
+
+    ret = ff_alloc_entries(s->avctx, s->ps.sps->ctb_height);
+    if (ret < 0)
+        return ret;
+    ff_reset_entries(s->avctx);
+
+    for (i = 1; i < s->avctx->thread_count; i++) {
+        memcpy(s->sList[i], s, sizeof(HEVCContext));
+        s->sList[i]->HEVClc = s->HEVClcList[i];
+    }
+
+    return 0;
+}
+
+static int hls_filter_frame(HEVCContext *s)
+{
+    int i, ret;
+
+    if (s->threads_number == 1) {
+        for (i = 0; i < s->ps.sps->ctb_height; i++)
+            hls_filter_ctb_row(s->avctx, NULL, i, 0);
+        return 0;
+    }
+
+    ret = init_filter_threads(s);
+    if (ret < 0)
+        return ret;
+
+    s->avctx->execute2(s->avctx, hls_filter_ctb_row, NULL, NULL, s->ps.sps->ctb_height);
+
+    return 0;
+}
+
+/**
+ * Job of the pipelined picture end: the first jobs decode the queued slice
+ * groups, the following ones filter one CTB row each behind them.
+ */
+static int hls_decode_filter_job(AVCodecContext *avctxt, void *arg, int job, int self_id)
+{
+    HEVCContext *s = avctxt->priv_data;
+
+    if (job < s->nb_slice_groups)
+        return hls_decode_slice_group(avctxt, arg, job, self_id);
+    return hls_filter_ctb_row(avctxt, NULL, job - s->nb_slice_groups, self_id);
+}
+
+/**
+ * Decode all queued slice segments, one job per independent slice.
+ * If filter is set, the loop filter pass of the picture runs in the same
+ * execute, each CTB row job lagging behind the decoding of the slices.
+ */
+static int decode_slice_queue(HEVCContext *s, int filter)
+{
+    HEVCLocalContext *lc;
+    int *ret = NULL;
+    int i, res = 0;
+    int nb_jobs = s->nb_slice_groups;
+
+    if (!s->nb_queued_slices)
+        return 0;
+
+    if (filter) {
+        for (i = 0; i < s->nb_slice_groups; i++)
+            s->group_progress[i] = s->slice_queue[s->slice_groups[i]].ctx->sh.slice_segment_addr;
+        s->pipelined_filter = 1;
+        res = init_filter_threads(s);
+        if (res < 0)
+            goto end;
+        nb_jobs += s->ps.sps->ctb_height;
+    }
+
+    ret = av_malloc_array(nb_jobs, sizeof(*ret));
+    if (!ret) {
+        res = AVERROR(ENOMEM);
+        goto end;
+    }
+
+    s->slice_groups[s->nb_slice_groups] = s->nb_queued_slices;
+    s->avctx->execute2(s->avctx, filter ? hls_decode_filter_job : hls_decode_slice_group,
+                       s->slice_groups, ret, nb_jobs);
+
+    for (i = 0; i < s->nb_slice_groups; i++) {
+        if (ret[i] < 0)
+            res = ret[i];
+        else if (ret[i] >= s->ps.sps->ctb_width * s->ps.sps->ctb_height)
+            s->is_decoded = 1;
+    }
+
+    lc = s->slice_queue[s->nb_queued_slices - 1].lc;
+    if (lc && lc != s->HEVClc)
+        sync_local_context(s->HEVClc, lc);
+
+end:
+    av_free(ret);
+    s->nb_queued_slices = 0;
+    s->nb_slice_groups  = 0;
+    s->pipelined_filter = 0;
+    return res;
+}
+
+/**
+ * Finish decoding the current picture: decode the queued slice segments
+ * and run the deferred loop filter pass.
+ *
+ * With the filter_thread option the filter pass is pipelined behind the
+ * decoding of the queued slices. This needs the tile scan to match the
+ * raster scan, so tiled pictures are still filtered after decoding.
+ */
+static int hevc_frame_end(HEVCContext *s)
+{
+    int pipeline = s->deferred_filter && s->ref && s->filter_thread &&
+                   s->nb_queued_slices && !s->ps.pps->tiles_enabled_flag;
+    int ret = decode_slice_queue(s, pipeline);
+
+    if (s->deferred_filter) {
+        int ret2 = s->ref && !pipeline ? hls_filter_frame(s) : 0;
+        if (ret >= 0)
+            ret = ret2;
+        s->deferred_filter = 0;
+    }
+
+    return ret;
+}
+
+/**
+ * Decode the queued slice segments before a NAL unit which cannot be
+ * queued behind them, i.e. anything other than a slice segment of the same
+ * picture using the same PPS.
+ */
+static int flush_slice_queue(HEVCContext *s, const HEVCNAL *nal)
+{
+    GetBitContext gb = nal->gb;
+
+    if (!s->nb_queued_slices && !s->deferred_filter)
+        return 0;
+
+    if (nal->type > NAL_CRA_NUT ||
+        (nal->type > NAL_RASL_R && nal->type < NAL_BLA_W_LP))
+        return decode_slice_queue(s, 0);
+
+    if (get_bits1(&gb)) // first_slice_segment_in_pic_flag
+        return hevc_frame_end(s);
+    if (IS_IRAP(s))
+        skip_bits1(&gb); // no_output_of_prior_pics_flag
+    if (get_ue_golomb_long(&gb) != s->sh.pps_id)
+        return decode_slice_queue(s, 0);
+
+    return 0;
+}
+
 static int set_side_data(HEVCContext *s)
 {
     AVFrame *out = s->ref->frame;
@@ -2602,6 +3074,18 @@ static int hevc_frame_start(HEVCContext *s)
     s->is_decoded        = 0;
     s->first_nal_type    = s->nal_unit_type;
 
+    /* With several threads or with tiles the CTBs are not decoded in raster
+     * order, so the picture is filtered in a separate pass once it is
+     * decoded. Tiled pictures always take this path, so that the filters
+     * run in the same order with any number of threads. */
+    s->deferred_filter   = (s->threads_number > 1 || s->ps.pps->tiles_enabled_flag) &&
+                           !s->avctx->hwaccel;
+    if (s->deferred_filter) {
+        ret = init_slice_contexts(s);
+        if (ret < 0)
+            goto fail;
+    }
+
     if (s->ps.pps->tiles_enabled_flag)
         lc->end_of_tiles_x = s->ps.pps->column_width[0] << s->ps.sps->log2_ctb_size;
 
@@ -2653,6 +3137,10 @@ static int decode_nal_unit(HEVCContext *s, const HEVCNAL *nal)
     s->nal_unit_type = nal->type;
     s->temporal_id   = nal->temporal_id;
 
+    ret = flush_slice_queue(s, nal);
+    if (ret < 0)
+        goto fail;
+
     switch (s->nal_unit_type) {
     case NAL_VPS:
         ret = ff_hevc_decode_nal_vps(gb, s->avctx, &s->ps);
@@ -2751,6 +3239,17 @@ static int decode_nal_unit(HEVCContext *s, const HEVCNAL *nal)
             if (ret < 0)
                 goto fail;
         } else {
+            if (s->deferred_filter && !s->ps.pps->entropy_coding_sync_enabled_flag &&
+                (s->sh.dependent_slice_segment_flag || !s->sh.num_entry_point_offsets)) {
+                ret = queue_slice_segment(s);
+                if (ret < 0)
+                    goto fail;
+                break;
+            }
+            ret = decode_slice_queue(s, 0);
+            if (ret < 0)
+                goto fail;
+
             if (s->threads_number > 1 && s->sh.num_entry_point_offsets > 0)
                 ctb_addr_ts = hls_slice_data_wpp(s, nal);
             else
@@ -2787,7 +3286,7 @@ fail:
 
 static int decode_nal_units(HEVCContext *s, const uint8_t *buf, int length)
 {
-    int i, ret = 0;
+    int i, ret = 0, ret2;
 
     s->ref = NULL;
     s->last_eos = s->eos;
@@ -2820,6 +3319,10 @@ static int decode_nal_units(HEVCContext *s, const uint8_t *buf, int length)
     }
 
 fail:
+    ret2 = hevc_frame_end(s);
+    if (ret >= 0 && ret2 < 0 && s->avctx->err_recognition & AV_EF_EXPLODE)
+        ret = ret2;
+
     if (s->ref && s->threads_type == FF_THREAD_FRAME)
         ff_thread_report_progress(&s->ref->tf, INT_MAX, 0);
 
@@ -3029,13 +3532,20 @@ static av_cold int hevc_decode_free(AVCodecContext *avctx)
     av_freep(&s->sh.offset);
     av_freep(&s->sh.size);
 
-    for (i = 1; i < s->threads_number; i++) {
-        HEVCLocalContext *lc = s->HEVClcList[i];
-        if (lc) {
-            av_freep(&s->HEVClcList[i]);
-            av_freep(&s->sList[i]);
-        }
+    for (i = 1; i < MAX_NB_THREADS; i++) {
+        av_freep(&s->HEVClcList[i]);
+        av_freep(&s->sList[i]);
     }
+
+    for (i = 0; i < s->slice_queue_size; i++)
+        av_freep(&s->slice_queue[i].ctx);
+    av_freep(&s->slice_queue);
+    av_freep(&s->slice_groups);
+    av_freep(&s->group_progress);
+#if HAVE_THREADS
+    pthread_mutex_destroy(&s->progress_mutex);
+    pthread_cond_destroy(&s->progress_cond);
+#endif
     if (s->HEVClc == s->HEVClcList[0])
         s->HEVClc = NULL;
     av_freep(&s->HEVClcList[0]);
@@ -3057,6 +3567,11 @@ static av_cold int hevc_init_context(AVCodecContext *avctx)
 
     s->avctx = avctx;
 
+#if HAVE_THREADS
+    pthread_mutex_init(&s->progress_mutex, NULL);
+    pthread_cond_init(&s->progress_cond, NULL);
+#endif
+
     s->HEVClc = av_mallocz(sizeof(HEVCLocalContext));
     if (!s->HEVClc)
         goto fail;
@@ -3322,6 +3837,8 @@ static const AVOption options[] = {
         AV_OPT_TYPE_INT, {.i64 = 0}, 0, 1, PAR },
     { "strict-displaywin", "stricly apply default display window size", OFFSET(apply_defdispwin),
         AV_OPT_TYPE_INT, {.i64 = 0}, 0, 1, PAR },
+    { "filter_thread", "Run the loop filters concurrently with slice decoding", OFFSET(filter_thread),
+        AV_OPT_TYPE_INT, {.i64 = 0}, 0, 1, PAR },
     { NULL },
 };
 
@@ -25,6 +25,7 @@
 
 #include "libavutil/buffer.h"
 #include "libavutil/md5.h"
+#include "libavutil/thread.h"
 
 #include "avcodec.h"
 #include "bswapdsp.h"
@@ -709,6 +710,7 @@ typedef struct TransformUnit {
 typedef struct DBParams {
     int beta_offset;
     int tc_offset;
+    int disable;    ///< slice_deblocking_filter_disabled_flag
 } DBParams;
 
 #define HEVC_FRAME_FLAG_OUTPUT    (1 << 0)
@@ -817,6 +819,23 @@ typedef struct HEVCLocalContext {
     int boundary_flags;
 } HEVCLocalContext;
 
+/**
+ * A slice segment waiting to be decoded in parallel with the other
+ * independent slices of the picture.
+ */
+typedef struct HEVCSliceSegment {
+    struct HEVCContext *ctx;    ///< decoder state after parsing the segment header
+    HEVCLocalContext   *lc;     ///< local context the segment was decoded with
+    HEVCFrame           ref;    ///< current picture with the reference lists of the segment
+    GetBitContext       gb;     ///< slice segment data
+
+    /* state a dependent segment continues from if it starts a new group */
+    uint8_t cabac_state[HEVC_CONTEXTS];
+    uint8_t stat_coeff[4];
+    int     qPy_pred;
+    int8_t  qp_y;
+} HEVCSliceSegment;
+
 typedef struct HEVCContext {
     const AVClass *c;  // needed by private avoptions
     AVCodecContext *avctx;
@@ -905,6 +924,31 @@ typedef struct HEVCContext {
     int enable_parallel_tiles;
     int wpp_err;
 
+    /**
+     * 1 if the loop filters of the current picture are run in a separate
+     * pass once all of its slices are decoded
+     */
+    uint8_t deferred_filter;
+
+    HEVCSliceSegment *slice_queue;
+    int nb_queued_slices;
+    int slice_queue_size;
+    /** index of the first queued segment of each independent slice */
+    int *slice_groups;
+    int nb_slice_groups;
+
+    /**
+     * 1 while the queued slices are decoded concurrently with the filter
+     * pass, which then waits for the decoding progress of each slice group
+     */
+    uint8_t pipelined_filter;
+    int slice_group;        ///< queued slice group decoded by this context
+    int *group_progress;    ///< address of the next CTB to be decoded in each group
+#if HAVE_THREADS
+    pthread_mutex_t progress_mutex;
+    pthread_cond_t  progress_cond;
+#endif
+
     const uint8_t *data;
 
     HEVCPacket pkt;
@@ -920,6 +964,7 @@ typedef struct HEVCContext {
     uint8_t is_nalff;       ///< this flag is != 0 if bitstream is encapsulated
                             ///< as a format defined in 14496-15
     int apply_defdispwin;
+    int filter_thread;
 
     int active_seq_parameter_set_id;
 
@@ -1054,6 +1099,7 @@ void ff_hevc_set_qPy(HEVCContext *s, int xBase, int yBase,
                      int log2_cb_size);
 void ff_hevc_deblocking_boundary_strengths(HEVCContext *s, int x0, int y0,
                                            int log2_trafo_size);
+void ff_hevc_deblocking_boundary_strengths_ctb(HEVCContext *s, int x0, int y0);
 int ff_hevc_cu_qp_delta_sign_flag(HEVCContext *s);
 int ff_hevc_cu_qp_delta_abs(HEVCContext *s);
 int ff_hevc_cu_chroma_qp_offset_flag(HEVCContext *s);
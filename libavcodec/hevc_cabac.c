@@ -520,7 +520,7 @@ void ff_hevc_cabac_init(HEVCContext *s, int ctb_addr_ts)
     } else {
         if (s->ps.pps->tiles_enabled_flag &&
             s->ps.pps->tile_id[ctb_addr_ts] != s->ps.pps->tile_id[ctb_addr_ts - 1]) {
-            if (s->threads_number == 1)
+            if (!s->enable_parallel_tiles)
                 cabac_reinit(s->HEVClc);
             else
                 cabac_init_decoder(s);
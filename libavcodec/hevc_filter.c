@@ -649,12 +649,13 @@ static void deblocking_filter_CTB(HEVCContext *s, int x0, int y0)
 }
 
 static int boundary_strength(HEVCContext *s, MvField *curr, MvField *neigh,
+                             RefPicList *curr_refPicList,
                              RefPicList *neigh_refPicList)
 {
     if (curr->pred_flag == PF_BI &&  neigh->pred_flag == PF_BI) {
         // same L0 and L1
-        if (s->ref->refPicList[0].list[curr->ref_idx[0]] == neigh_refPicList[0].list[neigh->ref_idx[0]]  &&
-            s->ref->refPicList[0].list[curr->ref_idx[0]] == s->ref->refPicList[1].list[curr->ref_idx[1]] &&
+        if (curr_refPicList[0].list[curr->ref_idx[0]] == neigh_refPicList[0].list[neigh->ref_idx[0]]  &&
+            curr_refPicList[0].list[curr->ref_idx[0]] == curr_refPicList[1].list[curr->ref_idx[1]] &&
             neigh_refPicList[0].list[neigh->ref_idx[0]] == neigh_refPicList[1].list[neigh->ref_idx[1]]) {
             if ((FFABS(neigh->mv[0].x - curr->mv[0].x) >= 4 || FFABS(neigh->mv[0].y - curr->mv[0].y) >= 4 ||
                  FFABS(neigh->mv[1].x - curr->mv[1].x) >= 4 || FFABS(neigh->mv[1].y - curr->mv[1].y) >= 4) &&
@@ -663,15 +664,15 @@ static int boundary_strength(HEVCContext *s, MvField *curr, MvField *neigh,
                 return 1;
             else
                 return 0;
-        } else if (neigh_refPicList[0].list[neigh->ref_idx[0]] == s->ref->refPicList[0].list[curr->ref_idx[0]] &&
-                   neigh_refPicList[1].list[neigh->ref_idx[1]] == s->ref->refPicList[1].list[curr->ref_idx[1]]) {
+        } else if (neigh_refPicList[0].list[neigh->ref_idx[0]] == curr_refPicList[0].list[curr->ref_idx[0]] &&
+                   neigh_refPicList[1].list[neigh->ref_idx[1]] == curr_refPicList[1].list[curr->ref_idx[1]]) {
             if (FFABS(neigh->mv[0].x - curr->mv[0].x) >= 4 || FFABS(neigh->mv[0].y - curr->mv[0].y) >= 4 ||
                 FFABS(neigh->mv[1].x - curr->mv[1].x) >= 4 || FFABS(neigh->mv[1].y - curr->mv[1].y) >= 4)
                 return 1;
             else
                 return 0;
-        } else if (neigh_refPicList[1].list[neigh->ref_idx[1]] == s->ref->refPicList[0].list[curr->ref_idx[0]] &&
-                   neigh_refPicList[0].list[neigh->ref_idx[0]] == s->ref->refPicList[1].list[curr->ref_idx[1]]) {
+        } else if (neigh_refPicList[1].list[neigh->ref_idx[1]] == curr_refPicList[0].list[curr->ref_idx[0]] &&
+                   neigh_refPicList[0].list[neigh->ref_idx[0]] == curr_refPicList[1].list[curr->ref_idx[1]]) {
             if (FFABS(neigh->mv[1].x - curr->mv[0].x) >= 4 || FFABS(neigh->mv[1].y - curr->mv[0].y) >= 4 ||
                 FFABS(neigh->mv[0].x - curr->mv[1].x) >= 4 || FFABS(neigh->mv[0].y - curr->mv[1].y) >= 4)
                 return 1;
@@ -686,10 +687,10 @@ static int boundary_strength(HEVCContext *s, MvField *curr, MvField *neigh,
 
         if (curr->pred_flag & 1) {
             A     = curr->mv[0];
-            ref_A = s->ref->refPicList[0].list[curr->ref_idx[0]];
+            ref_A = curr_refPicList[0].list[curr->ref_idx[0]];
         } else {
             A     = curr->mv[1];
-            ref_A = s->ref->refPicList[1].list[curr->ref_idx[1]];
+            ref_A = curr_refPicList[1].list[curr->ref_idx[1]];
         }
 
         if (neigh->pred_flag & 1) {
@@ -758,7 +759,7 @@ void ff_hevc_deblocking_boundary_strengths(HEVCContext *s, int x0, int y0,
                 else if (curr_cbf_luma || top_cbf_luma)
                     bs = 1;
                 else
-                    bs = boundary_strength(s, curr, top, rpl_top);
+                    bs = boundary_strength(s, curr, top, s->ref->refPicList, rpl_top);
                 s->horizontal_bs[((x0 + i) + y0 * s->bs_width) >> 2] = bs;
             }
     }
@@ -796,7 +797,7 @@ void ff_hevc_deblocking_boundary_strengths(HEVCContext *s, int x0, int y0,
                 else if (curr_cbf_luma || left_cbf_luma)
                     bs = 1;
                 else
-                    bs = boundary_strength(s, curr, left, rpl_left);
+                    bs = boundary_strength(s, curr, left, s->ref->refPicList, rpl_left);
                 s->vertical_bs[(x0 + (y0 + i) * s->bs_width) >> 2] = bs;
             }
     }
@@ -814,7 +815,7 @@ void ff_hevc_deblocking_boundary_strengths(HEVCContext *s, int x0, int y0,
                 MvField *top  = &tab_mvf[yp_pu * min_pu_width + x_pu];
                 MvField *curr = &tab_mvf[yq_pu * min_pu_width + x_pu];
 
-                bs = boundary_strength(s, curr, top, rpl);
+                bs = boundary_strength(s, curr, top, rpl, rpl);
                 s->horizontal_bs[((x0 + i) + (y0 + j) * s->bs_width) >> 2] = bs;
             }
         }
@@ -829,13 +830,108 @@ void ff_hevc_deblocking_boundary_strengths(HEVCContext *s, int x0, int y0,
                 MvField *left = &tab_mvf[y_pu * min_pu_width + xp_pu];
                 MvField *curr = &tab_mvf[y_pu * min_pu_width + xq_pu];
 
-                bs = boundary_strength(s, curr, left, rpl);
+                bs = boundary_strength(s, curr, left, rpl, rpl);
                 s->vertical_bs[((x0 + i) + (y0 + j) * s->bs_width) >> 2] = bs;
             }
         }
     }
 }
 
+/**
+ * Recompute the bs of the upper and left edges of a CTB which border a
+ * different slice or tile. When slices or tiles are decoded in parallel the
+ * neighbouring CTB is not necessarily decoded yet when the edge is first
+ * evaluated, so this is done again before the deferred filter pass.
+ */
+void ff_hevc_deblocking_boundary_strengths_ctb(HEVCContext *s, int x0, int y0)
+{
+    MvField *tab_mvf     = s->ref->tab_mvf;
+    int log2_ctb_size    = s->ps.sps->log2_ctb_size;
+    int log2_min_pu_size = s->ps.sps->log2_min_pu_size;
+    int log2_min_tu_size = s->ps.sps->log2_min_tb_size;
+    int min_pu_width     = s->ps.sps->min_pu_width;
+    int min_tu_width     = s->ps.sps->min_tb_width;
+    int ctb_size         = 1 << log2_ctb_size;
+    int ctb_addr_rs      = (y0 >> log2_ctb_size) * s->ps.sps->ctb_width +
+                           (x0 >> log2_ctb_size);
+    int ctb_addr_ts      = s->ps.pps->ctb_addr_rs_to_ts[ctb_addr_rs];
+    RefPicList *rpl;
+    int i, bs;
+
+    if (s->deblock[ctb_addr_rs].disable)
+        return;
+
+    rpl = ff_hevc_get_ref_list(s, s->ref, x0, y0);
+
+    if (y0 > 0) {
+        int up_rs      = ctb_addr_rs - s->ps.sps->ctb_width;
+        int slice_edge = s->tab_slice_address[ctb_addr_rs] != s->tab_slice_address[up_rs];
+        int tile_edge  = s->ps.pps->tiles_enabled_flag &&
+                         s->ps.pps->tile_id[ctb_addr_ts] != s->ps.pps->tile_id[s->ps.pps->ctb_addr_rs_to_ts[up_rs]];
+
+        if ((slice_edge || tile_edge) &&
+            !(slice_edge && !s->filter_slice_edges[ctb_addr_rs]) &&
+            !(tile_edge  && !s->ps.pps->loop_filter_across_tiles_enabled_flag)) {
+            RefPicList *rpl_top = slice_edge ? ff_hevc_get_ref_list(s, s->ref, x0, y0 - 1) : rpl;
+            int yp_pu = (y0 - 1) >> log2_min_pu_size;
+            int yq_pu =  y0      >> log2_min_pu_size;
+            int yp_tu = (y0 - 1) >> log2_min_tu_size;
+            int yq_tu =  y0      >> log2_min_tu_size;
+
+            for (i = 0; i < ctb_size && x0 + i < s->ps.sps->width; i += 4) {
+                int x_pu = (x0 + i) >> log2_min_pu_size;
+                int x_tu = (x0 + i) >> log2_min_tu_size;
+                MvField *top  = &tab_mvf[yp_pu * min_pu_width + x_pu];
+                MvField *curr = &tab_mvf[yq_pu * min_pu_width + x_pu];
+                uint8_t top_cbf_luma  = s->cbf_luma[yp_tu * min_tu_width + x_tu];
+                uint8_t curr_cbf_luma = s->cbf_luma[yq_tu * min_tu_width + x_tu];
+
+                if (curr->pred_flag == PF_INTRA || top->pred_flag == PF_INTRA)
+                    bs = 2;
+                else if (curr_cbf_luma || top_cbf_luma)
+                    bs = 1;
+                else
+                    bs = boundary_strength(s, curr, top, rpl, rpl_top);
+                s->horizontal_bs[((x0 + i) + y0 * s->bs_width) >> 2] = bs;
+            }
+        }
+    }
+
+    if (x0 > 0) {
+        int left_rs    = ctb_addr_rs - 1;
+        int slice_edge = s->tab_slice_address[ctb_addr_rs] != s->tab_slice_address[left_rs];
+        int tile_edge  = s->ps.pps->tiles_enabled_flag &&
+                         s->ps.pps->tile_id[ctb_addr_ts] != s->ps.pps->tile_id[s->ps.pps->ctb_addr_rs_to_ts[left_rs]];
+
+        if ((slice_edge || tile_edge) &&
+            !(slice_edge && !s->filter_slice_edges[ctb_addr_rs]) &&
+            !(tile_edge  && !s->ps.pps->loop_filter_across_tiles_enabled_flag)) {
+            RefPicList *rpl_left = slice_edge ? ff_hevc_get_ref_list(s, s->ref, x0 - 1, y0) : rpl;
+            int xp_pu = (x0 - 1) >> log2_min_pu_size;
+            int xq_pu =  x0      >> log2_min_pu_size;
+            int xp_tu = (x0 - 1) >> log2_min_tu_size;
+            int xq_tu =  x0      >> log2_min_tu_size;
+
+            for (i = 0; i < ctb_size && y0 + i < s->ps.sps->height; i += 4) {
+                int y_pu      = (y0 + i) >> log2_min_pu_size;
+                int y_tu      = (y0 + i) >> log2_min_tu_size;
+                MvField *left = &tab_mvf[y_pu * min_pu_width + xp_pu];
+                MvField *curr = &tab_mvf[y_pu * min_pu_width + xq_pu];
+                uint8_t left_cbf_luma = s->cbf_luma[y_tu * min_tu_width + xp_tu];
+                uint8_t curr_cbf_luma = s->cbf_luma[y_tu * min_tu_width + xq_tu];
+
+                if (curr->pred_flag == PF_INTRA || left->pred_flag == PF_INTRA)
+                    bs = 2;
+                else if (curr_cbf_luma || left_cbf_luma)
+                    bs = 1;
+                else
+                    bs = boundary_strength(s, curr, left, rpl, rpl_left);
+                s->vertical_bs[(x0 + (y0 + i) * s->bs_width) >> 2] = bs;
+            }
+        }
+    }
+}
+
 #undef LUMA
 #undef CB
 #undef CR
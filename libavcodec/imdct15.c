@@ -86,6 +86,9 @@ av_cold void ff_imdct15_uninit(IMDCT15Context **ps)
 
 static void imdct15_half(IMDCT15Context *s, float *dst, const float *src,
                          ptrdiff_t stride, float scale);
+static void fft_butterflies_c(FFTComplex *out, const FFTComplex *exptab, int len2);
+static void postrotate_c(FFTComplex *z, const FFTComplex *exptab, float scale,
+                         int len8);
 
 av_cold int ff_imdct15_init(IMDCT15Context **ps, int N)
 {
@@ -134,10 +137,14 @@ av_cold int ff_imdct15_init(IMDCT15Context **ps, int N)
     for (j = 15; j < 19; j++)
         s->exptab[0][j] = s->exptab[0][j - 15];
 
-    s->imdct_half = imdct15_half;
+    s->imdct_half      = imdct15_half;
+    s->fft_butterflies = fft_butterflies_c;
+    s->postrotate      = postrotate_c;
 
     if (ARCH_AARCH64)
         ff_imdct15_init_aarch64(s);
+    if (ARCH_X86)
+        ff_imdct15_init_x86(s);
 
     *ps = s;
 
@@ -214,6 +221,23 @@ static void fft15(IMDCT15Context *s, FFTComplex *out, const FFTComplex *in,
     }
 }
 
+static void fft_butterflies_c(FFTComplex *out, const FFTComplex *exptab, int len2)
+{
+    int k;
+
+    for (k = 0; k < len2; k++) {
+        FFTComplex t;
+
+        CMUL(t, out[len2 + k], exptab[k]);
+
+        out[len2 + k].re = out[k].re - t.re;
+        out[len2 + k].im = out[k].im - t.im;
+
+        out[k].re += t.re;
+        out[k].im += t.im;
+    }
+}
+
 /*
  * FFT of the length 15 * (2^N)
  */
@@ -221,26 +245,31 @@ static void fft_calc(IMDCT15Context *s, FFTComplex *out, const FFTComplex *in,
                      int N, ptrdiff_t stride)
 {
     if (N) {
-        const FFTComplex *exptab = s->exptab[N];
         const int len2 = 15 * (1 << (N - 1));
-        int k;
 
         fft_calc(s, out,        in,          N - 1, stride * 2);
         fft_calc(s, out + len2, in + stride, N - 1, stride * 2);
 
-        for (k = 0; k < len2; k++) {
-            FFTComplex t;
+        s->fft_butterflies(out, s->exptab[N], len2);
+    } else
+        fft15(s, out, in, stride);
+}
 
-            CMUL(t, out[len2 + k], exptab[k]);
+static void postrotate_c(FFTComplex *z, const FFTComplex *exptab, float scale,
+                         int len8)
+{
+    int i;
 
-            out[len2 + k].re = out[k].re - t.re;
-            out[len2 + k].im = out[k].im - t.im;
+    for (i = 0; i < len8; i++) {
+        float r0, i0, r1, i1;
 
-            out[k].re += t.re;
-            out[k].im += t.im;
-        }
-    } else
-        fft15(s, out, in, stride);
+        CMUL3(r0, i1, z[len8 - i - 1].im, z[len8 - i - 1].re,  exptab[len8 - i - 1].im, exptab[len8 - i - 1].re);
+        CMUL3(r1, i0, z[len8 + i].im,     z[len8 + i].re,      exptab[len8 + i].im,     exptab[len8 + i].re);
+        z[len8 - i - 1].re = scale * r0;
+        z[len8 - i - 1].im = scale * i0;
+        z[len8 + i].re     = scale * r1;
+        z[len8 + i].im     = scale * i1;
+    }
 }
 
 static void imdct15_half(IMDCT15Context *s, float *dst, const float *src,
@@ -261,14 +290,5 @@ static void imdct15_half(IMDCT15Context *s, float *dst, const float *src,
 
     fft_calc(s, z, s->tmp, s->fft_n, 1);
 
-    for (i = 0; i < len8; i++) {
-        float r0, i0, r1, i1;
-
-        CMUL3(r0, i1, z[len8 - i - 1].im, z[len8 - i - 1].re,  s->twiddle_exptab[len8 - i - 1].im, s->twiddle_exptab[len8 - i - 1].re);
-        CMUL3(r1, i0, z[len8 + i].im,     z[len8 + i].re,      s->twiddle_exptab[len8 + i].im,     s->twiddle_exptab[len8 + i].re);
-        z[len8 - i - 1].re = scale * r0;
-        z[len8 - i - 1].im = scale * i0;
-        z[len8 + i].re     = scale * r1;
-        z[len8 + i].im     = scale * i1;
-    }
+    s->postrotate(z, s->twiddle_exptab, scale, len8);
 }
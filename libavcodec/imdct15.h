@@ -39,6 +39,18 @@ typedef struct IMDCT15Context {
      */
     void (*imdct_half)(struct IMDCT15Context *s, float *dst, const float *src,
                        ptrdiff_t src_stride, float scale);
+
+    /**
+     * Radix-2 step of the FFT, in place:
+     * out[k] += t, out[len2 + k] = out[k] - t with t = out[len2 + k] * exptab[k]
+     */
+    void (*fft_butterflies)(FFTComplex *out, const FFTComplex *exptab, int len2);
+
+    /**
+     * Post-rotation and scaling of z[0...2 * len8 - 1], in place
+     */
+    void (*postrotate)(FFTComplex *z, const FFTComplex *exptab, float scale,
+                       int len8);
 } IMDCT15Context;
 
 /**
@@ -53,5 +65,6 @@ void ff_imdct15_uninit(IMDCT15Context **s);
 
 
 void ff_imdct15_init_aarch64(IMDCT15Context *s);
+void ff_imdct15_init_x86(IMDCT15Context *s);
 
 #endif /* AVCODEC_IMDCT15_H */
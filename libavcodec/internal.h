@@ -46,6 +46,13 @@
  * all.
  */
 #define FF_CODEC_CAP_INIT_CLEANUP           (1 << 1)
+/**
+ * The codec supports frame threading, but it is only used when the caller
+ * explicitly sets thread_type to FF_THREAD_FRAME, not with the default
+ * thread_type. For codecs where frame threads add latency and memory
+ * without being a clear gain for a single stream.
+ */
+#define FF_CODEC_CAP_FRAME_THREADS_OPT_IN   (1 << 2)
 
 
 #ifdef TRACE
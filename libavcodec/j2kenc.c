@@ -100,6 +100,15 @@ typedef struct {
    Jpeg2000Component *comp;
 } Jpeg2000Tile;
 
+typedef struct {
+    Jpeg2000Tile *tile;
+    Jpeg2000Component *comp;
+    Jpeg2000Band *band;
+    Jpeg2000Cblk *cblk;
+    int x0, x1, y0, y1; ///< code-block area in comp->i_data
+    int bandpos, lev;
+} Jpeg2000CblkJob;
+
 typedef struct {
     AVClass *class;
     AVCodecContext *avctx;
@@ -125,6 +134,10 @@ typedef struct {
 
     Jpeg2000Tile *tile;
 
+    Jpeg2000CblkJob *cblk_jobs; ///< code-blocks of all tiles, coded in parallel
+    unsigned int cblk_jobs_size;
+    int nb_cblk_jobs;
+
     int format;
 } Jpeg2000EncoderContext;
 
@@ -876,78 +889,160 @@ static void truncpasses(Jpeg2000EncoderContext *s, Jpeg2000Tile *tile)
     }
 }
 
-static int encode_tile(Jpeg2000EncoderContext *s, Jpeg2000Tile *tile, int tileno)
+static int dwt_tile(AVCodecContext *avctx, void *td, int jobnr, int threadnr)
 {
-    int compno, reslevelno, bandno, ret;
-    Jpeg2000T1Context t1;
-    Jpeg2000CodingStyle *codsty = &s->codsty;
-    for (compno = 0; compno < s->ncomponents; compno++){
-        Jpeg2000Component *comp = s->tile[tileno].comp + compno;
-
-        t1.stride = (1<<codsty->log2_cblk_width) + 2;
+    Jpeg2000EncoderContext *s = avctx->priv_data;
+    int compno, ret;
 
-        av_log(s->avctx, AV_LOG_DEBUG,"dwt\n");
+    for (compno = 0; compno < s->ncomponents; compno++){
+        Jpeg2000Component *comp = s->tile[jobnr].comp + compno;
         if ((ret = ff_dwt_encode(&comp->dwt, comp->i_data)) < 0)
             return ret;
-        av_log(s->avctx, AV_LOG_DEBUG,"after dwt -> tier1\n");
+    }
+    return 0;
+}
 
-        for (reslevelno = 0; reslevelno < codsty->nreslevels; reslevelno++){
-            Jpeg2000ResLevel *reslevel = comp->reslevel + reslevelno;
+/* Gather the code-blocks of all tiles, tier-1 coding of each of them is
+ * independent of the others. */
+static int collect_cblks(Jpeg2000EncoderContext *s)
+{
+    int tileno, compno, reslevelno, bandno;
+    Jpeg2000CodingStyle *codsty = &s->codsty;
 
-            for (bandno = 0; bandno < reslevel->nbands ; bandno++){
-                Jpeg2000Band *band = reslevel->band + bandno;
-                Jpeg2000Prec *prec = band->prec; // we support only 1 precinct per band ATM in the encoder
-                int cblkx, cblky, cblkno=0, xx0, x0, xx1, y0, yy0, yy1, bandpos;
-                yy0 = bandno == 0 ? 0 : comp->reslevel[reslevelno-1].coord[1][1] - comp->reslevel[reslevelno-1].coord[1][0];
-                y0 = yy0;
-                yy1 = FFMIN(ff_jpeg2000_ceildivpow2(band->coord[1][0] + 1, band->log2_cblk_height) << band->log2_cblk_height,
-                            band->coord[1][1]) - band->coord[1][0] + yy0;
+    s->nb_cblk_jobs = 0;
+    for (tileno = 0; tileno < s->numXtiles * s->numYtiles; tileno++){
+        Jpeg2000Tile *tile = s->tile + tileno;
+        for (compno = 0; compno < s->ncomponents; compno++){
+            Jpeg2000Component *comp = tile->comp + compno;
 
-                if (band->coord[0][0] == band->coord[0][1] || band->coord[1][0] == band->coord[1][1])
-                    continue;
+            for (reslevelno = 0; reslevelno < codsty->nreslevels; reslevelno++){
+                Jpeg2000ResLevel *reslevel = comp->reslevel + reslevelno;
 
-                bandpos = bandno + (reslevelno > 0);
-
-                for (cblky = 0; cblky < prec->nb_codeblocks_height; cblky++){
-                    if (reslevelno == 0 || bandno == 1)
-                        xx0 = 0;
-                    else
-                        xx0 = comp->reslevel[reslevelno-1].coord[0][1] - comp->reslevel[reslevelno-1].coord[0][0];
-                    x0 = xx0;
-                    xx1 = FFMIN(ff_jpeg2000_ceildivpow2(band->coord[0][0] + 1, band->log2_cblk_width) << band->log2_cblk_width,
-                                band->coord[0][1]) - band->coord[0][0] + xx0;
-
-                    for (cblkx = 0; cblkx < prec->nb_codeblocks_width; cblkx++, cblkno++){
-                        int y, x;
-                        if (codsty->transform == FF_DWT53){
-                            for (y = yy0; y < yy1; y++){
-                                int *ptr = t1.data + (y-yy0)*t1.stride;
-                                for (x = xx0; x < xx1; x++){
-                                    *ptr++ = comp->i_data[(comp->coord[0][1] - comp->coord[0][0]) * y + x] << NMSEDEC_FRACBITS;
-                                }
-                            }
-                        } else{
-                            for (y = yy0; y < yy1; y++){
-                                int *ptr = t1.data + (y-yy0)*t1.stride;
-                                for (x = xx0; x < xx1; x++){
-                                    *ptr = (comp->i_data[(comp->coord[0][1] - comp->coord[0][0]) * y + x]);
-                                    *ptr = (int64_t)*ptr * (int64_t)(16384 * 65536 / band->i_stepsize) >> 15 - NMSEDEC_FRACBITS;
-                                    ptr++;
-                                }
-                            }
+                for (bandno = 0; bandno < reslevel->nbands ; bandno++){
+                    Jpeg2000Band *band = reslevel->band + bandno;
+                    Jpeg2000Prec *prec = band->prec; // we support only 1 precinct per band ATM in the encoder
+                    int cblkx, cblky, cblkno=0, xx0, x0, xx1, y0, yy0, yy1, bandpos;
+                    Jpeg2000CblkJob *jobs;
+                    yy0 = bandno == 0 ? 0 : comp->reslevel[reslevelno-1].coord[1][1] - comp->reslevel[reslevelno-1].coord[1][0];
+                    y0 = yy0;
+                    yy1 = FFMIN(ff_jpeg2000_ceildivpow2(band->coord[1][0] + 1, band->log2_cblk_height) << band->log2_cblk_height,
+                                band->coord[1][1]) - band->coord[1][0] + yy0;
+
+                    if (band->coord[0][0] == band->coord[0][1] || band->coord[1][0] == band->coord[1][1])
+                        continue;
+
+                    bandpos = bandno + (reslevelno > 0);
+
+                    jobs = av_fast_realloc(s->cblk_jobs, &s->cblk_jobs_size,
+                                           (s->nb_cblk_jobs + prec->nb_codeblocks_width * prec->nb_codeblocks_height) * sizeof(*jobs));
+                    if (!jobs)
+                        return AVERROR(ENOMEM);
+                    s->cblk_jobs = jobs;
+
+                    for (cblky = 0; cblky < prec->nb_codeblocks_height; cblky++){
+                        if (reslevelno == 0 || bandno == 1)
+                            xx0 = 0;
+                        else
+                            xx0 = comp->reslevel[reslevelno-1].coord[0][1] - comp->reslevel[reslevelno-1].coord[0][0];
+                        x0 = xx0;
+                        xx1 = FFMIN(ff_jpeg2000_ceildivpow2(band->coord[0][0] + 1, band->log2_cblk_width) << band->log2_cblk_width,
+                                    band->coord[0][1]) - band->coord[0][0] + xx0;
+
+                        for (cblkx = 0; cblkx < prec->nb_codeblocks_width; cblkx++, cblkno++){
+                            Jpeg2000CblkJob *job = s->cblk_jobs + s->nb_cblk_jobs++;
+
+                            job->tile    = tile;
+                            job->comp    = comp;
+                            job->band    = band;
+                            job->cblk    = prec->cblk + cblkno;
+                            job->x0      = xx0;
+                            job->x1      = xx1;
+                            job->y0      = yy0;
+                            job->y1      = yy1;
+                            job->bandpos = bandpos;
+                            job->lev     = codsty->nreslevels - reslevelno - 1;
+
+                            xx0 = xx1;
+                            xx1 = FFMIN(xx1 + (1 << band->log2_cblk_width), band->coord[0][1] - band->coord[0][0] + x0);
                         }
-                        encode_cblk(s, &t1, prec->cblk + cblkno, tile, xx1 - xx0, yy1 - yy0,
-                                    bandpos, codsty->nreslevels - reslevelno - 1);
-                        xx0 = xx1;
-                        xx1 = FFMIN(xx1 + (1 << band->log2_cblk_width), band->coord[0][1] - band->coord[0][0] + x0);
+                        yy0 = yy1;
+                        yy1 = FFMIN(yy1 + (1 << band->log2_cblk_height), band->coord[1][1] - band->coord[1][0] + y0);
                     }
-                    yy0 = yy1;
-                    yy1 = FFMIN(yy1 + (1 << band->log2_cblk_height), band->coord[1][1] - band->coord[1][0] + y0);
                 }
             }
         }
-        av_log(s->avctx, AV_LOG_DEBUG, "after tier1\n");
     }
+    return 0;
+}
+
+static int encode_cblk_job(AVCodecContext *avctx, void *td, int jobnr, int threadnr)
+{
+    Jpeg2000EncoderContext *s = avctx->priv_data;
+    Jpeg2000CblkJob *job = s->cblk_jobs + jobnr;
+    Jpeg2000Component *comp = job->comp;
+    Jpeg2000Band *band = job->band;
+    Jpeg2000T1Context t1;
+    int y, x;
+
+    t1.stride = (1<<s->codsty.log2_cblk_width) + 2;
+
+    if (s->codsty.transform == FF_DWT53){
+        for (y = job->y0; y < job->y1; y++){
+            int *ptr = t1.data + (y-job->y0)*t1.stride;
+            for (x = job->x0; x < job->x1; x++){
+                *ptr++ = comp->i_data[(comp->coord[0][1] - comp->coord[0][0]) * y + x] << NMSEDEC_FRACBITS;
+            }
+        }
+    } else{
+        for (y = job->y0; y < job->y1; y++){
+            int *ptr = t1.data + (y-job->y0)*t1.stride;
+            for (x = job->x0; x < job->x1; x++){
+                *ptr = (comp->i_data[(comp->coord[0][1] - comp->coord[0][0]) * y + x]);
+                *ptr = (int64_t)*ptr * (int64_t)(16384 * 65536 / band->i_stepsize) >> 15 - NMSEDEC_FRACBITS;
+                ptr++;
+            }
+        }
+    }
+    encode_cblk(s, &t1, job->cblk, job->tile, job->x1 - job->x0, job->y1 - job->y0,
+                job->bandpos, job->lev);
+    return 0;
+}
+
+/* DWT and tier-1 coding of all tiles. Tiles are transformed in parallel when
+ * there are enough of them, otherwise the DWT passes are split between the
+ * threads; code-blocks are always coded in parallel. */
+static int encode_tiles_t1(Jpeg2000EncoderContext *s)
+{
+    AVCodecContext *avctx = s->avctx;
+    int tileno, compno, ret;
+    int nb_tiles = s->numXtiles * s->numYtiles;
+
+    av_log(s->avctx, AV_LOG_DEBUG,"dwt\n");
+    if (avctx->active_thread_type & FF_THREAD_SLICE && nb_tiles < avctx->thread_count) {
+        for (tileno = 0; tileno < nb_tiles; tileno++){
+            for (compno = 0; compno < s->ncomponents; compno++){
+                Jpeg2000Component *comp = s->tile[tileno].comp + compno;
+                if ((ret = ff_dwt_encode_thread(&comp->dwt, comp->i_data, avctx)) < 0)
+                    return ret;
+            }
+        }
+    } else {
+        avctx->execute2(avctx, dwt_tile, NULL, NULL, nb_tiles);
+    }
+    av_log(s->avctx, AV_LOG_DEBUG,"after dwt -> tier1\n");
+
+    if ((ret = collect_cblks(s)) < 0)
+        return ret;
+    if (s->nb_cblk_jobs)
+        avctx->execute2(avctx, encode_cblk_job, NULL, NULL, s->nb_cblk_jobs);
+    av_log(s->avctx, AV_LOG_DEBUG, "after tier1\n");
+
+    return 0;
+}
+
+static int encode_tile(Jpeg2000EncoderContext *s, Jpeg2000Tile *tile, int tileno)
+{
+    int ret;
 
     av_log(s->avctx, AV_LOG_DEBUG, "rate control\n");
     truncpasses(s, tile);
@@ -1072,6 +1167,9 @@ static int encode_frame(AVCodecContext *avctx, AVPacket *pkt,
     if ((ret = put_com(s, 0)) < 0)
         return ret;
 
+    if ((ret = encode_tiles_t1(s)) < 0)
+        return ret;
+
     for (tileno = 0; tileno < s->numXtiles * s->numYtiles; tileno++){
         uint8_t *psotptr;
         if (!(psotptr = put_sot(s, tileno)))
@@ -1165,6 +1263,7 @@ static int j2kenc_destroy(AVCodecContext *avctx)
     Jpeg2000EncoderContext *s = avctx->priv_data;
 
     cleanup(s);
+    av_freep(&s->cblk_jobs);
     return 0;
 }
 
@@ -1198,6 +1297,7 @@ AVCodec ff_jpeg2000_encoder = {
     .init           = j2kenc_init,
     .encode2        = encode_frame,
     .close          = j2kenc_destroy,
+    .capabilities   = AV_CODEC_CAP_SLICE_THREADS,
     .pix_fmts       = (const enum AVPixelFormat[]) {
         AV_PIX_FMT_RGB24, AV_PIX_FMT_YUV444P, AV_PIX_FMT_GRAY8,
         AV_PIX_FMT_YUV420P, AV_PIX_FMT_YUV422P,
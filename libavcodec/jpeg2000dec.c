@@ -84,6 +84,14 @@ typedef struct Jpeg2000Tile {
     int coord[2][2];                    // border coordinates {{x0, x1}, {y0, y1}}
 } Jpeg2000Tile;
 
+typedef struct Jpeg2000CblkJob {
+    Jpeg2000Component   *comp;
+    Jpeg2000CodingStyle *codsty;
+    Jpeg2000Band        *band;
+    Jpeg2000Cblk        *cblk;
+    int                 bandpos;
+} Jpeg2000CblkJob;
+
 typedef struct Jpeg2000DecoderContext {
     AVClass         *class;
     AVCodecContext  *avctx;
@@ -117,6 +125,15 @@ typedef struct Jpeg2000DecoderContext {
     Jpeg2000Tile    *tile;
     Jpeg2000DSPContext dsp;
 
+    /* code-blocks of all tiles, decoded in parallel */
+    Jpeg2000CblkJob *cblk_jobs;
+    unsigned int    cblk_jobs_size;
+    int             nb_cblk_jobs;
+
+    /* return values of the jobs of one execute2() call */
+    int             *job_ret;
+    unsigned int    job_ret_size;
+
     /*options parameters*/
     int             reduction_factor;
 } Jpeg2000DecoderContext;
@@ -1645,87 +1662,123 @@ static inline void mct_decode(Jpeg2000DecoderContext *s, Jpeg2000Tile *tile)
     s->dsp.mct_decode[tile->codsty[0].transform](src[0], src[1], src[2], csize);
 }
 
+/* Gather the code-blocks of all tiles, tier-1 decoding of each of them is
+ * independent of the others. */
+static int jpeg2000_collect_cblks(Jpeg2000DecoderContext *s)
+{
+    int tileno, compno, reslevelno, bandno, precno, cblkno;
+
+    s->nb_cblk_jobs = 0;
+    for (tileno = 0; tileno < s->numXtiles * s->numYtiles; tileno++) {
+        Jpeg2000Tile *tile = s->tile + tileno;
+
+        for (compno = 0; compno < s->ncomponents; compno++) {
+            Jpeg2000Component *comp     = tile->comp + compno;
+            Jpeg2000CodingStyle *codsty = tile->codsty + compno;
+
+            for (reslevelno = 0; reslevelno < codsty->nreslevels2decode; reslevelno++) {
+                Jpeg2000ResLevel *rlevel = comp->reslevel + reslevelno;
+                int nb_precincts = rlevel->num_precincts_x * rlevel->num_precincts_y;
+
+                for (bandno = 0; bandno < rlevel->nbands; bandno++) {
+                    Jpeg2000Band *band = rlevel->band + bandno;
+
+                    if (band->coord[0][0] == band->coord[0][1] ||
+                        band->coord[1][0] == band->coord[1][1])
+                        continue;
+
+                    for (precno = 0; precno < nb_precincts; precno++) {
+                        Jpeg2000Prec *prec = band->prec + precno;
+                        int nb_cblks = prec->nb_codeblocks_width * prec->nb_codeblocks_height;
+                        Jpeg2000CblkJob *jobs;
+
+                        jobs = av_fast_realloc(s->cblk_jobs, &s->cblk_jobs_size,
+                                               (s->nb_cblk_jobs + nb_cblks) * sizeof(*jobs));
+                        if (!jobs)
+                            return AVERROR(ENOMEM);
+                        s->cblk_jobs = jobs;
+                        jobs += s->nb_cblk_jobs;
+
+                        for (cblkno = 0; cblkno < nb_cblks; cblkno++) {
+                            jobs[cblkno].comp    = comp;
+                            jobs[cblkno].codsty  = codsty;
+                            jobs[cblkno].band    = band;
+                            jobs[cblkno].cblk    = prec->cblk + cblkno;
+                            jobs[cblkno].bandpos = bandno + (reslevelno > 0);
+                        }
+                        s->nb_cblk_jobs += nb_cblks;
+                    }
+                }
+            }
+        }
+    }
+    return 0;
+}
+
+static int jpeg2000_decode_cblk(AVCodecContext *avctx, void *td,
+                                int jobnr, int threadnr)
+{
+    Jpeg2000DecoderContext *s = avctx->priv_data;
+    Jpeg2000CblkJob *job      = s->cblk_jobs + jobnr;
+    Jpeg2000CodingStyle *codsty = job->codsty;
+    Jpeg2000Cblk *cblk        = job->cblk;
+    Jpeg2000Band *band        = job->band;
+    Jpeg2000T1Context t1;
+    int x, y;
+
+    t1.stride = (1<<codsty->log2_cblk_width) + 2;
+
+    decode_cblk(s, codsty, &t1, cblk,
+                cblk->coord[0][1] - cblk->coord[0][0],
+                cblk->coord[1][1] - cblk->coord[1][0],
+                job->bandpos);
+
+    x = cblk->coord[0][0] - band->coord[0][0];
+    y = cblk->coord[1][0] - band->coord[1][0];
+
+    if (codsty->transform == FF_DWT97)
+        dequantization_float(x, y, cblk, job->comp, &t1, band);
+    else if (codsty->transform == FF_DWT97_INT)
+        dequantization_int_97(x, y, cblk, job->comp, &t1, band);
+    else
+        dequantization_int(x, y, cblk, job->comp, &t1, band);
+
+    return 0;
+}
+
+/* Inverse DWT and MCT of a tile whose code-blocks are decoded, and output.
+ * With dwt_threads the DWT of each component is split between the slice
+ * threads, otherwise the whole tile runs on the calling thread. */
 static int jpeg2000_decode_tile(Jpeg2000DecoderContext *s, Jpeg2000Tile *tile,
-                                AVFrame *picture)
+                                AVFrame *picture, int dwt_threads)
 {
     const AVPixFmtDescriptor *pixdesc = av_pix_fmt_desc_get(s->avctx->pix_fmt);
-    int compno, reslevelno, bandno;
+    int compno;
     int x, y;
     int planar    = !!(pixdesc->flags & AV_PIX_FMT_FLAG_PLANAR);
     int pixelsize = planar ? 1 : pixdesc->nb_components;
 
     uint8_t *line;
-    Jpeg2000T1Context t1;
 
-    /* Loop on tile components */
     for (compno = 0; compno < s->ncomponents; compno++) {
         Jpeg2000Component *comp     = tile->comp + compno;
         Jpeg2000CodingStyle *codsty = tile->codsty + compno;
-
-        t1.stride = (1<<codsty->log2_cblk_width) + 2;
-
-        /* Loop on resolution levels */
-        for (reslevelno = 0; reslevelno < codsty->nreslevels2decode; reslevelno++) {
-            Jpeg2000ResLevel *rlevel = comp->reslevel + reslevelno;
-            /* Loop on bands */
-            for (bandno = 0; bandno < rlevel->nbands; bandno++) {
-                int nb_precincts, precno;
-                Jpeg2000Band *band = rlevel->band + bandno;
-                int cblkno = 0, bandpos;
-
-                bandpos = bandno + (reslevelno > 0);
-
-                if (band->coord[0][0] == band->coord[0][1] ||
-                    band->coord[1][0] == band->coord[1][1])
-                    continue;
-
-                nb_precincts = rlevel->num_precincts_x * rlevel->num_precincts_y;
-                /* Loop on precincts */
-                for (precno = 0; precno < nb_precincts; precno++) {
-                    Jpeg2000Prec *prec = band->prec + precno;
-
-                    /* Loop on codeblocks */
-                    for (cblkno = 0; cblkno < prec->nb_codeblocks_width * prec->nb_codeblocks_height; cblkno++) {
-                        int x, y;
-                        Jpeg2000Cblk *cblk = prec->cblk + cblkno;
-                        decode_cblk(s, codsty, &t1, cblk,
-                                    cblk->coord[0][1] - cblk->coord[0][0],
-                                    cblk->coord[1][1] - cblk->coord[1][0],
-                                    bandpos);
-
-                        x = cblk->coord[0][0] - band->coord[0][0];
-                        y = cblk->coord[1][0] - band->coord[1][0];
-
-                        if (codsty->transform == FF_DWT97)
-                            dequantization_float(x, y, cblk, comp, &t1, band);
-                        else if (codsty->transform == FF_DWT97_INT)
-                            dequantization_int_97(x, y, cblk, comp, &t1, band);
-                        else
-                            dequantization_int(x, y, cblk, comp, &t1, band);
-                   } /* end cblk */
-                } /*end prec */
-            } /* end band */
-        } /* end reslevel */
+        void *data = codsty->transform == FF_DWT97 ? (void*)comp->f_data : (void*)comp->i_data;
+        int ret;
 
         /* inverse DWT */
-        ff_dwt_decode(&comp->dwt, codsty->transform == FF_DWT97 ? (void*)comp->f_data : (void*)comp->i_data);
-    } /*end comp */
+        if (dwt_threads)
+            ret = ff_dwt_decode_thread(&comp->dwt, data, s->avctx);
+        else
+            ret = ff_dwt_decode(&comp->dwt, data);
+        if (ret < 0)
+            return ret;
+    }
 
     /* inverse MCT transformation */
     if (tile->codsty[0].mct)
         mct_decode(s, tile);
 
-    for (x = 0; x < s->ncomponents; x++) {
-        if (s->cdef[x] < 0) {
-            for (x = 0; x < s->ncomponents; x++) {
-                s->cdef[x] = x + 1;
-            }
-            if ((s->ncomponents & 1) == 0)
-                s->cdef[s->ncomponents-1] = 0;
-            break;
-        }
-    }
-
     if (s->precision <= 8) {
         for (compno = 0; compno < s->ncomponents; compno++) {
             Jpeg2000Component *comp = tile->comp + compno;
@@ -1825,6 +1878,33 @@ static int jpeg2000_decode_tile(Jpeg2000DecoderContext *s, Jpeg2000Tile *tile,
     return 0;
 }
 
+static int jpeg2000_decode_tile_job(AVCodecContext *avctx, void *td,
+                                    int jobnr, int threadnr)
+{
+    Jpeg2000DecoderContext *s = avctx->priv_data;
+
+    return jpeg2000_decode_tile(s, s->tile + jobnr, td, 0);
+}
+
+/* Run the jobs and return the first error of a job, as the serial loops do. */
+static int jpeg2000_execute(AVCodecContext *avctx,
+                            int (*func)(AVCodecContext *c, void *arg, int jobnr, int threadnr),
+                            void *arg, int count)
+{
+    Jpeg2000DecoderContext *s = avctx->priv_data;
+    int i;
+
+    av_fast_malloc(&s->job_ret, &s->job_ret_size, count * sizeof(*s->job_ret));
+    if (!s->job_ret)
+        return AVERROR(ENOMEM);
+
+    avctx->execute2(avctx, func, arg, s->job_ret, count);
+    for (i = 0; i < count; i++)
+        if (s->job_ret[i] < 0)
+            return s->job_ret[i];
+    return 0;
+}
+
 static void jpeg2000_dec_cleanup(Jpeg2000DecoderContext *s)
 {
     int tileno, compno;
@@ -2099,7 +2179,7 @@ static int jpeg2000_decode_frame(AVCodecContext *avctx, void *data,
     Jpeg2000DecoderContext *s = avctx->priv_data;
     ThreadFrame frame = { .f = data };
     AVFrame *picture = data;
-    int tileno, ret;
+    int tileno, nb_tiles, x, ret;
 
     s->avctx     = avctx;
     bytestream2_init(&s->g, avpkt->data, avpkt->size);
@@ -2146,9 +2226,33 @@ static int jpeg2000_decode_frame(AVCodecContext *avctx, void *data,
     if (ret = jpeg2000_read_bitstream_packets(s))
         goto end;
 
-    for (tileno = 0; tileno < s->numXtiles * s->numYtiles; tileno++)
-        if (ret = jpeg2000_decode_tile(s, s->tile + tileno, picture))
-            goto end;
+    for (x = 0; x < s->ncomponents; x++) {
+        if (s->cdef[x] < 0) {
+            for (x = 0; x < s->ncomponents; x++) {
+                s->cdef[x] = x + 1;
+            }
+            if ((s->ncomponents & 1) == 0)
+                s->cdef[s->ncomponents-1] = 0;
+            break;
+        }
+    }
+
+    if ((ret = jpeg2000_collect_cblks(s)) < 0)
+        goto end;
+    if (s->nb_cblk_jobs &&
+        (ret = jpeg2000_execute(avctx, jpeg2000_decode_cblk, NULL, s->nb_cblk_jobs)) < 0)
+        goto end;
+
+    /* Few large tiles (digital cinema uses a single one) leave the threads
+     * idle with one tile each, split their DWT between the threads instead. */
+    nb_tiles = s->numXtiles * s->numYtiles;
+    if (avctx->active_thread_type & FF_THREAD_SLICE && nb_tiles < avctx->thread_count) {
+        for (tileno = 0; tileno < nb_tiles; tileno++)
+            if ((ret = jpeg2000_decode_tile(s, s->tile + tileno, picture, 1)) < 0)
+                goto end;
+    } else if ((ret = jpeg2000_execute(avctx, jpeg2000_decode_tile_job, picture, nb_tiles)) < 0) {
+        goto end;
+    }
 
     jpeg2000_dec_cleanup(s);
 
@@ -2164,6 +2268,18 @@ end:
     return ret;
 }
 
+static av_cold int jpeg2000_decode_end(AVCodecContext *avctx)
+{
+    Jpeg2000DecoderContext *s = avctx->priv_data;
+
+    av_freep(&s->cblk_jobs);
+    s->cblk_jobs_size = 0;
+    av_freep(&s->job_ret);
+    s->job_ret_size = 0;
+
+    return 0;
+}
+
 static av_cold void jpeg2000_init_static_data(AVCodec *codec)
 {
     ff_jpeg2000_init_tier1_luts();
@@ -2200,11 +2316,13 @@ AVCodec ff_jpeg2000_decoder = {
     .long_name        = NULL_IF_CONFIG_SMALL("JPEG 2000"),
     .type             = AVMEDIA_TYPE_VIDEO,
     .id               = AV_CODEC_ID_JPEG2000,
-    .capabilities     = AV_CODEC_CAP_FRAME_THREADS | AV_CODEC_CAP_DR1,
+    .capabilities     = AV_CODEC_CAP_SLICE_THREADS | AV_CODEC_CAP_FRAME_THREADS |
+                        AV_CODEC_CAP_DR1,
     .priv_data_size   = sizeof(Jpeg2000DecoderContext),
     .init_static_data = jpeg2000_init_static_data,
     .init             = jpeg2000_decode_init,
     .decode           = jpeg2000_decode_frame,
+    .close            = jpeg2000_decode_end,
     .priv_class       = &jpeg2000_class,
     .max_lowres       = 5,
     .profiles         = NULL_IF_CONFIG_SMALL(profiles)
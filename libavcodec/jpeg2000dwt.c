@@ -94,24 +94,28 @@ static void sd_1d53(int *p, int i0, int i1)
         p[2*i] += (p[2*i-1] + p[2*i+1] + 2) >> 2;
 }
 
-static void dwt_encode53(DWTContext *s, int *t)
+/* The transforms below process the lines [lp0, lp1) of one pass of a
+ * decomposition level, rows for the horizontal (ver = 0) and columns for the
+ * vertical (ver = 1) pass. The lines of a pass are independent of each other,
+ * so ff_dwt_encode_thread() and ff_dwt_decode_thread() split them between
+ * threads, each with its own line buffer. */
+
+static void dwt_encode53_lines(DWTContext *s, int *t, int *line, int lev,
+                               int ver, int lp0, int lp1)
 {
-    int lev,
-        w = s->linelen[s->ndeclevels-1][0];
-    int *line = s->i_linebuf;
+    int w  = s->linelen[s->ndeclevels-1][0],
+        lh = s->linelen[lev][0],
+        lv = s->linelen[lev][1],
+        mh = s->mod[lev][0],
+        mv = s->mod[lev][1],
+        lp;
+    int *l;
     line += 3;
 
-    for (lev = s->ndeclevels-1; lev >= 0; lev--){
-        int lh = s->linelen[lev][0],
-            lv = s->linelen[lev][1],
-            mh = s->mod[lev][0],
-            mv = s->mod[lev][1],
-            lp;
-        int *l;
-
+    if (ver) {
         // VER_SD
         l = line + mv;
-        for (lp = 0; lp < lh; lp++) {
+        for (lp = lp0; lp < lp1; lp++) {
             int i, j = 0;
 
             for (i = 0; i < lv; i++)
@@ -125,10 +129,10 @@ static void dwt_encode53(DWTContext *s, int *t)
             for (i = 1-mv; i < lv; i+=2, j++)
                 t[w*j + lp] = l[i];
         }
-
+    } else {
         // HOR_SD
         l = line + mh;
-        for (lp = 0; lp < lv; lp++){
+        for (lp = lp0; lp < lp1; lp++){
             int i, j = 0;
 
             for (i = 0; i < lh; i++)
@@ -144,6 +148,17 @@ static void dwt_encode53(DWTContext *s, int *t)
         }
     }
 }
+
+static void dwt_encode53(DWTContext *s, int *t)
+{
+    int lev;
+
+    for (lev = s->ndeclevels-1; lev >= 0; lev--){
+        dwt_encode53_lines(s, t, s->i_linebuf, lev, 1, 0, s->linelen[lev][0]);
+        dwt_encode53_lines(s, t, s->i_linebuf, lev, 0, 0, s->linelen[lev][1]);
+    }
+}
+
 static void sd_1d97_float(float *p, int i0, int i1)
 {
     int i;
@@ -169,24 +184,22 @@ static void sd_1d97_float(float *p, int i0, int i1)
         p[2*i] += 0.443506 * (p[2*i-1] + p[2*i+1]);
 }
 
-static void dwt_encode97_float(DWTContext *s, float *t)
+static void dwt_encode97_float_lines(DWTContext *s, float *t, float *line,
+                                     int lev, int ver, int lp0, int lp1)
 {
-    int lev,
-        w = s->linelen[s->ndeclevels-1][0];
-    float *line = s->f_linebuf;
+    int w  = s->linelen[s->ndeclevels-1][0],
+        lh = s->linelen[lev][0],
+        lv = s->linelen[lev][1],
+        mh = s->mod[lev][0],
+        mv = s->mod[lev][1],
+        lp;
+    float *l;
     line += 5;
 
-    for (lev = s->ndeclevels-1; lev >= 0; lev--){
-        int lh = s->linelen[lev][0],
-            lv = s->linelen[lev][1],
-            mh = s->mod[lev][0],
-            mv = s->mod[lev][1],
-            lp;
-        float *l;
-
+    if (!ver) {
         // HOR_SD
         l = line + mh;
-        for (lp = 0; lp < lv; lp++){
+        for (lp = lp0; lp < lp1; lp++){
             int i, j = 0;
 
             for (i = 0; i < lh; i++)
@@ -200,10 +213,10 @@ static void dwt_encode97_float(DWTContext *s, float *t)
             for (i = 1-mh; i < lh; i+=2, j++)
                 t[w*lp + j] = l[i];
         }
-
+    } else {
         // VER_SD
         l = line + mv;
-        for (lp = 0; lp < lh; lp++) {
+        for (lp = lp0; lp < lp1; lp++) {
             int i, j = 0;
 
             for (i = 0; i < lv; i++)
@@ -220,6 +233,16 @@ static void dwt_encode97_float(DWTContext *s, float *t)
     }
 }
 
+static void dwt_encode97_float(DWTContext *s, float *t)
+{
+    int lev;
+
+    for (lev = s->ndeclevels-1; lev >= 0; lev--){
+        dwt_encode97_float_lines(s, t, s->f_linebuf, lev, 0, 0, s->linelen[lev][1]);
+        dwt_encode97_float_lines(s, t, s->f_linebuf, lev, 1, 0, s->linelen[lev][0]);
+    }
+}
+
 static void sd_1d97_int(int *p, int i0, int i1)
 {
     int i;
@@ -245,29 +268,43 @@ static void sd_1d97_int(int *p, int i0, int i1)
         p[2 * i]     += (I_LFTG_DELTA * (p[2 * i - 1] + p[2 * i + 1]) + (1 << 15)) >> 16;
 }
 
-static void dwt_encode97_int(DWTContext *s, int *t)
+static void dwt_preshift_int(int32_t *t, int encode, int i0, int i1)
 {
-    int lev;
-    int w = s->linelen[s->ndeclevels-1][0];
-    int h = s->linelen[s->ndeclevels-1][1];
     int i;
-    int *line = s->i_linebuf;
-    line += 5;
 
-    for (i = 0; i < w * h; i++)
-        t[i] <<= I_PRESHIFT;
+    if (encode) {
+        for (i = i0; i < i1; i++)
+            t[i] <<= I_PRESHIFT;
+    } else {
+        for (i = i0; i < i1; i++)
+            t[i] *= 1LL << I_PRESHIFT;
+    }
+}
 
-    for (lev = s->ndeclevels-1; lev >= 0; lev--){
-        int lh = s->linelen[lev][0],
-            lv = s->linelen[lev][1],
-            mh = s->mod[lev][0],
-            mv = s->mod[lev][1],
-            lp;
-        int *l;
+static void dwt_postshift_int(int32_t *t, int i0, int i1)
+{
+    int i;
+
+    for (i = i0; i < i1; i++)
+        t[i] = (t[i] + ((1<<I_PRESHIFT)>>1)) >> I_PRESHIFT;
+}
+
+static void dwt_encode97_int_lines(DWTContext *s, int *t, int *line, int lev,
+                                   int ver, int lp0, int lp1)
+{
+    int w  = s->linelen[s->ndeclevels-1][0],
+        lh = s->linelen[lev][0],
+        lv = s->linelen[lev][1],
+        mh = s->mod[lev][0],
+        mv = s->mod[lev][1],
+        lp;
+    int *l;
+    line += 5;
 
+    if (ver) {
         // VER_SD
         l = line + mv;
-        for (lp = 0; lp < lh; lp++) {
+        for (lp = lp0; lp < lp1; lp++) {
             int i, j = 0;
 
             for (i = 0; i < lv; i++)
@@ -281,10 +318,10 @@ static void dwt_encode97_int(DWTContext *s, int *t)
             for (i = 1-mv; i < lv; i+=2, j++)
                 t[w*j + lp] = l[i];
         }
-
+    } else {
         // HOR_SD
         l = line + mh;
-        for (lp = 0; lp < lv; lp++){
+        for (lp = lp0; lp < lp1; lp++){
             int i, j = 0;
 
             for (i = 0; i < lh; i++)
@@ -298,11 +335,23 @@ static void dwt_encode97_int(DWTContext *s, int *t)
             for (i = 1-mh; i < lh; i+=2, j++)
                 t[w*lp + j] = l[i];
         }
+    }
+}
+
+static void dwt_encode97_int(DWTContext *s, int *t)
+{
+    int lev;
+    int w = s->linelen[s->ndeclevels-1][0];
+    int h = s->linelen[s->ndeclevels-1][1];
+
+    dwt_preshift_int(t, 1, 0, w * h);
 
+    for (lev = s->ndeclevels-1; lev >= 0; lev--){
+        dwt_encode97_int_lines(s, t, s->i_linebuf, lev, 1, 0, s->linelen[lev][0]);
+        dwt_encode97_int_lines(s, t, s->i_linebuf, lev, 0, 0, s->linelen[lev][1]);
     }
 
-    for (i = 0; i < w * h; i++)
-        t[i] = (t[i] + ((1<<I_PRESHIFT)>>1)) >> I_PRESHIFT;
+    dwt_postshift_int(t, 0, w * h);
 }
 
 static void sr_1d53(unsigned *p, int i0, int i1)
@@ -323,24 +372,22 @@ static void sr_1d53(unsigned *p, int i0, int i1)
         p[2 * i + 1] += (int)(p[2 * i] + p[2 * i + 2]) >> 1;
 }
 
-static void dwt_decode53(DWTContext *s, int *t)
+static void dwt_decode53_lines(DWTContext *s, int *t, int32_t *line, int lev,
+                               int ver, int lp0, int lp1)
 {
-    int lev;
-    int w     = s->linelen[s->ndeclevels - 1][0];
-    int32_t *line = s->i_linebuf;
+    int w  = s->linelen[s->ndeclevels - 1][0],
+        lh = s->linelen[lev][0],
+        lv = s->linelen[lev][1],
+        mh = s->mod[lev][0],
+        mv = s->mod[lev][1],
+        lp;
+    int *l;
     line += 3;
 
-    for (lev = 0; lev < s->ndeclevels; lev++) {
-        int lh = s->linelen[lev][0],
-            lv = s->linelen[lev][1],
-            mh = s->mod[lev][0],
-            mv = s->mod[lev][1],
-            lp;
-        int *l;
-
+    if (!ver) {
         // HOR_SD
         l = line + mh;
-        for (lp = 0; lp < lv; lp++) {
+        for (lp = lp0; lp < lp1; lp++) {
             int i, j = 0;
             // copy with interleaving
             for (i = mh; i < lh; i += 2, j++)
@@ -353,10 +400,10 @@ static void dwt_decode53(DWTContext *s, int *t)
             for (i = 0; i < lh; i++)
                 t[w * lp + i] = l[i];
         }
-
+    } else {
         // VER_SD
         l = line + mv;
-        for (lp = 0; lp < lh; lp++) {
+        for (lp = lp0; lp < lp1; lp++) {
             int i, j = 0;
             // copy with interleaving
             for (i = mv; i < lv; i += 2, j++)
@@ -372,6 +419,16 @@ static void dwt_decode53(DWTContext *s, int *t)
     }
 }
 
+static void dwt_decode53(DWTContext *s, int *t)
+{
+    int lev;
+
+    for (lev = 0; lev < s->ndeclevels; lev++) {
+        dwt_decode53_lines(s, t, s->i_linebuf, lev, 0, 0, s->linelen[lev][1]);
+        dwt_decode53_lines(s, t, s->i_linebuf, lev, 1, 0, s->linelen[lev][0]);
+    }
+}
+
 static void sr_1d97_float(float *p, int i0, int i1)
 {
     int i;
@@ -399,25 +456,23 @@ static void sr_1d97_float(float *p, int i0, int i1)
         p[2 * i + 1] += F_LFTG_ALPHA * (p[2 * i]     + p[2 * i + 2]);
 }
 
-static void dwt_decode97_float(DWTContext *s, float *t)
+static void dwt_decode97_float_lines(DWTContext *s, float *data, float *line,
+                                     int lev, int ver, int lp0, int lp1)
 {
-    int lev;
-    int w       = s->linelen[s->ndeclevels - 1][0];
-    float *line = s->f_linebuf;
-    float *data = t;
+    int w  = s->linelen[s->ndeclevels - 1][0],
+        lh = s->linelen[lev][0],
+        lv = s->linelen[lev][1],
+        mh = s->mod[lev][0],
+        mv = s->mod[lev][1],
+        lp;
+    float *l;
     /* position at index O of line range [0-5,w+5] cf. extend function */
     line += 5;
 
-    for (lev = 0; lev < s->ndeclevels; lev++) {
-        int lh = s->linelen[lev][0],
-            lv = s->linelen[lev][1],
-            mh = s->mod[lev][0],
-            mv = s->mod[lev][1],
-            lp;
-        float *l;
+    if (!ver) {
         // HOR_SD
         l = line + mh;
-        for (lp = 0; lp < lv; lp++) {
+        for (lp = lp0; lp < lp1; lp++) {
             int i, j = 0;
             // copy with interleaving
             for (i = mh; i < lh; i += 2, j++)
@@ -430,10 +485,10 @@ static void dwt_decode97_float(DWTContext *s, float *t)
             for (i = 0; i < lh; i++)
                 data[w * lp + i] = l[i];
         }
-
+    } else {
         // VER_SD
         l = line + mv;
-        for (lp = 0; lp < lh; lp++) {
+        for (lp = lp0; lp < lp1; lp++) {
             int i, j = 0;
             // copy with interleaving
             for (i = mv; i < lv; i += 2, j++)
@@ -449,6 +504,16 @@ static void dwt_decode97_float(DWTContext *s, float *t)
     }
 }
 
+static void dwt_decode97_float(DWTContext *s, float *t)
+{
+    int lev;
+
+    for (lev = 0; lev < s->ndeclevels; lev++) {
+        dwt_decode97_float_lines(s, t, s->f_linebuf, lev, 0, 0, s->linelen[lev][1]);
+        dwt_decode97_float_lines(s, t, s->f_linebuf, lev, 1, 0, s->linelen[lev][0]);
+    }
+}
+
 static void sr_1d97_int(int32_t *p, int i0, int i1)
 {
     int i;
@@ -476,30 +541,23 @@ static void sr_1d97_int(int32_t *p, int i0, int i1)
         p[2 * i + 1] += (I_LFTG_ALPHA * (p[2 * i]     + p[2 * i + 2]) + (1 << 15)) >> 16;
 }
 
-static void dwt_decode97_int(DWTContext *s, int32_t *t)
+static void dwt_decode97_int_lines(DWTContext *s, int32_t *data, int32_t *line,
+                                   int lev, int ver, int lp0, int lp1)
 {
-    int lev;
-    int w       = s->linelen[s->ndeclevels - 1][0];
-    int h       = s->linelen[s->ndeclevels - 1][1];
-    int i;
-    int32_t *line = s->i_linebuf;
-    int32_t *data = t;
+    int w  = s->linelen[s->ndeclevels - 1][0],
+        lh = s->linelen[lev][0],
+        lv = s->linelen[lev][1],
+        mh = s->mod[lev][0],
+        mv = s->mod[lev][1],
+        lp;
+    int32_t *l;
     /* position at index O of line range [0-5,w+5] cf. extend function */
     line += 5;
 
-    for (i = 0; i < w * h; i++)
-        data[i] *= 1LL << I_PRESHIFT;
-
-    for (lev = 0; lev < s->ndeclevels; lev++) {
-        int lh = s->linelen[lev][0],
-            lv = s->linelen[lev][1],
-            mh = s->mod[lev][0],
-            mv = s->mod[lev][1],
-            lp;
-        int32_t *l;
+    if (!ver) {
         // HOR_SD
         l = line + mh;
-        for (lp = 0; lp < lv; lp++) {
+        for (lp = lp0; lp < lp1; lp++) {
             int i, j = 0;
             // rescale with interleaving
             for (i = mh; i < lh; i += 2, j++)
@@ -512,10 +570,10 @@ static void dwt_decode97_int(DWTContext *s, int32_t *t)
             for (i = 0; i < lh; i++)
                 data[w * lp + i] = l[i];
         }
-
+    } else {
         // VER_SD
         l = line + mv;
-        for (lp = 0; lp < lh; lp++) {
+        for (lp = lp0; lp < lp1; lp++) {
             int i, j = 0;
             // rescale with interleaving
             for (i = mv; i < lv; i += 2, j++)
@@ -529,9 +587,155 @@ static void dwt_decode97_int(DWTContext *s, int32_t *t)
                 data[w * i + lp] = l[i];
         }
     }
+}
+
+static void dwt_decode97_int(DWTContext *s, int32_t *t)
+{
+    int lev;
+    int w = s->linelen[s->ndeclevels - 1][0];
+    int h = s->linelen[s->ndeclevels - 1][1];
+
+    dwt_preshift_int(t, 0, 0, w * h);
+
+    for (lev = 0; lev < s->ndeclevels; lev++) {
+        dwt_decode97_int_lines(s, t, s->i_linebuf, lev, 0, 0, s->linelen[lev][1]);
+        dwt_decode97_int_lines(s, t, s->i_linebuf, lev, 1, 0, s->linelen[lev][0]);
+    }
+
+    dwt_postshift_int(t, 0, w * h);
+}
+
+enum DWTStep {
+    DWT_STEP_HOR,
+    DWT_STEP_VER,
+    DWT_STEP_PRESHIFT,
+    DWT_STEP_POSTSHIFT,
+};
+
+typedef struct DWTThreadData {
+    DWTContext *s;
+    void *t;
+    int encode;
+    enum DWTStep step;
+    int lev;
+    int nb_lines;           ///< lines of the current pass, samples for the shifts
+    int nb_jobs, max_jobs;
+} DWTThreadData;
+
+static int dwt_job(AVCodecContext *avctx, void *arg, int jobnr, int threadnr)
+{
+    DWTThreadData *td = arg;
+    DWTContext *s     = td->s;
+    int lp0  = (int64_t)td->nb_lines *  jobnr      / td->nb_jobs;
+    int lp1  = (int64_t)td->nb_lines * (jobnr + 1) / td->nb_jobs;
+    int ver  = td->step == DWT_STEP_VER;
+    void *line = (int32_t *)s->thread_linebuf + jobnr * s->linebuf_len;
+
+    if (td->step == DWT_STEP_PRESHIFT) {
+        dwt_preshift_int(td->t, td->encode, lp0, lp1);
+        return 0;
+    }
+    if (td->step == DWT_STEP_POSTSHIFT) {
+        dwt_postshift_int(td->t, lp0, lp1);
+        return 0;
+    }
+
+    switch (s->type) {
+    case FF_DWT97:
+        if (td->encode)
+            dwt_encode97_float_lines(s, td->t, line, td->lev, ver, lp0, lp1);
+        else
+            dwt_decode97_float_lines(s, td->t, line, td->lev, ver, lp0, lp1);
+        break;
+    case FF_DWT97_INT:
+        if (td->encode)
+            dwt_encode97_int_lines(s, td->t, line, td->lev, ver, lp0, lp1);
+        else
+            dwt_decode97_int_lines(s, td->t, line, td->lev, ver, lp0, lp1);
+        break;
+    case FF_DWT53:
+        if (td->encode)
+            dwt_encode53_lines(s, td->t, line, td->lev, ver, lp0, lp1);
+        else
+            dwt_decode53_lines(s, td->t, line, td->lev, ver, lp0, lp1);
+        break;
+    }
+    return 0;
+}
+
+static int dwt_execute(AVCodecContext *avctx, DWTThreadData *td,
+                       enum DWTStep step, int lev)
+{
+    DWTContext *s = td->s;
+    int i;
+
+    td->step = step;
+    td->lev  = lev;
+    if (step == DWT_STEP_PRESHIFT || step == DWT_STEP_POSTSHIFT)
+        td->nb_lines = s->linelen[s->ndeclevels - 1][0] *
+                       s->linelen[s->ndeclevels - 1][1];
+    else
+        td->nb_lines = s->linelen[lev][step == DWT_STEP_HOR];
+    td->nb_jobs = FFMIN(td->nb_lines, td->max_jobs);
+
+    if (td->nb_jobs <= 0)
+        return 0;
+
+    avctx->execute2(avctx, dwt_job, td, s->thread_ret, td->nb_jobs);
+    for (i = 0; i < td->nb_jobs; i++)
+        if (s->thread_ret[i] < 0)
+            return s->thread_ret[i];
+    return 0;
+}
+
+static int dwt_thread(DWTContext *s, void *t, int encode, AVCodecContext *avctx)
+{
+    DWTThreadData td = { .s = s, .t = t, .encode = encode };
+    int lev, ret;
+
+    if (s->ndeclevels == 0)
+        return 0;
+    if (s->type >= FF_DWT_NB)
+        return -1;
+
+    td.max_jobs = FFMAX(avctx->thread_count, 1);
+    if (!(avctx->active_thread_type & FF_THREAD_SLICE) || td.max_jobs == 1)
+        return encode ? ff_dwt_encode(s, t) : ff_dwt_decode(s, t);
+
+    av_fast_malloc(&s->thread_linebuf, &s->thread_linebuf_size,
+                   td.max_jobs * s->linebuf_len * sizeof(int32_t));
+    av_fast_malloc(&s->thread_ret, &s->thread_ret_size,
+                   td.max_jobs * sizeof(*s->thread_ret));
+    if (!s->thread_linebuf || !s->thread_ret)
+        return AVERROR(ENOMEM);
+
+    if (s->type == FF_DWT97_INT &&
+        (ret = dwt_execute(avctx, &td, DWT_STEP_PRESHIFT, 0)) < 0)
+        return ret;
+
+    if (encode) {
+        /* the float 9/7 transform does the rows first */
+        enum DWTStep first = s->type == FF_DWT97 ? DWT_STEP_HOR : DWT_STEP_VER;
+
+        for (lev = s->ndeclevels - 1; lev >= 0; lev--) {
+            if ((ret = dwt_execute(avctx, &td, first, lev)) < 0 ||
+                (ret = dwt_execute(avctx, &td, first == DWT_STEP_HOR ? DWT_STEP_VER
+                                                                     : DWT_STEP_HOR, lev)) < 0)
+                return ret;
+        }
+    } else {
+        for (lev = 0; lev < s->ndeclevels; lev++) {
+            if ((ret = dwt_execute(avctx, &td, DWT_STEP_HOR, lev)) < 0 ||
+                (ret = dwt_execute(avctx, &td, DWT_STEP_VER, lev)) < 0)
+                return ret;
+        }
+    }
+
+    if (s->type == FF_DWT97_INT &&
+        (ret = dwt_execute(avctx, &td, DWT_STEP_POSTSHIFT, 0)) < 0)
+        return ret;
 
-    for (i = 0; i < w * h; i++)
-        data[i] = (data[i] + ((1<<I_PRESHIFT)>>1)) >> I_PRESHIFT;
+    return 0;
 }
 
 int ff_jpeg2000_dwt_init(DWTContext *s, int border[2][2],
@@ -549,6 +753,7 @@ int ff_jpeg2000_dwt_init(DWTContext *s, int border[2][2],
 
     maxlen = FFMAX(b[0][1] - b[0][0],
                    b[1][1] - b[1][0]);
+    s->linebuf_len = maxlen + 12;
     while (--lev >= 0)
         for (i = 0; i < 2; i++) {
             s->linelen[lev][i] = b[i][1] - b[i][0];
@@ -617,10 +822,24 @@ int ff_dwt_decode(DWTContext *s, void *t)
     return 0;
 }
 
+int ff_dwt_encode_thread(DWTContext *s, void *t, AVCodecContext *avctx)
+{
+    return dwt_thread(s, t, 1, avctx);
+}
+
+int ff_dwt_decode_thread(DWTContext *s, void *t, AVCodecContext *avctx)
+{
+    return dwt_thread(s, t, 0, avctx);
+}
+
 void ff_dwt_destroy(DWTContext *s)
 {
     av_freep(&s->f_linebuf);
     av_freep(&s->i_linebuf);
+    av_freep(&s->thread_linebuf);
+    s->thread_linebuf_size = 0;
+    av_freep(&s->thread_ret);
+    s->thread_ret_size = 0;
 }
 
 #ifdef TEST
@@ -629,6 +848,10 @@ void ff_dwt_destroy(DWTContext *s)
 
 #define MAX_W 256
 
+static AVCodecContext *thread_ctx;
+static int   array_t [MAX_W * MAX_W];
+static float arrayf_t[MAX_W * MAX_W];
+
 static int test_dwt(int *array, int *ref, int border[2][2], int decomp_levels, int type, int max_diff) {
     int ret, j;
     DWTContext s1={{{0}}}, *s= &s1;
@@ -639,16 +862,27 @@ static int test_dwt(int *array, int *ref, int border[2][2], int decomp_levels, i
         fprintf(stderr, "ff_jpeg2000_dwt_init failed\n");
         return 1;
     }
+    memcpy(array_t, array, sizeof(array_t));
     ret = ff_dwt_encode(s, array);
     if (ret < 0) {
         fprintf(stderr, "ff_dwt_encode failed\n");
         return 1;
     }
+    ret = ff_dwt_encode_thread(s, array_t, thread_ctx);
+    if (ret < 0 || memcmp(array, array_t, sizeof(array_t))) {
+        fprintf(stderr, "ff_dwt_encode_thread mismatch\n");
+        return 1;
+    }
     ret = ff_dwt_decode(s, array);
     if (ret < 0) {
         fprintf(stderr, "ff_dwt_encode failed\n");
         return 1;
     }
+    ret = ff_dwt_decode_thread(s, array_t, thread_ctx);
+    if (ret < 0 || memcmp(array, array_t, sizeof(array_t))) {
+        fprintf(stderr, "ff_dwt_decode_thread mismatch\n");
+        return 1;
+    }
     for (j = 0; j<MAX_W * MAX_W; j++) {
         if (FFABS(array[j] - ref[j]) > max_diff) {
             fprintf(stderr, "missmatch at %d (%d != %d) decomp:%d border %d %d %d %d\n",
@@ -678,16 +912,27 @@ static int test_dwtf(float *array, float *ref, int border[2][2], int decomp_leve
         fprintf(stderr, "ff_jpeg2000_dwt_init failed\n");
         return 1;
     }
+    memcpy(arrayf_t, array, sizeof(arrayf_t));
     ret = ff_dwt_encode(s, array);
     if (ret < 0) {
         fprintf(stderr, "ff_dwt_encode failed\n");
         return 1;
     }
+    ret = ff_dwt_encode_thread(s, arrayf_t, thread_ctx);
+    if (ret < 0 || memcmp(array, arrayf_t, sizeof(arrayf_t))) {
+        fprintf(stderr, "ff_dwt_encode_thread mismatch\n");
+        return 1;
+    }
     ret = ff_dwt_decode(s, array);
     if (ret < 0) {
         fprintf(stderr, "ff_dwt_encode failed\n");
         return 1;
     }
+    ret = ff_dwt_decode_thread(s, arrayf_t, thread_ctx);
+    if (ret < 0 || memcmp(array, arrayf_t, sizeof(arrayf_t))) {
+        fprintf(stderr, "ff_dwt_decode_thread mismatch\n");
+        return 1;
+    }
     for (j = 0; j<MAX_W * MAX_W; j++) {
         if (FFABS(array[j] - ref[j]) > max_diff) {
             fprintf(stderr, "missmatch at %d (%f != %f) decomp:%d border %d %d %d %d\n",
@@ -719,6 +964,13 @@ int main(void) {
 
     av_lfg_init(&prng, 1);
 
+    /* split the passes into jobs, run serially by the default execute2() */
+    thread_ctx = avcodec_alloc_context3(NULL);
+    if (!thread_ctx)
+        return 1;
+    thread_ctx->thread_count       = 3;
+    thread_ctx->active_thread_type = FF_THREAD_SLICE;
+
     for (i = 0; i<MAX_W * MAX_W; i++)
         arrayf[i] = reff[i] = array[i] = ref[i] =  av_lfg_get(&prng) % 2048;
 
@@ -740,6 +992,8 @@ int main(void) {
             return ret;
     }
 
+    avcodec_free_context(&thread_ctx);
+
     return 0;
 }
 
@@ -29,6 +29,8 @@
 
 #include <stdint.h>
 
+#include "avcodec.h"
+
 #define FF_DWT_MAX_DECLVLS 32 ///< max number of decomposition levels
 #define F_LFTG_K      1.230174104914001f
 #define F_LFTG_X      0.812893066115961f
@@ -48,6 +50,11 @@ typedef struct DWTContext {
     uint8_t type;                        ///< 0 for 9/7; 1 for 5/3
     int32_t *i_linebuf;                  ///< int buffer used by transform
     float   *f_linebuf;                  ///< float buffer used by transform
+    int linebuf_len;                     ///< samples in one line buffer
+    void *thread_linebuf;                ///< line buffers of the threaded transform, one per job
+    unsigned int thread_linebuf_size;
+    int *thread_ret;                     ///< return values of the jobs of one pass
+    unsigned int thread_ret_size;
 } DWTContext;
 
 /**
@@ -63,6 +70,13 @@ int ff_jpeg2000_dwt_init(DWTContext *s, int border[2][2],
 int ff_dwt_encode(DWTContext *s, void *t);
 int ff_dwt_decode(DWTContext *s, void *t);
 
+/**
+ * Same as ff_dwt_encode() and ff_dwt_decode(), but split the lines of each
+ * pass between the slice threads of avctx. The output is identical.
+ */
+int ff_dwt_encode_thread(DWTContext *s, void *t, AVCodecContext *avctx);
+int ff_dwt_decode_thread(DWTContext *s, void *t, AVCodecContext *avctx);
+
 void ff_dwt_destroy(DWTContext *s);
 
 #endif /* AVCODEC_JPEG2000DWT_H */
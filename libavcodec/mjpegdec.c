@@ -30,6 +30,8 @@
  * MJPEG decoder.
  */
 
+#define CACHED_BITSTREAM_READER
+
 #include "libavutil/imgutils.h"
 #include "libavutil/avassert.h"
 #include "libavutil/opt.h"
@@ -43,6 +45,7 @@
 #include "mjpegdec.h"
 #include "jpeglsdec.h"
 #include "put_bits.h"
+#include "thread.h"
 #include "tiff.h"
 #include "exif.h"
 #include "bytestream.h"
@@ -71,20 +74,62 @@ static int build_vlc(VLC *vlc, const uint8_t *bits_table,
                               huff_code, 2, 2, huff_sym, 2, 2, use_static);
 }
 
+/* (re)build the VLCs of a huffman table from its raw DHT representation */
+static int init_huffman_vlc(MJpegDecodeContext *s, int class, int index)
+{
+    const uint8_t *bits_table = s->raw_huffman_bits[class][index];
+    const uint8_t *val_table  = s->raw_huffman_values[class][index];
+    int i, n = 0, code_max = 0, ret;
+
+    for (i = 1; i <= 16; i++)
+        n += bits_table[i];
+    for (i = 0; i < n; i++)
+        code_max = FFMAX(code_max, val_table[i]);
+
+    /* build VLC and flush previous vlc if present */
+    ff_free_vlc(&s->vlcs[class][index]);
+    if (class > 0)
+        ff_free_vlc(&s->vlcs[2][index]);
+    if (!n)
+        return 0;
+
+    av_log(s->avctx, AV_LOG_DEBUG, "class=%d index=%d nb_codes=%d\n",
+           class, index, code_max + 1);
+    if ((ret = build_vlc(&s->vlcs[class][index], bits_table, val_table,
+                         code_max + 1, 0, class > 0)) < 0)
+        return ret;
+
+    if (class > 0) {
+        if ((ret = build_vlc(&s->vlcs[2][index], bits_table, val_table,
+                             code_max + 1, 0, 0)) < 0)
+            return ret;
+    }
+    return 0;
+}
+
+static int set_huffman_table(MJpegDecodeContext *s, int class, int index,
+                             const uint8_t *bits_table, const uint8_t *val_table,
+                             int nb_values)
+{
+    memcpy(s->raw_huffman_bits[class][index], bits_table,
+           sizeof(s->raw_huffman_bits[class][index]));
+    memcpy(s->raw_huffman_values[class][index], val_table, nb_values);
+    memset(s->raw_huffman_values[class][index] + nb_values, 0,
+           sizeof(s->raw_huffman_values[class][index]) - nb_values);
+
+    return init_huffman_vlc(s, class, index);
+}
+
 static void build_basic_mjpeg_vlc(MJpegDecodeContext *s)
 {
-    build_vlc(&s->vlcs[0][0], avpriv_mjpeg_bits_dc_luminance,
-              avpriv_mjpeg_val_dc, 12, 0, 0);
-    build_vlc(&s->vlcs[0][1], avpriv_mjpeg_bits_dc_chrominance,
-              avpriv_mjpeg_val_dc, 12, 0, 0);
-    build_vlc(&s->vlcs[1][0], avpriv_mjpeg_bits_ac_luminance,
-              avpriv_mjpeg_val_ac_luminance, 251, 0, 1);
-    build_vlc(&s->vlcs[1][1], avpriv_mjpeg_bits_ac_chrominance,
-              avpriv_mjpeg_val_ac_chrominance, 251, 0, 1);
-    build_vlc(&s->vlcs[2][0], avpriv_mjpeg_bits_ac_luminance,
-              avpriv_mjpeg_val_ac_luminance, 251, 0, 0);
-    build_vlc(&s->vlcs[2][1], avpriv_mjpeg_bits_ac_chrominance,
-              avpriv_mjpeg_val_ac_chrominance, 251, 0, 0);
+    set_huffman_table(s, 0, 0, avpriv_mjpeg_bits_dc_luminance,
+                      avpriv_mjpeg_val_dc, 12);
+    set_huffman_table(s, 0, 1, avpriv_mjpeg_bits_dc_chrominance,
+                      avpriv_mjpeg_val_dc, 12);
+    set_huffman_table(s, 1, 0, avpriv_mjpeg_bits_ac_luminance,
+                      avpriv_mjpeg_val_ac_luminance, 162);
+    set_huffman_table(s, 1, 1, avpriv_mjpeg_bits_ac_chrominance,
+                      avpriv_mjpeg_val_ac_chrominance, 162);
 }
 
 static void parse_avid(MJpegDecodeContext *s, uint8_t *buf, int len)
@@ -125,6 +170,7 @@ av_cold int ff_mjpeg_decode_init(AVCodecContext *avctx)
     s->buffer_size   = 0;
     s->buffer        = NULL;
     s->start_code    = -1;
+    s->nb_rst        = -1;
     s->first_picture = 1;
     s->got_picture   = 0;
     s->org_height    = avctx->coded_height;
@@ -204,8 +250,8 @@ int ff_mjpeg_decode_dqt(MJpegDecodeContext *s)
 /* decode huffman tables and build VLC decoders */
 int ff_mjpeg_decode_dht(MJpegDecodeContext *s)
 {
-    int len, index, i, class, n, v, code_max;
-    uint8_t bits_table[17];
+    int len, index, i, class, n;
+    uint8_t bits_table[17] = { 0 };
     uint8_t val_table[256];
     int ret = 0;
 
@@ -234,29 +280,13 @@ int ff_mjpeg_decode_dht(MJpegDecodeContext *s)
         if (len < n || n > 256)
             return AVERROR_INVALIDDATA;
 
-        code_max = 0;
-        for (i = 0; i < n; i++) {
-            v = get_bits(&s->gb, 8);
-            if (v > code_max)
-                code_max = v;
-            val_table[i] = v;
-        }
+        for (i = 0; i < n; i++)
+            val_table[i] = get_bits(&s->gb, 8);
         len -= n;
 
-        /* build VLC and flush previous vlc if present */
-        ff_free_vlc(&s->vlcs[class][index]);
-        av_log(s->avctx, AV_LOG_DEBUG, "class=%d index=%d nb_codes=%d\n",
-               class, index, code_max + 1);
-        if ((ret = build_vlc(&s->vlcs[class][index], bits_table, val_table,
-                             code_max + 1, 0, class > 0)) < 0)
+        if ((ret = set_huffman_table(s, class, index, bits_table,
+                                     val_table, n)) < 0)
             return ret;
-
-        if (class > 0) {
-            ff_free_vlc(&s->vlcs[2][index]);
-            if ((ret = build_vlc(&s->vlcs[2][index], bits_table, val_table,
-                                 code_max + 1, 0, 0)) < 0)
-                return ret;
-        }
     }
     return 0;
 }
@@ -267,6 +297,7 @@ int ff_mjpeg_decode_sof(MJpegDecodeContext *s)
     unsigned pix_fmt_id;
     int h_count[MAX_COMPONENTS] = { 0 };
     int v_count[MAX_COMPONENTS] = { 0 };
+    ThreadFrame tframe = { 0 };
 
     s->cur_scan = 0;
     memset(s->upscale_h, 0, sizeof(s->upscale_h));
@@ -620,8 +651,9 @@ unk_pixfmt:
         return AVERROR_BUG;
     }
 
-    av_frame_unref(s->picture_ptr);
-    if (ff_get_buffer(s->avctx, s->picture_ptr, AV_GET_BUFFER_FLAG_REF) < 0)
+    tframe.f = s->picture_ptr;
+    ff_thread_release_buffer(s->avctx, &tframe);
+    if (ff_thread_get_buffer(s->avctx, &tframe, AV_GET_BUFFER_FLAG_REF) < 0)
         return -1;
     s->picture_ptr->pict_type = AV_PICTURE_TYPE_I;
     s->picture_ptr->key_frame = 1;
@@ -1258,27 +1290,17 @@ static void shift_output(MJpegDecodeContext *s, uint8_t *ptr, int linesize)
     }
 }
 
-static int mjpeg_decode_scan(MJpegDecodeContext *s, int nb_components, int Ah,
-                             int Al, const uint8_t *mb_bitmask,
-                             int mb_bitmask_size,
-                             const AVFrame *reference)
+static int decode_scan_mcus(MJpegDecodeContext *s, int nb_components, int Ah,
+                            int Al, int mcu_start, int mcu_end,
+                            GetBitContext *mb_bitmask_gb,
+                            const AVFrame *reference)
 {
     int i, mb_x, mb_y, chroma_h_shift, chroma_v_shift, chroma_width, chroma_height;
     uint8_t *data[MAX_COMPONENTS];
     const uint8_t *reference_data[MAX_COMPONENTS];
     int linesize[MAX_COMPONENTS];
-    GetBitContext mb_bitmask_gb = {0}; // initialize to silence gcc warning
     int bytes_per_pixel = 1 + (s->bits > 8);
-
-    if (mb_bitmask) {
-        if (mb_bitmask_size != (s->mb_width * s->mb_height + 7)>>3) {
-            av_log(s->avctx, AV_LOG_ERROR, "mb_bitmask_size mismatches\n");
-            return AVERROR_INVALIDDATA;
-        }
-        init_get_bits(&mb_bitmask_gb, mb_bitmask, s->mb_width * s->mb_height);
-    }
-
-    s->restart_count = 0;
+    int left = mcu_end - mcu_start;
 
     av_pix_fmt_get_chroma_sub_sample(s->avctx->pix_fmt, &chroma_h_shift,
                                      &chroma_v_shift);
@@ -1290,13 +1312,12 @@ static int mjpeg_decode_scan(MJpegDecodeContext *s, int nb_components, int Ah,
         data[c] = s->picture_ptr->data[c];
         reference_data[c] = reference ? reference->data[c] : NULL;
         linesize[c] = s->linesize[c];
-        s->coefs_finished[c] |= 1;
     }
 
-    for (mb_y = 0; mb_y < s->mb_height; mb_y++) {
-        for (mb_x = 0; mb_x < s->mb_width; mb_x++) {
-            const int copy_mb = mb_bitmask && !get_bits1(&mb_bitmask_gb);
-
+    mb_x = mcu_start % s->mb_width;
+    for (mb_y = mcu_start / s->mb_width; mb_y < s->mb_height && left > 0; mb_y++) {
+        for (; mb_x < s->mb_width && left > 0; mb_x++, left--) {
+            const int copy_mb = mb_bitmask_gb && !get_bits1(mb_bitmask_gb);
             if (s->restart_interval && !s->restart_count)
                 s->restart_count = s->restart_interval;
 
@@ -1375,10 +1396,134 @@ static int mjpeg_decode_scan(MJpegDecodeContext *s, int nb_components, int Ah,
 
             handle_rstn(s, nb_components);
         }
+        mb_x = 0;
     }
     return 0;
 }
 
+/*
+ * Restart intervals are independently decodable, as the DC predictors are
+ * reset at each RSTn. When the scan was unescaped, the position following
+ * each RSTn marker was recorded, so each job can decode a run of intervals
+ * from its own copy of the context.
+ */
+#define MAX_SCAN_SLICES 32
+
+typedef struct ScanSliceArg {
+    int nb_components, Ah, Al;
+    int nb_intervals, nb_jobs;
+    int start_bit;
+} ScanSliceArg;
+
+static int decode_scan_slice(AVCodecContext *avctx, void *arg, int jobnr,
+                             int threadnr)
+{
+    MJpegDecodeContext *s  = avctx->priv_data;
+    MJpegDecodeContext *sc = &s->slice_ctx[jobnr];
+    const ScanSliceArg *sa = arg;
+    int nb_mcus  = s->mb_width * s->mb_height;
+    int first    = sa->nb_intervals *  jobnr      / sa->nb_jobs;
+    int last     = sa->nb_intervals * (jobnr + 1) / sa->nb_jobs;
+    int i;
+
+    memcpy(sc, s, sizeof(*sc));
+    if (first)
+        skip_bits_long(&sc->gb, s->rst_offsets[first - 1] * 8 -
+                                get_bits_count(&sc->gb));
+    else
+        skip_bits_long(&sc->gb, sa->start_bit - get_bits_count(&sc->gb));
+    for (i = 0; i < sa->nb_components; i++)
+        sc->last_dc[i] = (4 << sc->bits);
+    sc->restart_count = 0;
+
+    return decode_scan_mcus(sc, sa->nb_components, sa->Ah, sa->Al,
+                            first * s->restart_interval,
+                            FFMIN(last * s->restart_interval, nb_mcus),
+                            NULL, NULL);
+}
+
+static int decode_scan_slices(MJpegDecodeContext *s, int nb_components,
+                              int Ah, int Al)
+{
+    AVCodecContext *avctx = s->avctx;
+    ScanSliceArg sa = { nb_components, Ah, Al };
+    int nb_mcus = s->mb_width * s->mb_height;
+    int i, nb_jobs, ret[MAX_SCAN_SLICES];
+
+    sa.nb_intervals = (nb_mcus + s->restart_interval - 1) / s->restart_interval;
+    sa.start_bit    = get_bits_count(&s->gb);
+    sa.nb_jobs      = nb_jobs = FFMIN3(avctx->thread_count, sa.nb_intervals,
+                                       MAX_SCAN_SLICES);
+
+    av_fast_malloc(&s->slice_ctx, &s->slice_ctx_size,
+                   nb_jobs * sizeof(*s->slice_ctx));
+    if (!s->slice_ctx)
+        return AVERROR(ENOMEM);
+
+    avctx->execute2(avctx, decode_scan_slice, &sa, ret, nb_jobs);
+
+    /* continue parsing after the data of the last interval */
+    s->gb = s->slice_ctx[nb_jobs - 1].gb;
+    for (i = 0; i < nb_jobs; i++)
+        if (ret[i] < 0)
+            return ret[i];
+    return 0;
+}
+
+/*
+ * Check that the scan has one RSTn, in order, between each pair of intervals.
+ * Some encoders also write one after the last interval.
+ */
+static int can_decode_scan_slices(MJpegDecodeContext *s)
+{
+    int nb_intervals, i;
+
+    if (!(s->avctx->active_thread_type & FF_THREAD_SLICE) ||
+        !s->restart_interval || s->progressive ||
+        s->gb.buffer != s->buffer)
+        return 0;
+
+    nb_intervals = (s->mb_width * s->mb_height + s->restart_interval - 1) /
+                   s->restart_interval;
+    if (nb_intervals < 2 || s->nb_rst < nb_intervals - 1 ||
+        s->nb_rst > nb_intervals)
+        return 0;
+
+    for (i = 0; i < nb_intervals - 1; i++)
+        if ((s->buffer[s->rst_offsets[i] - 1] & 7) != (i & 7))
+            return 0;
+    return 1;
+}
+
+static int mjpeg_decode_scan(MJpegDecodeContext *s, int nb_components, int Ah,
+                             int Al, const uint8_t *mb_bitmask,
+                             int mb_bitmask_size,
+                             const AVFrame *reference)
+{
+    int i;
+    GetBitContext mb_bitmask_gb = {0}; // initialize to silence gcc warning
+
+    if (mb_bitmask) {
+        if (mb_bitmask_size != (s->mb_width * s->mb_height + 7)>>3) {
+            av_log(s->avctx, AV_LOG_ERROR, "mb_bitmask_size mismatches\n");
+            return AVERROR_INVALIDDATA;
+        }
+        init_get_bits(&mb_bitmask_gb, mb_bitmask, s->mb_width * s->mb_height);
+    }
+
+    s->restart_count = 0;
+
+    for (i = 0; i < nb_components; i++)
+        s->coefs_finished[s->comp_index[i]] |= 1;
+
+    if (!mb_bitmask && can_decode_scan_slices(s))
+        return decode_scan_slices(s, nb_components, Ah, Al);
+
+    return decode_scan_mcus(s, nb_components, Ah, Al,
+                            0, s->mb_width * s->mb_height,
+                            mb_bitmask ? &mb_bitmask_gb : NULL, reference);
+}
+
 static int mjpeg_decode_scan_progressive_ac(MJpegDecodeContext *s, int ss,
                                             int se, int Ah, int Al)
 {
@@ -1949,6 +2094,22 @@ found:
     return val;
 }
 
+static void add_rst_offset(MJpegDecodeContext *s, int offset)
+{
+    int *tmp;
+
+    if (s->nb_rst < 0)
+        return;
+    tmp = av_fast_realloc(s->rst_offsets, &s->rst_offsets_size,
+                          (s->nb_rst + 1) * sizeof(*s->rst_offsets));
+    if (!tmp) {
+        s->nb_rst = -1;
+        return;
+    }
+    s->rst_offsets = tmp;
+    s->rst_offsets[s->nb_rst++] = offset;
+}
+
 int ff_mjpeg_find_marker(MJpegDecodeContext *s,
                          const uint8_t **buf_ptr, const uint8_t *buf_end,
                          const uint8_t **unescaped_buf_ptr,
@@ -1965,7 +2126,9 @@ int ff_mjpeg_find_marker(MJpegDecodeContext *s,
     if (start_code == SOS && !s->ls) {
         const uint8_t *src = *buf_ptr;
         uint8_t *dst = s->buffer;
+        int record_rst = s->avctx->active_thread_type & FF_THREAD_SLICE;
 
+        s->nb_rst = record_rst ? 0 : -1;
         while (src < buf_end) {
             uint8_t x = *(src++);
 
@@ -1975,9 +2138,11 @@ int ff_mjpeg_find_marker(MJpegDecodeContext *s,
                     while (src < buf_end && x == 0xff)
                         x = *(src++);
 
-                    if (x >= 0xd0 && x <= 0xd7)
+                    if (x >= 0xd0 && x <= 0xd7) {
                         *(dst++) = x;
-                    else if (x)
+                        if (record_rst)
+                            add_rst_offset(s, dst - s->buffer);
+                    } else if (x)
                         break;
                 }
             }
@@ -2039,6 +2204,23 @@ int ff_mjpeg_find_marker(MJpegDecodeContext *s,
     return start_code;
 }
 
+/*
+ * With frame threading, the next frame can start once the state it inherits
+ * is final. This is the case at the first SOS if the rest of the packet only
+ * holds entropy coded data, RSTn and EOI; otherwise the setup is finished
+ * when the packet has been decoded.
+ */
+static int only_scan_data_left(const uint8_t *buf_ptr, const uint8_t *buf_end)
+{
+    int start_code;
+
+    do {
+        start_code = find_marker(&buf_ptr, buf_end);
+    } while (start_code >= RST0 && start_code <= RST7);
+
+    return start_code < 0 || start_code == EOI;
+}
+
 int ff_mjpeg_decode_frame(AVCodecContext *avctx, void *data, int *got_frame,
                           AVPacket *avpkt)
 {
@@ -2200,6 +2382,10 @@ eoi_parser:
             goto the_end;
         case SOS:
             s->cur_scan++;
+            if (avctx->active_thread_type & FF_THREAD_FRAME &&
+                s->cur_scan == 1 && !s->interlaced &&
+                only_scan_data_left(buf_ptr, buf_end))
+                ff_thread_finish_setup(avctx);
             if ((ret = ff_mjpeg_decode_sos(s, NULL, 0, NULL)) < 0 &&
                 (avctx->err_recognition & AV_EF_EXPLODE))
                 goto fail;
@@ -2440,6 +2626,8 @@ av_cold int ff_mjpeg_decode_end(AVCodecContext *avctx)
         av_frame_unref(s->picture_ptr);
 
     av_freep(&s->buffer);
+    av_freep(&s->rst_offsets);
+    av_freep(&s->slice_ctx);
     av_freep(&s->stereo3d);
     av_freep(&s->ljpeg_buffer);
     s->ljpeg_buffer_size = 0;
@@ -2456,6 +2644,108 @@ av_cold int ff_mjpeg_decode_end(AVCodecContext *avctx)
     return 0;
 }
 
+static av_cold int decode_init_thread_copy(AVCodecContext *avctx)
+{
+    MJpegDecodeContext *s = avctx->priv_data;
+    int class, index, ret;
+
+    s->avctx         = avctx;
+    s->picture       = av_frame_alloc();
+    if (!s->picture)
+        return AVERROR(ENOMEM);
+    s->picture_ptr   = s->picture;
+    s->buffer        = NULL;
+    s->buffer_size   = 0;
+    s->rst_offsets   = NULL;
+    s->rst_offsets_size = 0;
+    s->slice_ctx     = NULL;
+    s->slice_ctx_size = 0;
+    s->ljpeg_buffer  = NULL;
+    s->ljpeg_buffer_size = 0;
+    s->exif_metadata = NULL;
+    s->stereo3d      = NULL;
+    memset(s->blocks,   0, sizeof(s->blocks));
+    memset(s->last_nnz, 0, sizeof(s->last_nnz));
+
+    /* the VLC tables are owned by the context the copy was made from */
+    memset(s->vlcs, 0, sizeof(s->vlcs));
+    for (class = 0; class < 2; class++)
+        for (index = 0; index < 4; index++)
+            if ((ret = init_huffman_vlc(s, class, index)) < 0)
+                return ret;
+
+    return 0;
+}
+
+/*
+ * Carry over the state a JPEG frame can inherit from the previous one: the
+ * quantization and huffman tables, and the picture geometry used to detect
+ * interlaced MJPEG.
+ */
+static int decode_update_thread_context(AVCodecContext *dst,
+                                        const AVCodecContext *src)
+{
+    MJpegDecodeContext *s = dst->priv_data, *s1 = src->priv_data;
+    int class, index, ret;
+
+    if (dst == src)
+        return 0;
+
+    for (class = 0; class < 2; class++) {
+        for (index = 0; index < 4; index++) {
+            if (!memcmp(s->raw_huffman_bits[class][index],
+                        s1->raw_huffman_bits[class][index],
+                        sizeof(s->raw_huffman_bits[class][index])) &&
+                !memcmp(s->raw_huffman_values[class][index],
+                        s1->raw_huffman_values[class][index],
+                        sizeof(s->raw_huffman_values[class][index])))
+                continue;
+            memcpy(s->raw_huffman_bits[class][index],
+                   s1->raw_huffman_bits[class][index],
+                   sizeof(s->raw_huffman_bits[class][index]));
+            memcpy(s->raw_huffman_values[class][index],
+                   s1->raw_huffman_values[class][index],
+                   sizeof(s->raw_huffman_values[class][index]));
+            if ((ret = init_huffman_vlc(s, class, index)) < 0)
+                return ret;
+        }
+    }
+
+    memcpy(s->quant_matrixes, s1->quant_matrixes, sizeof(s->quant_matrixes));
+    memcpy(s->qscale,         s1->qscale,         sizeof(s->qscale));
+    memcpy(s->h_count,        s1->h_count,        sizeof(s->h_count));
+    memcpy(s->v_count,        s1->v_count,        sizeof(s->v_count));
+    s->width              = s1->width;
+    s->height             = s1->height;
+    s->bits               = s1->bits;
+    s->first_picture      = s1->first_picture;
+    s->interlaced         = s1->interlaced;
+    s->bottom_field       = s1->bottom_field;
+    s->interlace_polarity = s1->interlace_polarity;
+    s->buggy_avid         = s1->buggy_avid;
+    s->cs_itu601          = s1->cs_itu601;
+    s->multiscope         = s1->multiscope;
+    s->pegasus_rct        = s1->pegasus_rct;
+    s->colr               = s1->colr;
+    s->xfrm               = s1->xfrm;
+
+    /* the other field of an interlaced picture is in this packet */
+    s->got_picture = 0;
+    if (s1->got_picture && s1->interlaced &&
+        s1->bottom_field == !s1->interlace_polarity) {
+        av_frame_unref(s->picture_ptr);
+        if ((ret = av_frame_ref(s->picture_ptr, s1->picture_ptr)) < 0)
+            return ret;
+        memcpy(s->linesize, s1->linesize, sizeof(s->linesize));
+        s->nb_components = s1->nb_components;
+        s->rgb         = s1->rgb;
+        s->pix_desc    = s1->pix_desc;
+        s->got_picture = 1;
+    }
+
+    return 0;
+}
+
 static void decode_flush(AVCodecContext *avctx)
 {
     MJpegDecodeContext *s = avctx->priv_data;
@@ -2488,7 +2778,10 @@ AVCodec ff_mjpeg_decoder = {
     .close          = ff_mjpeg_decode_end,
     .decode         = ff_mjpeg_decode_frame,
     .flush          = decode_flush,
-    .capabilities   = AV_CODEC_CAP_DR1,
+    .init_thread_copy      = ONLY_IF_THREADS_ENABLED(decode_init_thread_copy),
+    .update_thread_context = ONLY_IF_THREADS_ENABLED(decode_update_thread_context),
+    .capabilities   = AV_CODEC_CAP_DR1 | AV_CODEC_CAP_FRAME_THREADS |
+                      AV_CODEC_CAP_SLICE_THREADS,
     .max_lowres     = 3,
     .priv_class     = &mjpegdec_class,
     .caps_internal  = FF_CODEC_CAP_INIT_THREADSAFE,
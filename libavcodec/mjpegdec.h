@@ -53,6 +53,8 @@ typedef struct MJpegDecodeContext {
 
     int16_t quant_matrixes[4][64];
     VLC vlcs[3][4];
+    uint8_t raw_huffman_bits[2][4][17];   ///< DHT code counts, [1..16] as in the bitstream
+    uint8_t raw_huffman_values[2][4][256];
     int qscale[4];      ///< quantizer scale calculated from quant_matrixes
 
     int org_height;  /* size given at codec init */
@@ -112,6 +114,12 @@ typedef struct MJpegDecodeContext {
     int restart_interval;
     int restart_count;
 
+    int *rst_offsets;   ///< byte offsets of the data following each RSTn in the unescaped scan
+    unsigned int rst_offsets_size;
+    int nb_rst;         ///< number of RSTn markers in the scan, -1 if unknown
+    struct MJpegDecodeContext *slice_ctx; ///< per job contexts for slice threading
+    unsigned int slice_ctx_size;
+
     int buggy_avid;
     int cs_itu601;
     int interlace_polarity;
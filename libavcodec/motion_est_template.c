@@ -629,7 +629,31 @@ static int full_search(MpegEncContext * s, int *best, int dmin,
     chroma_cmpf = s->mecc.me_cmp[size + 1];
 
     for(y=FFMAX(-dia_size, ymin); y<=FFMIN(dia_size,ymax); y++){
-        for(x=FFMAX(-dia_size, xmin); x<=FFMIN(dia_size,xmax); x++){
+        x= FFMAX(-dia_size, xmin);
+        if(flags==0 && size==0 && h==16 && cmpf == s->mecc.sad[0]){
+            /* plain luma SAD, score 4 horizontal neighbours at once */
+            const int stride= c->stride;
+            uint8_t *src= c->src[src_index][0];
+            uint8_t *ref= c->ref[ref_index][0] + y*stride;
+
+            for(; x+3<=FFMIN(dia_size,xmax); x+=4){
+                uint8_t *const cand[4]= { ref+x, ref+x+1, ref+x+2, ref+x+3 };
+                int scores[4], i;
+
+                s->mecc.sad_x4[0](s, src, cand, stride, 16, scores);
+                for(i=0; i<4; i++){
+                    const unsigned key = ((unsigned)y<<ME_MAP_MV_BITS) + x+i + map_generation;
+                    const int index= (((unsigned)y<<ME_MAP_SHIFT) + x+i)&(ME_MAP_SIZE-1);
+                    if(map[index]!=key){
+                        map[index]= key;
+                        score_map[index]= d= scores[i];
+                        d += (mv_penalty[((x+i)*(1<<shift))-pred_x] + mv_penalty[(y*(1<<shift))-pred_y])*penalty_factor;
+                        COPY3_IF_LT(dmin, d, best[0], x+i, best[1], y)
+                    }
+                }
+            }
+        }
+        for(; x<=FFMIN(dia_size,xmax); x++){
             CHECK_MV(x, y);
         }
     }
@@ -46,9 +46,13 @@ AVCodec ff_mp1_decoder = {
     .id             = AV_CODEC_ID_MP1,
     .priv_data_size = sizeof(MPADecodeContext),
     .init           = decode_init,
+    .close          = decode_close,
     .decode         = decode_frame,
-    .capabilities   = AV_CODEC_CAP_DR1,
+    .capabilities   = AV_CODEC_CAP_DR1 | AV_CODEC_CAP_FRAME_THREADS,
+    .caps_internal  = FF_CODEC_CAP_FRAME_THREADS_OPT_IN,
     .flush          = flush,
+    .init_thread_copy      = ONLY_IF_THREADS_ENABLED(decode_init),
+    .update_thread_context = ONLY_IF_THREADS_ENABLED(update_thread_context),
     .sample_fmts    = (const enum AVSampleFormat[]) { AV_SAMPLE_FMT_S16P,
                                                       AV_SAMPLE_FMT_S16,
                                                       AV_SAMPLE_FMT_NONE },
@@ -62,9 +66,13 @@ AVCodec ff_mp2_decoder = {
     .id             = AV_CODEC_ID_MP2,
     .priv_data_size = sizeof(MPADecodeContext),
     .init           = decode_init,
+    .close          = decode_close,
     .decode         = decode_frame,
-    .capabilities   = AV_CODEC_CAP_DR1,
+    .capabilities   = AV_CODEC_CAP_DR1 | AV_CODEC_CAP_FRAME_THREADS,
+    .caps_internal  = FF_CODEC_CAP_FRAME_THREADS_OPT_IN,
     .flush          = flush,
+    .init_thread_copy      = ONLY_IF_THREADS_ENABLED(decode_init),
+    .update_thread_context = ONLY_IF_THREADS_ENABLED(update_thread_context),
     .sample_fmts    = (const enum AVSampleFormat[]) { AV_SAMPLE_FMT_S16P,
                                                       AV_SAMPLE_FMT_S16,
                                                       AV_SAMPLE_FMT_NONE },
@@ -78,9 +86,13 @@ AVCodec ff_mp3_decoder = {
     .id             = AV_CODEC_ID_MP3,
     .priv_data_size = sizeof(MPADecodeContext),
     .init           = decode_init,
+    .close          = decode_close,
     .decode         = decode_frame,
-    .capabilities   = AV_CODEC_CAP_DR1,
+    .capabilities   = AV_CODEC_CAP_DR1 | AV_CODEC_CAP_FRAME_THREADS,
+    .caps_internal  = FF_CODEC_CAP_FRAME_THREADS_OPT_IN,
     .flush          = flush,
+    .init_thread_copy      = ONLY_IF_THREADS_ENABLED(decode_init),
+    .update_thread_context = ONLY_IF_THREADS_ENABLED(update_thread_context),
     .sample_fmts    = (const enum AVSampleFormat[]) { AV_SAMPLE_FMT_S16P,
                                                       AV_SAMPLE_FMT_S16,
                                                       AV_SAMPLE_FMT_NONE },
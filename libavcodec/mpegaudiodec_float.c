@@ -48,8 +48,11 @@ AVCodec ff_mp1float_decoder = {
     .init           = decode_init,
     .close          = decode_close,
     .decode         = decode_frame,
-    .capabilities   = AV_CODEC_CAP_DR1,
+    .capabilities   = AV_CODEC_CAP_DR1 | AV_CODEC_CAP_FRAME_THREADS,
+    .caps_internal  = FF_CODEC_CAP_FRAME_THREADS_OPT_IN,
     .flush          = flush,
+    .init_thread_copy      = ONLY_IF_THREADS_ENABLED(decode_init),
+    .update_thread_context = ONLY_IF_THREADS_ENABLED(update_thread_context),
     .sample_fmts    = (const enum AVSampleFormat[]) { AV_SAMPLE_FMT_FLTP,
                                                       AV_SAMPLE_FMT_FLT,
                                                       AV_SAMPLE_FMT_NONE },
@@ -65,8 +68,11 @@ AVCodec ff_mp2float_decoder = {
     .init           = decode_init,
     .decode         = decode_frame,
     .close          = decode_close,
-    .capabilities   = AV_CODEC_CAP_DR1,
+    .capabilities   = AV_CODEC_CAP_DR1 | AV_CODEC_CAP_FRAME_THREADS,
+    .caps_internal  = FF_CODEC_CAP_FRAME_THREADS_OPT_IN,
     .flush          = flush,
+    .init_thread_copy      = ONLY_IF_THREADS_ENABLED(decode_init),
+    .update_thread_context = ONLY_IF_THREADS_ENABLED(update_thread_context),
     .sample_fmts    = (const enum AVSampleFormat[]) { AV_SAMPLE_FMT_FLTP,
                                                       AV_SAMPLE_FMT_FLT,
                                                       AV_SAMPLE_FMT_NONE },
@@ -82,8 +88,11 @@ AVCodec ff_mp3float_decoder = {
     .init           = decode_init,
     .close          = decode_close,
     .decode         = decode_frame,
-    .capabilities   = AV_CODEC_CAP_DR1,
+    .capabilities   = AV_CODEC_CAP_DR1 | AV_CODEC_CAP_FRAME_THREADS,
+    .caps_internal  = FF_CODEC_CAP_FRAME_THREADS_OPT_IN,
     .flush          = flush,
+    .init_thread_copy      = ONLY_IF_THREADS_ENABLED(decode_init),
+    .update_thread_context = ONLY_IF_THREADS_ENABLED(update_thread_context),
     .sample_fmts    = (const enum AVSampleFormat[]) { AV_SAMPLE_FMT_FLTP,
                                                       AV_SAMPLE_FMT_FLT,
                                                       AV_SAMPLE_FMT_NONE },
@@ -34,6 +34,7 @@
 #include "internal.h"
 #include "mathops.h"
 #include "mpegaudiodsp.h"
+#include "thread.h"
 
 /*
  * TODO:
@@ -87,8 +88,26 @@ typedef struct MPADecodeContext {
     MPADSPContext mpadsp;
     AVFloatDSPContext *fdsp;
     AVFrame *frame;
+
+    /* frame threading, the state carried from one packet to the next is
+       passed on in state_buf once progress is reported on cur_frame */
+    ThreadFrame cur_frame;
+    ThreadFrame prev_frame;
+    AVBufferRef *state_buf;
+    AVBufferRef *prev_state_buf;
+    int state_loaded;
 } MPADecodeContext;
 
+/* state handed over between frame threads */
+typedef struct MPADecodeState {
+    uint8_t last_buf[LAST_BUF_SIZE];
+    int last_buf_size;
+    MPA_INT synth_buf[MPA_MAX_CHANNELS][512 * 2];
+    int synth_buf_offset[MPA_MAX_CHANNELS];
+    INTFLOAT mdct_buf[MPA_MAX_CHANNELS][SBLIMIT * 18];
+    int dither_state;
+} MPADecodeState;
+
 #define HEADER_SIZE 4
 
 #include "mpegaudiodata.h"
@@ -406,15 +425,20 @@ static av_cold void decode_init_static(void)
     }
 }
 
-#if USE_FLOATS
 static av_cold int decode_close(AVCodecContext * avctx)
 {
     MPADecodeContext *s = avctx->priv_data;
     av_freep(&s->fdsp);
 
+    ff_thread_release_buffer(avctx, &s->cur_frame);
+    ff_thread_release_buffer(avctx, &s->prev_frame);
+    av_frame_free(&s->cur_frame.f);
+    av_frame_free(&s->prev_frame.f);
+    av_buffer_unref(&s->state_buf);
+    av_buffer_unref(&s->prev_state_buf);
+
     return 0;
 }
-#endif
 
 static av_cold int decode_init(AVCodecContext * avctx)
 {
@@ -446,6 +470,18 @@ static av_cold int decode_init(AVCodecContext * avctx)
     if (avctx->codec_id == AV_CODEC_ID_MP3ADU)
         s->adu_mode = 1;
 
+    s->cur_frame.f      = NULL;
+    s->prev_frame.f     = NULL;
+    s->state_buf        = NULL;
+    s->prev_state_buf   = NULL;
+    if (avctx->active_thread_type & FF_THREAD_FRAME) {
+        s->cur_frame.f  = av_frame_alloc();
+        s->prev_frame.f = av_frame_alloc();
+        if (!s->cur_frame.f || !s->prev_frame.f)
+            return AVERROR(ENOMEM);
+        avctx->internal->allocate_progress = 1;
+    }
+
     return 0;
 }
 
@@ -1560,6 +1596,52 @@ static int mp_decode_layer3(MPADecodeContext *s)
     return nb_granules * 18;
 }
 
+static void mp_flush(MPADecodeContext *ctx)
+{
+    memset(ctx->synth_buf, 0, sizeof(ctx->synth_buf));
+    memset(ctx->mdct_buf, 0, sizeof(ctx->mdct_buf));
+    ctx->last_buf_size = 0;
+    ctx->dither_state = 0;
+}
+
+/**
+ * Wait for the previous frame thread and take over the decoder state it
+ * left. Does nothing without frame threading or if already done for the
+ * current packet.
+ */
+static void load_prev_state(MPADecodeContext *s)
+{
+    if (!s->state_buf || s->state_loaded)
+        return;
+
+    ff_thread_await_progress(&s->prev_frame, 1, 0);
+    if (s->prev_state_buf) {
+        const MPADecodeState *st = (const MPADecodeState *)s->prev_state_buf->data;
+        memcpy(s->last_buf, st->last_buf, st->last_buf_size);
+        s->last_buf_size = st->last_buf_size;
+        memcpy(s->synth_buf, st->synth_buf, sizeof(s->synth_buf));
+        memcpy(s->synth_buf_offset, st->synth_buf_offset, sizeof(s->synth_buf_offset));
+        memcpy(s->mdct_buf, st->mdct_buf, sizeof(s->mdct_buf));
+        s->dither_state = st->dither_state;
+    } else {
+        mp_flush(s);
+        memset(s->synth_buf_offset, 0, sizeof(s->synth_buf_offset));
+    }
+    s->state_loaded = 1;
+}
+
+static void store_state(MPADecodeContext *s)
+{
+    MPADecodeState *st = (MPADecodeState *)s->state_buf->data;
+
+    memcpy(st->last_buf, s->last_buf, s->last_buf_size);
+    st->last_buf_size = s->last_buf_size;
+    memcpy(st->synth_buf, s->synth_buf, sizeof(s->synth_buf));
+    memcpy(st->synth_buf_offset, s->synth_buf_offset, sizeof(s->synth_buf_offset));
+    memcpy(st->mdct_buf, s->mdct_buf, sizeof(s->mdct_buf));
+    st->dither_state = s->dither_state;
+}
+
 static int mp_decode_frame(MPADecodeContext *s, OUT_INT **samples,
                            const uint8_t *buf, int buf_size)
 {
@@ -1584,6 +1666,9 @@ static int mp_decode_frame(MPADecodeContext *s, OUT_INT **samples,
     case 3:
         s->avctx->frame_size = s->lsf ? 576 : 1152;
     default:
+        /* the bit reservoir and the MDCT overlap make all of layer 3
+           depend on the previous frame */
+        load_prev_state(s);
         nb_frames = mp_decode_layer3(s);
 
         s->last_buf_size=0;
@@ -1619,13 +1704,16 @@ static int mp_decode_frame(MPADecodeContext *s, OUT_INT **samples,
     /* get output buffer */
     if (!samples) {
         av_assert0(s->frame);
-        s->frame->nb_samples = s->avctx->frame_size;
-        if ((ret = ff_get_buffer(s->avctx, s->frame, 0)) < 0)
-            return ret;
+        if (!s->frame->buf[0]) {
+            s->frame->nb_samples = s->avctx->frame_size;
+            if ((ret = ff_get_buffer(s->avctx, s->frame, 0)) < 0)
+                return ret;
+        }
         samples = (OUT_INT **)s->frame->extended_data;
     }
 
     /* apply the synthesis filter */
+    load_prev_state(s);
     for (ch = 0; ch < s->nb_channels; ch++) {
         int sample_stride;
         if (s->avctx->sample_fmt == OUT_FMT_P) {
@@ -1648,6 +1736,61 @@ static int mp_decode_frame(MPADecodeContext *s, OUT_INT **samples,
     return nb_frames * 32 * sizeof(OUT_INT) * s->nb_channels;
 }
 
+/**
+ * Get the output buffer of a frame thread before setup is finished.
+ */
+static int thread_get_buffer(MPADecodeContext *s)
+{
+    int ret;
+
+    s->state_buf = av_buffer_alloc(sizeof(MPADecodeState));
+    if (!s->state_buf)
+        return AVERROR(ENOMEM);
+
+    s->avctx->frame_size = s->layer == 1 ? 384 :
+                           s->layer == 2 || !s->lsf ? 1152 : 576;
+    s->cur_frame.f->nb_samples = s->avctx->frame_size;
+    if ((ret = ff_thread_get_buffer(s->avctx, &s->cur_frame, 0)) < 0) {
+        av_buffer_unref(&s->state_buf);
+        return ret;
+    }
+    ff_thread_finish_setup(s->avctx);
+    s->frame = s->cur_frame.f;
+
+    return 0;
+}
+
+static int update_thread_context(AVCodecContext *dst, const AVCodecContext *src)
+{
+    MPADecodeContext *s = dst->priv_data, *s1 = src->priv_data;
+    ThreadFrame *prev_frame;
+    AVBufferRef *prev_state;
+    int ret;
+
+    if (dst == src)
+        return 0;
+
+    /* a packet rejected before getting a buffer leaves the state
+       untouched, so pass on the one it was given */
+    if (s1->state_buf) {
+        prev_frame = &s1->cur_frame;
+        prev_state = s1->state_buf;
+    } else {
+        prev_frame = &s1->prev_frame;
+        prev_state = s1->prev_state_buf;
+    }
+
+    ff_thread_release_buffer(dst, &s->prev_frame);
+    av_buffer_unref(&s->prev_state_buf);
+    if (prev_frame->f->buf[0] &&
+        (ret = ff_thread_ref_frame(&s->prev_frame, prev_frame)) < 0)
+        return ret;
+    if (prev_state && !(s->prev_state_buf = av_buffer_ref(prev_state)))
+        return AVERROR(ENOMEM);
+
+    return 0;
+}
+
 static int decode_frame(AVCodecContext * avctx, void *data, int *got_frame_ptr,
                         AVPacket *avpkt)
 {
@@ -1658,6 +1801,12 @@ static int decode_frame(AVCodecContext * avctx, void *data, int *got_frame_ptr,
     int ret;
 
     int skipped = 0;
+
+    if (avctx->active_thread_type & FF_THREAD_FRAME) {
+        ff_thread_release_buffer(avctx, &s->cur_frame);
+        av_buffer_unref(&s->state_buf);
+        s->state_loaded = 0;
+    }
     while(buf_size && !*buf){
         buf++;
         buf_size--;
@@ -1696,11 +1845,26 @@ static int decode_frame(AVCodecContext * avctx, void *data, int *got_frame_ptr,
         buf_size= s->frame_size;
     }
 
-    s->frame = data;
-
-    ret = mp_decode_frame(s, NULL, buf, buf_size);
+    if (avctx->active_thread_type & FF_THREAD_FRAME) {
+        /* everything up to the synthesis filter (all of layer 3) runs
+           before waiting for the previous packet's state */
+        if ((ret = thread_get_buffer(s)) < 0)
+            return ret;
+        ret = mp_decode_frame(s, NULL, buf, buf_size);
+        load_prev_state(s);
+        store_state(s);
+        ff_thread_report_progress(&s->cur_frame, 1, 0);
+        if (ret >= 0) {
+            int err = av_frame_ref(data, s->frame);
+            if (err < 0)
+                return err;
+        }
+    } else {
+        s->frame = data;
+        ret = mp_decode_frame(s, NULL, buf, buf_size);
+    }
     if (ret >= 0) {
-        s->frame->nb_samples = avctx->frame_size;
+        ((AVFrame *)data)->nb_samples = avctx->frame_size;
         *got_frame_ptr       = 1;
         avctx->sample_rate   = s->sample_rate;
         //FIXME maybe move the other codec info stuff from above here too
@@ -1719,17 +1883,15 @@ static int decode_frame(AVCodecContext * avctx, void *data, int *got_frame_ptr,
     return buf_size + skipped;
 }
 
-static void mp_flush(MPADecodeContext *ctx)
-{
-    memset(ctx->synth_buf, 0, sizeof(ctx->synth_buf));
-    memset(ctx->mdct_buf, 0, sizeof(ctx->mdct_buf));
-    ctx->last_buf_size = 0;
-    ctx->dither_state = 0;
-}
-
 static void flush(AVCodecContext *avctx)
 {
-    mp_flush(avctx->priv_data);
+    MPADecodeContext *s = avctx->priv_data;
+
+    mp_flush(s);
+    if (avctx->active_thread_type & FF_THREAD_FRAME) {
+        ff_thread_release_buffer(avctx, &s->prev_frame);
+        av_buffer_unref(&s->prev_state_buf);
+    }
 }
 
 #if CONFIG_MP3ADU_DECODER || CONFIG_MP3ADUFLOAT_DECODER
@@ -963,6 +963,28 @@ av_cold int ff_mpv_common_init(MpegEncContext *s)
         s->slice_context_count = nb_slices;
 //     }
 
+    /* The extra bands change the motion vector predictors at the band
+     * borders, so they are only used when requested. */
+    if (s->encoding && s->me_threads && HAVE_THREADS &&
+        s->avctx->active_thread_type & FF_THREAD_SLICE) {
+        int nb_me = FFMIN3(s->avctx->thread_count, MAX_THREADS, s->mb_height);
+
+        if (nb_me > nb_slices) {
+            for (i = 0; i < nb_me; i++) {
+                s->me_context[i] = av_memdup(s, sizeof(MpegEncContext));
+                if (!s->me_context[i])
+                    goto fail;
+                s->me_context_count = i + 1;
+                if (init_duplicate_context(s->me_context[i]) < 0)
+                    goto fail;
+                s->me_context[i]->start_mb_y =
+                    (s->mb_height * (i) + nb_me / 2) / nb_me;
+                s->me_context[i]->end_mb_y   =
+                    (s->mb_height * (i + 1) + nb_me / 2) / nb_me;
+            }
+        }
+    }
+
     return 0;
  fail:
     ff_mpv_common_end(s);
@@ -1119,6 +1141,12 @@ void ff_mpv_common_end(MpegEncContext *s)
         s->slice_context_count = 1;
     } else free_duplicate_context(s);
 
+    for (i = 0; i < s->me_context_count; i++) {
+        free_duplicate_context(s->me_context[i]);
+        av_freep(&s->me_context[i]);
+    }
+    s->me_context_count = 0;
+
     av_freep(&s->parse_context.buffer);
     s->parse_context.buffer_size = 0;
 
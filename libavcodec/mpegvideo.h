@@ -161,6 +161,13 @@ typedef struct MpegEncContext {
     int end_mb_y;              ///< end   mb_y of this thread (so current thread should process start_mb_y <= row < end_mb_y)
     struct MpegEncContext *thread_context[MAX_THREADS];
     int slice_context_count;   ///< number of used thread_contexts
+    /**
+     * Encoder only: contexts splitting the frame into row bands for motion
+     * estimation when there are more threads than slice contexts.
+     */
+    struct MpegEncContext *me_context[MAX_THREADS];
+    int me_context_count;      ///< number of used me_contexts, 0 if the thread_contexts are used
+    int me_threads;            ///< split motion estimation into one band per thread instead of per slice
 
     /**
      * copy of the previous picture structure.
@@ -556,6 +563,17 @@ typedef struct MpegEncContext {
 
     /* temporary frames used by b_frame_strategy = 2 */
     AVFrame *tmp_frames[MAX_B_FRAMES + 2];
+
+    /* b_frame_strategy = 3 lookahead, costs are indexed by
+     * display_picture_number % MAX_PICTURE_COUNT */
+    uint8_t *lookahead_lowres[MAX_B_FRAMES + 3]; ///< half resolution luma of the recent input pictures
+    int lookahead_lowres_num[MAX_B_FRAMES + 3];  ///< display_picture_number held by each lowres plane
+    int lookahead_intra_cost[MAX_PICTURE_COUNT];
+    int lookahead_cost[MAX_PICTURE_COUNT];       ///< estimated cost for the type the picture will be coded as
+    int *lookahead_row_cost;
+    int lookahead_stride;
+    int lookahead_width, lookahead_height;       ///< analysed area, multiple of 8
+    int lookahead_scenecut;
 } MpegEncContext;
 
 /* mpegvideo_enc common options */
@@ -606,6 +624,10 @@ typedef struct MpegEncContext {
 { "zero", NULL, 0, AV_OPT_TYPE_CONST, { .i64 = FF_ME_ZERO }, 0, 0, FF_MPV_OPT_FLAGS, "motion_est" }, \
 { "epzs", NULL, 0, AV_OPT_TYPE_CONST, { .i64 = FF_ME_EPZS }, 0, 0, FF_MPV_OPT_FLAGS, "motion_est" }, \
 { "xone", NULL, 0, AV_OPT_TYPE_CONST, { .i64 = FF_ME_XONE }, 0, 0, FF_MPV_OPT_FLAGS, "motion_est" }, \
+{"la_scenecut", "scene cut threshold for b_strategy 3 in percent of the intra cost (0 disables)", \
+                                                                    FF_MPV_OFFSET(lookahead_scenecut), AV_OPT_TYPE_INT, {.i64 = 40 }, 0, 100, FF_MPV_OPT_FLAGS }, \
+{"me_threads", "run motion estimation on one band per thread instead of per slice, the output then depends on the number of threads", \
+                                                                    FF_MPV_OFFSET(me_threads), AV_OPT_TYPE_INT, {.i64 = 0 }, 0, 1, FF_MPV_OPT_FLAGS }, \
 
 extern const AVOption ff_mpv_generic_options[];
 
@@ -1028,6 +1028,25 @@ FF_ENABLE_DEPRECATION_WARNINGS
         }
     }
 
+    if (avctx->b_frame_strategy == 3) {
+        s->lookahead_width  = (s->width  >> 1) & ~7;
+        s->lookahead_height = (s->height >> 1) & ~7;
+        s->lookahead_stride = FFALIGN(s->width >> 1, 16);
+        if (!s->lookahead_width || !s->lookahead_height) {
+            av_log(avctx, AV_LOG_ERROR,
+                   "b_frame_strategy 3 needs at least a 16x16 picture\n");
+            return AVERROR(EINVAL);
+        }
+
+        FF_ALLOCZ_OR_GOTO(s->avctx, s->lookahead_row_cost,
+                          (s->lookahead_height >> 3) * sizeof(int), fail);
+        for (i = 0; i < s->max_b_frames + 3; i++) {
+            FF_ALLOCZ_OR_GOTO(s->avctx, s->lookahead_lowres[i],
+                              s->lookahead_stride * (s->height >> 1), fail);
+            s->lookahead_lowres_num[i] = -1;
+        }
+    }
+
     return 0;
 fail:
     ff_mpv_encode_end(avctx);
@@ -1050,6 +1069,9 @@ av_cold int ff_mpv_encode_end(AVCodecContext *avctx)
 
     for (i = 0; i < FF_ARRAY_ELEMS(s->tmp_frames); i++)
         av_frame_free(&s->tmp_frames[i]);
+    for (i = 0; i < FF_ARRAY_ELEMS(s->lookahead_lowres); i++)
+        av_freep(&s->lookahead_lowres[i]);
+    av_freep(&s->lookahead_row_cost);
 
     ff_free_picture_tables(&s->new_picture);
     ff_mpeg_unref_picture(s->avctx, &s->new_picture);
@@ -1109,6 +1131,273 @@ static int get_intra_count(MpegEncContext *s, uint8_t *src,
     return acc;
 }
 
+/* b_frame_strategy 3 works on half resolution luma, so every 8x8 lookahead
+ * block roughly corresponds to one macroblock of the coded picture. */
+#define LOOKAHEAD_INDEX(n) ((n) % MAX_PICTURE_COUNT)
+
+typedef struct LookaheadJob {
+    uint8_t *cur;
+    uint8_t *ref[2]; ///< past and future reference, NULL if unused
+} LookaheadJob;
+
+static uint8_t *lookahead_lowres(MpegEncContext *s, int display_picture_number)
+{
+    int idx = display_picture_number % (s->max_b_frames + 3);
+
+    if (s->lookahead_lowres_num[idx] != display_picture_number)
+        return NULL;
+    return s->lookahead_lowres[idx];
+}
+
+/**
+ * Small iterative diamond search with decreasing step size.
+ * @return the SAD of the best position, stored in *mx, *my
+ */
+static int lookahead_search(MpegEncContext *s, uint8_t *cur, uint8_t *ref,
+                            int x, int y, int *mx, int *my)
+{
+    static const int8_t dia[4][2] = { { -1, 0 }, { 1, 0 }, { 0, -1 }, { 0, 1 } };
+    const int stride = s->lookahead_stride;
+    const int xmin = -x, xmax = s->lookahead_width  - 8 - x;
+    const int ymin = -y, ymax = s->lookahead_height - 8 - y;
+    int bx = av_clip(*mx, xmin, xmax);
+    int by = av_clip(*my, ymin, ymax);
+    int best = s->mecc.sad[1](NULL, cur, ref + bx + by * stride, stride, 8);
+    int step, i, j;
+
+    if (bx || by) {
+        int d = s->mecc.sad[1](NULL, cur, ref, stride, 8);
+        if (d < best) {
+            best = d;
+            bx = by = 0;
+        }
+    }
+
+    for (step = 4; step; step >>= 1) {
+        for (i = 0; i < 8; i++) {
+            int cx = bx, cy = by;
+
+            for (j = 0; j < 4; j++) {
+                int nx = cx + dia[j][0] * step;
+                int ny = cy + dia[j][1] * step;
+                int d;
+
+                if (nx < xmin || nx > xmax || ny < ymin || ny > ymax)
+                    continue;
+                d = s->mecc.sad[1](NULL, cur, ref + nx + ny * stride, stride, 8);
+                if (d < best) {
+                    best = d;
+                    bx   = nx;
+                    by   = ny;
+                }
+            }
+            if (bx == cx && by == cy)
+                break;
+        }
+    }
+
+    *mx = bx;
+    *my = by;
+    return best;
+}
+
+/**
+ * Cost of one row of 8x8 blocks, the minimum SATD of intra, forward,
+ * backward and bidirectional prediction.
+ */
+static int lookahead_cost_row(AVCodecContext *avctx, void *arg,
+                              int jobnr, int threadnr)
+{
+    MpegEncContext *s      = avctx->priv_data;
+    const LookaheadJob *lj = arg;
+    const int stride       = s->lookahead_stride;
+    const int y            = jobnr * 8;
+    LOCAL_ALIGNED_16(uint8_t, cur_blk, [64]);
+    LOCAL_ALIGNED_16(uint8_t, bi_blk,  [64]);
+    int mv[2][2] = { { 0 } };
+    int x, i, j, cost = 0;
+
+    for (x = 0; x + 8 <= s->lookahead_width; x += 8) {
+        uint8_t *cur = lj->cur + x + y * stride;
+        uint8_t *pred[2] = { NULL };
+        int best = s->mecc.hadamard8_diff[5](NULL, cur, NULL, stride, 8);
+
+        for (i = 0; i < 2; i++) {
+            if (!lj->ref[i])
+                continue;
+            lookahead_search(s, cur, lj->ref[i] + x + y * stride, x, y,
+                             &mv[i][0], &mv[i][1]);
+            pred[i] = lj->ref[i] + x + mv[i][0] + (y + mv[i][1]) * stride;
+            best    = FFMIN(best, s->mecc.hadamard8_diff[1](NULL, cur, pred[i],
+                                                            stride, 8));
+        }
+
+        if (pred[0] && pred[1]) {
+            for (j = 0; j < 8; j++) {
+                for (i = 0; i < 8; i++) {
+                    cur_blk[i + 8 * j] = cur[i + j * stride];
+                    bi_blk[i + 8 * j]  = (pred[0][i + j * stride] +
+                                          pred[1][i + j * stride] + 1) >> 1;
+                }
+            }
+            best = FFMIN(best, s->mecc.hadamard8_diff[1](NULL, cur_blk, bi_blk,
+                                                         8, 8));
+        }
+
+        cost += best;
+    }
+
+    s->lookahead_row_cost[jobnr] = cost;
+    return 0;
+}
+
+/**
+ * Estimate the cost of coding picture b predicted from p0 and p1, all given
+ * by display_picture_number. b == p0 gives the intra cost, b == p1 the cost
+ * of a P picture.
+ * @return the cost or -1 if a picture is no longer available
+ */
+static int lookahead_frame_cost(MpegEncContext *s, int p0, int p1, int b)
+{
+    const int rows = s->lookahead_height >> 3;
+    LookaheadJob lj;
+    int i, cost = 0;
+
+    if (p0 == b)
+        return s->lookahead_intra_cost[LOOKAHEAD_INDEX(b)];
+
+    lj.cur    = lookahead_lowres(s, b);
+    lj.ref[0] = lookahead_lowres(s, p0);
+    lj.ref[1] = p1 != b ? lookahead_lowres(s, p1) : NULL;
+    if (!lj.cur || !lj.ref[0] || (p1 != b && !lj.ref[1]))
+        return -1;
+
+    s->avctx->execute2(s->avctx, lookahead_cost_row, &lj, NULL, rows);
+    emms_c();
+
+    for (i = 0; i < rows; i++)
+        cost += s->lookahead_row_cost[i];
+    return cost;
+}
+
+/**
+ * Downscale a new input picture, compute its intra cost and the cost of
+ * predicting it from the previous one, and turn it into an I picture if
+ * that prediction fails (scene cut).
+ */
+static void lookahead_analyse(MpegEncContext *s, Picture *pic,
+                              const AVFrame *pic_arg)
+{
+    const int n     = pic->f->display_picture_number;
+    const int idx   = n % (s->max_b_frames + 3);
+    const int rows  = s->lookahead_height >> 3;
+    LookaheadJob lj = { s->lookahead_lowres[idx] };
+    int i, intra = 0, inter;
+
+    s->mpvencdsp.shrink[1](s->lookahead_lowres[idx], s->lookahead_stride,
+                           pic_arg->data[0], pic_arg->linesize[0],
+                           s->width >> 1, s->height >> 1);
+    s->lookahead_lowres_num[idx] = n;
+
+    s->avctx->execute2(s->avctx, lookahead_cost_row, &lj, NULL, rows);
+    emms_c();
+    for (i = 0; i < rows; i++)
+        intra += s->lookahead_row_cost[i];
+
+    s->lookahead_intra_cost[LOOKAHEAD_INDEX(n)] =
+    s->lookahead_cost[LOOKAHEAD_INDEX(n)]       = intra;
+
+    if (!n || (inter = lookahead_frame_cost(s, n - 1, n, n)) < 0)
+        return;
+    s->lookahead_cost[LOOKAHEAD_INDEX(n)] = inter;
+
+    if (s->lookahead_scenecut && !pic->f->pict_type &&
+        100LL * inter >= (100LL - s->lookahead_scenecut) * intra) {
+        if (s->avctx->debug & FF_DEBUG_PICT_INFO)
+            av_log(s->avctx, AV_LOG_DEBUG, "scene cut at picture %d\n", n);
+        pic->f->pict_type = AV_PICTURE_TYPE_I;
+    }
+}
+
+/**
+ * Choose the number of B-frames by comparing the estimated cost of every
+ * possible P/B pattern over the pictures in the lookahead window.
+ */
+static int lookahead_best_b_count(MpegEncContext *s)
+{
+    const int p0 = s->next_picture_ptr->f->display_picture_number;
+    int64_t best_cost = INT64_MAX;
+    int best_b_count  = 0;
+    int i, j, k, n;
+
+    for (n = 0; n < s->max_b_frames + 1 && s->input_picture[n]; n++) {
+        int type = s->input_picture[n]->f->pict_type;
+        if (type && type != AV_PICTURE_TYPE_B) {
+            n++;
+            break;
+        }
+    }
+
+    for (j = 0; j < n; j++) {
+        int64_t cost = 0;
+        int prev     = p0;
+        int prev_i   = -1;
+
+        for (i = 0; i < n; i++) {
+            int is_p = i % (j + 1) == j || i == n - 1;
+            int cur, c;
+
+            if (!is_p)
+                continue;
+
+            cur = s->input_picture[i]->f->display_picture_number;
+            c   = lookahead_frame_cost(s, prev, cur, cur);
+            if (c < 0)
+                return s->max_b_frames;
+            cost += c;
+            for (k = prev_i + 1; k < i; k++) {
+                c = lookahead_frame_cost(s, prev, cur,
+                                         s->input_picture[k]->f->display_picture_number);
+                if (c < 0)
+                    return s->max_b_frames;
+                cost += c;
+            }
+            prev   = cur;
+            prev_i = i;
+        }
+
+        if (cost < best_cost) {
+            best_cost    = cost;
+            best_b_count = j;
+        }
+    }
+
+    return best_b_count;
+}
+
+/**
+ * Store the estimated cost of the pictures of the chosen group for the
+ * VBV planning in the rate control.
+ */
+static void lookahead_set_costs(MpegEncContext *s, int b_frames)
+{
+    const int p0 = s->next_picture_ptr->f->display_picture_number;
+    const int p1 = s->input_picture[b_frames]->f->display_picture_number;
+    int i, c;
+
+    if (s->input_picture[b_frames]->f->pict_type == AV_PICTURE_TYPE_I)
+        s->lookahead_cost[LOOKAHEAD_INDEX(p1)] =
+            s->lookahead_intra_cost[LOOKAHEAD_INDEX(p1)];
+    else if ((c = lookahead_frame_cost(s, p0, p1, p1)) >= 0)
+        s->lookahead_cost[LOOKAHEAD_INDEX(p1)] = c;
+
+    for (i = 0; i < b_frames; i++) {
+        int b = s->input_picture[i]->f->display_picture_number;
+        if ((c = lookahead_frame_cost(s, p0, p1, b)) >= 0)
+            s->lookahead_cost[LOOKAHEAD_INDEX(b)] = c;
+    }
+}
+
 static int alloc_picture(MpegEncContext *s, Picture *pic, int shared)
 {
     return ff_alloc_picture(s->avctx, pic, &s->me, &s->sc, shared, 1,
@@ -1246,6 +1535,9 @@ static int load_input_picture(MpegEncContext *s, const AVFrame *pic_arg)
 
         pic->f->display_picture_number = display_picture_number;
         pic->f->pts = pts; // we set this here to avoid modifiying pic_arg
+
+        if (s->avctx->b_frame_strategy == 3)
+            lookahead_analyse(s, pic, pic_arg);
     }
 
     /* shift buffer entries */
@@ -1509,6 +1801,8 @@ static int select_input_picture(MpegEncContext *s)
                 }
             } else if (s->avctx->b_frame_strategy == 2) {
                 b_frames = estimate_best_b_count(s);
+            } else if (s->avctx->b_frame_strategy == 3) {
+                b_frames = lookahead_best_b_count(s);
             } else {
                 av_log(s->avctx, AV_LOG_ERROR, "illegal b frame strategy\n");
                 b_frames = 0;
@@ -1542,6 +1836,9 @@ static int select_input_picture(MpegEncContext *s)
                 s->input_picture[b_frames]->f->pict_type == AV_PICTURE_TYPE_I)
                 b_frames--;
 
+            if (s->avctx->b_frame_strategy == 3)
+                lookahead_set_costs(s, b_frames);
+
             s->reordered_input_picture[0] = s->input_picture[b_frames];
             if (s->reordered_input_picture[0]->f->pict_type != AV_PICTURE_TYPE_I)
                 s->reordered_input_picture[0]->f->pict_type = AV_PICTURE_TYPE_P;
@@ -3544,6 +3841,10 @@ static int encode_picture(MpegEncContext *s, int picture_number)
     int i, ret;
     int bits;
     int context_count = s->slice_context_count;
+    /* motion estimation runs on its own row bands when there are more
+     * threads than slices, thread_context[0] is s itself otherwise */
+    MpegEncContext **me_context = s->me_context_count ? s->me_context : s->thread_context;
+    int me_context_count        = s->me_context_count ? s->me_context_count : context_count;
 
     s->picture_number = picture_number;
 
@@ -3595,21 +3896,26 @@ static int encode_picture(MpegEncContext *s, int picture_number)
         if (ret < 0)
             return ret;
     }
-
     if(ff_init_me(s)<0)
         return -1;
 
+    for(i=0; i<s->me_context_count; i++){
+        ret = ff_update_duplicate_context(s->me_context[i], s);
+        if (ret < 0)
+            return ret;
+    }
+
     /* Estimate motion for every MB */
     if(s->pict_type != AV_PICTURE_TYPE_I){
         s->lambda = (s->lambda * s->avctx->me_penalty_compensation + 128)>>8;
         s->lambda2= (s->lambda2* (int64_t)s->avctx->me_penalty_compensation + 128)>>8;
         if (s->pict_type != AV_PICTURE_TYPE_B) {
             if((s->avctx->pre_me && s->last_non_b_pict_type==AV_PICTURE_TYPE_I) || s->avctx->pre_me==2){
-                s->avctx->execute(s->avctx, pre_estimate_motion_thread, &s->thread_context[0], NULL, context_count, sizeof(void*));
+                s->avctx->execute(s->avctx, pre_estimate_motion_thread, &me_context[0], NULL, me_context_count, sizeof(void*));
             }
         }
 
-        s->avctx->execute(s->avctx, estimate_motion_thread, &s->thread_context[0], NULL, context_count, sizeof(void*));
+        s->avctx->execute(s->avctx, estimate_motion_thread, &me_context[0], NULL, me_context_count, sizeof(void*));
     }else /* if(s->pict_type == AV_PICTURE_TYPE_I) */{
         /* I-Frame */
         for(i=0; i<s->mb_stride*s->mb_height; i++)
@@ -3617,11 +3923,12 @@ static int encode_picture(MpegEncContext *s, int picture_number)
 
         if(!s->fixed_qscale){
             /* finding spatial complexity for I-frame rate control */
-            s->avctx->execute(s->avctx, mb_var_thread, &s->thread_context[0], NULL, context_count, sizeof(void*));
+            s->avctx->execute(s->avctx, mb_var_thread, &me_context[0], NULL, me_context_count, sizeof(void*));
         }
     }
-    for(i=1; i<context_count; i++){
-        merge_context_after_me(s, s->thread_context[i]);
+    for(i=0; i<me_context_count; i++){
+        if (me_context[i] != s)
+            merge_context_after_me(s, me_context[i]);
     }
     s->current_picture.mc_mb_var_sum= s->current_picture_ptr->mc_mb_var_sum= s->me.mc_mb_var_sum_temp;
     s->current_picture.   mb_var_sum= s->current_picture_ptr->   mb_var_sum= s->me.   mb_var_sum_temp;
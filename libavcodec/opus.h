@@ -151,6 +151,8 @@ typedef struct OpusStreamContext {
     int delayed_samples;
 
     OpusPacket packet;
+    /* start of this stream's sub-packet in the current packet */
+    const uint8_t *subpacket;
 
     int redundancy_idx;
 } OpusStreamContext;
@@ -444,6 +444,21 @@ finish:
     return output_samples;
 }
 
+static int opus_decode_subpacket_job(AVCodecContext *avctx, void *arg,
+                                     int jobnr, int threadnr)
+{
+    OpusContext *c       = avctx->priv_data;
+    OpusStreamContext *s = &c->streams[jobnr];
+    int nb_samples       = *(int *)arg;
+
+    c->decoded_samples[jobnr] = opus_decode_subpacket(s, s->subpacket,
+                                                      s->packet.data_size,
+                                                      c->out + 2 * jobnr,
+                                                      c->out_size[jobnr],
+                                                      nb_samples);
+    return 0;
+}
+
 static int opus_decode_packet(AVCodecContext *avctx, void *data,
                               int *got_frame_ptr, AVPacket *avpkt)
 {
@@ -529,7 +544,7 @@ static int opus_decode_packet(AVCodecContext *avctx, void *data,
         c->out_size[i] = frame->linesize[0] - ret * sizeof(float);
     }
 
-    /* decode each sub-packet */
+    /* parse the headers of all the sub-packets */
     for (i = 0; i < c->nb_streams; i++) {
         OpusStreamContext *s = &c->streams[i];
 
@@ -548,15 +563,32 @@ static int opus_decode_packet(AVCodecContext *avctx, void *data,
             s->silk_samplerate = get_silk_samplerate(s->packet.config);
         }
 
-        ret = opus_decode_subpacket(&c->streams[i], buf, s->packet.data_size,
-                                    c->out + 2 * i, c->out_size[i], coded_samples);
-        if (ret < 0)
-            return ret;
-        c->decoded_samples[i] = ret;
-        decoded_samples       = FFMIN(decoded_samples, ret);
+        s->subpacket = buf;
+        if (buf) {
+            buf      += s->packet.packet_size;
+            buf_size -= s->packet.packet_size;
+        }
+    }
+
+    /* the streams are independent, decode them in parallel */
+    if (c->nb_streams > 1 && avctx->thread_count > 1) {
+        avctx->execute2(avctx, opus_decode_subpacket_job, &coded_samples, NULL,
+                        c->nb_streams);
+    } else {
+        for (i = 0; i < c->nb_streams; i++) {
+            OpusStreamContext *s = &c->streams[i];
+            c->decoded_samples[i] = opus_decode_subpacket(s, s->subpacket,
+                                                          s->packet.data_size,
+                                                          c->out + 2 * i,
+                                                          c->out_size[i],
+                                                          coded_samples);
+        }
+    }
 
-        buf      += s->packet.packet_size;
-        buf_size -= s->packet.packet_size;
+    for (i = 0; i < c->nb_streams; i++) {
+        if (c->decoded_samples[i] < 0)
+            return c->decoded_samples[i];
+        decoded_samples = FFMIN(decoded_samples, c->decoded_samples[i]);
     }
 
     /* buffer the extra samples */
@@ -753,5 +785,6 @@ AVCodec ff_opus_decoder = {
     .close           = opus_decode_close,
     .decode          = opus_decode_packet,
     .flush           = opus_decode_flush,
-    .capabilities    = AV_CODEC_CAP_DR1 | AV_CODEC_CAP_DELAY,
+    .capabilities    = AV_CODEC_CAP_DR1 | AV_CODEC_CAP_DELAY |
+                       AV_CODEC_CAP_SLICE_THREADS,
 };
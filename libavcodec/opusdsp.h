@@ -0,0 +1,47 @@
+/*
+ * This file is part of FFmpeg.
+ *
+ * FFmpeg is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * FFmpeg is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with FFmpeg; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+
+#ifndef AVCODEC_OPUSDSP_H
+#define AVCODEC_OPUSDSP_H
+
+typedef struct OpusDSPContext {
+    /**
+     * CELT pitch postfilter with constant period and gains:
+     * data[i] += g0 * x[i] + g1 * (x[i - 1] + x[i + 1]) + g2 * (x[i - 2] + x[i + 2])
+     * with x = data - period.
+     * @param period at least CELT_POSTFILTER_MINPERIOD
+     */
+    void (*postfilter)(float *data, int period, const float *gains, int len);
+
+    /**
+     * Scale the decoded PVQ pulses: X[i] = g * iy[i]
+     */
+    void (*normalize_residual)(float *X, const int *iy, float g, int N);
+
+    /**
+     * Scale a band in place, used for the denormalization: X[i] *= g
+     */
+    void (*scale_band)(float *X, float g, int N);
+} OpusDSPContext;
+
+void ff_opus_dsp_init(OpusDSPContext *dsp);
+
+/* for internal use only */
+void ff_opus_dsp_init_x86(OpusDSPContext *dsp);
+
+#endif /* AVCODEC_OPUSDSP_H */
@@ -24,6 +24,7 @@
 #include "bytestream.h"
 #include "huffyuvencdsp.h"
 #include "png.h"
+#include "pngencdsp.h"
 #include "apng.h"
 
 #include "libavutil/avassert.h"
@@ -35,6 +36,8 @@
 #include <zlib.h>
 
 #define IOBUF_SIZE 4096
+#define PNG_WINDOW_SIZE    (1 << 15)
+#define PNG_MIN_SLICE_SIZE (1 << 17)
 
 typedef struct APNGFctlChunk {
     uint32_t sequence_number;
@@ -44,15 +47,34 @@ typedef struct APNGFctlChunk {
     uint8_t dispose_op, blend_op;
 } APNGFctlChunk;
 
+/**
+ * A range of rows deflated as a raw deflate stream of its own.
+ * The slices of a frame are concatenated into a single zlib stream.
+ */
+typedef struct PNGEncSlice {
+    z_stream zstream;
+    uint8_t *crow_base;
+    unsigned crow_base_size;
+    uint8_t *dict;               ///< filtered rows preceding the slice
+    unsigned dict_size;
+    uint8_t *buf;                ///< deflated rows
+    unsigned buf_size;
+    int len;
+    uLong in_len;
+    uLong adler;                 ///< Adler-32 of the filtered rows
+} PNGEncSlice;
+
 typedef struct PNGEncContext {
     AVClass *class;
     HuffYUVEncDSPContext hdsp;
+    PNGEncDSPContext dsp;
 
     uint8_t *bytestream;
     uint8_t *bytestream_start;
     uint8_t *bytestream_end;
 
     int filter_type;
+    int compression_level;
 
     z_stream zstream;
     uint8_t buf[IOBUF_SIZE];
@@ -73,6 +95,11 @@ typedef struct PNGEncContext {
     APNGFctlChunk last_frame_fctl;
     uint8_t *last_frame_packet;
     size_t last_frame_packet_size;
+
+    // slice threading
+    PNGEncSlice *slices;
+    int nb_slices;               ///< number of allocated slices
+    int nb_frame_slices;         ///< number of slices used by the current frame
 } PNGEncContext;
 
 static void png_get_interlaced_row(uint8_t *dst, int row_size,
@@ -114,34 +141,6 @@ static void png_get_interlaced_row(uint8_t *dst, int row_size,
     }
 }
 
-static void sub_png_paeth_prediction(uint8_t *dst, uint8_t *src, uint8_t *top,
-                                     int w, int bpp)
-{
-    int i;
-    for (i = 0; i < w; i++) {
-        int a, b, c, p, pa, pb, pc;
-
-        a = src[i - bpp];
-        b = top[i];
-        c = top[i - bpp];
-
-        p  = b - c;
-        pc = a - c;
-
-        pa = abs(p);
-        pb = abs(pc);
-        pc = abs(p + pc);
-
-        if (pa <= pb && pa <= pc)
-            p = a;
-        else if (pb <= pc)
-            p = b;
-        else
-            p = c;
-        dst[i] = src[i] - p;
-    }
-}
-
 static void sub_left_prediction(PNGEncContext *c, uint8_t *dst, const uint8_t *src, int bpp, int size)
 {
     const uint8_t *src1 = src + bpp;
@@ -176,13 +175,12 @@ static void png_filter_row(PNGEncContext *c, uint8_t *dst, int filter_type,
     case PNG_FILTER_VALUE_AVG:
         for (i = 0; i < bpp; i++)
             dst[i] = src[i] - (top[i] >> 1);
-        for (; i < size; i++)
-            dst[i] = src[i] - ((src[i - bpp] + top[i]) >> 1);
+        c->dsp.sub_avg_prediction(dst + i, src + i, top + i, size - i, bpp);
         break;
     case PNG_FILTER_VALUE_PAETH:
         for (i = 0; i < bpp; i++)
             dst[i] = src[i] - top[i];
-        sub_png_paeth_prediction(dst + i, src + i, top + i, size - i, bpp);
+        c->dsp.sub_paeth_prediction(dst + i, src + i, top + i, size - i, bpp);
         break;
     }
 }
@@ -195,15 +193,12 @@ static uint8_t *png_choose_filter(PNGEncContext *s, uint8_t *dst,
     if (!top && pred)
         pred = PNG_FILTER_VALUE_SUB;
     if (pred == PNG_FILTER_VALUE_MIXED) {
-        int i;
         int cost, bcost = INT_MAX;
         uint8_t *buf1 = dst, *buf2 = dst + size + 16;
         for (pred = 0; pred < 5; pred++) {
             png_filter_row(s, buf1 + 1, pred, src, top, size, bpp);
             buf1[0] = pred;
-            cost = 0;
-            for (i = 0; i <= size; i++)
-                cost += abs((int8_t) buf1[i]);
+            cost = s->dsp.filter_cost(buf1, size + 1);
             if (cost < bcost) {
                 bcost = cost;
                 FFSWAP(uint8_t *, buf1, buf2);
@@ -285,6 +280,148 @@ static int png_write_row(AVCodecContext *avctx, const uint8_t *data, int size)
     return 0;
 }
 
+/* copy already deflated data into IDAT/fdAT chunks, like png_write_row() */
+static void png_write_deflated(AVCodecContext *avctx, const uint8_t *data, int size)
+{
+    PNGEncContext *s = avctx->priv_data;
+
+    while (size > 0) {
+        int len = FFMIN(size, s->zstream.avail_out);
+
+        memcpy(s->zstream.next_out, data, len);
+        s->zstream.next_out  += len;
+        s->zstream.avail_out -= len;
+        data += len;
+        size -= len;
+        if (s->zstream.avail_out == 0) {
+            if (s->bytestream_end - s->bytestream > IOBUF_SIZE + 100)
+                png_write_image_data(avctx, s->buf, IOBUF_SIZE);
+            s->zstream.avail_out = IOBUF_SIZE;
+            s->zstream.next_out  = s->buf;
+        }
+    }
+}
+
+static uint8_t *png_filter_frame_row(PNGEncContext *s, uint8_t *crow_buf,
+                                     const AVFrame *p, int y, int row_size)
+{
+    uint8_t *ptr = p->data[0] + y * p->linesize[0];
+    uint8_t *top = y ? ptr - p->linesize[0] : NULL;
+
+    return png_choose_filter(s, crow_buf, ptr, top, row_size,
+                             s->bits_per_pixel >> 3);
+}
+
+static int deflate_slice(AVCodecContext *avctx, void *arg, int jobnr, int threadnr)
+{
+    PNGEncContext *s = avctx->priv_data;
+    PNGEncSlice *sl  = &s->slices[jobnr];
+    z_stream *zs     = &sl->zstream;
+    const AVFrame *p = arg;
+    int row_size     = (p->width * s->bits_per_pixel + 7) >> 3;
+    int y_start      = p->height *  jobnr      / s->nb_frame_slices;
+    int y_end        = p->height * (jobnr + 1) / s->nb_frame_slices;
+    int dict_rows    = FFMIN(y_start, (PNG_WINDOW_SIZE + row_size) / (row_size + 1));
+    int flush        = jobnr == s->nb_frame_slices - 1 ? Z_FINISH : Z_SYNC_FLUSH;
+    uint8_t *crow_buf, *crow;
+    int y, ret;
+
+    deflateReset(zs);
+
+    sl->in_len = (uLong)(y_end - y_start) * (row_size + 1);
+    av_fast_malloc(&sl->crow_base, &sl->crow_base_size,
+                   (row_size + 32) << (s->filter_type == PNG_FILTER_VALUE_MIXED));
+    av_fast_malloc(&sl->buf, &sl->buf_size, deflateBound(zs, sl->in_len) + 16);
+    if (!sl->crow_base || !sl->buf)
+        return AVERROR(ENOMEM);
+    crow_buf = sl->crow_base + 15;
+
+    /* Prime the window with the filtered rows of the previous slice, so
+     * that matches may reach across the slice boundary. */
+    if (dict_rows) {
+        int dict_len = dict_rows * (row_size + 1);
+        int len      = FFMIN(dict_len, PNG_WINDOW_SIZE);
+
+        av_fast_malloc(&sl->dict, &sl->dict_size, dict_len);
+        if (!sl->dict)
+            return AVERROR(ENOMEM);
+        for (y = y_start - dict_rows; y < y_start; y++) {
+            crow = png_filter_frame_row(s, crow_buf, p, y, row_size);
+            memcpy(sl->dict + (y - y_start + dict_rows) * (row_size + 1),
+                   crow, row_size + 1);
+        }
+        if (deflateSetDictionary(zs, sl->dict + dict_len - len, len) != Z_OK)
+            return -1;
+    }
+
+    zs->next_out  = sl->buf;
+    zs->avail_out = sl->buf_size;
+    sl->adler     = adler32(0, NULL, 0);
+    for (y = y_start; y < y_end; y++) {
+        crow = png_filter_frame_row(s, crow_buf, p, y, row_size);
+        sl->adler = adler32(sl->adler, crow, row_size + 1);
+
+        zs->next_in  = crow;
+        zs->avail_in = row_size + 1;
+        ret = deflate(zs, y == y_end - 1 ? flush : Z_NO_FLUSH);
+        if ((ret != Z_OK && ret != Z_STREAM_END) || !zs->avail_out)
+            return -1;
+    }
+    sl->len = zs->next_out - sl->buf;
+
+    return 0;
+}
+
+/**
+ * Filter and deflate row ranges of the image in parallel, pigz style.
+ * Every slice but the last ends with a sync flush, so the raw deflate
+ * streams concatenate into a single valid one; the zlib header and the
+ * combined Adler-32 are added around it here.
+ */
+static int encode_frame_slices(AVCodecContext *avctx, const AVFrame *pict)
+{
+    PNGEncContext *s = avctx->priv_data;
+    uLong adler      = adler32(0, NULL, 0);
+    int level        = s->compression_level == Z_DEFAULT_COMPRESSION ? 6 : s->compression_level;
+    uint8_t buf[4];
+    int *rets;
+    int i, ret = 0;
+
+    rets = av_malloc_array(s->nb_frame_slices, sizeof(*rets));
+    if (!rets)
+        return AVERROR(ENOMEM);
+
+    avctx->execute2(avctx, deflate_slice, (void *)pict, rets, s->nb_frame_slices);
+
+    for (i = 0; i < s->nb_frame_slices && !ret; i++)
+        ret = FFMIN(rets[i], 0);
+    av_free(rets);
+    if (ret < 0)
+        return ret;
+
+    /* zlib header: deflate with a 32K window, level hint as zlib sets it */
+    AV_WB16(buf, 0x7800 | (level < 2 ? 0 : level < 6 ? 1 : level == 6 ? 2 : 3) << 6);
+    AV_WB16(buf, AV_RB16(buf) + 31 - AV_RB16(buf) % 31);
+
+    s->zstream.avail_out = IOBUF_SIZE;
+    s->zstream.next_out  = s->buf;
+    png_write_deflated(avctx, buf, 2);
+    for (i = 0; i < s->nb_frame_slices; i++) {
+        PNGEncSlice *sl = &s->slices[i];
+
+        png_write_deflated(avctx, sl->buf, sl->len);
+        adler = adler32_combine(adler, sl->adler, sl->in_len);
+    }
+    AV_WB32(buf, adler);
+    png_write_deflated(avctx, buf, 4);
+
+    i = IOBUF_SIZE - s->zstream.avail_out;
+    if (i > 0 && s->bytestream_end - s->bytestream > i + 100)
+        png_write_image_data(avctx, s->buf, i);
+
+    return 0;
+}
+
 #define AV_WB32_PNG(buf, n) AV_WB32(buf, lrint((n) * 100000))
 static int png_get_chrm(enum AVColorPrimaries prim,  uint8_t *buf)
 {
@@ -419,6 +556,15 @@ static int encode_frame(AVCodecContext *avctx, const AVFrame *pict)
 
     row_size = (pict->width * s->bits_per_pixel + 7) >> 3;
 
+    if (s->nb_slices > 1 && !s->is_progressive) {
+        int64_t size = (int64_t)pict->height * (row_size + 1);
+
+        s->nb_frame_slices = FFMIN3(s->nb_slices, pict->height,
+                                    size / PNG_MIN_SLICE_SIZE);
+        if (s->nb_frame_slices > 1)
+            return encode_frame_slices(avctx, pict);
+    }
+
     crow_base = av_malloc((row_size + 32) << (s->filter_type == PNG_FILTER_VALUE_MIXED));
     if (!crow_base) {
         ret = AVERROR(ENOMEM);
@@ -976,6 +1122,7 @@ FF_ENABLE_DEPRECATION_WARNINGS
 #endif
 
     ff_huffyuvencdsp_init(&s->hdsp);
+    ff_pngencdsp_init(&s->dsp);
 
     s->filter_type = av_clip(avctx->prediction_method,
                              PNG_FILTER_VALUE_NONE,
@@ -1045,6 +1192,25 @@ FF_ENABLE_DEPRECATION_WARNINGS
                       : av_clip(avctx->compression_level, 0, 9);
     if (deflateInit2(&s->zstream, compression_level, Z_DEFLATED, 15, 8, Z_DEFAULT_STRATEGY) != Z_OK)
         return -1;
+    s->compression_level = compression_level;
+
+    if (avctx->active_thread_type & FF_THREAD_SLICE && avctx->thread_count > 1) {
+        int i;
+
+        s->slices = av_mallocz_array(avctx->thread_count, sizeof(*s->slices));
+        if (!s->slices)
+            return AVERROR(ENOMEM);
+        for (i = 0; i < avctx->thread_count; i++) {
+            z_stream *zs = &s->slices[i].zstream;
+
+            zs->zalloc = ff_png_zalloc;
+            zs->zfree  = ff_png_zfree;
+            zs->opaque = NULL;
+            if (deflateInit2(zs, compression_level, Z_DEFLATED, -15, 8, Z_DEFAULT_STRATEGY) != Z_OK)
+                return -1;
+            s->nb_slices++;
+        }
+    }
 
     return 0;
 }
@@ -1052,8 +1218,18 @@ FF_ENABLE_DEPRECATION_WARNINGS
 static av_cold int png_enc_close(AVCodecContext *avctx)
 {
     PNGEncContext *s = avctx->priv_data;
+    int i;
 
     deflateEnd(&s->zstream);
+    for (i = 0; i < s->nb_slices; i++) {
+        PNGEncSlice *sl = &s->slices[i];
+
+        deflateEnd(&sl->zstream);
+        av_freep(&sl->crow_base);
+        av_freep(&sl->dict);
+        av_freep(&sl->buf);
+    }
+    av_freep(&s->slices);
     av_frame_free(&s->last_frame);
     av_frame_free(&s->prev_frame);
     av_freep(&s->last_frame_packet);
@@ -1091,7 +1267,9 @@ AVCodec ff_png_encoder = {
     .init           = png_enc_init,
     .close          = png_enc_close,
     .encode2        = encode_png,
-    .capabilities   = AV_CODEC_CAP_FRAME_THREADS | AV_CODEC_CAP_INTRA_ONLY,
+    .capabilities   = AV_CODEC_CAP_FRAME_THREADS | AV_CODEC_CAP_SLICE_THREADS |
+                      AV_CODEC_CAP_INTRA_ONLY,
+    .caps_internal  = FF_CODEC_CAP_INIT_CLEANUP,
     .pix_fmts       = (const enum AVPixelFormat[]) {
         AV_PIX_FMT_RGB24, AV_PIX_FMT_RGBA,
         AV_PIX_FMT_RGB48BE, AV_PIX_FMT_RGBA64BE,
@@ -1112,7 +1290,8 @@ AVCodec ff_apng_encoder = {
     .init           = png_enc_init,
     .close          = png_enc_close,
     .encode2        = encode_apng,
-    .capabilities   = CODEC_CAP_DELAY,
+    .capabilities   = CODEC_CAP_DELAY | AV_CODEC_CAP_SLICE_THREADS,
+    .caps_internal  = FF_CODEC_CAP_INIT_CLEANUP,
     .pix_fmts       = (const enum AVPixelFormat[]) {
         AV_PIX_FMT_RGB24, AV_PIX_FMT_RGBA,
         AV_PIX_FMT_RGB48BE, AV_PIX_FMT_RGBA64BE,
@@ -0,0 +1,54 @@
+/*
+ * PNG encoder row filters
+ *
+ * This file is part of FFmpeg.
+ *
+ * FFmpeg is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * FFmpeg is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with FFmpeg; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+
+#ifndef AVCODEC_PNGENCDSP_H
+#define AVCODEC_PNGENCDSP_H
+
+#include <stdint.h>
+
+typedef struct PNGEncDSPContext {
+    /**
+     * Subtract the average prediction from w bytes of src.
+     * Reads the left neighbours from src[-bpp] onwards.
+     */
+    void (*sub_avg_prediction)(uint8_t *dst, const uint8_t *src,
+                               const uint8_t *top, int w, int bpp);
+
+    /**
+     * Subtract the Paeth prediction from w bytes of src.
+     * Reads the left neighbours from src[-bpp] and top[-bpp] onwards.
+     */
+    void (*sub_paeth_prediction)(uint8_t *dst, const uint8_t *src,
+                                 const uint8_t *top, int w, int bpp);
+
+    /**
+     * Sum of the absolute values of size bytes interpreted as int8_t,
+     * the cost used to pick the filter of a row.
+     */
+    int (*filter_cost)(const uint8_t *buf, int size);
+} PNGEncDSPContext;
+
+void ff_png_sub_paeth_prediction_c(uint8_t *dst, const uint8_t *src,
+                                    const uint8_t *top, int w, int bpp);
+
+void ff_pngencdsp_init(PNGEncDSPContext *c);
+void ff_pngencdsp_init_x86(PNGEncDSPContext *c);
+
+#endif /* AVCODEC_PNGENCDSP_H */
@@ -27,6 +27,7 @@
 //#define DEBUG
 
 #define LONG_BITSTREAM_READER
+#define CACHED_BITSTREAM_READER
 
 #include "libavutil/internal.h"
 #include "avcodec.h"
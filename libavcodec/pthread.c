@@ -48,7 +48,9 @@ static void validate_thread_parameters(AVCodecContext *avctx)
     int frame_threading_supported = (avctx->codec->capabilities & AV_CODEC_CAP_FRAME_THREADS)
                                 && !(avctx->flags  & AV_CODEC_FLAG_TRUNCATED)
                                 && !(avctx->flags  & AV_CODEC_FLAG_LOW_DELAY)
-                                && !(avctx->flags2 & AV_CODEC_FLAG2_CHUNKS);
+                                && !(avctx->flags2 & AV_CODEC_FLAG2_CHUNKS)
+                                && (!(avctx->codec->caps_internal & FF_CODEC_CAP_FRAME_THREADS_OPT_IN) ||
+                                    avctx->thread_type == FF_THREAD_FRAME);
     if (avctx->thread_count == 1) {
         avctx->active_thread_type = 0;
     } else if (frame_threading_supported && (avctx->thread_type & FF_THREAD_FRAME)) {
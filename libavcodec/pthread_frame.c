@@ -239,6 +239,9 @@ FF_ENABLE_DEPRECATION_WARNINGS
         dst->sample_rate    = src->sample_rate;
         dst->sample_fmt     = src->sample_fmt;
         dst->channel_layout = src->channel_layout;
+        dst->frame_size     = src->frame_size;
+        dst->bit_rate       = src->bit_rate;
+        dst->audio_service_type = src->audio_service_type;
         dst->internal->hwaccel_priv_data = src->internal->hwaccel_priv_data;
     }
 
@@ -283,19 +283,31 @@ int ff_alloc_entries(AVCodecContext *avctx, int count)
 
     if (avctx->active_thread_type & FF_THREAD_SLICE)  {
         SliceThreadContext *p = avctx->internal->thread_ctx;
-        p->thread_count  = avctx->thread_count;
+
+        if (p->entries && p->entries_count >= count)
+            return 0;
+
+        av_freep(&p->entries);
+        p->entries_count = 0;
         p->entries       = av_mallocz_array(count, sizeof(int));
+        if (!p->entries)
+            return AVERROR(ENOMEM);
+        p->entries_count = count;
+
+        if (p->progress_mutex)
+            return 0;
 
-        p->progress_mutex = av_malloc_array(p->thread_count, sizeof(pthread_mutex_t));
-        p->progress_cond  = av_malloc_array(p->thread_count, sizeof(pthread_cond_t));
+        p->progress_mutex = av_malloc_array(avctx->thread_count, sizeof(pthread_mutex_t));
+        p->progress_cond  = av_malloc_array(avctx->thread_count, sizeof(pthread_cond_t));
 
-        if (!p->entries || !p->progress_mutex || !p->progress_cond) {
+        if (!p->progress_mutex || !p->progress_cond) {
             av_freep(&p->entries);
             av_freep(&p->progress_mutex);
             av_freep(&p->progress_cond);
+            p->entries_count = 0;
             return AVERROR(ENOMEM);
         }
-        p->entries_count  = count;
+        p->thread_count = avctx->thread_count;
 
         for (i = 0; i < p->thread_count; i++) {
             pthread_mutex_init(&p->progress_mutex[i], NULL);
@@ -748,6 +748,49 @@ void ff_get_2pass_fcode(MpegEncContext *s)
     s->b_code = rce->b_code;
 }
 
+/**
+ * Raise q until the VBV buffer is not predicted to underflow over the
+ * pictures already analysed by the b_frame_strategy 3 lookahead. The size
+ * of every upcoming picture is predicted from the size of the current one
+ * scaled by the ratio of their lookahead costs.
+ */
+static double lookahead_vbv_qscale(MpegEncContext *s, RateControlEntry *rce,
+                                   double q, int qmax)
+{
+    RateControlContext *rcc  = &s->rc_context;
+    const double buffer_size = s->avctx->rc_buffer_size;
+    const double max_rate    = s->avctx->rc_max_rate / get_fps(s->avctx);
+    const int cur_cost       = s->lookahead_cost[s->current_picture_ptr->f->display_picture_number % MAX_PICTURE_COUNT];
+    int cost[2 * MAX_PICTURE_COUNT];
+    int i, n = 0, iter;
+
+    if (cur_cost <= 0)
+        return q;
+
+    for (i = 1; i < MAX_PICTURE_COUNT && s->reordered_input_picture[i]; i++)
+        cost[n++] = s->lookahead_cost[s->reordered_input_picture[i]->f->display_picture_number % MAX_PICTURE_COUNT];
+    for (i = 0; i < MAX_PICTURE_COUNT && s->input_picture[i]; i++)
+        cost[n++] = s->lookahead_cost[s->input_picture[i]->f->display_picture_number % MAX_PICTURE_COUNT];
+
+    for (iter = 0; iter < 64 && q < qmax; iter++) {
+        double bits   = qp2bits(rce, q);
+        double buffer = rcc->buffer_index - bits;
+
+        for (i = 0; i < n && buffer >= 0; i++) {
+            buffer  = FFMIN(buffer + max_rate, buffer_size);
+            buffer -= bits * cost[i] / cur_cost;
+        }
+        if (buffer >= 0)
+            break;
+        q *= 1.05;
+    }
+
+    if (iter && s->avctx->debug & FF_DEBUG_RC)
+        av_log(s->avctx, AV_LOG_DEBUG, "lookahead VBV QP -> %f\n", q);
+
+    return FFMIN(q, qmax);
+}
+
 // FIXME rd or at least approx for dquant
 
 float ff_rate_estimate_qscale(MpegEncContext *s, int dry_run)
@@ -881,6 +924,8 @@ float ff_rate_estimate_qscale(MpegEncContext *s, int dry_run)
         av_assert0(q > 0.0);
 
         q = modify_qscale(s, rce, q, picture_number);
+        if (a->b_frame_strategy == 3 && a->rc_max_rate && a->rc_buffer_size)
+            q = lookahead_vbv_qscale(s, rce, q, qmax);
 
         rcc->pass1_wanted_bits += s->bit_rate / fps;
 
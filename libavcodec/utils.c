@@ -516,10 +516,13 @@ int avcodec_fill_audio_frame(AVFrame *frame, int nb_channels,
 static int update_frame_pool(AVCodecContext *avctx, AVFrame *frame)
 {
     FramePool *pool = avctx->internal->pool;
+    int category = avctx->codec && av_codec_is_encoder(avctx->codec) ?
+                   AV_CLASS_CATEGORY_ENCODER : AV_CLASS_CATEGORY_DECODER;
     int i, ret;
 
     switch (avctx->codec_type) {
     case AVMEDIA_TYPE_VIDEO: {
+        AVBufferRef *(*alloc)(int size) = av_buffer_get_frame_allocator();
         AVPicture picture;
         int size[4] = { 0 };
         int w = frame->width;
@@ -553,18 +556,23 @@ static int update_frame_pool(AVCodecContext *avctx, AVFrame *frame)
             size[i] = picture.data[i + 1] - picture.data[i];
         size[i] = tmpsize - (picture.data[i] - picture.data[0]);
 
+        if (!alloc)
+            alloc = CONFIG_MEMORY_POISONING ? NULL : av_buffer_allocz;
+
         for (i = 0; i < 4; i++) {
             av_buffer_pool_uninit(&pool->pools[i]);
             pool->linesize[i] = picture.linesize[i];
             if (size[i]) {
-                pool->pools[i] = av_buffer_pool_init(size[i] + 16 + STRIDE_ALIGN - 1,
-                                                     CONFIG_MEMORY_POISONING ?
-                                                        NULL :
-                                                        av_buffer_allocz);
+                // with frame threading buffers are released by other threads
+                pool->pools[i] = av_buffer_pool_init_flags(size[i] + 16 + STRIDE_ALIGN - 1,
+                                                           alloc,
+                                                           avctx->active_thread_type & FF_THREAD_FRAME ?
+                                                              AV_BUFFER_POOL_FLAG_THREAD_CACHE : 0);
                 if (!pool->pools[i]) {
                     ret = AVERROR(ENOMEM);
                     goto fail;
                 }
+                av_buffer_pool_set_category(pool->pools[i], category);
             }
         }
         pool->format = frame->format;
@@ -593,6 +601,7 @@ static int update_frame_pool(AVCodecContext *avctx, AVFrame *frame)
             ret = AVERROR(ENOMEM);
             goto fail;
         }
+        av_buffer_pool_set_category(pool->pools[0], category);
 
         pool->format     = frame->format;
         pool->planes     = planes;
@@ -84,9 +84,10 @@ static int decode_plane(UtvideoContext *c, int plane_no,
                         int width, int height,
                         const uint8_t *src, int use_pred)
 {
-    int i, j, slice, pix;
+    int i, j, k, slice, pix;
     int sstart, send;
     VLC vlc;
+    VLC_MULTI multi = { 0 };
     GetBitContext gb;
     int prev, fsym;
     const int cmask = ~(!plane_no && c->avctx->pix_fmt == AV_PIX_FMT_YUV420P);
@@ -120,6 +121,11 @@ static int decode_plane(UtvideoContext *c, int plane_no,
         return 0;
     }
 
+    if (ff_init_vlc_multi(&multi, &vlc) < 0) {
+        ff_free_vlc(&vlc);
+        return AVERROR(ENOMEM);
+    }
+
     src      += 256;
 
     send = 0;
@@ -152,22 +158,37 @@ static int decode_plane(UtvideoContext *c, int plane_no,
 
         prev = 0x80;
         for (j = sstart; j < send; j++) {
-            for (i = 0; i < width * step; i += step) {
+            for (i = 0; i < width * step;) {
+                uint8_t syms[8];
+                int n;
+
                 if (get_bits_left(&gb) <= 0) {
                     av_log(c->avctx, AV_LOG_ERROR,
                            "Slice decoding ran out of bits\n");
                     goto fail;
                 }
-                pix = get_vlc2(&gb, vlc.table, vlc.bits, 3);
-                if (pix < 0) {
+                /* several codes per lookup, as long as they can neither
+                 * run into the next line nor past the end of the slice */
+                if (i + VLC_MULTI_MAX_SYMBOLS * step <= width * step &&
+                    get_bits_left(&gb) >= vlc.bits) {
+                    n = get_vlc_multi(&gb, syms, multi.table, vlc.table,
+                                      vlc.bits, 3);
+                } else {
+                    syms[0] = pix = get_vlc2(&gb, vlc.table, vlc.bits, 3);
+                    n       = pix < 0 ? -1 : 1;
+                }
+                if (n < 0) {
                     av_log(c->avctx, AV_LOG_ERROR, "Decoding error\n");
                     goto fail;
                 }
-                if (use_pred) {
-                    prev += pix;
-                    pix   = prev;
+                for (k = 0; k < n; k++, i += step) {
+                    pix = syms[k];
+                    if (use_pred) {
+                        prev += pix;
+                        pix   = prev;
+                    }
+                    dest[i] = pix;
                 }
-                dest[i] = pix;
             }
             dest += stride;
         }
@@ -177,10 +198,12 @@ static int decode_plane(UtvideoContext *c, int plane_no,
     }
 
     ff_free_vlc(&vlc);
+    ff_free_vlc_multi(&multi);
 
     return 0;
 fail:
     ff_free_vlc(&vlc);
+    ff_free_vlc_multi(&multi);
     return AVERROR_INVALIDDATA;
 }
 
@@ -30,6 +30,7 @@
 #include "mpegutils.h"
 #include "mpegvideo.h"
 #include "msmpeg4data.h"
+#include "thread.h"
 #include "unary.h"
 #include "vc1.h"
 #include "vc1_pred.h"
@@ -2482,6 +2483,18 @@ static int vc1_decode_b_mb_intfr(VC1Context *v)
     return 0;
 }
 
+/** Report the rows of an anchor picture that are final to frame threads.
+ * The delayed overlap and loop filters may still modify the two MB rows
+ * above the current one, so progress lags the decoding position by two rows.
+ */
+static inline void vc1_report_decode_progress(VC1Context *v)
+{
+    MpegEncContext *s = &v->s;
+
+    if (!v->field_mode && s->pict_type != AV_PICTURE_TYPE_B && !s->er.error_occurred)
+        ff_thread_report_progress(&s->current_picture_ptr->tf, s->mb_y - 2, 0);
+}
+
 /** Decode blocks of I-frame
  */
 static void vc1_decode_i_blocks(VC1Context *v)
@@ -2616,6 +2629,7 @@ static void vc1_decode_i_blocks(VC1Context *v)
             ff_mpeg_draw_horiz_band(s, s->mb_y * 16, 16);
         else if (s->mb_y)
             ff_mpeg_draw_horiz_band(s, (s->mb_y - 1) * 16, 16);
+        vc1_report_decode_progress(v);
 
         s->first_slice_line = 0;
     }
@@ -2745,6 +2759,7 @@ static void vc1_decode_i_blocks_adv(VC1Context *v)
             ff_mpeg_draw_horiz_band(s, s->mb_y * 16, 16);
         else if (s->mb_y)
             ff_mpeg_draw_horiz_band(s, (s->mb_y-1) * 16, 16);
+        vc1_report_decode_progress(v);
         s->first_slice_line = 0;
     }
 
@@ -2824,6 +2839,7 @@ static void vc1_decode_p_blocks(VC1Context *v)
         memmove(v->luma_mv_base,  v->luma_mv,  sizeof(v->luma_mv_base[0])  * s->mb_stride);
         if (s->mb_y != s->start_mb_y)
             ff_mpeg_draw_horiz_band(s, (s->mb_y - 1) * 16, 16);
+        vc1_report_decode_progress(v);
         s->first_slice_line = 0;
     }
     if (apply_loop_filter) {
@@ -2871,6 +2887,10 @@ static void vc1_decode_b_blocks(VC1Context *v)
 
     s->first_slice_line = 1;
     for (s->mb_y = s->start_mb_y; s->mb_y < s->end_mb_y; s->mb_y++) {
+        /* direct mode reads the co-located motion vectors of the anchor */
+        if (HAVE_THREADS && s->avctx->active_thread_type & FF_THREAD_FRAME)
+            ff_thread_await_progress(&s->next_picture_ptr->tf,
+                                     v->field_mode ? INT_MAX : s->mb_y, 0);
         s->mb_x = 0;
         init_block_index(v);
         for (; s->mb_x < s->mb_width; s->mb_x++) {
@@ -2917,10 +2937,13 @@ static void vc1_decode_skip_blocks(VC1Context *v)
         s->mb_x = 0;
         init_block_index(v);
         ff_update_block_index(s);
+        if (HAVE_THREADS && s->avctx->active_thread_type & FF_THREAD_FRAME)
+            ff_thread_await_progress(&s->last_picture_ptr->tf, s->mb_y, 0);
         memcpy(s->dest[0], s->last_picture.f->data[0] + s->mb_y * 16 * s->linesize,   s->linesize   * 16);
         memcpy(s->dest[1], s->last_picture.f->data[1] + s->mb_y *  8 * s->uvlinesize, s->uvlinesize *  8);
         memcpy(s->dest[2], s->last_picture.f->data[2] + s->mb_y *  8 * s->uvlinesize, s->uvlinesize *  8);
         ff_mpeg_draw_horiz_band(s, s->mb_y * 16, 16);
+        vc1_report_decode_progress(v);
         s->first_slice_line = 0;
     }
     s->pict_type = AV_PICTURE_TYPE_P;
@@ -30,6 +30,7 @@
 #include "h264chroma.h"
 #include "mathops.h"
 #include "mpegvideo.h"
+#include "thread.h"
 #include "vc1.h"
 
 static av_always_inline void vc1_scale_luma(uint8_t *srcY,
@@ -166,6 +167,20 @@ static av_always_inline int get_chroma_mv(VC1Context *v, int dir, int16_t *tx, i
     return valid_count;
 }
 
+/**
+ * Wait until a reference picture is decoded down to luma line y.
+ * y is in lines of the current picture, i.e. field lines for field pictures.
+ */
+static av_always_inline void vc1_await_reference(VC1Context *v, Picture *ref, int y)
+{
+    MpegEncContext *s = &v->s;
+
+    if (HAVE_THREADS && ref && s->avctx->active_thread_type & FF_THREAD_FRAME) {
+        y = (y << v->field_mode) + v->field_mode;
+        ff_thread_await_progress(&ref->tf, FFMAX(y, 0) >> 4, 0);
+    }
+}
+
 /** Do motion compensation over 1 macroblock
  * Mostly adapted hpel_motion and qpel_motion from mpegvideo.c
  */
@@ -179,6 +194,7 @@ void ff_vc1_mc_1mv(VC1Context *v, int dir)
     int i;
     uint8_t (*luty)[256], (*lutuv)[256];
     int use_ic;
+    Picture *ref;
 
     if ((!v->field_mode ||
          (v->ref_field_type[dir] == 1 && v->cur_field_type == 1)) &&
@@ -220,6 +236,7 @@ void ff_vc1_mc_1mv(VC1Context *v, int dir)
             luty  = v->curr_luty;
             lutuv = v->curr_lutuv;
             use_ic = *v->curr_use_ic;
+            ref    = NULL;
         } else {
             srcY = s->last_picture.f->data[0];
             srcU = s->last_picture.f->data[1];
@@ -227,6 +244,7 @@ void ff_vc1_mc_1mv(VC1Context *v, int dir)
             luty  = v->last_luty;
             lutuv = v->last_lutuv;
             use_ic = v->last_use_ic;
+            ref    = s->last_picture_ptr;
         }
     } else {
         srcY = s->next_picture.f->data[0];
@@ -235,6 +253,7 @@ void ff_vc1_mc_1mv(VC1Context *v, int dir)
         luty  = v->next_luty;
         lutuv = v->next_lutuv;
         use_ic = v->next_use_ic;
+        ref    = s->next_picture_ptr;
     }
 
     if (!srcY || !srcU) {
@@ -259,6 +278,8 @@ void ff_vc1_mc_1mv(VC1Context *v, int dir)
         uvsrc_y = av_clip(uvsrc_y,  -8, s->avctx->coded_height >> 1);
     }
 
+    vc1_await_reference(v, ref, FFMAX(src_y + 18, 2 * uvsrc_y + 18));
+
     srcY += src_y   * s->linesize   + src_x;
     srcU += uvsrc_y * s->uvlinesize + uvsrc_x;
     srcV += uvsrc_y * s->uvlinesize + uvsrc_x;
@@ -358,6 +379,7 @@ void ff_vc1_mc_4mv_luma(VC1Context *v, int n, int dir, int avg)
     int v_edge_pos = s->v_edge_pos >> v->field_mode;
     uint8_t (*luty)[256];
     int use_ic;
+    Picture *ref;
 
     if ((!v->field_mode ||
          (v->ref_field_type[dir] == 1 && v->cur_field_type == 1)) &&
@@ -372,15 +394,18 @@ void ff_vc1_mc_4mv_luma(VC1Context *v, int n, int dir, int avg)
             srcY = s->current_picture.f->data[0];
             luty = v->curr_luty;
             use_ic = *v->curr_use_ic;
+            ref  = NULL;
         } else {
             srcY = s->last_picture.f->data[0];
             luty = v->last_luty;
             use_ic = v->last_use_ic;
+            ref  = s->last_picture_ptr;
         }
     } else {
         srcY = s->next_picture.f->data[0];
         luty = v->next_luty;
         use_ic = v->next_use_ic;
+        ref  = s->next_picture_ptr;
     }
 
     if (!srcY) {
@@ -449,6 +474,8 @@ void ff_vc1_mc_4mv_luma(VC1Context *v, int n, int dir, int avg)
         }
     }
 
+    vc1_await_reference(v, ref, src_y + (11 << fieldmv));
+
     srcY += src_y * s->linesize + src_x;
     if (v->field_mode && v->ref_field_type[dir])
         srcY += s->current_picture_ptr->f->linesize[0];
@@ -515,6 +542,7 @@ void ff_vc1_mc_4mv_chroma(VC1Context *v, int dir)
     int v_edge_pos = s->v_edge_pos >> v->field_mode;
     uint8_t (*lutuv)[256];
     int use_ic;
+    Picture *ref;
 
     if (!v->field_mode && !v->s.last_picture.f->data[0])
         return;
@@ -570,17 +598,20 @@ void ff_vc1_mc_4mv_chroma(VC1Context *v, int dir)
             srcV = s->current_picture.f->data[2];
             lutuv = v->curr_lutuv;
             use_ic = *v->curr_use_ic;
+            ref   = NULL;
         } else {
             srcU = s->last_picture.f->data[1];
             srcV = s->last_picture.f->data[2];
             lutuv = v->last_lutuv;
             use_ic = v->last_use_ic;
+            ref   = s->last_picture_ptr;
         }
     } else {
         srcU = s->next_picture.f->data[1];
         srcV = s->next_picture.f->data[2];
         lutuv = v->next_lutuv;
         use_ic = v->next_use_ic;
+        ref   = s->next_picture_ptr;
     }
 
     if (!srcU) {
@@ -588,6 +619,8 @@ void ff_vc1_mc_4mv_chroma(VC1Context *v, int dir)
         return;
     }
 
+    vc1_await_reference(v, ref, 2 * uvsrc_y + 18);
+
     srcU += uvsrc_y * s->uvlinesize + uvsrc_x;
     srcV += uvsrc_y * s->uvlinesize + uvsrc_x;
 
@@ -654,6 +687,7 @@ void ff_vc1_mc_4mv_chroma4(VC1Context *v, int dir, int dir2, int avg)
     int v_edge_pos = s->v_edge_pos >> 1;
     int use_ic;
     uint8_t (*lutuv)[256];
+    Picture *ref;
 
     if (CONFIG_GRAY && s->avctx->flags & AV_CODEC_FLAG_GRAY)
         return;
@@ -681,14 +715,17 @@ void ff_vc1_mc_4mv_chroma4(VC1Context *v, int dir, int dir2, int avg)
             srcV = s->next_picture.f->data[2];
             lutuv  = v->next_lutuv;
             use_ic = v->next_use_ic;
+            ref    = s->next_picture_ptr;
         } else {
             srcU = s->last_picture.f->data[1];
             srcV = s->last_picture.f->data[2];
             lutuv  = v->last_lutuv;
             use_ic = v->last_use_ic;
+            ref    = s->last_picture_ptr;
         }
         if (!srcU)
             return;
+        vc1_await_reference(v, ref, 2 * (uvsrc_y + (5 << fieldmv)) + 1);
         srcU += uvsrc_y * s->uvlinesize + uvsrc_x;
         srcV += uvsrc_y * s->uvlinesize + uvsrc_x;
         uvmx_field[i] = (uvmx_field[i] & 3) << 1;
@@ -790,6 +827,8 @@ void ff_vc1_interp_mc(VC1Context *v)
         uvsrc_y = av_clip(uvsrc_y,  -8, s->avctx->coded_height >> 1);
     }
 
+    vc1_await_reference(v, s->next_picture_ptr, FFMAX(src_y + 18, 2 * uvsrc_y + 18));
+
     srcY += src_y   * s->linesize   + src_x;
     srcU += uvsrc_y * s->uvlinesize + uvsrc_x;
     srcV += uvsrc_y * s->uvlinesize + uvsrc_x;
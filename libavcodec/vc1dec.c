@@ -34,6 +34,7 @@
 #include "mpegvideo.h"
 #include "msmpeg4.h"
 #include "msmpeg4data.h"
+#include "thread.h"
 #include "vc1.h"
 #include "vc1data.h"
 #include "vdpau_compat.h"
@@ -346,7 +347,7 @@ av_cold int ff_vc1_decode_init_alloc_tables(VC1Context *v)
     v->luma_mv          = v->luma_mv_base + s->mb_stride;
 
     /* allocate block type info in that way so it could be used with s->block_index[] */
-    v->mb_type_base = av_malloc(s->b8_stride * (mb_height * 2 + 1) + s->mb_stride * (mb_height + 1) * 2);
+    v->mb_type_base = av_mallocz(s->b8_stride * (mb_height * 2 + 1) + s->mb_stride * (mb_height + 1) * 2);
     v->mb_type[0]   = v->mb_type_base + s->b8_stride + 1;
     v->mb_type[1]   = v->mb_type_base + s->b8_stride * (mb_height * 2 + 1) + s->mb_stride + 1;
     v->mb_type[2]   = v->mb_type[1] + s->mb_stride * (mb_height + 1);
@@ -537,6 +538,7 @@ static av_cold int vc1_decode_init(AVCodecContext *avctx)
         return AVERROR(ENOMEM);
 
     avctx->has_b_frames = !!avctx->max_b_frames;
+    avctx->internal->allocate_progress = 1;
 
     if (v->color_prim == 1 || v->color_prim == 5 || v->color_prim == 6)
         avctx->color_primaries = v->color_prim;
@@ -577,6 +579,115 @@ static av_cold int vc1_decode_init(AVCodecContext *avctx)
     return 0;
 }
 
+static av_cold int vc1_decode_init_thread_copy(AVCodecContext *avctx)
+{
+    VC1Context *v = avctx->priv_data;
+
+    v->s.avctx = avctx;
+    // only the sprite decoders use it and they are not frame threaded
+    v->sprite_output_frame = NULL;
+
+    return 0;
+}
+
+static int vc1_update_thread_context(AVCodecContext *dst, const AVCodecContext *src)
+{
+    VC1Context *v = dst->priv_data;
+    const VC1Context *v1 = src->priv_data;
+    MpegEncContext *s = &v->s;
+    const MpegEncContext *s1 = &v1->s;
+    int ret;
+
+    if (dst == src || !s1->context_initialized)
+        return 0;
+
+    // the VC-1 tables depend on the frame size, reallocate everything
+    if (s->context_initialized &&
+        (s->width != s1->width || s->height != s1->height))
+        ff_vc1_decode_end(dst);
+
+    if ((ret = ff_mpeg_update_thread_context(dst, src)) < 0)
+        return ret;
+
+    if (!v->block && (ret = ff_vc1_decode_init_alloc_tables(v)) < 0)
+        return ret;
+
+    // sequence header and entry point
+    memcpy(&v->res_sprite, &v1->res_sprite,
+           (const char *)&v1->finterpflag + sizeof(v1->finterpflag) -
+           (const char *)&v1->res_sprite);
+    v->hrd_num_leaky_buckets = v1->hrd_num_leaky_buckets;
+    v->bit_rate_exponent     = v1->bit_rate_exponent;
+    v->buffer_size_exponent  = v1->buffer_size_exponent;
+    v->broken_link           = v1->broken_link;
+    v->closed_entry          = v1->closed_entry;
+    v->range_mapy_flag       = v1->range_mapy_flag;
+    v->range_mapuv_flag      = v1->range_mapuv_flag;
+    v->range_mapy            = v1->range_mapy;
+    v->range_mapuv           = v1->range_mapuv;
+    s->loop_filter           = s1->loop_filter;
+
+    // state carried over from the previous pictures
+    s->quarter_sample = s1->quarter_sample;
+    s->mspel          = s1->mspel;
+    v->mv_mode        = v1->mv_mode;
+    v->mv_mode2       = v1->mv_mode2;
+    v->qs_last        = v1->qs_last;
+    v->rnd            = v1->rnd;
+    v->respic         = v1->respic;
+    v->refdist        = v1->refdist;
+    v->tff            = v1->tff;
+    v->rff            = v1->rff;
+    v->rptfrm         = v1->rptfrm;
+    v->ref_field_type[0] = v1->ref_field_type[0];
+    v->ref_field_type[1] = v1->ref_field_type[1];
+    v->reffield       = v1->reffield;
+    v->pq             = v1->pq;
+    v->halfpq         = v1->halfpq;
+    v->altpq          = v1->altpq;
+    // DQUANT == 2 does not code these and keeps the previous values
+    v->dquantfrm      = v1->dquantfrm;
+    v->dqprofile      = v1->dqprofile;
+    v->dqsbedge       = v1->dqsbedge;
+    v->dqbilevel      = v1->dqbilevel;
+
+    // intensity compensation
+    memcpy(v->last_luty, v1->last_luty, sizeof(v->last_luty));
+    memcpy(v->last_lutuv, v1->last_lutuv, sizeof(v->last_lutuv));
+    memcpy(v->aux_luty, v1->aux_luty, sizeof(v->aux_luty));
+    memcpy(v->aux_lutuv, v1->aux_lutuv, sizeof(v->aux_lutuv));
+    memcpy(v->next_luty, v1->next_luty, sizeof(v->next_luty));
+    memcpy(v->next_lutuv, v1->next_lutuv, sizeof(v->next_lutuv));
+    v->last_use_ic = v1->last_use_ic;
+    v->next_use_ic = v1->next_use_ic;
+    v->aux_use_ic  = v1->aux_use_ic;
+    v->curr_luty   = !v1->curr_luty ? NULL :
+                     v1->curr_luty == v1->aux_luty ? v->aux_luty : v->next_luty;
+    v->curr_lutuv  = !v1->curr_lutuv ? NULL :
+                     v1->curr_lutuv == v1->aux_lutuv ? v->aux_lutuv : v->next_lutuv;
+    v->curr_use_ic = !v1->curr_use_ic ? NULL :
+                     v1->curr_use_ic == &v1->aux_use_ic ? &v->aux_use_ic : &v->next_use_ic;
+
+    // field MV flags of the last anchor, used by field B-pictures
+    if (v1->mv_f_next[0]) {
+        int mb_height = FFALIGN(s->mb_height, 2);
+        int size      = s->b8_stride * (mb_height * 2 + 1) + s->mb_stride * (mb_height + 1) * 2;
+
+        memcpy(v->mv_f_next[0] - s->b8_stride - 1,
+               v1->mv_f_next[0] - s1->b8_stride - 1, 2 * size);
+        /* field pictures are fully decoded before the next thread starts,
+         * so the block info their successor may predict from is final */
+        if (v1->field_mode) {
+            memcpy(v->mv_f[0] - s->b8_stride - 1,
+                   v1->mv_f[0] - s1->b8_stride - 1, 2 * size);
+            memcpy(v->mb_type_base, v1->mb_type_base, size);
+            memcpy(v->blk_mv_type_base, v1->blk_mv_type_base, size);
+        }
+    }
+
+    return 0;
+}
+
 /** Close a VC1/WMV3 decoder
  * @warning Initial try at using MpegEncContext stuff
  */
@@ -625,7 +736,7 @@ static int vc1_decode_frame(AVCodecContext *avctx, void *data,
     AVFrame *pict = data;
     uint8_t *buf2 = NULL;
     const uint8_t *buf_start = buf, *buf_start_second_field = NULL;
-    int mb_height, n_slices1=-1;
+    int mb_height, n_slices1=-1, frame_started = 0;
     struct {
         uint8_t *buf;
         GetBitContext gb;
@@ -885,6 +996,7 @@ static int vc1_decode_frame(AVCodecContext *avctx, void *data,
     if ((ret = ff_mpv_frame_start(s, avctx)) < 0) {
         goto err;
     }
+    frame_started = 1;
 
     v->s.current_picture_ptr->field_picture = v->field_mode;
     v->s.current_picture_ptr->f->interlaced_frame = (v->fcm != PROGRESSIVE);
@@ -902,6 +1014,11 @@ static int vc1_decode_frame(AVCodecContext *avctx, void *data,
         s->current_picture_ptr->f->repeat_pict = v->rptfrm * 2;
     }
 
+    /* The second field header may still change the decoder state, so
+     * field pictures only let the next frame start once they are done. */
+    if (!v->field_mode)
+        ff_thread_finish_setup(avctx);
+
     s->me.qpel_put = s->qdsp.put_qpel_pixels_tab;
     s->me.qpel_avg = s->qdsp.avg_qpel_pixels_tab;
 
@@ -1045,6 +1162,7 @@ static int vc1_decode_frame(AVCodecContext *avctx, void *data,
                 FFSWAP(uint8_t *, v->mv_f_next[0], v->mv_f[0]);
                 FFSWAP(uint8_t *, v->mv_f_next[1], v->mv_f[1]);
             }
+            ff_thread_finish_setup(avctx);
         }
         ff_dlog(s->avctx, "Consumed %i/%i bits\n",
                 get_bits_count(&s->gb), s->gb.size_in_bits);
@@ -1095,6 +1213,8 @@ end:
     return buf_size;
 
 err:
+    if (frame_started)
+        ff_thread_report_progress(&s->current_picture_ptr->tf, INT_MAX, 0);
     av_free(buf2);
     for (i = 0; i < n_slices; i++)
         av_free(slices[i].buf);
@@ -1138,9 +1258,12 @@ AVCodec ff_vc1_decoder = {
     .close          = ff_vc1_decode_end,
     .decode         = vc1_decode_frame,
     .flush          = ff_mpeg_flush,
-    .capabilities   = AV_CODEC_CAP_DR1 | AV_CODEC_CAP_DELAY,
+    .capabilities   = AV_CODEC_CAP_DR1 | AV_CODEC_CAP_DELAY |
+                      AV_CODEC_CAP_FRAME_THREADS,
     .pix_fmts       = vc1_hwaccel_pixfmt_list_420,
-    .profiles       = NULL_IF_CONFIG_SMALL(profiles)
+    .profiles       = NULL_IF_CONFIG_SMALL(profiles),
+    .init_thread_copy      = ONLY_IF_THREADS_ENABLED(vc1_decode_init_thread_copy),
+    .update_thread_context = ONLY_IF_THREADS_ENABLED(vc1_update_thread_context),
 };
 
 #if CONFIG_WMV3_DECODER
@@ -1154,9 +1277,12 @@ AVCodec ff_wmv3_decoder = {
     .close          = ff_vc1_decode_end,
     .decode         = vc1_decode_frame,
     .flush          = ff_mpeg_flush,
-    .capabilities   = AV_CODEC_CAP_DR1 | AV_CODEC_CAP_DELAY,
+    .capabilities   = AV_CODEC_CAP_DR1 | AV_CODEC_CAP_DELAY |
+                      AV_CODEC_CAP_FRAME_THREADS,
     .pix_fmts       = vc1_hwaccel_pixfmt_list_420,
-    .profiles       = NULL_IF_CONFIG_SMALL(profiles)
+    .profiles       = NULL_IF_CONFIG_SMALL(profiles),
+    .init_thread_copy      = ONLY_IF_THREADS_ENABLED(vc1_decode_init_thread_copy),
+    .update_thread_context = ONLY_IF_THREADS_ENABLED(vc1_update_thread_context),
 };
 #endif
 
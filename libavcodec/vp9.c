@@ -32,6 +32,7 @@
 #include "vp9dsp.h"
 #include "libavutil/avassert.h"
 #include "libavutil/pixdesc.h"
+#include "libavutil/thread.h"
 
 #define VP9_SYNCCODE 0x498342
 
@@ -254,6 +255,21 @@ typedef struct VP9Context {
     DECLARE_ALIGNED(32, uint8_t, tmp_uv)[2][64 * 64 * 2];
     uint16_t mvscale[3][2];
     uint8_t mvstep[3][2];
+
+    // slice threading: one context per tile column, see decode_tiles_slice()
+    struct VP9Context *td;
+    int nb_td;
+    VP9Block *td_b_base;
+    int16_t *td_block_base;
+    unsigned td_block_size;
+    struct VP9Filter *td_lflvl;
+    unsigned td_lflvl_size;
+    int *sb_row_progress;
+    unsigned sb_row_progress_size;
+    int lf_sb_row, lf_busy;
+#if HAVE_THREADS
+    pthread_mutex_t progress_mutex;
+#endif
 } VP9Context;
 
 static const uint8_t bwh_tab[2][N_BS_SIZES][2] = {
@@ -846,14 +862,13 @@ static int decode_frame_header(AVCodecContext *ctx,
     }
     s->tiling.log2_tile_rows = decode012(&s->gb);
     s->tiling.tile_rows = 1 << s->tiling.log2_tile_rows;
-    if (s->tiling.tile_cols != (1 << s->tiling.log2_tile_cols)) {
-        s->tiling.tile_cols = 1 << s->tiling.log2_tile_cols;
-        s->c_b = av_fast_realloc(s->c_b, &s->c_b_size,
-                                 sizeof(VP56RangeCoder) * s->tiling.tile_cols);
-        if (!s->c_b) {
-            av_log(ctx, AV_LOG_ERROR, "Ran out of memory during range coder init\n");
-            return AVERROR(ENOMEM);
-        }
+    s->tiling.tile_cols = 1 << s->tiling.log2_tile_cols;
+    // slice threading sets up the range coders of all tile rows at once
+    s->c_b = av_fast_realloc(s->c_b, &s->c_b_size,
+                             sizeof(VP56RangeCoder) * s->tiling.tile_cols * s->tiling.tile_rows);
+    if (!s->c_b) {
+        av_log(ctx, AV_LOG_ERROR, "Ran out of memory during range coder init\n");
+        return AVERROR(ENOMEM);
     }
 
     if (s->keyframe || s->errorres || (s->intraonly && s->resetctx == 3)) {
@@ -1462,7 +1477,7 @@ static av_always_inline void setctx_2d(uint8_t *ptr, int w, int h,
     }
 }
 
-static void decode_mode(AVCodecContext *ctx)
+static void decode_mode(VP9Context *s)
 {
     static const uint8_t left_ctx[N_BS_SIZES] = {
         0x0, 0x8, 0x0, 0x8, 0xc, 0x8, 0xc, 0xe, 0xc, 0xe, 0xf, 0xe, 0xf
@@ -1474,7 +1489,6 @@ static void decode_mode(AVCodecContext *ctx)
         TX_32X32, TX_32X32, TX_32X32, TX_32X32, TX_16X16, TX_16X16,
         TX_16X16, TX_8X8, TX_8X8, TX_8X8, TX_4X4, TX_4X4, TX_4X4
     };
-    VP9Context *s = ctx->priv_data;
     VP9Block *b = s->b;
     int row = s->row, col = s->col, row7 = s->row7;
     enum TxfmMode max_tx = max_tx_for_bl_bp[b->bs];
@@ -2331,9 +2345,8 @@ static int decode_coeffs_b32_16bpp(VP9Context *s, int16_t *coef, int n_coeffs,
                                    nnz, scan, nb, band_counts, qmul);
 }
 
-static av_always_inline int decode_coeffs(AVCodecContext *ctx, int is8bitsperpixel)
+static av_always_inline int decode_coeffs(VP9Context *s, int is8bitsperpixel)
 {
-    VP9Context *s = ctx->priv_data;
     VP9Block *b = s->b;
     int row = s->row, col = s->col;
     uint8_t (*p)[6][11] = s->prob.coef[b->tx][0 /* y */][!b->intra];
@@ -2498,14 +2511,14 @@ static av_always_inline int decode_coeffs(AVCodecContext *ctx, int is8bitsperpix
     return total_coeff;
 }
 
-static int decode_coeffs_8bpp(AVCodecContext *ctx)
+static int decode_coeffs_8bpp(VP9Context *s)
 {
-    return decode_coeffs(ctx, 1);
+    return decode_coeffs(s, 1);
 }
 
-static int decode_coeffs_16bpp(AVCodecContext *ctx)
+static int decode_coeffs_16bpp(VP9Context *s)
 {
-    return decode_coeffs(ctx, 0);
+    return decode_coeffs(s, 0);
 }
 
 static av_always_inline int check_intra_mode(VP9Context *s, int mode, uint8_t **a,
@@ -2689,10 +2702,9 @@ static av_always_inline int check_intra_mode(VP9Context *s, int mode, uint8_t **
     return mode;
 }
 
-static av_always_inline void intra_recon(AVCodecContext *ctx, ptrdiff_t y_off,
+static av_always_inline void intra_recon(VP9Context *s, ptrdiff_t y_off,
                                          ptrdiff_t uv_off, int bytesperpixel)
 {
-    VP9Context *s = ctx->priv_data;
     VP9Block *b = s->b;
     int row = s->row, col = s->col;
     int w4 = bwh_tab[1][b->bs][0] << 1, step1d = 1 << b->tx, n;
@@ -2759,14 +2771,14 @@ static av_always_inline void intra_recon(AVCodecContext *ctx, ptrdiff_t y_off,
     }
 }
 
-static void intra_recon_8bpp(AVCodecContext *ctx, ptrdiff_t y_off, ptrdiff_t uv_off)
+static void intra_recon_8bpp(VP9Context *s, ptrdiff_t y_off, ptrdiff_t uv_off)
 {
-    intra_recon(ctx, y_off, uv_off, 1);
+    intra_recon(s, y_off, uv_off, 1);
 }
 
-static void intra_recon_16bpp(AVCodecContext *ctx, ptrdiff_t y_off, ptrdiff_t uv_off)
+static void intra_recon_16bpp(VP9Context *s, ptrdiff_t y_off, ptrdiff_t uv_off)
 {
-    intra_recon(ctx, y_off, uv_off, 2);
+    intra_recon(s, y_off, uv_off, 2);
 }
 
 static av_always_inline void mc_luma_scaled(VP9Context *s, vp9_scaled_mc_func smc,
@@ -3009,23 +3021,22 @@ static av_always_inline void mc_chroma_unscaled(VP9Context *s, vp9_mc_func (*mc)
 #undef BYTES_PER_PIXEL
 #undef SCALED
 
-static av_always_inline void inter_recon(AVCodecContext *ctx, int bytesperpixel)
+static av_always_inline void inter_recon(VP9Context *s, int bytesperpixel)
 {
-    VP9Context *s = ctx->priv_data;
     VP9Block *b = s->b;
     int row = s->row, col = s->col;
 
     if (s->mvscale[b->ref[0]][0] || (b->comp && s->mvscale[b->ref[1]][0])) {
         if (bytesperpixel == 1) {
-            inter_pred_scaled_8bpp(ctx);
+            inter_pred_scaled_8bpp(s);
         } else {
-            inter_pred_scaled_16bpp(ctx);
+            inter_pred_scaled_16bpp(s);
         }
     } else {
         if (bytesperpixel == 1) {
-            inter_pred_8bpp(ctx);
+            inter_pred_8bpp(s);
         } else {
-            inter_pred_16bpp(ctx);
+            inter_pred_16bpp(s);
         }
     }
     if (!b->skip) {
@@ -3075,14 +3086,14 @@ static av_always_inline void inter_recon(AVCodecContext *ctx, int bytesperpixel)
     }
 }
 
-static void inter_recon_8bpp(AVCodecContext *ctx)
+static void inter_recon_8bpp(VP9Context *s)
 {
-    inter_recon(ctx, 1);
+    inter_recon(s, 1);
 }
 
-static void inter_recon_16bpp(AVCodecContext *ctx)
+static void inter_recon_16bpp(VP9Context *s)
 {
-    inter_recon(ctx, 2);
+    inter_recon(s, 2);
 }
 
 static av_always_inline void mask_edges(uint8_t (*mask)[8][4], int ss_h, int ss_v,
@@ -3207,11 +3218,10 @@ static av_always_inline void mask_edges(uint8_t (*mask)[8][4], int ss_h, int ss_
     }
 }
 
-static void decode_b(AVCodecContext *ctx, int row, int col,
+static void decode_b(VP9Context *s, int row, int col,
                      struct VP9Filter *lflvl, ptrdiff_t yoff, ptrdiff_t uvoff,
                      enum BlockLevel bl, enum BlockPartition bp)
 {
-    VP9Context *s = ctx->priv_data;
     VP9Block *b = s->b;
     enum BlockSize bs = bl * 3 + bp;
     int bytesperpixel = s->bytesperpixel;
@@ -3231,7 +3241,7 @@ static void decode_b(AVCodecContext *ctx, int row, int col,
         b->bs = bs;
         b->bl = bl;
         b->bp = bp;
-        decode_mode(ctx);
+        decode_mode(s);
         b->uvtx = b->tx - ((s->ss_h && w4 * 2 == (1 << b->tx)) ||
                            (s->ss_v && h4 * 2 == (1 << b->tx)));
 
@@ -3239,9 +3249,9 @@ static void decode_b(AVCodecContext *ctx, int row, int col,
             int has_coeffs;
 
             if (bytesperpixel == 1) {
-                has_coeffs = decode_coeffs_8bpp(ctx);
+                has_coeffs = decode_coeffs_8bpp(s);
             } else {
-                has_coeffs = decode_coeffs_16bpp(ctx);
+                has_coeffs = decode_coeffs_16bpp(s);
             }
             if (!has_coeffs && b->bs <= BS_8x8 && !b->intra) {
                 b->skip = 1;
@@ -3322,15 +3332,15 @@ static void decode_b(AVCodecContext *ctx, int row, int col,
     }
     if (b->intra) {
         if (s->bpp > 8) {
-            intra_recon_16bpp(ctx, yoff, uvoff);
+            intra_recon_16bpp(s, yoff, uvoff);
         } else {
-            intra_recon_8bpp(ctx, yoff, uvoff);
+            intra_recon_8bpp(s, yoff, uvoff);
         }
     } else {
         if (s->bpp > 8) {
-            inter_recon_16bpp(ctx);
+            inter_recon_16bpp(s);
         } else {
-            inter_recon_8bpp(ctx);
+            inter_recon_8bpp(s);
         }
     }
     if (emu[0]) {
@@ -3406,10 +3416,9 @@ static void decode_b(AVCodecContext *ctx, int row, int col,
     }
 }
 
-static void decode_sb(AVCodecContext *ctx, int row, int col, struct VP9Filter *lflvl,
+static void decode_sb(VP9Context *s, int row, int col, struct VP9Filter *lflvl,
                       ptrdiff_t yoff, ptrdiff_t uvoff, enum BlockLevel bl)
 {
-    VP9Context *s = ctx->priv_data;
     int c = ((s->above_partition_ctx[col] >> (3 - bl)) & 1) |
             (((s->left_partition_ctx[row & 0x7] >> (3 - bl)) & 1) << 1);
     const uint8_t *p = s->keyframe || s->intraonly ? vp9_default_kf_partition_probs[bl][c] :
@@ -3422,35 +3431,35 @@ static void decode_sb(AVCodecContext *ctx, int row, int col, struct VP9Filter *l
 
     if (bl == BL_8X8) {
         bp = vp8_rac_get_tree(&s->c, vp9_partition_tree, p);
-        decode_b(ctx, row, col, lflvl, yoff, uvoff, bl, bp);
+        decode_b(s, row, col, lflvl, yoff, uvoff, bl, bp);
     } else if (col + hbs < s->cols) { // FIXME why not <=?
         if (row + hbs < s->rows) { // FIXME why not <=?
             bp = vp8_rac_get_tree(&s->c, vp9_partition_tree, p);
             switch (bp) {
             case PARTITION_NONE:
-                decode_b(ctx, row, col, lflvl, yoff, uvoff, bl, bp);
+                decode_b(s, row, col, lflvl, yoff, uvoff, bl, bp);
                 break;
             case PARTITION_H:
-                decode_b(ctx, row, col, lflvl, yoff, uvoff, bl, bp);
+                decode_b(s, row, col, lflvl, yoff, uvoff, bl, bp);
                 yoff  += hbs * 8 * y_stride;
                 uvoff += hbs * 8 * uv_stride >> s->ss_v;
-                decode_b(ctx, row + hbs, col, lflvl, yoff, uvoff, bl, bp);
+                decode_b(s, row + hbs, col, lflvl, yoff, uvoff, bl, bp);
                 break;
             case PARTITION_V:
-                decode_b(ctx, row, col, lflvl, yoff, uvoff, bl, bp);
+                decode_b(s, row, col, lflvl, yoff, uvoff, bl, bp);
                 yoff  += hbs * 8 * bytesperpixel;
                 uvoff += hbs * 8 * bytesperpixel >> s->ss_h;
-                decode_b(ctx, row, col + hbs, lflvl, yoff, uvoff, bl, bp);
+                decode_b(s, row, col + hbs, lflvl, yoff, uvoff, bl, bp);
                 break;
             case PARTITION_SPLIT:
-                decode_sb(ctx, row, col, lflvl, yoff, uvoff, bl + 1);
-                decode_sb(ctx, row, col + hbs, lflvl,
+                decode_sb(s, row, col, lflvl, yoff, uvoff, bl + 1);
+                decode_sb(s, row, col + hbs, lflvl,
                           yoff + 8 * hbs * bytesperpixel,
                           uvoff + (8 * hbs * bytesperpixel >> s->ss_h), bl + 1);
                 yoff  += hbs * 8 * y_stride;
                 uvoff += hbs * 8 * uv_stride >> s->ss_v;
-                decode_sb(ctx, row + hbs, col, lflvl, yoff, uvoff, bl + 1);
-                decode_sb(ctx, row + hbs, col + hbs, lflvl,
+                decode_sb(s, row + hbs, col, lflvl, yoff, uvoff, bl + 1);
+                decode_sb(s, row + hbs, col + hbs, lflvl,
                           yoff + 8 * hbs * bytesperpixel,
                           uvoff + (8 * hbs * bytesperpixel >> s->ss_h), bl + 1);
                 break;
@@ -3459,36 +3468,35 @@ static void decode_sb(AVCodecContext *ctx, int row, int col, struct VP9Filter *l
             }
         } else if (vp56_rac_get_prob_branchy(&s->c, p[1])) {
             bp = PARTITION_SPLIT;
-            decode_sb(ctx, row, col, lflvl, yoff, uvoff, bl + 1);
-            decode_sb(ctx, row, col + hbs, lflvl,
+            decode_sb(s, row, col, lflvl, yoff, uvoff, bl + 1);
+            decode_sb(s, row, col + hbs, lflvl,
                       yoff + 8 * hbs * bytesperpixel,
                       uvoff + (8 * hbs * bytesperpixel >> s->ss_h), bl + 1);
         } else {
             bp = PARTITION_H;
-            decode_b(ctx, row, col, lflvl, yoff, uvoff, bl, bp);
+            decode_b(s, row, col, lflvl, yoff, uvoff, bl, bp);
         }
     } else if (row + hbs < s->rows) { // FIXME why not <=?
         if (vp56_rac_get_prob_branchy(&s->c, p[2])) {
             bp = PARTITION_SPLIT;
-            decode_sb(ctx, row, col, lflvl, yoff, uvoff, bl + 1);
+            decode_sb(s, row, col, lflvl, yoff, uvoff, bl + 1);
             yoff  += hbs * 8 * y_stride;
             uvoff += hbs * 8 * uv_stride >> s->ss_v;
-            decode_sb(ctx, row + hbs, col, lflvl, yoff, uvoff, bl + 1);
+            decode_sb(s, row + hbs, col, lflvl, yoff, uvoff, bl + 1);
         } else {
             bp = PARTITION_V;
-            decode_b(ctx, row, col, lflvl, yoff, uvoff, bl, bp);
+            decode_b(s, row, col, lflvl, yoff, uvoff, bl, bp);
         }
     } else {
         bp = PARTITION_SPLIT;
-        decode_sb(ctx, row, col, lflvl, yoff, uvoff, bl + 1);
+        decode_sb(s, row, col, lflvl, yoff, uvoff, bl + 1);
     }
     s->counts.partition[bl][c][bp]++;
 }
 
-static void decode_sb_mem(AVCodecContext *ctx, int row, int col, struct VP9Filter *lflvl,
+static void decode_sb_mem(VP9Context *s, int row, int col, struct VP9Filter *lflvl,
                           ptrdiff_t yoff, ptrdiff_t uvoff, enum BlockLevel bl)
 {
-    VP9Context *s = ctx->priv_data;
     VP9Block *b = s->b;
     ptrdiff_t hbs = 4 >> bl;
     AVFrame *f = s->frames[CUR_FRAME].tf.f;
@@ -3497,39 +3505,39 @@ static void decode_sb_mem(AVCodecContext *ctx, int row, int col, struct VP9Filte
 
     if (bl == BL_8X8) {
         av_assert2(b->bl == BL_8X8);
-        decode_b(ctx, row, col, lflvl, yoff, uvoff, b->bl, b->bp);
+        decode_b(s, row, col, lflvl, yoff, uvoff, b->bl, b->bp);
     } else if (s->b->bl == bl) {
-        decode_b(ctx, row, col, lflvl, yoff, uvoff, b->bl, b->bp);
+        decode_b(s, row, col, lflvl, yoff, uvoff, b->bl, b->bp);
         if (b->bp == PARTITION_H && row + hbs < s->rows) {
             yoff  += hbs * 8 * y_stride;
             uvoff += hbs * 8 * uv_stride >> s->ss_v;
-            decode_b(ctx, row + hbs, col, lflvl, yoff, uvoff, b->bl, b->bp);
+            decode_b(s, row + hbs, col, lflvl, yoff, uvoff, b->bl, b->bp);
         } else if (b->bp == PARTITION_V && col + hbs < s->cols) {
             yoff  += hbs * 8 * bytesperpixel;
             uvoff += hbs * 8 * bytesperpixel >> s->ss_h;
-            decode_b(ctx, row, col + hbs, lflvl, yoff, uvoff, b->bl, b->bp);
+            decode_b(s, row, col + hbs, lflvl, yoff, uvoff, b->bl, b->bp);
         }
     } else {
-        decode_sb_mem(ctx, row, col, lflvl, yoff, uvoff, bl + 1);
+        decode_sb_mem(s, row, col, lflvl, yoff, uvoff, bl + 1);
         if (col + hbs < s->cols) { // FIXME why not <=?
             if (row + hbs < s->rows) {
-                decode_sb_mem(ctx, row, col + hbs, lflvl, yoff + 8 * hbs * bytesperpixel,
+                decode_sb_mem(s, row, col + hbs, lflvl, yoff + 8 * hbs * bytesperpixel,
                               uvoff + (8 * hbs * bytesperpixel >> s->ss_h), bl + 1);
                 yoff  += hbs * 8 * y_stride;
                 uvoff += hbs * 8 * uv_stride >> s->ss_v;
-                decode_sb_mem(ctx, row + hbs, col, lflvl, yoff, uvoff, bl + 1);
-                decode_sb_mem(ctx, row + hbs, col + hbs, lflvl,
+                decode_sb_mem(s, row + hbs, col, lflvl, yoff, uvoff, bl + 1);
+                decode_sb_mem(s, row + hbs, col + hbs, lflvl,
                               yoff + 8 * hbs * bytesperpixel,
                               uvoff + (8 * hbs * bytesperpixel >> s->ss_h), bl + 1);
             } else {
                 yoff  += hbs * 8 * bytesperpixel;
                 uvoff += hbs * 8 * bytesperpixel >> s->ss_h;
-                decode_sb_mem(ctx, row, col + hbs, lflvl, yoff, uvoff, bl + 1);
+                decode_sb_mem(s, row, col + hbs, lflvl, yoff, uvoff, bl + 1);
             }
         } else if (row + hbs < s->rows) {
             yoff  += hbs * 8 * y_stride;
             uvoff += hbs * 8 * uv_stride >> s->ss_v;
-            decode_sb_mem(ctx, row + hbs, col, lflvl, yoff, uvoff, bl + 1);
+            decode_sb_mem(s, row + hbs, col, lflvl, yoff, uvoff, bl + 1);
         }
     }
 }
@@ -3686,10 +3694,9 @@ static av_always_inline void filter_plane_rows(VP9Context *s, int row, int ss_h,
     }
 }
 
-static void loopfilter_sb(AVCodecContext *ctx, struct VP9Filter *lflvl,
+static void loopfilter_sb(VP9Context *s, struct VP9Filter *lflvl,
                           int row, int col, ptrdiff_t yoff, ptrdiff_t uvoff)
 {
-    VP9Context *s = ctx->priv_data;
     AVFrame *f = s->frames[CUR_FRAME].tf.f;
     uint8_t *dst = f->data[0] + yoff;
     ptrdiff_t ls_y = f->linesize[0], ls_uv = f->linesize[1];
@@ -3964,6 +3971,15 @@ static void free_buffers(VP9Context *s)
     av_freep(&s->intra_pred_data[0]);
     av_freep(&s->b_base);
     av_freep(&s->block_base);
+    av_freep(&s->td);
+    s->nb_td = 0;
+    av_freep(&s->td_b_base);
+    av_freep(&s->td_block_base);
+    s->td_block_size = 0;
+    av_freep(&s->td_lflvl);
+    s->td_lflvl_size = 0;
+    av_freep(&s->sb_row_progress);
+    s->sb_row_progress_size = 0;
 }
 
 static av_cold int vp9_decode_free(AVCodecContext *ctx)
@@ -3987,121 +4003,21 @@ static av_cold int vp9_decode_free(AVCodecContext *ctx)
     free_buffers(s);
     av_freep(&s->c_b);
     s->c_b_size = 0;
+#if HAVE_THREADS
+    pthread_mutex_destroy(&s->progress_mutex);
+#endif
 
     return 0;
 }
 
 
-static int vp9_decode_frame(AVCodecContext *ctx, void *frame,
-                            int *got_frame, AVPacket *pkt)
+static int decode_tiles(AVCodecContext *ctx, const uint8_t *data, int size)
 {
-    const uint8_t *data = pkt->data;
-    int size = pkt->size;
     VP9Context *s = ctx->priv_data;
-    int res, tile_row, tile_col, i, ref, row, col;
-    int retain_segmap_ref = s->frames[REF_FRAME_SEGMAP].segmentation_map &&
-                            (!s->segmentation.enabled || !s->segmentation.update_map);
-    ptrdiff_t yoff, uvoff, ls_y, ls_uv;
-    AVFrame *f;
-    int bytesperpixel;
-
-    if ((res = decode_frame_header(ctx, data, size, &ref)) < 0) {
-        return res;
-    } else if (res == 0) {
-        if (!s->refs[ref].f->data[0]) {
-            av_log(ctx, AV_LOG_ERROR, "Requested reference %d not available\n", ref);
-            return AVERROR_INVALIDDATA;
-        }
-        if ((res = av_frame_ref(frame, s->refs[ref].f)) < 0)
-            return res;
-        ((AVFrame *)frame)->pkt_pts = pkt->pts;
-        ((AVFrame *)frame)->pkt_dts = pkt->dts;
-        for (i = 0; i < 8; i++) {
-            if (s->next_refs[i].f->data[0])
-                ff_thread_release_buffer(ctx, &s->next_refs[i]);
-            if (s->refs[i].f->data[0] &&
-                (res = ff_thread_ref_frame(&s->next_refs[i], &s->refs[i])) < 0)
-                return res;
-        }
-        *got_frame = 1;
-        return pkt->size;
-    }
-    data += res;
-    size -= res;
-
-    if (!retain_segmap_ref || s->keyframe || s->intraonly) {
-        if (s->frames[REF_FRAME_SEGMAP].tf.f->data[0])
-            vp9_unref_frame(ctx, &s->frames[REF_FRAME_SEGMAP]);
-        if (!s->keyframe && !s->intraonly && !s->errorres && s->frames[CUR_FRAME].tf.f->data[0] &&
-            (res = vp9_ref_frame(ctx, &s->frames[REF_FRAME_SEGMAP], &s->frames[CUR_FRAME])) < 0)
-            return res;
-    }
-    if (s->frames[REF_FRAME_MVPAIR].tf.f->data[0])
-        vp9_unref_frame(ctx, &s->frames[REF_FRAME_MVPAIR]);
-    if (!s->intraonly && !s->keyframe && !s->errorres && s->frames[CUR_FRAME].tf.f->data[0] &&
-        (res = vp9_ref_frame(ctx, &s->frames[REF_FRAME_MVPAIR], &s->frames[CUR_FRAME])) < 0)
-        return res;
-    if (s->frames[CUR_FRAME].tf.f->data[0])
-        vp9_unref_frame(ctx, &s->frames[CUR_FRAME]);
-    if ((res = vp9_alloc_frame(ctx, &s->frames[CUR_FRAME])) < 0)
-        return res;
-    f = s->frames[CUR_FRAME].tf.f;
-    f->key_frame = s->keyframe;
-    f->pict_type = (s->keyframe || s->intraonly) ? AV_PICTURE_TYPE_I : AV_PICTURE_TYPE_P;
-    ls_y = f->linesize[0];
-    ls_uv =f->linesize[1];
-
-    // ref frame setup
-    for (i = 0; i < 8; i++) {
-        if (s->next_refs[i].f->data[0])
-            ff_thread_release_buffer(ctx, &s->next_refs[i]);
-        if (s->refreshrefmask & (1 << i)) {
-            res = ff_thread_ref_frame(&s->next_refs[i], &s->frames[CUR_FRAME].tf);
-        } else if (s->refs[i].f->data[0]) {
-            res = ff_thread_ref_frame(&s->next_refs[i], &s->refs[i]);
-        }
-        if (res < 0)
-            return res;
-    }
-
-    // main tile decode loop
-    bytesperpixel = s->bytesperpixel;
-    memset(s->above_partition_ctx, 0, s->cols);
-    memset(s->above_skip_ctx, 0, s->cols);
-    if (s->keyframe || s->intraonly) {
-        memset(s->above_mode_ctx, DC_PRED, s->cols * 2);
-    } else {
-        memset(s->above_mode_ctx, NEARESTMV, s->cols);
-    }
-    memset(s->above_y_nnz_ctx, 0, s->sb_cols * 16);
-    memset(s->above_uv_nnz_ctx[0], 0, s->sb_cols * 16 >> s->ss_h);
-    memset(s->above_uv_nnz_ctx[1], 0, s->sb_cols * 16 >> s->ss_h);
-    memset(s->above_segpred_ctx, 0, s->cols);
-    s->pass = s->frames[CUR_FRAME].uses_2pass =
-        ctx->active_thread_type == FF_THREAD_FRAME && s->refreshctx && !s->parallelmode;
-    if ((res = update_block_buffers(ctx)) < 0) {
-        av_log(ctx, AV_LOG_ERROR,
-               "Failed to allocate block buffers\n");
-        return res;
-    }
-    if (s->refreshctx && s->parallelmode) {
-        int j, k, l, m;
-
-        for (i = 0; i < 4; i++) {
-            for (j = 0; j < 2; j++)
-                for (k = 0; k < 2; k++)
-                    for (l = 0; l < 6; l++)
-                        for (m = 0; m < 6; m++)
-                            memcpy(s->prob_ctx[s->framectxid].coef[i][j][k][l][m],
-                                   s->prob.coef[i][j][k][l][m], 3);
-            if (s->txfmmode == i)
-                break;
-        }
-        s->prob_ctx[s->framectxid].p = s->prob.p;
-        ff_thread_finish_setup(ctx);
-    } else if (!s->refreshctx) {
-        ff_thread_finish_setup(ctx);
-    }
+    AVFrame *f = s->frames[CUR_FRAME].tf.f;
+    ptrdiff_t yoff, uvoff, ls_y = f->linesize[0], ls_uv = f->linesize[1];
+    int bytesperpixel = s->bytesperpixel;
+    int res, tile_row, tile_col, row, col;
 
     do {
         yoff = uvoff = 0;
@@ -4179,10 +4095,10 @@ static int vp9_decode_frame(AVCodecContext *ctx, void *frame,
                         }
 
                         if (s->pass == 2) {
-                            decode_sb_mem(ctx, row, col, lflvl_ptr,
+                            decode_sb_mem(s, row, col, lflvl_ptr,
                                           yoff2, uvoff2, BL_64X64);
                         } else {
-                            decode_sb(ctx, row, col, lflvl_ptr,
+                            decode_sb(s, row, col, lflvl_ptr,
                                       yoff2, uvoff2, BL_64X64);
                         }
                     }
@@ -4217,7 +4133,7 @@ static int vp9_decode_frame(AVCodecContext *ctx, void *frame,
                     for (col = 0; col < s->cols;
                          col += 8, yoff2 += 64 * bytesperpixel,
                          uvoff2 += 64 * bytesperpixel >> s->ss_h, lflvl_ptr++) {
-                        loopfilter_sb(ctx, lflvl_ptr, row, col, yoff2, uvoff2);
+                        loopfilter_sb(s, lflvl_ptr, row, col, yoff2, uvoff2);
                     }
                 }
 
@@ -4233,6 +4149,370 @@ static int vp9_decode_frame(AVCodecContext *ctx, void *frame,
             ff_thread_finish_setup(ctx);
         }
     } while (s->pass++ == 1);
+
+    return 0;
+}
+
+#if HAVE_THREADS
+static void loopfilter_row(VP9Context *s, int row)
+{
+    AVFrame *f = s->frames[CUR_FRAME].tf.f;
+    struct VP9Filter *lflvl_ptr = s->td_lflvl + (row >> 3) * s->sb_cols;
+    ptrdiff_t yoff  = (row >> 3) * f->linesize[0] * 64;
+    ptrdiff_t uvoff = (row >> 3) * (f->linesize[1] * 64 >> s->ss_v);
+    int bytesperpixel = s->bytesperpixel;
+    int col;
+
+    for (col = 0; col < s->cols;
+         col += 8, yoff += 64 * bytesperpixel,
+         uvoff += 64 * bytesperpixel >> s->ss_h, lflvl_ptr++) {
+        loopfilter_sb(s, lflvl_ptr, row, col, yoff, uvoff);
+    }
+}
+
+/*
+ * Mark a sb64 row as decoded by one more tile column, and loopfilter the rows
+ * that all tile columns have decoded, in order. Whichever job finds the next
+ * row ready filters it, so the loopfilter runs concurrently with the decoding
+ * of the following rows: it only touches the pixels of its row and the 8
+ * bottom lines of the row above, while decoding of the next row only reads
+ * the saved intra_pred_data[].
+ */
+static void report_sb_row(VP9Context *s, int sb_row)
+{
+    pthread_mutex_lock(&s->progress_mutex);
+    s->sb_row_progress[sb_row]++;
+    while (!s->lf_busy && s->lf_sb_row < s->sb_rows &&
+           s->sb_row_progress[s->lf_sb_row] == s->tiling.tile_cols) {
+        int row = s->lf_sb_row << 3;
+
+        s->lf_busy = 1;
+        pthread_mutex_unlock(&s->progress_mutex);
+        if (s->filter.level)
+            loopfilter_row(s, row);
+        pthread_mutex_lock(&s->progress_mutex);
+        s->lf_busy = 0;
+        s->lf_sb_row++;
+    }
+    pthread_mutex_unlock(&s->progress_mutex);
+}
+
+static void decode_tile_col(VP9Context *s, VP9Context *td, int tile_col)
+{
+    AVFrame *f = s->frames[CUR_FRAME].tf.f;
+    ptrdiff_t ls_y = f->linesize[0], ls_uv = f->linesize[1];
+    int bytesperpixel = s->bytesperpixel;
+    int tile_row, row, col, cols;
+
+    set_tile_offset(&td->tiling.tile_col_start, &td->tiling.tile_col_end,
+                    tile_col, s->tiling.log2_tile_cols, s->sb_cols);
+    cols = FFMIN(td->tiling.tile_col_end, s->cols) - td->tiling.tile_col_start;
+
+    for (tile_row = 0; tile_row < s->tiling.tile_rows; tile_row++) {
+        set_tile_offset(&td->tiling.tile_row_start, &td->tiling.tile_row_end,
+                        tile_row, s->tiling.log2_tile_rows, s->sb_rows);
+        td->c = s->c_b[tile_row * s->tiling.tile_cols + tile_col];
+
+        for (row = td->tiling.tile_row_start; row < td->tiling.tile_row_end; row += 8) {
+            struct VP9Filter *lflvl_ptr = s->td_lflvl + (row >> 3) * s->sb_cols +
+                                          (td->tiling.tile_col_start >> 3);
+            ptrdiff_t yoff  = (row >> 3) * ls_y * 64 +
+                              td->tiling.tile_col_start * 8 * bytesperpixel;
+            ptrdiff_t uvoff = (row >> 3) * (ls_uv * 64 >> s->ss_v) +
+                              (td->tiling.tile_col_start * 8 * bytesperpixel >> s->ss_h);
+
+            memset(td->left_partition_ctx, 0, 8);
+            memset(td->left_skip_ctx, 0, 8);
+            if (s->keyframe || s->intraonly) {
+                memset(td->left_mode_ctx, DC_PRED, 16);
+            } else {
+                memset(td->left_mode_ctx, NEARESTMV, 8);
+            }
+            memset(td->left_y_nnz_ctx, 0, 16);
+            memset(td->left_uv_nnz_ctx, 0, 32);
+            memset(td->left_segpred_ctx, 0, 8);
+
+            for (col = td->tiling.tile_col_start; col < td->tiling.tile_col_end;
+                 col += 8, yoff += 64 * bytesperpixel,
+                 uvoff += 64 * bytesperpixel >> s->ss_h, lflvl_ptr++) {
+                memset(lflvl_ptr->mask, 0, sizeof(lflvl_ptr->mask));
+                decode_sb(td, row, col, lflvl_ptr, yoff, uvoff, BL_64X64);
+            }
+
+            // backup pre-loopfilter reconstruction data of this tile column
+            // for intra prediction of the next row of sb64s; intra
+            // prediction never reads above pixels outside of the tile
+            if (row + 8 < s->rows) {
+                ptrdiff_t x = td->tiling.tile_col_start * 8 * bytesperpixel;
+                ptrdiff_t y_line  = (row >> 3) * ls_y * 64 + 63 * ls_y;
+                ptrdiff_t uv_line = (row >> 3) * (ls_uv * 64 >> s->ss_v) +
+                                    ((64 >> s->ss_v) - 1) * ls_uv;
+
+                memcpy(s->intra_pred_data[0] + x, f->data[0] + y_line + x,
+                       8 * cols * bytesperpixel);
+                memcpy(s->intra_pred_data[1] + (x >> s->ss_h),
+                       f->data[1] + uv_line + (x >> s->ss_h),
+                       8 * cols * bytesperpixel >> s->ss_h);
+                memcpy(s->intra_pred_data[2] + (x >> s->ss_h),
+                       f->data[2] + uv_line + (x >> s->ss_h),
+                       8 * cols * bytesperpixel >> s->ss_h);
+            }
+            report_sb_row(s, row >> 3);
+        }
+    }
+}
+
+static int decode_tiles_job(AVCodecContext *ctx, void *arg, int jobnr, int threadnr)
+{
+    VP9Context *s = ctx->priv_data;
+
+    decode_tile_col(s, &s->td[jobnr], jobnr);
+
+    return 0;
+}
+
+static int alloc_tile_data(VP9Context *s)
+{
+    int chroma_blocks = 64 * 64 >> (s->ss_h + s->ss_v);
+    int chroma_eobs   = 16 * 16 >> (s->ss_h + s->ss_v);
+    int block_size    = (64 * 64 + 2 * chroma_blocks) * s->bytesperpixel * sizeof(int16_t) +
+                        16 * 16 + 2 * chroma_eobs;
+    int i, n = s->tiling.tile_cols;
+
+    if (s->nb_td < n) {
+        av_freep(&s->td);
+        av_freep(&s->td_b_base);
+        s->nb_td = 0;
+        s->td        = av_malloc_array(n, sizeof(*s->td));
+        s->td_b_base = av_malloc_array(n, sizeof(*s->td_b_base));
+        if (!s->td || !s->td_b_base)
+            return AVERROR(ENOMEM);
+        s->nb_td = n;
+    }
+    // coefficient buffers are kept zeroed between blocks, so they must start zeroed
+    block_size = FFALIGN(block_size, 32);
+    av_fast_padded_mallocz(&s->td_block_base, &s->td_block_size, (size_t)block_size * n);
+    av_fast_malloc(&s->td_lflvl, &s->td_lflvl_size,
+                   sizeof(*s->td_lflvl) * s->sb_cols * s->sb_rows);
+    av_fast_malloc(&s->sb_row_progress, &s->sb_row_progress_size,
+                   sizeof(*s->sb_row_progress) * s->sb_rows);
+    if (!s->td_block_base || !s->td_lflvl || !s->sb_row_progress)
+        return AVERROR(ENOMEM);
+    memset(s->sb_row_progress, 0, sizeof(*s->sb_row_progress) * s->sb_rows);
+
+    for (i = 0; i < n; i++) {
+        VP9Context *td = &s->td[i];
+
+        memcpy(td, s, sizeof(*td));
+        memset(&td->counts, 0, sizeof(td->counts));
+        td->b_base = td->b = &s->td_b_base[i];
+        td->block_base = td->block = (int16_t *) ((uint8_t *) s->td_block_base + i * block_size);
+        td->uvblock_base[0] = td->uvblock[0] = td->block_base + 64 * 64 * s->bytesperpixel;
+        td->uvblock_base[1] = td->uvblock[1] = td->uvblock_base[0] + chroma_blocks * s->bytesperpixel;
+        td->eob_base = td->eob = (uint8_t *) (td->uvblock_base[1] + chroma_blocks * s->bytesperpixel);
+        td->uveob_base[0] = td->uveob[0] = td->eob_base + 16 * 16;
+        td->uveob_base[1] = td->uveob[1] = td->uveob_base[0] + chroma_eobs;
+    }
+
+    return 0;
+}
+
+/*
+ * Slice threaded decoding: each tile column is decoded by its own job, in a
+ * private copy of the context that holds the block state, range coder and
+ * symbol counts. The above context, segmentation map and motion vector
+ * arrays are shared, since tile columns write disjoint parts of them.
+ */
+static int decode_tiles_slice(AVCodecContext *ctx, const uint8_t *data, int size)
+{
+    VP9Context *s = ctx->priv_data;
+    int res, tile_row, tile_col, i;
+
+    for (tile_row = 0; tile_row < s->tiling.tile_rows; tile_row++) {
+        for (tile_col = 0; tile_col < s->tiling.tile_cols; tile_col++) {
+            VP56RangeCoder *c = &s->c_b[tile_row * s->tiling.tile_cols + tile_col];
+            int64_t tile_size;
+
+            if (tile_col == s->tiling.tile_cols - 1 &&
+                tile_row == s->tiling.tile_rows - 1) {
+                tile_size = size;
+            } else {
+                tile_size = AV_RB32(data);
+                data += 4;
+                size -= 4;
+            }
+            if (tile_size > size)
+                return AVERROR_INVALIDDATA;
+            res = ff_vp56_init_range_decoder(c, data, tile_size);
+            if (res < 0)
+                return res;
+            if (vp56_rac_get_prob_branchy(c, 128)) // marker bit
+                return AVERROR_INVALIDDATA;
+            data += tile_size;
+            size -= tile_size;
+        }
+    }
+
+    // decode_b() fills the limit LUTs lazily, but the tile contexts are
+    // copies, and the loopfilter reads the shared ones, so fill them up front
+    for (i = 1; i < 64; i++) {
+        int sharp = s->filter.sharpness;
+        int limit = i;
+
+        if (sharp > 0) {
+            limit >>= (sharp + 3) >> 2;
+            limit = FFMIN(limit, 9 - sharp);
+        }
+        limit = FFMAX(limit, 1);
+
+        s->filter.lim_lut[i] = limit;
+        s->filter.mblim_lut[i] = 2 * (i + 2) + limit;
+    }
+
+    if ((res = alloc_tile_data(s)) < 0) {
+        av_log(ctx, AV_LOG_ERROR, "Failed to allocate tile buffers\n");
+        return res;
+    }
+
+    s->lf_sb_row = 0;
+    s->lf_busy   = 0;
+    ctx->execute2(ctx, decode_tiles_job, NULL, NULL, s->tiling.tile_cols);
+
+    if (s->refreshctx && !s->parallelmode) {
+        unsigned *dst = (unsigned *) &s->counts;
+
+        memset(&s->counts, 0, sizeof(s->counts));
+        for (i = 0; i < s->tiling.tile_cols; i++) {
+            const unsigned *src = (const unsigned *) &s->td[i].counts;
+            int n;
+
+            for (n = 0; n < sizeof(s->counts) / sizeof(*dst); n++)
+                dst[n] += src[n];
+        }
+        adapt_probs(s);
+    }
+
+    return 0;
+}
+#else
+static int decode_tiles_slice(AVCodecContext *ctx, const uint8_t *data, int size)
+{
+    return AVERROR(ENOSYS);
+}
+#endif
+
+static int vp9_decode_frame(AVCodecContext *ctx, void *frame,
+                            int *got_frame, AVPacket *pkt)
+{
+    const uint8_t *data = pkt->data;
+    int size = pkt->size;
+    VP9Context *s = ctx->priv_data;
+    int res, i, ref;
+    int retain_segmap_ref = s->frames[REF_FRAME_SEGMAP].segmentation_map &&
+                            (!s->segmentation.enabled || !s->segmentation.update_map);
+    AVFrame *f;
+
+    if ((res = decode_frame_header(ctx, data, size, &ref)) < 0) {
+        return res;
+    } else if (res == 0) {
+        if (!s->refs[ref].f->data[0]) {
+            av_log(ctx, AV_LOG_ERROR, "Requested reference %d not available\n", ref);
+            return AVERROR_INVALIDDATA;
+        }
+        if ((res = av_frame_ref(frame, s->refs[ref].f)) < 0)
+            return res;
+        ((AVFrame *)frame)->pkt_pts = pkt->pts;
+        ((AVFrame *)frame)->pkt_dts = pkt->dts;
+        for (i = 0; i < 8; i++) {
+            if (s->next_refs[i].f->data[0])
+                ff_thread_release_buffer(ctx, &s->next_refs[i]);
+            if (s->refs[i].f->data[0] &&
+                (res = ff_thread_ref_frame(&s->next_refs[i], &s->refs[i])) < 0)
+                return res;
+        }
+        *got_frame = 1;
+        return pkt->size;
+    }
+    data += res;
+    size -= res;
+
+    if (!retain_segmap_ref || s->keyframe || s->intraonly) {
+        if (s->frames[REF_FRAME_SEGMAP].tf.f->data[0])
+            vp9_unref_frame(ctx, &s->frames[REF_FRAME_SEGMAP]);
+        if (!s->keyframe && !s->intraonly && !s->errorres && s->frames[CUR_FRAME].tf.f->data[0] &&
+            (res = vp9_ref_frame(ctx, &s->frames[REF_FRAME_SEGMAP], &s->frames[CUR_FRAME])) < 0)
+            return res;
+    }
+    if (s->frames[REF_FRAME_MVPAIR].tf.f->data[0])
+        vp9_unref_frame(ctx, &s->frames[REF_FRAME_MVPAIR]);
+    if (!s->intraonly && !s->keyframe && !s->errorres && s->frames[CUR_FRAME].tf.f->data[0] &&
+        (res = vp9_ref_frame(ctx, &s->frames[REF_FRAME_MVPAIR], &s->frames[CUR_FRAME])) < 0)
+        return res;
+    if (s->frames[CUR_FRAME].tf.f->data[0])
+        vp9_unref_frame(ctx, &s->frames[CUR_FRAME]);
+    if ((res = vp9_alloc_frame(ctx, &s->frames[CUR_FRAME])) < 0)
+        return res;
+    f = s->frames[CUR_FRAME].tf.f;
+    f->key_frame = s->keyframe;
+    f->pict_type = (s->keyframe || s->intraonly) ? AV_PICTURE_TYPE_I : AV_PICTURE_TYPE_P;
+
+    // ref frame setup
+    for (i = 0; i < 8; i++) {
+        if (s->next_refs[i].f->data[0])
+            ff_thread_release_buffer(ctx, &s->next_refs[i]);
+        if (s->refreshrefmask & (1 << i)) {
+            res = ff_thread_ref_frame(&s->next_refs[i], &s->frames[CUR_FRAME].tf);
+        } else if (s->refs[i].f->data[0]) {
+            res = ff_thread_ref_frame(&s->next_refs[i], &s->refs[i]);
+        }
+        if (res < 0)
+            return res;
+    }
+
+    // main tile decode loop
+    memset(s->above_partition_ctx, 0, s->cols);
+    memset(s->above_skip_ctx, 0, s->cols);
+    if (s->keyframe || s->intraonly) {
+        memset(s->above_mode_ctx, DC_PRED, s->cols * 2);
+    } else {
+        memset(s->above_mode_ctx, NEARESTMV, s->cols);
+    }
+    memset(s->above_y_nnz_ctx, 0, s->sb_cols * 16);
+    memset(s->above_uv_nnz_ctx[0], 0, s->sb_cols * 16 >> s->ss_h);
+    memset(s->above_uv_nnz_ctx[1], 0, s->sb_cols * 16 >> s->ss_h);
+    memset(s->above_segpred_ctx, 0, s->cols);
+    s->pass = s->frames[CUR_FRAME].uses_2pass =
+        ctx->active_thread_type == FF_THREAD_FRAME && s->refreshctx && !s->parallelmode;
+    if ((res = update_block_buffers(ctx)) < 0) {
+        av_log(ctx, AV_LOG_ERROR,
+               "Failed to allocate block buffers\n");
+        return res;
+    }
+    if (s->refreshctx && s->parallelmode) {
+        int j, k, l, m;
+
+        for (i = 0; i < 4; i++) {
+            for (j = 0; j < 2; j++)
+                for (k = 0; k < 2; k++)
+                    for (l = 0; l < 6; l++)
+                        for (m = 0; m < 6; m++)
+                            memcpy(s->prob_ctx[s->framectxid].coef[i][j][k][l][m],
+                                   s->prob.coef[i][j][k][l][m], 3);
+            if (s->txfmmode == i)
+                break;
+        }
+        s->prob_ctx[s->framectxid].p = s->prob.p;
+        ff_thread_finish_setup(ctx);
+    } else if (!s->refreshctx) {
+        ff_thread_finish_setup(ctx);
+    }
+
+    if (ctx->active_thread_type & FF_THREAD_SLICE)
+        res = decode_tiles_slice(ctx, data, size);
+    else
+        res = decode_tiles(ctx, data, size);
+    if (res < 0)
+        return res;
     ff_thread_report_progress(&s->frames[CUR_FRAME].tf, INT_MAX, 0);
 
     // ref frame setup
@@ -4267,6 +4547,10 @@ static int init_frames(AVCodecContext *ctx)
     VP9Context *s = ctx->priv_data;
     int i;
 
+#if HAVE_THREADS
+    pthread_mutex_init(&s->progress_mutex, NULL);
+#endif
+
     for (i = 0; i < 3; i++) {
         s->frames[i].tf.f = av_frame_alloc();
         if (!s->frames[i].tf.f) {
@@ -4369,7 +4653,8 @@ AVCodec ff_vp9_decoder = {
     .init                  = vp9_decode_init,
     .close                 = vp9_decode_free,
     .decode                = vp9_decode_frame,
-    .capabilities          = AV_CODEC_CAP_DR1 | AV_CODEC_CAP_FRAME_THREADS,
+    .capabilities          = AV_CODEC_CAP_DR1 | AV_CODEC_CAP_FRAME_THREADS |
+                             AV_CODEC_CAP_SLICE_THREADS,
     .flush                 = vp9_decode_flush,
     .init_thread_copy      = ONLY_IF_THREADS_ENABLED(vp9_decode_init_thread_copy),
     .update_thread_context = ONLY_IF_THREADS_ENABLED(vp9_decode_update_thread_context),
@@ -0,0 +1,102 @@
+;******************************************************************************
+;* SIMD optimized AAC encoder quantization functions
+;*
+;* This file is part of FFmpeg.
+;*
+;* FFmpeg is free software; you can redistribute it and/or
+;* modify it under the terms of the GNU Lesser General Public
+;* License as published by the Free Software Foundation; either
+;* version 2.1 of the License, or (at your option) any later version.
+;*
+;* FFmpeg is distributed in the hope that it will be useful,
+;* but WITHOUT ANY WARRANTY; without even the implied warranty of
+;* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+;* Lesser General Public License for more details.
+;*
+;* You should have received a copy of the GNU Lesser General Public
+;* License along with FFmpeg; if not, write to the Free Software
+;* Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+;******************************************************************************
+
+%include "libavutil/x86/x86util.asm"
+
+SECTION_RODATA
+
+ps_abs_mask: times 4 dd 0x7fffffff
+
+SECTION .text
+
+;-----------------------------------------------------------------------------
+; void ff_abs_pow34_sse(float *out, const float *in, int len)
+; len is a multiple of 4
+;-----------------------------------------------------------------------------
+INIT_XMM sse
+cglobal abs_pow34, 3, 3, 3, out, in, len
+    mova           m2, [ps_abs_mask]
+    shl          lend, 2
+    add           inq, lenq
+    add          outq, lenq
+    neg          lenq
+.loop:
+    movu           m0, [inq+lenq]
+    andps          m0, m2
+    sqrtps         m1, m0
+    mulps          m0, m1
+    sqrtps         m0, m0
+    movu [outq+lenq], m0
+    add          lenq, mmsize
+    jl .loop
+    RET
+
+;-----------------------------------------------------------------------------
+; void ff_aac_quantize_bands_sse2(int *out, const float *in, const float *scaled,
+;                                 int len, int is_signed, int maxval,
+;                                 float Q34, float rounding)
+; len is a multiple of 4; like the C version, the rounding and the clipping
+; are done in double precision
+;-----------------------------------------------------------------------------
+INIT_XMM sse2
+cglobal aac_quantize_bands, 5, 5, 8, out, in, scaled, len, is_signed, maxval, Q34, rounding
+%if UNIX64 == 0
+    movss          m0, Q34m
+    movss          m1, roundingm
+    cvtsi2sd       m6, dword maxvalm
+%else
+    cvtsi2sd       m6, maxvald
+%endif
+    shufps         m0, m0, 0
+    cvtss2sd       m5, m1
+    unpcklpd       m5, m5
+    unpcklpd       m6, m6
+    neg    is_signedd
+    sbb    is_signedd, is_signedd
+    movd           m7, is_signedd
+    pshufd         m7, m7, 0
+    xorps          m3, m3
+    shl          lend, 2
+    add           inq, lenq
+    add       scaledq, lenq
+    add          outq, lenq
+    neg          lenq
+.loop:
+    movu           m1, [scaledq+lenq]
+    movu           m4, [inq+lenq]
+    mulps          m1, m0
+    cmpltps        m4, m3
+    pshufd         m2, m1, q3232
+    cvtps2pd       m1, m1
+    cvtps2pd       m2, m2
+    andps          m4, m7
+    addpd          m1, m5
+    addpd          m2, m5
+    minpd          m1, m6
+    minpd          m2, m6
+    cvttpd2dq      m1, m1
+    cvttpd2dq      m2, m2
+    punpcklqdq     m1, m2
+    pxor           m1, m4
+    psubd          m1, m4
+    movu [outq+lenq], m1
+    add          lenq, mmsize
+    jl .loop
+    RET
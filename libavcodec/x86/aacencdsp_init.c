@@ -0,0 +1,66 @@
+/*
+ * AAC encoder quantization SIMD functions
+ *
+ * This file is part of FFmpeg.
+ *
+ * FFmpeg is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * FFmpeg is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with FFmpeg; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+
+#include "libavutil/attributes.h"
+#include "libavutil/cpu.h"
+#include "libavutil/x86/cpu.h"
+#include "libavcodec/aacenc.h"
+#include "libavcodec/aacenc_utils.h"
+
+void ff_abs_pow34_sse(float *out, const float *in, int len);
+void ff_aac_quantize_bands_sse2(int *out, const float *in, const float *scaled,
+                                int len, int is_signed, int maxval,
+                                const float Q34, const float rounding);
+
+#if HAVE_YASM
+static void abs_pow34_sse(float *out, const float *in, const int size)
+{
+    int len = size & ~3;
+
+    if (len)
+        ff_abs_pow34_sse(out, in, len);
+    abs_pow34_v(out + len, in + len, size - len);
+}
+
+static void quantize_bands_sse2(int *out, const float *in, const float *scaled,
+                                int size, float Q34, int is_signed, int maxval,
+                                const float rounding)
+{
+    int len = size & ~3;
+
+    if (len)
+        ff_aac_quantize_bands_sse2(out, in, scaled, len, is_signed, maxval,
+                                   Q34, rounding);
+    quantize_bands(out + len, in + len, scaled + len, size - len,
+                   Q34, is_signed, maxval, rounding);
+}
+#endif /* HAVE_YASM */
+
+av_cold void ff_aac_dsp_init_x86(AACEncContext *s)
+{
+#if HAVE_YASM
+    int cpu_flags = av_get_cpu_flags();
+
+    if (EXTERNAL_SSE(cpu_flags))
+        s->abs_pow34   = abs_pow34_sse;
+    if (EXTERNAL_SSE2(cpu_flags))
+        s->quant_bands = quantize_bands_sse2;
+#endif /* HAVE_YASM */
+}
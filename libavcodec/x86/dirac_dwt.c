@@ -20,6 +20,7 @@
  * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
  */
 
+#include "libavutil/common.h"
 #include "libavutil/x86/asm.h"
 #include "libavutil/x86/cpu.h"
 #include "dirac_dwt.h"
@@ -40,7 +41,8 @@ static void vertical_compose53iL0##ext(IDWTELEM *b0, IDWTELEM *b1, IDWTELEM *b2,
     for(i=width_align; i<width; i++) \
         b1[i] = COMPOSE_53iL0(b0[i], b1[i], b2[i]); \
 \
-    ff_vertical_compose53iL0##ext(b0, b1, b2, width_align); \
+    if (width_align) \
+        ff_vertical_compose53iL0##ext(b0, b1, b2, width_align); \
 } \
 \
 static void vertical_compose_dirac53iH0##ext(IDWTELEM *b0, IDWTELEM *b1, IDWTELEM *b2, int width) \
@@ -50,7 +52,8 @@ static void vertical_compose_dirac53iH0##ext(IDWTELEM *b0, IDWTELEM *b1, IDWTELE
     for(i=width_align; i<width; i++) \
         b1[i] = COMPOSE_DIRAC53iH0(b0[i], b1[i], b2[i]); \
 \
-    ff_vertical_compose_dirac53iH0##ext(b0, b1, b2, width_align); \
+    if (width_align) \
+        ff_vertical_compose_dirac53iH0##ext(b0, b1, b2, width_align); \
 } \
 \
 static void vertical_compose_dd137iL0##ext(IDWTELEM *b0, IDWTELEM *b1, IDWTELEM *b2, \
@@ -61,7 +64,8 @@ static void vertical_compose_dd137iL0##ext(IDWTELEM *b0, IDWTELEM *b1, IDWTELEM
     for(i=width_align; i<width; i++) \
         b2[i] = COMPOSE_DD137iL0(b0[i], b1[i], b2[i], b3[i], b4[i]); \
 \
-    ff_vertical_compose_dd137iL0##ext(b0, b1, b2, b3, b4, width_align); \
+    if (width_align) \
+        ff_vertical_compose_dd137iL0##ext(b0, b1, b2, b3, b4, width_align); \
 } \
 \
 static void vertical_compose_dd97iH0##ext(IDWTELEM *b0, IDWTELEM *b1, IDWTELEM *b2, \
@@ -72,7 +76,8 @@ static void vertical_compose_dd97iH0##ext(IDWTELEM *b0, IDWTELEM *b1, IDWTELEM *
     for(i=width_align; i<width; i++) \
         b2[i] = COMPOSE_DD97iH0(b0[i], b1[i], b2[i], b3[i], b4[i]); \
 \
-    ff_vertical_compose_dd97iH0##ext(b0, b1, b2, b3, b4, width_align); \
+    if (width_align) \
+        ff_vertical_compose_dd97iH0##ext(b0, b1, b2, b3, b4, width_align); \
 } \
 static void vertical_compose_haar##ext(IDWTELEM *b0, IDWTELEM *b1, int width) \
 { \
@@ -83,7 +88,8 @@ static void vertical_compose_haar##ext(IDWTELEM *b0, IDWTELEM *b1, int width) \
         b1[i] = COMPOSE_HAARiH0(b1[i], b0[i]); \
     } \
 \
-    ff_vertical_compose_haar##ext(b0, b1, width_align); \
+    if (width_align) \
+        ff_vertical_compose_haar##ext(b0, b1, width_align); \
 } \
 static void horizontal_compose_haar0i##ext(IDWTELEM *b, IDWTELEM *tmp, int w)\
 {\
@@ -131,11 +137,141 @@ static void horizontal_compose_dd97i_ssse3(IDWTELEM *b, IDWTELEM *tmp, int w)
 }
 #endif
 
+
+#if HAVE_YASM && ARCH_X86_64
+/* The lifting kernels process a non-zero multiple of 16 elements (8 for the
+ * interleaving ones), the wrappers do the rest in C. */
+void ff_dwt_lift_53iL0_avx2(IDWTELEM *dst, const IDWTELEM *b0,
+                            const IDWTELEM *b1, const IDWTELEM *b2, int n);
+void ff_dwt_lift_daub97iL1_avx2(IDWTELEM *dst, const IDWTELEM *b0,
+                                const IDWTELEM *b1, const IDWTELEM *b2, int n);
+void ff_dwt_lift_daub97iH1_avx2(IDWTELEM *dst, const IDWTELEM *b0,
+                                const IDWTELEM *b1, const IDWTELEM *b2, int n);
+void ff_dwt_lift_daub97iL0_avx2(IDWTELEM *dst, const IDWTELEM *b0,
+                                const IDWTELEM *b1, const IDWTELEM *b2, int n);
+void ff_dwt_lift_daub97iH0_avx2(IDWTELEM *dst, const IDWTELEM *b0,
+                                const IDWTELEM *b1, const IDWTELEM *b2, int n);
+void ff_dwt_lift_dd137iL0_avx2(IDWTELEM *dst, const IDWTELEM *b0,
+                               const IDWTELEM *b1, const IDWTELEM *b2,
+                               const IDWTELEM *b3, const IDWTELEM *b4, int n);
+void ff_vertical_compose_haar_avx2(IDWTELEM *b0, IDWTELEM *b1, int width);
+void ff_dwt_interleave_dd97i_avx2(IDWTELEM *b, const IDWTELEM *tmp,
+                                  const IDWTELEM *hi, int n);
+void ff_dwt_interleave_dirac53i_avx2(IDWTELEM *b, const IDWTELEM *tmp,
+                                     const IDWTELEM *hi, int n);
+
+#define VERTICAL_3TAP_AVX2(name, COMPOSE)                                   \
+static void vertical_compose_ ## name ## _avx2(IDWTELEM *b0, IDWTELEM *b1,  \
+                                               IDWTELEM *b2, int width)     \
+{                                                                           \
+    int i, width_align = width & ~15;                                       \
+                                                                            \
+    for (i = width_align; i < width; i++)                                   \
+        b1[i] = COMPOSE(b0[i], b1[i], b2[i]);                               \
+                                                                            \
+    if (width_align)                                                        \
+        ff_dwt_lift_ ## name ## _avx2(b1, b0, b1, b2, width_align);         \
+}
+
+VERTICAL_3TAP_AVX2(daub97iL1, COMPOSE_DAUB97iL1)
+VERTICAL_3TAP_AVX2(daub97iH1, COMPOSE_DAUB97iH1)
+VERTICAL_3TAP_AVX2(daub97iL0, COMPOSE_DAUB97iL0)
+VERTICAL_3TAP_AVX2(daub97iH0, COMPOSE_DAUB97iH0)
+
+static void vertical_compose_haar_avx2(IDWTELEM *b0, IDWTELEM *b1, int width)
+{
+    int i, width_align = width & ~15;
+
+    for (i = width_align; i < width; i++) {
+        b0[i] = COMPOSE_HAARiL0(b0[i], b1[i]);
+        b1[i] = COMPOSE_HAARiH0(b1[i], b0[i]);
+    }
+
+    if (width_align)
+        ff_vertical_compose_haar_avx2(b0, b1, width_align);
+}
+
+static void horizontal_compose_dirac53i_avx2(IDWTELEM *b, IDWTELEM *tmp, int w)
+{
+    const int w2 = w >> 1;
+    int x, n = FFMAX(w2 - 1, 0) & ~15;
+
+    tmp[0] = COMPOSE_53iL0(b[w2], b[0], b[w2]);
+    if (n)
+        ff_dwt_lift_53iL0_avx2(tmp + 1, b + w2, b + 1, b + w2 + 1, n);
+    for (x = n + 1; x < w2; x++)
+        tmp[x] = COMPOSE_53iL0(b[x+w2-1], b[x], b[x+w2]);
+
+    // extend the edge
+    tmp[w2] = tmp[w2-1];
+
+    n = w2 & ~7;
+    if (n)
+        ff_dwt_interleave_dirac53i_avx2(b, tmp, b + w2, n);
+    for (x = n; x < w2; x++) {
+        IDWTELEM hi = COMPOSE_DIRAC53iH0(tmp[x], b[x+w2], tmp[x+1]);
+        b[2*x  ] = (tmp[x] + 1) >> 1;
+        b[2*x+1] = (hi     + 1) >> 1;
+    }
+}
+
+static void horizontal_compose_dd137i_avx2(IDWTELEM *b, IDWTELEM *tmp, int w)
+{
+    const int w2 = w >> 1;
+    int x, n = FFMAX(w2 - 3, 0) & ~15;
+
+    tmp[0] = COMPOSE_DD137iL0(b[w2], b[w2], b[0], b[w2  ], b[w2+1]);
+    tmp[1] = COMPOSE_DD137iL0(b[w2], b[w2], b[1], b[w2+1], b[w2+2]);
+    if (n)
+        ff_dwt_lift_dd137iL0_avx2(tmp + 2, b + w2, b + w2 + 1, b + 2,
+                                  b + w2 + 2, b + w2 + 3, n);
+    for (x = n + 2; x < w2-1; x++)
+        tmp[x] = COMPOSE_DD137iL0(b[x+w2-2], b[x+w2-1], b[x], b[x+w2], b[x+w2+1]);
+    tmp[w2-1] = COMPOSE_DD137iL0(b[w-3], b[w-2], b[w2-1], b[w-1], b[w-1]);
+
+    // extend the edges
+    tmp[-1]   = tmp[0];
+    tmp[w2+1] = tmp[w2] = tmp[w2-1];
+
+    n = w2 & ~7;
+    if (n)
+        ff_dwt_interleave_dd97i_avx2(b, tmp, b + w2, n);
+    for (x = n; x < w2; x++) {
+        b[2*x  ] = (tmp[x] + 1)>>1;
+        b[2*x+1] = (COMPOSE_DD97iH0(tmp[x-1], tmp[x], b[x+w2], tmp[x+1], tmp[x+2]) + 1)>>1;
+    }
+}
+
+/* Only the transforms where the 32-bit lanes beat the 16-bit SSE2/SSSE3
+ * versions above, or where there is no other SIMD version. */
+static void spatial_idwt_init_avx2(DWTContext *d, enum dwt_type type)
+{
+    switch (type) {
+    case DWT_DIRAC_LEGALL5_3:
+        d->horizontal_compose  = horizontal_compose_dirac53i_avx2;
+        break;
+    case DWT_DIRAC_DD13_7:
+        d->horizontal_compose  = horizontal_compose_dd137i_avx2;
+        break;
+    case DWT_DIRAC_HAAR0:
+    case DWT_DIRAC_HAAR1:
+        d->vertical_compose    = (void*)vertical_compose_haar_avx2;
+        break;
+    case DWT_DIRAC_DAUB9_7:
+        d->vertical_compose_l0 = (void*)vertical_compose_daub97iL0_avx2;
+        d->vertical_compose_h0 = (void*)vertical_compose_daub97iH0_avx2;
+        d->vertical_compose_l1 = (void*)vertical_compose_daub97iL1_avx2;
+        d->vertical_compose_h1 = (void*)vertical_compose_daub97iH1_avx2;
+        break;
+    }
+}
+#endif /* HAVE_YASM && ARCH_X86_64 */
+
 void ff_spatial_idwt_init_mmx(DWTContext *d, enum dwt_type type)
 {
-#if HAVE_YASM
-  int mm_flags = av_get_cpu_flags();
+    int mm_flags = av_get_cpu_flags();
 
+#if HAVE_YASM
 #if !ARCH_X86_64
     if (!(mm_flags & AV_CPU_FLAG_MMX))
         return;
@@ -198,5 +334,10 @@ void ff_spatial_idwt_init_mmx(DWTContext *d, enum dwt_type type)
         d->horizontal_compose = horizontal_compose_dd97i_ssse3;
         break;
     }
+
+#if ARCH_X86_64
+    if (EXTERNAL_AVX2(mm_flags))
+        spatial_idwt_init_avx2(d, type);
+#endif
 #endif // HAVE_YASM
 }
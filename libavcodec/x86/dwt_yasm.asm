@@ -23,7 +23,17 @@
 
 SECTION_RODATA
 pw_1991: times 4 dw 9,-1
+pd_2:    dd 2
+pd_8:    dd 8
+pd_16:   dd 16
+pd_64:   dd 64
+pd_113:  dd 113
+pd_217:  dd 217
+pd_1817: dd 1817
+pd_2048: dd 2048
+pd_6497: dd 6497
 
+cextern pd_1
 cextern pw_1
 cextern pw_2
 cextern pw_8
@@ -305,3 +315,211 @@ INIT_XMM
 COMPOSE_VERTICAL sse2
 HAAR_HORIZONTAL sse2, 0
 HAAR_HORIZONTAL sse2, 1
+
+%if ARCH_X86_64 && HAVE_AVX2_EXTERNAL
+; The lifting steps below are computed on 32-bit lanes and truncated to 16 bits
+; on store, exactly like the C code, so they are bitexact for any input.
+
+; pack the low words of the dwords in m0 and m1 into m0, m7 must be zero
+%macro PACK_DWORDS 0
+    pblendw    m0, m7, 0xaa
+    pblendw    m1, m7, 0xaa
+    packusdw   m0, m1
+    vpermq     m0, m0, q3120
+%endmacro
+
+; (%1 + 1) >> 1 on words without overflow, as (%1 >> 1) + (%1 & 1)
+; %2 = tmp, m7 = pw_1
+%macro ROUND_HALF 2
+    pand       %2, %1, m7
+    psraw      %1, 1
+    paddw      %1, %2
+%endmacro
+
+; void dwt_lift_<name>(IDWTELEM *dst, const IDWTELEM *b0, const IDWTELEM *b1,
+;                      const IDWTELEM *b2, int n)
+; dst = b1 op ((mul * (b0 + b2) + rnd) >> shift), n a non-zero multiple of 16
+; %1 = name, %2 = op, %3 = shift, %4 = rnd, %5 = mul if any
+%macro LIFT_3TAP 4-5
+cglobal dwt_lift_%1, 5, 5, 8, dst, b0, b1, b2, n
+    movsxdifnidn nq, nd
+    add        nq, nq
+    add      dstq, nq
+    add       b0q, nq
+    add       b1q, nq
+    add       b2q, nq
+    neg        nq
+%if %0 > 4
+    vpbroadcastd m6, [pd_%5]
+%endif
+    vpbroadcastd m5, [pd_%4]
+    pxor       m7, m7
+.loop:
+    pmovsxwd   m0, [b0q+nq]
+    pmovsxwd   m1, [b0q+nq+16]
+    pmovsxwd   m2, [b2q+nq]
+    pmovsxwd   m3, [b2q+nq+16]
+    paddd      m0, m2
+    paddd      m1, m3
+%if %0 > 4
+    pmulld     m0, m6
+    pmulld     m1, m6
+%endif
+    paddd      m0, m5
+    paddd      m1, m5
+    psrad      m0, %3
+    psrad      m1, %3
+    pmovsxwd   m2, [b1q+nq]
+    pmovsxwd   m3, [b1q+nq+16]
+    %2         m0, m2, m0
+    %2         m1, m3, m1
+    PACK_DWORDS
+    movu [dstq+nq], m0
+    add        nq, mmsize
+    jl .loop
+    RET
+%endmacro
+
+; void dwt_lift_<name>(IDWTELEM *dst, const IDWTELEM *b0, const IDWTELEM *b1,
+;                      const IDWTELEM *b2, const IDWTELEM *b3,
+;                      const IDWTELEM *b4, int n)
+; dst = b2 op ((9 * (b1 + b3) - (b0 + b4) + rnd) >> shift)
+; %1 = name, %2 = op, %3 = shift, %4 = rnd
+%macro LIFT_5TAP 4
+cglobal dwt_lift_%1, 7, 7, 8, dst, b0, b1, b2, b3, b4, n
+    movsxdifnidn nq, nd
+    add        nq, nq
+    add      dstq, nq
+    add       b0q, nq
+    add       b1q, nq
+    add       b2q, nq
+    add       b3q, nq
+    add       b4q, nq
+    neg        nq
+    vpbroadcastd m5, [pd_%4]
+    pxor       m7, m7
+.loop:
+    pmovsxwd   m0, [b1q+nq]
+    pmovsxwd   m1, [b1q+nq+16]
+    pmovsxwd   m2, [b3q+nq]
+    pmovsxwd   m3, [b3q+nq+16]
+    paddd      m0, m2
+    paddd      m1, m3
+    pslld      m2, m0, 3
+    pslld      m3, m1, 3
+    paddd      m0, m2
+    paddd      m1, m3
+    pmovsxwd   m2, [b0q+nq]
+    pmovsxwd   m3, [b0q+nq+16]
+    pmovsxwd   m4, [b4q+nq]
+    paddd      m2, m4
+    pmovsxwd   m4, [b4q+nq+16]
+    paddd      m3, m4
+    psubd      m0, m2
+    psubd      m1, m3
+    paddd      m0, m5
+    paddd      m1, m5
+    psrad      m0, %3
+    psrad      m1, %3
+    pmovsxwd   m2, [b2q+nq]
+    pmovsxwd   m3, [b2q+nq+16]
+    %2         m0, m2, m0
+    %2         m1, m3, m1
+    PACK_DWORDS
+    movu [dstq+nq], m0
+    add        nq, mmsize
+    jl .loop
+    RET
+%endmacro
+
+; void vertical_compose_haar(IDWTELEM *b0, IDWTELEM *b1, int width)
+; width a non-zero multiple of 16; 16 bits suffice once the halving is exact
+%macro VERTICAL_HAAR 0
+cglobal vertical_compose_haar, 3, 3, 8, b0, b1, width
+    movsxdifnidn widthq, widthd
+    add    widthq, widthq
+    add       b0q, widthq
+    add       b1q, widthq
+    neg    widthq
+    mova       m7, [pw_1]
+.loop:
+    movu       m0, [b0q+widthq]
+    movu       m1, [b1q+widthq]
+    mova       m2, m1
+    ROUND_HALF m2, m3
+    psubw      m0, m2
+    paddw      m1, m0
+    movu [b0q+widthq], m0
+    movu [b1q+widthq], m1
+    add    widthq, mmsize
+    jl .loop
+    RET
+%endmacro
+
+; void dwt_interleave_<name>(IDWTELEM *b, const IDWTELEM *tmp,
+;                            const IDWTELEM *hi, int n)
+; Second horizontal lifting step combined with the interleave and the final
+; rounding: b[2x] = (tmp[x] + 1) >> 1, b[2x+1] = (odd + 1) >> 1. b may alias
+; hi, which is only overwritten once it has been read. n a non-zero multiple
+; of 8.
+%macro INTERLEAVE 1
+cglobal dwt_interleave_%1, 4, 4, 7, b, tmp, hi, n
+    movsxdifnidn nq, nd
+    add        nq, nq
+    lea        bq, [bq+2*nq]
+    add      tmpq, nq
+    add       hiq, nq
+    neg        nq
+    vpbroadcastd m6, [pd_1]
+%ifidn %1, dd97i
+    vpbroadcastd m5, [pd_8]
+%endif
+.loop:
+    pmovsxwd   m0, [tmpq+nq]
+    pmovsxwd   m1, [tmpq+nq+2]
+%ifidn %1, dd97i
+    ; odd = hi + ((9 * (tmp[x] + tmp[x+1]) - (tmp[x-1] + tmp[x+2]) + 8) >> 4)
+    pmovsxwd   m2, [tmpq+nq-2]
+    pmovsxwd   m3, [tmpq+nq+4]
+    paddd      m1, m0
+    pslld      m4, m1, 3
+    paddd      m1, m4
+    paddd      m2, m3
+    psubd      m1, m2
+    paddd      m1, m5
+    psrad      m1, 4
+    pmovsxwd   m2, [hiq+nq]
+    paddd      m1, m2
+%else
+    ; odd = (int16_t)(hi + ((tmp[x] + tmp[x+1] + 1) >> 1))
+    paddd      m1, m0
+    paddd      m1, m6
+    psrad      m1, 1
+    pmovsxwd   m2, [hiq+nq]
+    paddd      m1, m2
+    pslld      m1, 16
+    psrad      m1, 16
+%endif
+    paddd      m1, m6
+    psrad      m1, 1
+    pslld      m1, 16
+    paddd      m0, m6
+    psrad      m0, 1
+    pblendw    m0, m1, 0xaa
+    movu [bq+2*nq], m0
+    add        nq, mmsize/2
+    jl .loop
+    RET
+%endmacro
+
+INIT_YMM avx2
+LIFT_3TAP 53iL0,      psubd, 2, 2
+LIFT_3TAP daub97iL1,  psubd, 12, 2048, 1817
+LIFT_3TAP daub97iH1,  psubd, 7,  64,   113
+LIFT_3TAP daub97iL0,  paddd, 12, 2048, 217
+LIFT_3TAP daub97iH0,  paddd, 12, 2048, 6497
+LIFT_5TAP dd137iL0,   psubd, 5, 16
+VERTICAL_HAAR
+INTERLEAVE dd97i
+INTERLEAVE dirac53i
+%endif ; ARCH_X86_64 && HAVE_AVX2_EXTERNAL
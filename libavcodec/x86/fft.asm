@@ -243,6 +243,19 @@ IF%1 mova    m7, Z2(7)
     mova     m5, Z(5) ; i2
     mova     m0, [wq] ; wre
     mova     m1, [wq+o1q] ; wim
+%if cpuflag(fma3)
+    mulps    m2, m5, m1 ; i2*wim
+    mova     m6, Z2(6) ; r3
+    mulps    m3, m4, m1 ; r2*wim
+    mova     m7, Z2(7) ; i3
+    fmaddps  m2, m4, m0, m2 ; r2*wre + i2*wim
+    fmsubps  m5, m5, m0, m3 ; i2*wre - r2*wim
+    mulps    m3, m1, m7 ; i3*wim
+    mulps    m1, m1, m6 ; r3*wim
+    fmsubps  m3, m0, m6, m3 ; r3*wre - i3*wim
+    fmaddps  m0, m0, m7, m1 ; i3*wre + r3*wim
+    SWAP      3, 4
+%else
     mulps    m2, m4, m0 ; r2*wre
     mova     m6, Z2(6) ; r3
     mulps    m3, m5, m1 ; i2*wim
@@ -256,8 +269,9 @@ IF%1 mova    m7, Z2(7)
     mulps    m4, m0, m6 ; r3*wre
     mulps    m0, m0, m7 ; i3*wre
     subps    m4, m4, m3 ; r3*wre - i3*wim
-    mova     m3, Z(0)
     addps    m0, m0, m1 ; i3*wre + r3*wim
+%endif
+    mova     m3, Z(0)
     subps    m1, m4, m2 ; t3
     addps    m4, m4, m2 ; t5
     subps    m3, m3, m4 ; r2
@@ -552,18 +566,37 @@ INIT_YMM avx
 
 %define INTERL INTERL_AVX
 
-DECL_PASS pass_avx, PASS_BIG 1
-DECL_PASS pass_interleave_avx, PASS_BIG 0
-
+%macro FFT_CALC_FUNC_AVX 0
 cglobal fft_calc, 2,5,8
     mov     r3d, [r0 + FFTContext.nbits]
     mov     r0, r1
     mov     r1, r3
     FFT_DISPATCH _interleave %+ SUFFIX, r1
     REP_RET
+%endmacro
+
+DECL_PASS pass_avx, PASS_BIG 1
+DECL_PASS pass_interleave_avx, PASS_BIG 0
+
+FFT_CALC_FUNC_AVX
 
 %endif
 
+%if HAVE_FMA3_EXTERNAL
+INIT_YMM fma3
+; the transforms up to size 32 have no twiddle products worth fusing
+%define fft4_fma3             fft4_avx
+%define fft8_fma3             fft8_avx
+%define fft16_fma3            fft16_avx
+%define fft32_fma3            fft32_avx
+%define fft32_interleave_fma3 fft32_interleave_avx
+
+DECL_PASS pass_fma3, PASS_BIG 1
+DECL_PASS pass_interleave_fma3, PASS_BIG 0
+
+FFT_CALC_FUNC_AVX
+%endif
+
 INIT_XMM sse
 
 %macro INTERL_SSE 5
@@ -786,6 +819,11 @@ INIT_YMM avx
 DECL_FFT 6
 DECL_FFT 6, _interleave
 %endif
+%if HAVE_FMA3_EXTERNAL
+INIT_YMM fma3
+DECL_FFT 6
+DECL_FFT 6, _interleave
+%endif
 INIT_XMM sse
 DECL_FFT 5
 DECL_FFT 5, _interleave
@@ -863,10 +901,15 @@ INIT_XMM sse
 %macro CMUL 6 ;j, xmm0, xmm1, 3, 4, 5
     mulps      m6, %3, [%5+%1]
     mulps      m7, %2, [%5+%1]
+%if cpuflag(fma3)
+    fmsubps    %2, %2, [%6+%1], m6
+    fmaddps    %3, %3, [%6+%1], m7
+%else
     mulps      %2, %2, [%6+%1]
     mulps      %3, %3, [%6+%1]
     subps      %2, %2, m6
     addps      %3, %3, m7
+%endif
 %endmacro
 
 %macro POSROTATESHUF_AVX 5 ;j, k, z+n8, tcos+n8, tsin+n8
@@ -1091,3 +1134,8 @@ INIT_YMM avx
 %if HAVE_AVX_EXTERNAL
 DECL_IMDCT POSROTATESHUF_AVX
 %endif
+
+%if HAVE_FMA3_EXTERNAL
+INIT_YMM fma3
+DECL_IMDCT POSROTATESHUF_AVX
+%endif
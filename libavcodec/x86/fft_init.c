@@ -54,4 +54,10 @@ av_cold void ff_fft_init_x86(FFTContext *s)
         s->fft_calc        = ff_fft_calc_avx;
         s->fft_permutation = FF_FFT_PERM_AVX;
     }
+    if (EXTERNAL_FMA3(cpu_flags) && !(cpu_flags & AV_CPU_FLAG_AVXSLOW) &&
+        s->nbits >= 5) {
+        s->imdct_half      = ff_imdct_half_fma3;
+        s->fft_calc        = ff_fft_calc_fma3;
+        s->fft_permutation = FF_FFT_PERM_AVX;
+    }
 }
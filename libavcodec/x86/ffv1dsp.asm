@@ -0,0 +1,92 @@
+;******************************************************************************
+;* SIMD optimized FFV1 context and prediction functions
+;*
+;* This file is part of FFmpeg.
+;*
+;* FFmpeg is free software; you can redistribute it and/or
+;* modify it under the terms of the GNU Lesser General Public
+;* License as published by the Free Software Foundation; either
+;* version 2.1 of the License, or (at your option) any later version.
+;*
+;* FFmpeg is distributed in the hope that it will be useful,
+;* but WITHOUT ANY WARRANTY; without even the implied warranty of
+;* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+;* Lesser General Public License for more details.
+;*
+;* You should have received a copy of the GNU Lesser General Public
+;* License along with FFmpeg; if not, write to the Free Software
+;* Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+;******************************************************************************
+
+%include "libavutil/x86/x86util.asm"
+
+SECTION .text
+
+%if ARCH_X86_64 && HAVE_AVX2_EXTERNAL
+INIT_YMM avx2
+;-----------------------------------------------------------------------------
+; void ff_ffv1_quant_lookup_avx2(int32_t *context, const int16_t *a,
+;                                const int16_t *b, const int16_t *q,
+;                                int n, int accumulate)
+; context[x] = (accumulate ? context[x] : 0) + q[(a[x] - b[x]) & 0xFF]
+; n is a non-zero multiple of 8; the table entries are gathered as dwords
+; and sign extended, so q[256] has to be readable
+;-----------------------------------------------------------------------------
+cglobal ffv1_quant_lookup, 6, 6, 8, context, a, b, q, n, acc
+    movsxdifnidn      nq, nd
+    neg             accd
+    movd             xm6, accd
+    vpbroadcastd      m6, xm6
+    pcmpeqd           m7, m7
+    psrld             m5, m7, 24
+    add               nq, nq
+    lea         contextq, [contextq+nq*2]
+    add               aq, nq
+    add               bq, nq
+    neg               nq
+.loop:
+    pmovsxwd          m0, [aq+nq]
+    pmovsxwd          m1, [bq+nq]
+    psubd             m0, m1
+    pand              m0, m5
+    mova              m2, m7
+    vpgatherdd        m3, [qq+m0*2], m2
+    pslld             m3, 16
+    psrad             m3, 16
+    pand              m4, m6, [contextq+nq*2]
+    paddd             m3, m4
+    movu [contextq+nq*2], m3
+    add               nq, mmsize/2
+    jl .loop
+    RET
+
+;-----------------------------------------------------------------------------
+; void ff_ffv1_predict_residual_avx2(int32_t *diff, const int16_t *src,
+;                                    const int16_t *last, int n)
+; diff[x] = src[x] - mid_pred(L, L + T - LT, T), computed as
+; max(min(L, T), min(max(L, T), L + T - LT)); n is a non-zero multiple of 8
+;-----------------------------------------------------------------------------
+cglobal ffv1_predict_residual, 4, 4, 6, diff, src, last, n
+    movsxdifnidn      nq, nd
+    add               nq, nq
+    lea            diffq, [diffq+nq*2]
+    add             srcq, nq
+    add            lastq, nq
+    neg               nq
+.loop:
+    pmovsxwd          m0, [srcq+nq-2]       ; L
+    pmovsxwd          m1, [lastq+nq]        ; T
+    pmovsxwd          m2, [lastq+nq-2]      ; LT
+    pmovsxwd          m3, [srcq+nq]
+    paddd             m4, m0, m1
+    psubd             m4, m2
+    pminsd            m5, m0, m1
+    pmaxsd            m0, m1
+    pminsd            m4, m0
+    pmaxsd            m4, m5
+    psubd             m3, m4
+    movu [diffq+nq*2], m3
+    add               nq, mmsize/2
+    jl .loop
+    RET
+%endif ; ARCH_X86_64 && HAVE_AVX2_EXTERNAL
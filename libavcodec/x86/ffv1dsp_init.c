@@ -0,0 +1,87 @@
+/*
+ * This file is part of FFmpeg.
+ *
+ * FFmpeg is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * FFmpeg is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with FFmpeg; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+
+#include <stdint.h>
+
+#include "config.h"
+#include "libavutil/attributes.h"
+#include "libavutil/cpu.h"
+#include "libavutil/x86/cpu.h"
+#include "libavcodec/ffv1dsp.h"
+
+void ff_ffv1_quant_lookup_avx2(int32_t *context, const int16_t *a,
+                               const int16_t *b, const int16_t *q,
+                               int n, int accumulate);
+void ff_ffv1_predict_residual_avx2(int32_t *diff, const int16_t *src,
+                                   const int16_t *last, int n);
+
+#if HAVE_YASM && ARCH_X86_64
+static void context_top_avx2(int32_t *context, const int16_t *last,
+                             const int16_t *last2, int16_t (*quant_table)[256],
+                             int w, int large)
+{
+    int n = w & ~7;
+
+    if (n) {
+        ff_ffv1_quant_lookup_avx2(context, last - 1, last, quant_table[1], n, 0);
+        ff_ffv1_quant_lookup_avx2(context, last, last + 1, quant_table[2], n, 1);
+        if (large)
+            ff_ffv1_quant_lookup_avx2(context, last2, last, quant_table[4], n, 1);
+    }
+    ff_ffv1_context_top_c(context + n, last + n, last2 + n, quant_table,
+                          w - n, large);
+}
+
+static void context_left_avx2(int32_t *context, const int16_t *src,
+                              const int16_t *last, int16_t (*quant_table)[256],
+                              int w, int large)
+{
+    int n = w & ~7;
+
+    if (n) {
+        ff_ffv1_quant_lookup_avx2(context, src - 1, last - 1, quant_table[0], n, 1);
+        if (large)
+            ff_ffv1_quant_lookup_avx2(context, src - 2, src - 1, quant_table[3], n, 1);
+    }
+    ff_ffv1_context_left_c(context + n, src + n, last + n, quant_table,
+                           w - n, large);
+}
+
+static void predict_residual_avx2(int32_t *diff, const int16_t *src,
+                                  const int16_t *last, int w)
+{
+    int n = w & ~7;
+
+    if (n)
+        ff_ffv1_predict_residual_avx2(diff, src, last, n);
+    ff_ffv1_predict_residual_c(diff + n, src + n, last + n, w - n);
+}
+#endif /* HAVE_YASM && ARCH_X86_64 */
+
+av_cold void ff_ffv1dsp_init_x86(FFV1DSPContext *c)
+{
+#if HAVE_YASM && ARCH_X86_64
+    int cpu_flags = av_get_cpu_flags();
+
+    if (EXTERNAL_AVX2(cpu_flags)) {
+        c->context_top      = context_top_avx2;
+        c->context_left     = context_left_avx2;
+        c->predict_residual = predict_residual_avx2;
+    }
+#endif /* HAVE_YASM && ARCH_X86_64 */
+}
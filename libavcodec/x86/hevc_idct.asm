@@ -21,6 +21,64 @@
 ; */
 %include "libavutil/x86/x86util.asm"
 
+SECTION_RODATA 32
+
+; For p = 0 .. size / 4 - 1, one row with the pairs { T[4p][i], T[4p + 2][i] }
+; followed by one with { T[4p + 1][i], T[4p + 3][i] }, for i = 0 .. size / 2 - 1
+idct16_coeffs:
+    dw  64,  89,  64,  75,  64,  50,  64,  18,  64, -18,  64, -50,  64, -75,  64, -89
+    dw  90,  87,  87,  57,  80,   9,  70, -43,  57, -80,  43, -90,  25, -70,   9, -25
+    dw  83,  75,  36, -18, -36, -89, -83, -50, -83,  50, -36,  89,  36,  18,  83, -75
+    dw  80,  70,   9, -43, -70, -87, -87,   9, -25,  90,  57,  25,  90, -80,  43, -57
+    dw  64,  50, -64, -89, -64,  18,  64,  75,  64, -75, -64, -18, -64,  89,  64, -50
+    dw  57,  43, -80, -90, -25,  57,  90,  25,  -9, -87, -87,  70,  43,   9,  70, -80
+    dw  36,  18, -83, -50,  83,  75, -36, -89, -36,  89,  83, -75, -83,  50,  36, -18
+    dw  25,   9, -70, -25,  90,  43, -80, -57,  43,  70,   9, -80, -57,  87,  87, -90
+idct32_coeffs:
+    dw  64,  90,  64,  87,  64,  80,  64,  70,  64,  57,  64,  43,  64,  25,  64,   9
+    dw  64,  -9,  64, -25,  64, -43,  64, -57,  64, -70,  64, -80,  64, -87,  64, -90
+    dw  90,  90,  90,  82,  88,  67,  85,  46,  82,  22,  78,  -4,  73, -31,  67, -54
+    dw  61, -73,  54, -85,  46, -90,  38, -88,  31, -78,  22, -61,  13, -38,   4, -13
+    dw  89,  87,  75,  57,  50,   9,  18, -43, -18, -80, -50, -90, -75, -70, -89, -25
+    dw -89,  25, -75,  70, -50,  90, -18,  80,  18,  43,  50,  -9,  75, -57,  89, -87
+    dw  88,  85,  67,  46,  31, -13, -13, -67, -54, -90, -82, -73, -90, -22, -78,  38
+    dw -46,  82,  -4,  88,  38,  54,  73,  -4,  90, -61,  85, -90,  61, -78,  22, -31
+    dw  83,  80,  36,   9, -36, -70, -83, -87, -83, -25, -36,  57,  36,  90,  83,  43
+    dw  83, -43,  36, -90, -36, -57, -83,  25, -83,  87, -36,  70,  36,  -9,  83, -80
+    dw  82,  78,  22,  -4, -54, -82, -90, -73, -61,  13,  13,  85,  78,  67,  85, -22
+    dw  31, -88, -46, -61, -90,  31, -67,  90,   4,  54,  73, -38,  88, -90,  38, -46
+    dw  75,  70, -18, -43, -89, -87, -50,   9,  50,  90,  89,  25,  18, -80, -75, -57
+    dw -75,  57,  18,  80,  89, -25,  50, -90, -50,  -9, -89,  87, -18,  43,  75, -70
+    dw  73,  67, -31, -54, -90, -78, -22,  38,  78,  85,  67, -22, -38, -90, -90,   4
+    dw -13,  90,  82,  13,  61, -88, -46, -31, -88,  82,  -4,  46,  85, -73,  54, -61
+    dw  64,  57, -64, -80, -64, -25,  64,  90,  64,  -9, -64, -87, -64,  43,  64,  70
+    dw  64, -70, -64, -43, -64,  87,  64,   9,  64, -90, -64,  25, -64,  80,  64, -57
+    dw  61,  54, -73, -85, -46,  -4,  82,  88,  31, -46, -88, -61, -13,  82,  90,  13
+    dw  -4, -90, -90,  38,  22,  67,  85, -78, -38, -22, -78,  90,  54, -31,  67, -73
+    dw  50,  43, -89, -90,  18,  57,  75,  25, -75, -87, -18,  70,  89,   9, -50, -80
+    dw -50,  80,  89,  -9, -18, -70, -75,  87,  75, -25,  18, -57, -89,  90,  50, -43
+    dw  46,  38, -90, -88,  38,  73,  54,  -4, -90, -67,  31,  90,  61, -46, -88, -31
+    dw  22,  85,  67, -78, -85,  13,  13,  61,  73, -90, -82,  54,   4,  22,  78, -82
+    dw  36,  25, -83, -70,  83,  90, -36, -80, -36,  43,  83,   9, -83, -57,  36,  87
+    dw  36, -87, -83,  57,  83,  -9, -36, -43, -36,  80,  83, -90, -83,  70,  36, -25
+    dw  31,  22, -78, -61,  90,  85, -61, -90,   4,  73,  54, -38, -88,  -4,  82,  46
+    dw -38, -78, -22,  90,  73, -82, -90,  54,  67, -13, -13, -31, -46,  67,  85, -88
+    dw  18,   9, -50, -25,  75,  43, -89, -57,  89,  70, -75, -80,  50,  87, -18, -90
+    dw -18,  90,  50, -87, -75,  80,  89, -70, -89,  57,  75, -43, -50,  25,  18,  -9
+    dw  13,   4, -38, -13,  61,  22, -78, -31,  88,  38, -90, -46,  85,  54, -73, -61
+    dw  54,  67, -31, -73,   4,  78,  22, -82, -46,  85,  67, -88, -82,  90,  90, -90
+
+; the even words of each lane in its low and the odd ones in its high quadword
+shuf_even_odd:     times 2 db 0, 1, 4, 5, 8, 9, 12, 13, 2, 3, 6, 7, 10, 11, 14, 15
+shuf_reverse:      times 2 db 14, 15, 12, 13, 10, 11, 8, 9, 6, 7, 4, 5, 2, 3, 0, 1
+shuf_reverse_high:         db 0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15
+                           db 14, 15, 12, 13, 10, 11, 8, 9, 6, 7, 4, 5, 2, 3, 0, 1
+
+pd_64:   times 8 dd 64
+pd_128:  times 8 dd 128
+pd_512:  times 8 dd 512
+pd_2048: times 8 dd 2048
+
 SECTION .text
 
 ; void ff_hevc_idctHxW_dc_{8,10}_<opt>(int16_t *coeffs)
@@ -120,3 +178,203 @@ INIT_YMM avx2
 IDCT_DC    16,  2, 12
 IDCT_DC    32,  8, 12
 %endif ;HAVE_AVX2_EXTERNAL
+
+; void ff_hevc_idct_NxN_{8,10,12}_avx2(int16_t *coeffs, int col_limit)
+; Each 1-D transform is a product with the DCT matrix T split into its even
+; part E and odd part O, out[i] = E[i] + O[i] and out[N - 1 - i] = E[i] - O[i].
+; The sums are exact, hence bitexact with the butterflies of the C version.
+; The columns are transformed first, 16 at a time, from a copy of the block
+; with the rows 4p and 4p + 2, 4p + 1 and 4p + 3 interleaved for pmaddwd.
+
+; %1 = N
+%macro IDCT_COLUMNS 1
+    xor                xd, xd
+.interleave:
+    lea              srcq, [coeffsq + 2*xq]
+    imul             dstq, xq, %1*2
+    add              dstq, rsp
+%assign p 0
+%rep %1/4
+    movu               m0, [srcq + (4*p + 0)*%1*2]
+    movu               m1, [srcq + (4*p + 1)*%1*2]
+    movu               m2, [srcq + (4*p + 2)*%1*2]
+    movu               m3, [srcq + (4*p + 3)*%1*2]
+    punpckhwd          m4, m0, m2
+    punpcklwd          m0, m2
+    punpckhwd          m5, m1, m3
+    punpcklwd          m1, m3
+    mova [dstq + 128*p +  0], m0
+    mova [dstq + 128*p + 32], m4
+    mova [dstq + 128*p + 64], m1
+    mova [dstq + 128*p + 96], m5
+%assign p p+1
+%endrep
+    add                xd, 16
+    cmp                xd, %1
+    jl .interleave
+
+    xor                xd, xd
+.column_strip:
+    imul             srcq, xq, %1*2
+    add              srcq, rsp
+    lea              tabq, [idct%1_coeffs]
+    lea              dstq, [coeffsq + 2*xq]
+    lea              endq, [coeffsq + 2*xq + (%1 - 1)*%1*2]
+    mov              cntd, %1/2
+.column:
+%assign p 0
+%rep %1/4
+    vpbroadcastd       m4, [tabq + (2*p + 0)*%1*2]
+    vpbroadcastd       m5, [tabq + (2*p + 1)*%1*2]
+%if p == 0
+    pmaddwd            m0, m4, [srcq +  0]
+    pmaddwd            m1, m4, [srcq + 32]
+    pmaddwd            m2, m5, [srcq + 64]
+    pmaddwd            m3, m5, [srcq + 96]
+%else
+    pmaddwd            m6, m4, [srcq + 128*p +  0]
+    paddd              m0, m6
+    pmaddwd            m6, m4, [srcq + 128*p + 32]
+    paddd              m1, m6
+    pmaddwd            m6, m5, [srcq + 128*p + 64]
+    paddd              m2, m6
+    pmaddwd            m6, m5, [srcq + 128*p + 96]
+    paddd              m3, m6
+%endif
+%assign p p+1
+%endrep
+    paddd              m0, [pd_64]
+    paddd              m1, [pd_64]
+    paddd              m4, m0, m2
+    paddd              m6, m1, m3
+    psubd              m0, m2
+    psubd              m1, m3
+    psrad              m4, 7
+    psrad              m6, 7
+    psrad              m0, 7
+    psrad              m1, 7
+    packssdw           m4, m6
+    packssdw           m0, m1
+    movu           [dstq], m4
+    movu           [endq], m0
+    add              tabq, 4
+    add              dstq, %1*2
+    sub              endq, %1*2
+    dec              cntd
+    jg .column
+    add                xd, 16
+    cmp                xd, %1
+    jl .column_strip
+
+    mova               m7, [shuf_even_odd]
+    mov              srcq, coeffsq
+    mov              cntd, %1
+%endmacro
+
+; %1 = bitdepth, %2 = 1 << (19 - bitdepth)
+%macro IDCT16_AVX2 2
+cglobal hevc_idct_16x16_%1, 1, 7, 8, 16*16*2, coeffs, src, dst, tab, end, cnt, x
+    IDCT_COLUMNS 16
+.row:
+    movu               m0, [srcq]
+    pshufb             m0, m7
+    vpermq             m0, m0, q3120
+    mova            [rsp], m0
+%assign p 0
+%rep 4
+    vpbroadcastd       m4, [rsp + 4*p]
+    vpbroadcastd       m5, [rsp + 4*p + 16]
+%if p == 0
+    pmaddwd            m0, m4, [idct16_coeffs]
+    pmaddwd            m1, m5, [idct16_coeffs + 32]
+%else
+    pmaddwd            m6, m4, [idct16_coeffs + 64*p]
+    paddd              m0, m6
+    pmaddwd            m6, m5, [idct16_coeffs + 64*p + 32]
+    paddd              m1, m6
+%endif
+%assign p p+1
+%endrep
+    paddd              m0, [pd_%2]
+    paddd              m2, m0, m1
+    psubd              m0, m1
+    psrad              m2, 20 - %1
+    psrad              m0, 20 - %1
+    packssdw           m2, m0
+    vpermq             m2, m2, q3120
+    pshufb             m2, [shuf_reverse_high]
+    movu           [srcq], m2
+    add              srcq, 32
+    dec              cntd
+    jg .row
+    RET
+%endmacro
+
+; %1 = bitdepth, %2 = 1 << (19 - bitdepth)
+%macro IDCT32_AVX2 2
+cglobal hevc_idct_32x32_%1, 1, 7, 8, 32*32*2, coeffs, src, dst, tab, end, cnt, x
+    IDCT_COLUMNS 32
+.row:
+    movu               m0, [srcq]
+    movu               m1, [srcq + 32]
+    pshufb             m0, m7
+    pshufb             m1, m7
+    vpermq             m0, m0, q3120
+    vpermq             m1, m1, q3120
+    vperm2i128         m2, m0, m1, 0x20
+    vperm2i128         m3, m0, m1, 0x31
+    mova            [rsp], m2
+    mova       [rsp + 32], m3
+%assign p 0
+%rep 8
+    vpbroadcastd       m4, [rsp + 4*p]
+    vpbroadcastd       m5, [rsp + 4*p + 32]
+%if p == 0
+    pmaddwd            m0, m4, [idct32_coeffs]
+    pmaddwd            m1, m4, [idct32_coeffs + 32]
+    pmaddwd            m2, m5, [idct32_coeffs + 64]
+    pmaddwd            m3, m5, [idct32_coeffs + 96]
+%else
+    pmaddwd            m6, m4, [idct32_coeffs + 128*p]
+    paddd              m0, m6
+    pmaddwd            m6, m4, [idct32_coeffs + 128*p + 32]
+    paddd              m1, m6
+    pmaddwd            m6, m5, [idct32_coeffs + 128*p + 64]
+    paddd              m2, m6
+    pmaddwd            m6, m5, [idct32_coeffs + 128*p + 96]
+    paddd              m3, m6
+%endif
+%assign p p+1
+%endrep
+    paddd              m0, [pd_%2]
+    paddd              m1, [pd_%2]
+    paddd              m4, m0, m2
+    paddd              m6, m1, m3
+    psubd              m0, m2
+    psubd              m1, m3
+    psrad              m4, 20 - %1
+    psrad              m6, 20 - %1
+    psrad              m0, 20 - %1
+    psrad              m1, 20 - %1
+    packssdw           m4, m6
+    packssdw           m0, m1
+    vpermq             m4, m4, q3120
+    pshufb             m0, [shuf_reverse]
+    vpermq             m0, m0, q1302
+    movu           [srcq], m4
+    movu      [srcq + 32], m0
+    add              srcq, 64
+    dec              cntd
+    jg .row
+    RET
+%endmacro
+
+%if ARCH_X86_64 && HAVE_AVX2_EXTERNAL
+INIT_YMM avx2
+IDCT16_AVX2  8, 2048
+IDCT32_AVX2  8, 2048
+IDCT16_AVX2 10,  512
+IDCT32_AVX2 10,  512
+IDCT16_AVX2 12,  128
+IDCT32_AVX2 12,  128
+%endif
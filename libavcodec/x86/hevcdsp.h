@@ -258,4 +258,12 @@ void ff_hevc_transform_add32_10_sse2(uint8_t *dst, int16_t *coeffs, ptrdiff_t st
 void ff_hevc_transform_add16_10_avx2(uint8_t *dst, int16_t *coeffs, ptrdiff_t stride);
 void ff_hevc_transform_add32_10_avx2(uint8_t *dst, int16_t *coeffs, ptrdiff_t stride);
 
+void ff_hevc_idct_16x16_8_avx2(int16_t *coeffs, int col_limit);
+void ff_hevc_idct_32x32_8_avx2(int16_t *coeffs, int col_limit);
+void ff_hevc_idct_16x16_10_avx2(int16_t *coeffs, int col_limit);
+void ff_hevc_idct_32x32_10_avx2(int16_t *coeffs, int col_limit);
+void ff_hevc_idct_16x16_12_avx2(int16_t *coeffs, int col_limit);
+void ff_hevc_idct_32x32_12_avx2(int16_t *coeffs, int col_limit);
+
+
 #endif // AVCODEC_X86_HEVCDSP_H
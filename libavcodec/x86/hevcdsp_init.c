@@ -853,6 +853,10 @@ void ff_hevc_dsp_init_x86(HEVCDSPContext *c, const int bit_depth)
 
             c->transform_add[3]    = ff_hevc_transform_add32_8_avx2;
         }
+        if (EXTERNAL_AVX2(cpu_flags) && ARCH_X86_64) {
+            c->idct[2] = ff_hevc_idct_16x16_8_avx2;
+            c->idct[3] = ff_hevc_idct_32x32_8_avx2;
+        }
     } else if (bit_depth == 10) {
         if (EXTERNAL_MMXEXT(cpu_flags)) {
             c->transform_add[0] = ff_hevc_transform_add4_10_mmxext;
@@ -1058,6 +1062,10 @@ void ff_hevc_dsp_init_x86(HEVCDSPContext *c, const int bit_depth)
             c->transform_add[3] = ff_hevc_transform_add32_10_avx2;
 
         }
+        if (EXTERNAL_AVX2(cpu_flags) && ARCH_X86_64) {
+            c->idct[2] = ff_hevc_idct_16x16_10_avx2;
+            c->idct[3] = ff_hevc_idct_32x32_10_avx2;
+        }
     } else if (bit_depth == 12) {
         if (EXTERNAL_MMXEXT(cpu_flags)) {
             c->idct_dc[0] = ff_hevc_idct4x4_dc_12_mmxext;
@@ -1110,5 +1118,9 @@ void ff_hevc_dsp_init_x86(HEVCDSPContext *c, const int bit_depth)
             c->sao_edge_filter[3] = ff_hevc_sao_edge_filter_48_12_avx2;
             c->sao_edge_filter[4] = ff_hevc_sao_edge_filter_64_12_avx2;
         }
+        if (EXTERNAL_AVX2(cpu_flags) && ARCH_X86_64) {
+            c->idct[2] = ff_hevc_idct_16x16_12_avx2;
+            c->idct[3] = ff_hevc_idct_32x32_12_avx2;
+        }
     }
 }
@@ -0,0 +1,116 @@
+;******************************************************************************
+;* SIMD optimized 15 * 2^N iMDCT functions
+;*
+;* This file is part of FFmpeg.
+;*
+;* FFmpeg is free software; you can redistribute it and/or
+;* modify it under the terms of the GNU Lesser General Public
+;* License as published by the Free Software Foundation; either
+;* version 2.1 of the License, or (at your option) any later version.
+;*
+;* FFmpeg is distributed in the hope that it will be useful,
+;* but WITHOUT ANY WARRANTY; without even the implied warranty of
+;* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+;* Lesser General Public License for more details.
+;*
+;* You should have received a copy of the GNU Lesser General Public
+;* License along with FFmpeg; if not, write to the Free Software
+;* Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+;******************************************************************************
+
+%include "libavutil/x86/x86util.asm"
+
+SECTION .text
+
+; reverse the order of the 4 complexes in %1
+%macro REVERSE_CPX 1
+    vperm2f128        %1, %1, %1, 1
+    vpermilps         %1, %1, q1032
+%endmacro
+
+INIT_YMM fma3
+;-----------------------------------------------------------------------------
+; void ff_imdct15_butterflies_fma3(FFTComplex *lo, FFTComplex *hi,
+;                                  const FFTComplex *exptab, int n)
+; lo[k] += t, hi[k] = lo[k] - t with t = hi[k] * exptab[k]
+; n is a non-zero multiple of 4
+;-----------------------------------------------------------------------------
+cglobal imdct15_butterflies, 4, 4, 5, lo, hi, exptab, n
+    movsxdifnidn      nq, nd
+    shl               nq, 3
+    add              loq, nq
+    add              hiq, nq
+    add          exptabq, nq
+    neg               nq
+.loop:
+    movu              m1, [hiq+nq]
+    movu              m2, [exptabq+nq]
+    movsldup          m3, m2
+    movshdup          m2, m2
+    vpermilps         m4, m1, q2301
+    mulps             m4, m2
+    fmaddsubps        m1, m1, m3, m4        ; t
+    movu              m0, [loq+nq]
+    addps             m2, m0, m1
+    subps             m0, m1
+    movu      [loq+nq], m2
+    movu      [hiq+nq], m0
+    add               nq, mmsize
+    jl .loop
+    RET
+
+%if ARCH_X86_64
+;-----------------------------------------------------------------------------
+; void ff_imdct15_postrotate_fma3(FFTComplex *z, const FFTComplex *exptab,
+;                                 float scale, int n)
+; z and exptab point at the middle element, z[-k - 1] pairs with z[k] for
+; k < n, so the lower half is walked downwards and reversed on load and
+; store. n is a non-zero multiple of 4
+;-----------------------------------------------------------------------------
+%if UNIX64
+cglobal imdct15_postrotate, 3, 6, 9, z, exptab, n, zlo, tablo, lo
+%else
+cglobal imdct15_postrotate, 4, 7, 9, z, exptab, scale, n, zlo, tablo, lo
+    SWAP               0, 2
+%endif
+    shufps           xm0, xm0, 0
+    vinsertf128       m8, m0, xm0, 1
+    movsxdifnidn      nq, nd
+    shl               nq, 3
+    mov             zloq, zq
+    mov           tabloq, exptabq
+    sub             zloq, nq
+    sub           tabloq, nq
+    add               zq, nq
+    add          exptabq, nq
+    mov              loq, nq
+    neg               nq
+.loop:
+    movu              m0, [zloq+loq-mmsize]
+    movu              m1, [zq+nq]
+    movu              m2, [tabloq+loq-mmsize]
+    movu              m3, [exptabq+nq]
+    REVERSE_CPX       m0
+    REVERSE_CPX       m2
+    movsldup          m4, m2
+    movshdup          m2, m2
+    movsldup          m5, m3
+    movshdup          m3, m3
+    vpermilps         m6, m0, q2301
+    vpermilps         m7, m1, q2301
+    mulps             m0, m4
+    mulps             m1, m5
+    fmaddsubps        m6, m6, m2, m0        ; r0, i1
+    fmaddsubps        m7, m7, m3, m1        ; r1, i0
+    mulps             m6, m8
+    mulps             m7, m8
+    blendps           m0, m6, m7, 0xaa
+    blendps           m1, m7, m6, 0xaa
+    REVERSE_CPX       m0
+    movu [zloq+loq-mmsize], m0
+    movu      [zq+nq], m1
+    sub              loq, mmsize
+    add               nq, mmsize
+    jl .loop
+    RET
+%endif ; ARCH_X86_64
@@ -0,0 +1,93 @@
+/*
+ * This file is part of FFmpeg.
+ *
+ * FFmpeg is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * FFmpeg is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with FFmpeg; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+
+#include <stddef.h>
+
+#include "config.h"
+#include "libavutil/attributes.h"
+#include "libavutil/cpu.h"
+#include "libavutil/x86/cpu.h"
+#include "libavcodec/imdct15.h"
+
+void ff_imdct15_butterflies_fma3(FFTComplex *lo, FFTComplex *hi,
+                                 const FFTComplex *exptab, int n);
+void ff_imdct15_postrotate_fma3(FFTComplex *z, const FFTComplex *exptab,
+                                float scale, int n);
+
+#if HAVE_YASM
+/* the lengths are 15 * 2^N, so the last len2 % 4 are done in C */
+static void fft_butterflies_fma3(FFTComplex *out, const FFTComplex *exptab, int len2)
+{
+    int n = len2 & ~3;
+    int k;
+
+    if (n)
+        ff_imdct15_butterflies_fma3(out, out + len2, exptab, n);
+
+    for (k = n; k < len2; k++) {
+        float tre = out[len2 + k].re * exptab[k].re - out[len2 + k].im * exptab[k].im;
+        float tim = out[len2 + k].re * exptab[k].im + out[len2 + k].im * exptab[k].re;
+
+        out[len2 + k].re = out[k].re - tre;
+        out[len2 + k].im = out[k].im - tim;
+
+        out[k].re += tre;
+        out[k].im += tim;
+    }
+}
+
+#if ARCH_X86_64
+static void postrotate_fma3(FFTComplex *z, const FFTComplex *exptab, float scale,
+                            int len8)
+{
+    int n = len8 & ~3;
+    int i;
+
+    if (n)
+        ff_imdct15_postrotate_fma3(z + len8, exptab + len8, scale, n);
+
+    for (i = n; i < len8; i++) {
+        const FFTComplex *w0 = &exptab[len8 - i - 1], *w1 = &exptab[len8 + i];
+        FFTComplex *z0 = &z[len8 - i - 1], *z1 = &z[len8 + i];
+        float r0 = z0->im * w0->im - z0->re * w0->re;
+        float i1 = z0->im * w0->re + z0->re * w0->im;
+        float r1 = z1->im * w1->im - z1->re * w1->re;
+        float i0 = z1->im * w1->re + z1->re * w1->im;
+
+        z0->re = scale * r0;
+        z0->im = scale * i0;
+        z1->re = scale * r1;
+        z1->im = scale * i1;
+    }
+}
+#endif /* ARCH_X86_64 */
+#endif /* HAVE_YASM */
+
+av_cold void ff_imdct15_init_x86(IMDCT15Context *s)
+{
+#if HAVE_YASM
+    int cpu_flags = av_get_cpu_flags();
+
+    if (EXTERNAL_FMA3(cpu_flags)) {
+        s->fft_butterflies = fft_butterflies_fma3;
+#if ARCH_X86_64
+        s->postrotate      = postrotate_fma3;
+#endif
+    }
+#endif /* HAVE_YASM */
+}
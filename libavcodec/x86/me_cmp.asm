@@ -932,3 +932,253 @@ VSAD_APPROX 8
 VSAD_APPROX 16
 INIT_XMM sse2
 VSAD_APPROX 16
+
+%if HAVE_AVX2_EXTERNAL
+; sad16 and sad16_x4 load two rows per ymm register (one per 128-bit lane),
+; so h must be even.
+
+; load 16 pixels of the rows at %2 and %2 + %3 into m%1
+%macro LOAD_2ROWS 3
+    movu           xm%1, [%2]
+    vinserti128     m%1, m%1, [%2+%3], 1
+%endmacro
+
+; add up the dwords of m%1 into xm%1, m%2 = tmp
+%macro HSUM_D 2
+    vextracti128   xm%2, m%1, 1
+    paddd          xm%1, xm%2
+    pshufd         xm%2, xm%1, q0032
+    paddd          xm%1, xm%2
+    pshufd         xm%2, xm%1, q0001
+    paddd          xm%1, xm%2
+%endmacro
+
+INIT_YMM avx2
+;---------------------------------------------------------------------------------------
+;int ff_sad16_avx2(MpegEncContext *v, uint8_t *pix1, uint8_t *pix2, ptrdiff_t stride, int h);
+;---------------------------------------------------------------------------------------
+cglobal sad16, 5, 5, 4, v, pix1, pix2, stride, h
+    pxor      m0, m0
+.loop:
+    LOAD_2ROWS 2, pix1q, strideq
+    LOAD_2ROWS 3, pix2q, strideq
+    psadbw    m2, m3
+    paddd     m0, m2
+    lea    pix1q, [pix1q+strideq*2]
+    lea    pix2q, [pix2q+strideq*2]
+    sub       hd, 2
+    jg .loop
+    HSUM_D     0, 1
+    movd     eax, xm0
+    RET
+
+;-------------------------------------------------------------------------------------------
+;int ff_sad16_xy2_avx2(MpegEncContext *v, uint8_t *pix1, uint8_t *pix2, ptrdiff_t stride, int h);
+;-------------------------------------------------------------------------------------------
+; the 4 point average needs 16-bit precision to round like the C code
+cglobal sad16_xy2, 5, 5, 8, v, pix1, pix2, stride, h
+    pcmpeqw   m6, m6
+    psrlw     m6, 15          ; pw_1
+    psllw     m7, m6, 1       ; pw_2
+    pxor      m5, m5
+    pmovzxbw  m2, [pix2q]
+    pmovzxbw  m3, [pix2q+1]
+    paddw     m2, m3
+.loop:
+    add    pix2q, strideq
+    pmovzxbw  m3, [pix2q]
+    pmovzxbw  m4, [pix2q+1]
+    paddw     m3, m4
+    paddw     m2, m3
+    paddw     m2, m7
+    psrlw     m2, 2
+    pmovzxbw  m4, [pix1q]
+    psubw     m4, m2
+    pabsw     m4, m4
+    paddw     m5, m4
+    mova      m2, m3
+    add    pix1q, strideq
+    dec       hd
+    jg .loop
+    pmaddwd   m0, m5, m6
+    HSUM_D     0, 1
+    movd     eax, xm0
+    RET
+
+;--------------------------------------------------------------------------------------
+;int ff_sse16_avx2(MpegEncContext *v, uint8_t *pix1, uint8_t *pix2, ptrdiff_t lsize, int h);
+;--------------------------------------------------------------------------------------
+cglobal sse16, 5, 5, 4, v, pix1, pix2, lsize, h
+    pxor      m0, m0
+.loop:
+    pmovzxbw  m2, [pix1q]
+    pmovzxbw  m3, [pix2q]
+    psubw     m2, m3
+    pmaddwd   m2, m2
+    paddd     m0, m2
+    add    pix1q, lsizeq
+    add    pix2q, lsizeq
+    dec       hd
+    jg .loop
+    HSUM_D     0, 1
+    movd     eax, xm0
+    RET
+
+%if ARCH_X86_64
+;--------------------------------------------------------------------------------------
+;void ff_sad16_x4_avx2(MpegEncContext *v, uint8_t *pix1, uint8_t *const pix2[4],
+;                      ptrdiff_t stride, int h, int scores[4]);
+;--------------------------------------------------------------------------------------
+cglobal sad16_x4, 6, 10, 6, v, pix1, pix2, stride, h, scores, ref0, ref1, ref2, ref3
+    mov    ref0q, [pix2q]
+    mov    ref1q, [pix2q+gprsize]
+    mov    ref2q, [pix2q+gprsize*2]
+    mov    ref3q, [pix2q+gprsize*3]
+    pxor      m0, m0
+    pxor      m1, m1
+    pxor      m2, m2
+    pxor      m3, m3
+.loop:
+    LOAD_2ROWS 4, pix1q, strideq
+    LOAD_2ROWS 5, ref0q, strideq
+    psadbw    m5, m4
+    paddd     m0, m5
+    LOAD_2ROWS 5, ref1q, strideq
+    psadbw    m5, m4
+    paddd     m1, m5
+    LOAD_2ROWS 5, ref2q, strideq
+    psadbw    m5, m4
+    paddd     m2, m5
+    LOAD_2ROWS 5, ref3q, strideq
+    psadbw    m5, m4
+    paddd     m3, m5
+    lea    pix1q, [pix1q+strideq*2]
+    lea    ref0q, [ref0q+strideq*2]
+    lea    ref1q, [ref1q+strideq*2]
+    lea    ref2q, [ref2q+strideq*2]
+    lea    ref3q, [ref3q+strideq*2]
+    sub       hd, 2
+    jg .loop
+    ; the sums are in the low dword of each qword, gather them
+    ; as a0 a2 b0 b2 | a4 a6 b4 b6 and c0 c2 d0 d2 | c4 c6 d4 d6
+    pshufd    m0, m0, q0020
+    pshufd    m1, m1, q2000
+    pshufd    m2, m2, q0020
+    pshufd    m3, m3, q2000
+    vpblendd  m0, m0, m1, 0xcc
+    vpblendd  m2, m2, m3, 0xcc
+    phaddd    m0, m2
+    vextracti128 xm1, m0, 1
+    paddd    xm0, xm1
+    movu [scoresq], xm0
+    RET
+
+; a = a + b, b = a - b
+%macro SUMSUB_W 3
+    paddw    m%3, m%1, m%2
+    psubw    m%2, m%1, m%2
+    mova     m%1, m%3
+%endmacro
+
+%macro HADAMARD8_W 9
+    SUMSUB_W %1, %2, %9
+    SUMSUB_W %3, %4, %9
+    SUMSUB_W %5, %6, %9
+    SUMSUB_W %7, %8, %9
+    SUMSUB_W %1, %3, %9
+    SUMSUB_W %2, %4, %9
+    SUMSUB_W %5, %7, %9
+    SUMSUB_W %6, %8, %9
+    SUMSUB_W %1, %5, %9
+    SUMSUB_W %2, %6, %9
+    SUMSUB_W %3, %7, %9
+    SUMSUB_W %4, %8, %9
+%endmacro
+
+; m%1 = src1 - src2 for the 16 pixels at offset %3, m%2 = tmp
+%macro DIFF_ROW_W 3
+    pmovzxbw m%1, [src1q+%3]
+    pmovzxbw m%2, [src2q+%3]
+    psubw    m%1, m%2
+%endmacro
+
+;--------------------------------------------------------------------------------------
+;int ff_hadamard8_diff16_avx2(MpegEncContext *s, uint8_t *src1, uint8_t *src2,
+;                             ptrdiff_t stride, int h);
+;--------------------------------------------------------------------------------------
+; The two 8x8 blocks side by side live in one lane each, so the row
+; transform is a lane-wise transpose plus the column transform.
+cglobal hadamard8_diff16, 5, 7, 16, v, src1, src2, stride, h, stride3, sum
+    lea  stride3q, [strideq*3]
+    xor      sumd, sumd
+.loop:
+    DIFF_ROW_W 0, 8, 0
+    DIFF_ROW_W 1, 8, strideq
+    DIFF_ROW_W 2, 8, strideq*2
+    DIFF_ROW_W 3, 8, stride3q
+    lea     src1q, [src1q+strideq*4]
+    lea     src2q, [src2q+strideq*4]
+    DIFF_ROW_W 4, 8, 0
+    DIFF_ROW_W 5, 8, strideq
+    DIFF_ROW_W 6, 8, strideq*2
+    DIFF_ROW_W 7, 8, stride3q
+    lea     src1q, [src1q+strideq*4]
+    lea     src2q, [src2q+strideq*4]
+    HADAMARD8_W 0, 1, 2, 3, 4, 5, 6, 7, 8
+    ; transpose the 8x8 words of each lane
+    punpcklwd  m8,  m0,  m1
+    punpckhwd  m9,  m0,  m1
+    punpcklwd m10,  m2,  m3
+    punpckhwd m11,  m2,  m3
+    punpcklwd m12,  m4,  m5
+    punpckhwd m13,  m4,  m5
+    punpcklwd m14,  m6,  m7
+    punpckhwd m15,  m6,  m7
+    punpckldq  m0,  m8, m10
+    punpckhdq  m1,  m8, m10
+    punpckldq  m2,  m9, m11
+    punpckhdq  m3,  m9, m11
+    punpckldq  m4, m12, m14
+    punpckhdq  m5, m12, m14
+    punpckldq  m6, m13, m15
+    punpckhdq  m7, m13, m15
+    punpcklqdq m8,  m0,  m4
+    punpckhqdq m9,  m0,  m4
+    punpcklqdq m10, m1,  m5
+    punpckhqdq m11, m1,  m5
+    punpcklqdq m12, m2,  m6
+    punpckhqdq m13, m2,  m6
+    punpcklqdq m14, m3,  m7
+    punpckhqdq m15, m3,  m7
+    HADAMARD8_W 8, 9, 10, 11, 12, 13, 14, 15, 0
+    pabsw      m8,  m8
+    pabsw      m9,  m9
+    pabsw     m10, m10
+    pabsw     m11, m11
+    pabsw     m12, m12
+    pabsw     m13, m13
+    pabsw     m14, m14
+    pabsw     m15, m15
+    ; two coefficients still fit in a signed word
+    paddw      m8,  m9
+    paddw     m10, m11
+    paddw     m12, m13
+    paddw     m14, m15
+    pcmpeqw    m0, m0
+    psrlw      m0, 15
+    pmaddwd    m8, m0
+    pmaddwd   m10, m0
+    pmaddwd   m12, m0
+    pmaddwd   m14, m0
+    paddd      m8, m10
+    paddd     m12, m14
+    paddd      m8, m12
+    HSUM_D     8, 0
+    movd       vd, xm8
+    add      sumd, vd
+    sub        hd, 8
+    jg .loop
+    mov       eax, sumd
+    RET
+%endif ; ARCH_X86_64
+%endif ; HAVE_AVX2_EXTERNAL
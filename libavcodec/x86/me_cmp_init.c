@@ -77,6 +77,14 @@ int ff_vsad16_approx_mmxext(MpegEncContext *v, uint8_t *pix1, uint8_t *pix2,
                      ptrdiff_t stride, int h);
 int ff_vsad16_approx_sse2(MpegEncContext *v, uint8_t *pix1, uint8_t *pix2,
                    ptrdiff_t stride, int h);
+int ff_sad16_avx2(MpegEncContext *v, uint8_t *pix1, uint8_t *pix2,
+                  ptrdiff_t stride, int h);
+int ff_sad16_xy2_avx2(MpegEncContext *v, uint8_t *pix1, uint8_t *pix2,
+                      ptrdiff_t stride, int h);
+void ff_sad16_x4_avx2(MpegEncContext *v, uint8_t *pix1, uint8_t *const pix2[4],
+                      ptrdiff_t stride, int h, int scores[4]);
+int ff_sse16_avx2(MpegEncContext *v, uint8_t *pix1, uint8_t *pix2,
+                  ptrdiff_t stride, int h);
 
 #define hadamard_func(cpu)                                                    \
     int ff_hadamard8_diff_ ## cpu(MpegEncContext *s, uint8_t *src1,           \
@@ -88,6 +96,8 @@ hadamard_func(mmx)
 hadamard_func(mmxext)
 hadamard_func(sse2)
 hadamard_func(ssse3)
+int ff_hadamard8_diff16_avx2(MpegEncContext *s, uint8_t *src1, uint8_t *src2,
+                             ptrdiff_t stride, int h);
 
 #if HAVE_YASM
 static int nsse16_mmx(MpegEncContext *c, uint8_t *pix1, uint8_t *pix2,
@@ -646,6 +656,17 @@ av_cold void ff_me_cmp_init_x86(MECmpContext *c, AVCodecContext *avctx)
 #if HAVE_ALIGNED_STACK
         c->hadamard8_diff[0] = ff_hadamard8_diff16_ssse3;
         c->hadamard8_diff[1] = ff_hadamard8_diff_ssse3;
+#endif
+    }
+
+    if (EXTERNAL_AVX2(cpu_flags)) {
+        c->pix_abs[0][0]     = ff_sad16_avx2;
+        c->pix_abs[0][3]     = ff_sad16_xy2_avx2;
+        c->sad[0]            = ff_sad16_avx2;
+        c->sse[0]            = ff_sse16_avx2;
+#if ARCH_X86_64
+        c->sad_x4[0]         = ff_sad16_x4_avx2;
+        c->hadamard8_diff[0] = ff_hadamard8_diff16_avx2;
 #endif
     }
 }
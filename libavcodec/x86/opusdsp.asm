@@ -0,0 +1,115 @@
+;******************************************************************************
+;* SIMD optimized Opus CELT functions
+;*
+;* This file is part of FFmpeg.
+;*
+;* FFmpeg is free software; you can redistribute it and/or
+;* modify it under the terms of the GNU Lesser General Public
+;* License as published by the Free Software Foundation; either
+;* version 2.1 of the License, or (at your option) any later version.
+;*
+;* FFmpeg is distributed in the hope that it will be useful,
+;* but WITHOUT ANY WARRANTY; without even the implied warranty of
+;* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+;* Lesser General Public License for more details.
+;*
+;* You should have received a copy of the GNU Lesser General Public
+;* License along with FFmpeg; if not, write to the Free Software
+;* Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+;******************************************************************************
+
+%include "libavutil/x86/x86util.asm"
+
+SECTION .text
+
+;-----------------------------------------------------------------------------
+; void ff_opus_normalize_residual_sse2(float *X, const int *iy, float g, int N)
+; N is a non-zero multiple of 4
+;-----------------------------------------------------------------------------
+INIT_XMM sse2
+%if UNIX64
+cglobal opus_normalize_residual, 3, 3, 2, X, iy, N
+%else
+cglobal opus_normalize_residual, 4, 4, 3, X, iy, g, N
+%endif
+%if ARCH_X86_32
+    movss             m0, gm
+%elif WIN64
+    SWAP               0, 2
+%endif
+    shufps            m0, m0, 0
+    shl               Nd, 2
+    add               Xq, Nq
+    add              iyq, Nq
+    neg               Nq
+.loop:
+    movu              m1, [iyq+Nq]
+    cvtdq2ps          m1, m1
+    mulps             m1, m0
+    movu       [Xq+Nq], m1
+    add               Nq, mmsize
+    jl .loop
+    RET
+
+;-----------------------------------------------------------------------------
+; void ff_opus_scale_band_sse(float *X, float g, int N)
+; N is a non-zero multiple of 4
+;-----------------------------------------------------------------------------
+INIT_XMM sse
+%if UNIX64
+cglobal opus_scale_band, 2, 2, 2, X, N
+%else
+cglobal opus_scale_band, 3, 3, 2, X, g, N
+%endif
+%if ARCH_X86_32
+    movss             m0, gm
+%elif WIN64
+    SWAP               0, 1
+%endif
+    shufps            m0, m0, 0
+    shl               Nd, 2
+    add               Xq, Nq
+    neg               Nq
+.loop:
+    movu              m1, [Xq+Nq]
+    mulps             m1, m0
+    movu       [Xq+Nq], m1
+    add               Nq, mmsize
+    jl .loop
+    RET
+
+;-----------------------------------------------------------------------------
+; void ff_opus_postfilter_fma3(float *data, int period, const float *gains,
+;                              int len)
+; 8 outputs per iteration; the taps read at most data[i + 7 - period + 2],
+; which is already filtered as period >= CELT_POSTFILTER_MINPERIOD, so the
+; result matches the sequential filter up to the fma rounding.
+; len is a non-zero multiple of 8
+;-----------------------------------------------------------------------------
+INIT_YMM fma3
+cglobal opus_postfilter, 4, 5, 6, data, period, gains, len, x
+    movsxdifnidn periodq, periodd
+    movsxdifnidn    lenq, lend
+    shl          periodq, 2
+    shl             lenq, 2
+    mov               xq, dataq
+    sub               xq, periodq
+    add            dataq, lenq
+    add               xq, lenq
+    neg             lenq
+    vbroadcastss      m3, [gainsq]
+    vbroadcastss      m4, [gainsq+4]
+    vbroadcastss      m5, [gainsq+8]
+.loop:
+    movu              m0, [xq+lenq-8]
+    movu              m1, [xq+lenq-4]
+    addps             m0, [xq+lenq+8]       ; x0 + x4
+    addps             m1, [xq+lenq+4]       ; x1 + x3
+    mulps             m2, m3, [xq+lenq]
+    fmaddps           m2, m1, m4, m2
+    fmaddps           m2, m0, m5, m2
+    addps             m2, [dataq+lenq]
+    movu  [dataq+lenq], m2
+    add             lenq, mmsize
+    jl .loop
+    RET
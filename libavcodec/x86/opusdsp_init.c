@@ -0,0 +1,79 @@
+/*
+ * This file is part of FFmpeg.
+ *
+ * FFmpeg is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * FFmpeg is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with FFmpeg; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+
+#include "config.h"
+#include "libavutil/attributes.h"
+#include "libavutil/cpu.h"
+#include "libavutil/x86/cpu.h"
+#include "libavcodec/opusdsp.h"
+
+void ff_opus_normalize_residual_sse2(float *X, const int *iy, float g, int N);
+void ff_opus_scale_band_sse(float *X, float g, int N);
+void ff_opus_postfilter_fma3(float *data, int period, const float *gains,
+                             int len);
+
+#if HAVE_YASM
+static void normalize_residual_sse2(float *X, const int *iy, float g, int N)
+{
+    int i, n = N & ~3;
+
+    if (n)
+        ff_opus_normalize_residual_sse2(X, iy, g, n);
+    for (i = n; i < N; i++)
+        X[i] = g * iy[i];
+}
+
+static void scale_band_sse(float *X, float g, int N)
+{
+    int i, n = N & ~3;
+
+    if (n)
+        ff_opus_scale_band_sse(X, g, n);
+    for (i = n; i < N; i++)
+        X[i] *= g;
+}
+
+static void postfilter_fma3(float *data, int period, const float *gains, int len)
+{
+    int n = len & ~7;
+    const float *x = data - period;
+    int j;
+
+    if (n)
+        ff_opus_postfilter_fma3(data, period, gains, n);
+
+    for (j = n; j < len; j++)
+        data[j] += gains[0] * x[j] +
+                   gains[1] * (x[j - 1] + x[j + 1]) +
+                   gains[2] * (x[j - 2] + x[j + 2]);
+}
+#endif /* HAVE_YASM */
+
+av_cold void ff_opus_dsp_init_x86(OpusDSPContext *dsp)
+{
+#if HAVE_YASM
+    int cpu_flags = av_get_cpu_flags();
+
+    if (EXTERNAL_SSE(cpu_flags))
+        dsp->scale_band = scale_band_sse;
+    if (EXTERNAL_SSE2(cpu_flags))
+        dsp->normalize_residual = normalize_residual_sse2;
+    if (EXTERNAL_FMA3(cpu_flags))
+        dsp->postfilter = postfilter_fma3;
+#endif /* HAVE_YASM */
+}
@@ -0,0 +1,142 @@
+;******************************************************************************
+;* x86 optimizations for PNG encoding
+;*
+;* This file is part of FFmpeg.
+;*
+;* FFmpeg is free software; you can redistribute it and/or
+;* modify it under the terms of the GNU Lesser General Public
+;* License as published by the Free Software Foundation; either
+;* version 2.1 of the License, or (at your option) any later version.
+;*
+;* FFmpeg is distributed in the hope that it will be useful,
+;* but WITHOUT ANY WARRANTY; without even the implied warranty of
+;* MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+;* Lesser General Public License for more details.
+;*
+;* You should have received a copy of the GNU Lesser General Public
+;* License along with FFmpeg; if not, write to the Free Software
+;* Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+;******************************************************************************
+
+%include "libavutil/x86/x86util.asm"
+
+SECTION_RODATA
+
+cextern pb_1
+cextern pb_80
+
+SECTION .text
+
+; The encoder knows the whole source row, so unlike in the decoder the left
+; neighbour is never a freshly computed output and both predictors vectorize
+; for any bpp.
+
+;-----------------------------------------------------------------------------
+; void ff_png_sub_avg_prediction_sse2(uint8_t *dst, const uint8_t *src,
+;                                     const uint8_t *top, int w, int bpp)
+; w is a multiple of 16
+;-----------------------------------------------------------------------------
+INIT_XMM sse2
+cglobal png_sub_avg_prediction, 5, 5, 5, dst, src, top, w, bpp
+    movsxdifnidn     wq, wd
+    movsxdifnidn   bppq, bppd
+    add            dstq, wq
+    add            srcq, wq
+    add            topq, wq
+    neg              wq
+    neg            bppq
+    add            bppq, srcq
+    DEFINE_ARGS dst, src, top, w, left
+    mova             m4, [pb_1]
+.loop:
+    movu             m1, [topq+wq]
+    movu             m0, [leftq+wq]
+    movu             m2, [srcq+wq]
+    pxor             m3, m0, m1
+    pavgb            m0, m1
+    pand             m3, m4
+    psubb            m0, m3               ; (left + top) >> 1
+    psubb            m2, m0
+    movu    [dstq+wq], m2
+    add              wq, mmsize
+    jl .loop
+    RET
+
+;-----------------------------------------------------------------------------
+; void ff_png_sub_paeth_prediction_<opt>(uint8_t *dst, const uint8_t *src,
+;                                        const uint8_t *top, int w, int bpp)
+; w is a multiple of 8
+;-----------------------------------------------------------------------------
+%macro SUB_PAETH_PREDICTION 0
+cglobal png_sub_paeth_prediction, 5, 6, 8, dst, src, top, w, bpp, topleft
+    movsxdifnidn     wq, wd
+    movsxdifnidn   bppq, bppd
+    add            dstq, wq
+    add            srcq, wq
+    add            topq, wq
+    neg              wq
+    neg            bppq
+    lea        topleftq, [topq+bppq]
+    add            bppq, srcq
+    DEFINE_ARGS dst, src, top, w, left, topleft
+    pxor             m7, m7
+.loop:
+    movh             m1, [topq+wq]        ; b
+    movh             m0, [leftq+wq]       ; a
+    movh             m2, [topleftq+wq]    ; c
+    punpcklbw        m0, m7
+    punpcklbw        m1, m7
+    punpcklbw        m2, m7
+    psubw            m3, m1, m2           ; p  = b - c
+    psubw            m4, m0, m2           ; pc = a - c
+    paddw            m5, m3, m4
+    ABS1             m3, m6               ; pa
+    ABS1             m4, m6               ; pb
+    ABS1             m5, m6               ; pc
+    pcmpgtw          m6, m3, m4           ; pa > pb
+    pcmpgtw          m3, m5               ; pa > pc
+    por              m3, m6               ; not a
+    pcmpgtw          m4, m5               ; pb > pc
+    pand             m2, m4
+    pandn            m4, m1
+    por              m4, m2               ; pb > pc ? c : b
+    pand             m4, m3
+    pandn            m3, m0
+    por              m3, m4
+    packuswb         m3, m3
+    movh             m0, [srcq+wq]
+    psubb            m0, m3
+    movh    [dstq+wq], m0
+    add              wq, mmsize/2
+    jl .loop
+    RET
+%endmacro
+
+INIT_XMM sse2
+SUB_PAETH_PREDICTION
+INIT_XMM ssse3
+SUB_PAETH_PREDICTION
+
+;-----------------------------------------------------------------------------
+; int ff_png_filter_cost_sse2(const uint8_t *buf, int size)
+; size is a multiple of 16
+;-----------------------------------------------------------------------------
+INIT_XMM sse2
+cglobal png_filter_cost, 2, 2, 4, buf, size
+    movsxdifnidn  sizeq, sized
+    add            bufq, sizeq
+    neg           sizeq
+    mova             m2, [pb_80]
+    pxor             m3, m3
+.loop:
+    ; |(int8_t)x| == |(x ^ 0x80) - 0x80|, which psadbw sums directly
+    movu             m0, [bufq+sizeq]
+    pxor             m0, m2
+    psadbw           m0, m2
+    paddq            m3, m0
+    add           sizeq, mmsize
+    jl .loop
+    movhlps          m0, m3
+    paddq            m3, m0
+    movd            eax, m3
+    RET
@@ -0,0 +1,88 @@
+/*
+ * PNG encoder row filters, x86 versions
+ *
+ * This file is part of FFmpeg.
+ *
+ * FFmpeg is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * FFmpeg is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with FFmpeg; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+
+#include <stdlib.h>
+
+#include "libavutil/attributes.h"
+#include "libavutil/cpu.h"
+#include "libavutil/x86/cpu.h"
+#include "libavcodec/pngencdsp.h"
+
+void ff_png_sub_avg_prediction_sse2(uint8_t *dst, const uint8_t *src,
+                                    const uint8_t *top, int w, int bpp);
+void ff_png_sub_paeth_prediction_sse2(uint8_t *dst, const uint8_t *src,
+                                      const uint8_t *top, int w, int bpp);
+void ff_png_sub_paeth_prediction_ssse3(uint8_t *dst, const uint8_t *src,
+                                       const uint8_t *top, int w, int bpp);
+int ff_png_filter_cost_sse2(const uint8_t *buf, int size);
+
+#if HAVE_YASM
+static void sub_avg_prediction_sse2(uint8_t *dst, const uint8_t *src,
+                                    const uint8_t *top, int w, int bpp)
+{
+    int i, len = w & ~15;
+
+    if (len)
+        ff_png_sub_avg_prediction_sse2(dst, src, top, len, bpp);
+    for (i = len; i < w; i++)
+        dst[i] = src[i] - ((src[i - bpp] + top[i]) >> 1);
+}
+
+#define SUB_PAETH_PREDICTION(opt)                                              \
+static void sub_paeth_prediction_ ## opt(uint8_t *dst, const uint8_t *src,    \
+                                         const uint8_t *top, int w, int bpp)  \
+{                                                                              \
+    int len = w & ~7;                                                          \
+                                                                               \
+    if (len)                                                                   \
+        ff_png_sub_paeth_prediction_ ## opt(dst, src, top, len, bpp);          \
+    ff_png_sub_paeth_prediction_c(dst + len, src + len, top + len,             \
+                                  w - len, bpp);                               \
+}
+
+SUB_PAETH_PREDICTION(sse2)
+SUB_PAETH_PREDICTION(ssse3)
+
+static int filter_cost_sse2(const uint8_t *buf, int size)
+{
+    int i, cost = 0, len = size & ~15;
+
+    if (len)
+        cost = ff_png_filter_cost_sse2(buf, len);
+    for (i = len; i < size; i++)
+        cost += abs((int8_t) buf[i]);
+    return cost;
+}
+#endif /* HAVE_YASM */
+
+av_cold void ff_pngencdsp_init_x86(PNGEncDSPContext *c)
+{
+#if HAVE_YASM
+    int cpu_flags = av_get_cpu_flags();
+
+    if (EXTERNAL_SSE2(cpu_flags)) {
+        c->sub_avg_prediction   = sub_avg_prediction_sse2;
+        c->sub_paeth_prediction = sub_paeth_prediction_sse2;
+        c->filter_cost          = filter_cost_sse2;
+    }
+    if (EXTERNAL_SSSE3(cpu_flags))
+        c->sub_paeth_prediction = sub_paeth_prediction_ssse3;
+#endif /* HAVE_YASM */
+}
@@ -35,6 +35,7 @@
 #include "audio.h"
 #include "avfilter.h"
 #include "formats.h"
+#include "framepool.h"
 #include "internal.h"
 
 #include "libavutil/ffversion.h"
@@ -168,6 +169,7 @@ void avfilter_link_free(AVFilterLink **link)
         return;
 
     av_frame_free(&(*link)->partial_buf);
+    ff_video_frame_pool_uninit((FFVideoFramePool**)&(*link)->video_frame_pool);
 
     av_freep(link);
 }
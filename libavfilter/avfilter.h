@@ -864,6 +864,12 @@ struct AVFilterLink {
      * Number of past frames sent through the link.
      */
     int64_t frame_count;
+
+    /**
+     * A pointer to a FFVideoFramePool struct, used by the default
+     * get_video_buffer() of the link. Not part of the public API.
+     */
+    void *video_frame_pool;
 };
 
 /**
@@ -37,4 +37,9 @@ typedef struct RemoveGrainContext {
     void (*fl[4])(uint8_t *dst, uint8_t *src, ptrdiff_t stride, int pixels);
 } RemoveGrainContext;
 
+/**
+ * Set the pixel and line filter functions for the modes in rg->mode,
+ * for the first rg->nb_planes planes.
+ */
+void ff_removegrain_init(RemoveGrainContext *rg);
 void ff_removegrain_init_x86(RemoveGrainContext *rg);
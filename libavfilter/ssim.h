@@ -31,6 +31,7 @@ typedef struct SSIMDSPContext {
     float (*ssim_end_line)(const int (*sum0)[4], const int (*sum1)[4], int w);
 } SSIMDSPContext;
 
+void ff_ssim_init(SSIMDSPContext *dsp);
 void ff_ssim_init_x86(SSIMDSPContext *dsp);
 
 #endif /* LIBAVFILTER_SSIM_H */
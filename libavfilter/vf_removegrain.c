@@ -463,19 +463,10 @@ static int mode24(int c, int a1, int a2, int a3, int a4, int a5, int a6, int a7,
     return c - u + d;  // This probably will never overflow.
 }
 
-static int config_input(AVFilterLink *inlink)
+av_cold void ff_removegrain_init(RemoveGrainContext *s)
 {
-    RemoveGrainContext *s = inlink->dst->priv;
-    const AVPixFmtDescriptor *desc = av_pix_fmt_desc_get(inlink->format);
     int i;
 
-    s->nb_planes = av_pix_fmt_count_planes(inlink->format);
-
-    s->planeheight[1] = s->planeheight[2] = FF_CEIL_RSHIFT(inlink->h, desc->log2_chroma_h);
-    s->planeheight[0] = s->planeheight[3] = inlink->h;
-    s->planewidth[1]  = s->planewidth[2]  = FF_CEIL_RSHIFT(inlink->w, desc->log2_chroma_w);
-    s->planewidth[0]  = s->planewidth[3]  = inlink->w;
-
     for (i = 0; i < s->nb_planes; i++) {
         switch (s->mode[i]) {
         case 1:  s->rg[i] = mode01;   break;
@@ -511,6 +502,21 @@ static int config_input(AVFilterLink *inlink)
 
     if (ARCH_X86)
         ff_removegrain_init_x86(s);
+}
+
+static int config_input(AVFilterLink *inlink)
+{
+    RemoveGrainContext *s = inlink->dst->priv;
+    const AVPixFmtDescriptor *desc = av_pix_fmt_desc_get(inlink->format);
+
+    s->nb_planes = av_pix_fmt_count_planes(inlink->format);
+
+    s->planeheight[1] = s->planeheight[2] = FF_CEIL_RSHIFT(inlink->h, desc->log2_chroma_h);
+    s->planeheight[0] = s->planeheight[3] = inlink->h;
+    s->planewidth[1]  = s->planewidth[2]  = FF_CEIL_RSHIFT(inlink->w, desc->log2_chroma_w);
+    s->planewidth[0]  = s->planewidth[3]  = inlink->w;
+
+    ff_removegrain_init(s);
 
     return 0;
 }
@@ -147,6 +147,14 @@ static float ssim_endn(const int (*sum0)[4], const int (*sum1)[4], int width)
     return ssim;
 }
 
+av_cold void ff_ssim_init(SSIMDSPContext *dsp)
+{
+    dsp->ssim_4x4_line = ssim_4x4xn;
+    dsp->ssim_end_line = ssim_endn;
+    if (ARCH_X86)
+        ff_ssim_init_x86(dsp);
+}
+
 static float ssim_plane(SSIMDSPContext *dsp,
                         uint8_t *main, int main_stride,
                         uint8_t *ref, int ref_stride,
@@ -297,10 +305,7 @@ static int config_input_ref(AVFilterLink *inlink)
     if (!s->temp)
         return AVERROR(ENOMEM);
 
-    s->dsp.ssim_4x4_line = ssim_4x4xn;
-    s->dsp.ssim_end_line = ssim_endn;
-    if (ARCH_X86)
-        ff_ssim_init_x86(&s->dsp);
+    ff_ssim_init(&s->dsp);
 
     return 0;
 }
@@ -467,6 +467,20 @@ static int query_formats(AVFilterContext *ctx)
     return ff_set_common_formats(ctx, fmts_list);
 }
 
+av_cold void ff_yadif_init(YADIFContext *s)
+{
+    if (s->csp->comp[0].depth_minus1 / 8 == 1) {
+        s->filter_line  = filter_line_c_16bit;
+        s->filter_edges = filter_edges_16bit;
+    } else {
+        s->filter_line  = filter_line_c;
+        s->filter_edges = filter_edges;
+    }
+
+    if (ARCH_X86)
+        ff_yadif_init_x86(s);
+}
+
 static int config_props(AVFilterLink *link)
 {
     AVFilterContext *ctx = link->src;
@@ -486,16 +500,7 @@ static int config_props(AVFilterLink *link)
     }
 
     s->csp = av_pix_fmt_desc_get(link->format);
-    if (s->csp->comp[0].depth_minus1 / 8 == 1) {
-        s->filter_line  = filter_line_c_16bit;
-        s->filter_edges = filter_edges_16bit;
-    } else {
-        s->filter_line  = filter_line_c;
-        s->filter_edges = filter_edges;
-    }
-
-    if (ARCH_X86)
-        ff_yadif_init_x86(s);
+    ff_yadif_init(s);
 
     return 0;
 }
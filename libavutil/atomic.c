@@ -70,6 +70,47 @@ void *avpriv_atomic_ptr_cas(void * volatile *ptr, void *oldval, void *newval)
     return ret;
 }
 
+int64_t avpriv_atomic_int64_get(volatile int64_t *ptr)
+{
+    int64_t res;
+
+    pthread_mutex_lock(&atomic_lock);
+    res = *ptr;
+    pthread_mutex_unlock(&atomic_lock);
+
+    return res;
+}
+
+void avpriv_atomic_int64_set(volatile int64_t *ptr, int64_t val)
+{
+    pthread_mutex_lock(&atomic_lock);
+    *ptr = val;
+    pthread_mutex_unlock(&atomic_lock);
+}
+
+int64_t avpriv_atomic_int64_add_and_fetch(volatile int64_t *ptr, int64_t inc)
+{
+    int64_t res;
+
+    pthread_mutex_lock(&atomic_lock);
+    *ptr += inc;
+    res = *ptr;
+    pthread_mutex_unlock(&atomic_lock);
+
+    return res;
+}
+
+int64_t avpriv_atomic_int64_cas(volatile int64_t *ptr, int64_t oldval, int64_t newval)
+{
+    int64_t ret;
+    pthread_mutex_lock(&atomic_lock);
+    ret = *ptr;
+    if (ret == oldval)
+        *ptr = newval;
+    pthread_mutex_unlock(&atomic_lock);
+    return ret;
+}
+
 #elif !HAVE_THREADS
 
 int avpriv_atomic_int_get(volatile int *ptr)
@@ -97,6 +138,31 @@ void *avpriv_atomic_ptr_cas(void * volatile *ptr, void *oldval, void *newval)
     return *ptr;
 }
 
+int64_t avpriv_atomic_int64_get(volatile int64_t *ptr)
+{
+    return *ptr;
+}
+
+void avpriv_atomic_int64_set(volatile int64_t *ptr, int64_t val)
+{
+    *ptr = val;
+}
+
+int64_t avpriv_atomic_int64_add_and_fetch(volatile int64_t *ptr, int64_t inc)
+{
+    *ptr += inc;
+    return *ptr;
+}
+
+int64_t avpriv_atomic_int64_cas(volatile int64_t *ptr, int64_t oldval, int64_t newval)
+{
+    if (*ptr == oldval) {
+        *ptr = newval;
+        return oldval;
+    }
+    return *ptr;
+}
+
 #else /* HAVE_THREADS */
 
 /* This should never trigger, unless a new threading implementation
@@ -114,7 +180,9 @@ void *avpriv_atomic_ptr_cas(void * volatile *ptr, void *oldval, void *newval)
 int main(void)
 {
     volatile int val = 1;
+    volatile int64_t val64 = 1;
     int res;
+    int64_t res64;
 
     res = avpriv_atomic_int_add_and_fetch(&val, 1);
     av_assert0(res == 2);
@@ -122,6 +190,14 @@ int main(void)
     res = avpriv_atomic_int_get(&val);
     av_assert0(res == 3);
 
+    res64 = avpriv_atomic_int64_add_and_fetch(&val64, INT64_C(1) << 32);
+    av_assert0(res64 == (INT64_C(1) << 32) + 1);
+    res64 = avpriv_atomic_int64_cas(&val64, 1, 5);
+    av_assert0(res64 == (INT64_C(1) << 32) + 1);
+    res64 = avpriv_atomic_int64_cas(&val64, res64, 5);
+    avpriv_atomic_int64_set(&val64, avpriv_atomic_int64_get(&val64) + 1);
+    av_assert0(avpriv_atomic_int64_get(&val64) == 6);
+
     return 0;
 }
 #endif
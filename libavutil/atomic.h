@@ -21,6 +21,8 @@
 #ifndef AVUTIL_ATOMIC_H
 #define AVUTIL_ATOMIC_H
 
+#include <stdint.h>
+
 #include "config.h"
 
 #if HAVE_ATOMICS_NATIVE
@@ -74,6 +76,35 @@ int avpriv_atomic_int_add_and_fetch(volatile int *ptr, int inc);
  */
 void *avpriv_atomic_ptr_cas(void * volatile *ptr, void *oldval, void *newval);
 
+/**
+ * Load the current value stored in an atomic 64-bit integer.
+ *
+ * @note This acts as a memory barrier.
+ */
+int64_t avpriv_atomic_int64_get(volatile int64_t *ptr);
+
+/**
+ * Store a new value in an atomic 64-bit integer.
+ *
+ * @note This acts as a memory barrier.
+ */
+void avpriv_atomic_int64_set(volatile int64_t *ptr, int64_t val);
+
+/**
+ * Add a value to an atomic 64-bit integer.
+ *
+ * @return the new value of the atomic integer.
+ * @note This does NOT act as a memory barrier.
+ */
+int64_t avpriv_atomic_int64_add_and_fetch(volatile int64_t *ptr, int64_t inc);
+
+/**
+ * Atomic 64-bit integer compare and swap.
+ *
+ * @return the value of *ptr before comparison
+ */
+int64_t avpriv_atomic_int64_cas(volatile int64_t *ptr, int64_t oldval, int64_t newval);
+
 #endif /* HAVE_ATOMICS_NATIVE */
 
 #endif /* AVUTIL_ATOMIC_H */
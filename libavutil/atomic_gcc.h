@@ -75,4 +75,49 @@ static inline void *atomic_ptr_cas_gcc(void * volatile *ptr,
 #endif
 }
 
+#define avpriv_atomic_int64_get atomic_int64_get_gcc
+static inline int64_t atomic_int64_get_gcc(volatile int64_t *ptr)
+{
+#if HAVE_ATOMIC_COMPARE_EXCHANGE
+    return __atomic_load_n(ptr, __ATOMIC_SEQ_CST);
+#else
+    return __sync_val_compare_and_swap(ptr, 0, 0);
+#endif
+}
+
+#define avpriv_atomic_int64_cas atomic_int64_cas_gcc
+static inline int64_t atomic_int64_cas_gcc(volatile int64_t *ptr,
+                                           int64_t oldval, int64_t newval)
+{
+#if HAVE_SYNC_VAL_COMPARE_AND_SWAP
+    return __sync_val_compare_and_swap(ptr, oldval, newval);
+#else
+    __atomic_compare_exchange_n(ptr, &oldval, newval, 0, __ATOMIC_SEQ_CST, __ATOMIC_SEQ_CST);
+    return oldval;
+#endif
+}
+
+#define avpriv_atomic_int64_set atomic_int64_set_gcc
+static inline void atomic_int64_set_gcc(volatile int64_t *ptr, int64_t val)
+{
+#if HAVE_ATOMIC_COMPARE_EXCHANGE
+    __atomic_store_n(ptr, val, __ATOMIC_SEQ_CST);
+#else
+    int64_t old = *ptr, cur;
+    while ((cur = __sync_val_compare_and_swap(ptr, old, val)) != old)
+        old = cur;
+#endif
+}
+
+#define avpriv_atomic_int64_add_and_fetch atomic_int64_add_and_fetch_gcc
+static inline int64_t atomic_int64_add_and_fetch_gcc(volatile int64_t *ptr,
+                                                     int64_t inc)
+{
+#if HAVE_ATOMIC_COMPARE_EXCHANGE
+    return __atomic_add_fetch(ptr, inc, __ATOMIC_SEQ_CST);
+#else
+    return __sync_add_and_fetch(ptr, inc);
+#endif
+}
+
 #endif /* AVUTIL_ATOMIC_GCC_H */
@@ -52,4 +52,30 @@ static inline void *atomic_ptr_cas_suncc(void * volatile *ptr,
     return atomic_cas_ptr(ptr, oldval, newval);
 }
 
+#define avpriv_atomic_int64_get atomic_int64_get_suncc
+static inline int64_t atomic_int64_get_suncc(volatile int64_t *ptr)
+{
+    return atomic_or_64_nv((volatile uint64_t *)ptr, 0);
+}
+
+#define avpriv_atomic_int64_set atomic_int64_set_suncc
+static inline void atomic_int64_set_suncc(volatile int64_t *ptr, int64_t val)
+{
+    atomic_swap_64((volatile uint64_t *)ptr, val);
+}
+
+#define avpriv_atomic_int64_add_and_fetch atomic_int64_add_and_fetch_suncc
+static inline int64_t atomic_int64_add_and_fetch_suncc(volatile int64_t *ptr,
+                                                       int64_t inc)
+{
+    return atomic_add_64_nv((volatile uint64_t *)ptr, inc);
+}
+
+#define avpriv_atomic_int64_cas atomic_int64_cas_suncc
+static inline int64_t atomic_int64_cas_suncc(volatile int64_t *ptr,
+                                             int64_t oldval, int64_t newval)
+{
+    return atomic_cas_64((volatile uint64_t *)ptr, oldval, newval);
+}
+
 #endif /* AVUTIL_ATOMIC_SUNCC_H */
@@ -51,4 +51,31 @@ static inline void *atomic_ptr_cas_win32(void * volatile *ptr,
     return InterlockedCompareExchangePointer(ptr, newval, oldval);
 }
 
+#define avpriv_atomic_int64_get atomic_int64_get_win32
+static inline int64_t atomic_int64_get_win32(volatile int64_t *ptr)
+{
+    /* plain 64-bit loads are not atomic on 32-bit targets */
+    return InterlockedCompareExchange64(ptr, 0, 0);
+}
+
+#define avpriv_atomic_int64_set atomic_int64_set_win32
+static inline void atomic_int64_set_win32(volatile int64_t *ptr, int64_t val)
+{
+    InterlockedExchange64(ptr, val);
+}
+
+#define avpriv_atomic_int64_add_and_fetch atomic_int64_add_and_fetch_win32
+static inline int64_t atomic_int64_add_and_fetch_win32(volatile int64_t *ptr,
+                                                       int64_t inc)
+{
+    return inc + InterlockedExchangeAdd64(ptr, inc);
+}
+
+#define avpriv_atomic_int64_cas atomic_int64_cas_win32
+static inline int64_t atomic_int64_cas_win32(volatile int64_t *ptr,
+                                             int64_t oldval, int64_t newval)
+{
+    return InterlockedCompareExchange64(ptr, newval, oldval);
+}
+
 #endif /* AVUTIL_ATOMIC_WIN32_H */
@@ -16,15 +16,34 @@
  * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
  */
 
+#define _DEFAULT_SOURCE  // needed for MAP_ANONYMOUS and MADV_HUGEPAGE
+#define _DARWIN_C_SOURCE // needed for MAP_ANON
+
 #include <stdint.h>
 #include <string.h>
 
+#include "config.h"
+#if HAVE_MMAP
+#include <sys/mman.h>
+#if defined(MAP_ANON) && !defined(MAP_ANONYMOUS)
+#define MAP_ANONYMOUS MAP_ANON
+#endif
+#endif
+
 #include "atomic.h"
 #include "buffer_internal.h"
 #include "common.h"
+#include "cpu.h"
 #include "mem.h"
+#include "mem_internal.h"
 #include "thread.h"
 
+#define MAX_POOL_CACHES 64
+
+#define HUGEPAGE_SIZE (2 << 20)
+
+static AVBufferRef *(*frame_allocator)(int size);
+
 AVBufferRef *av_buffer_create(uint8_t *data, int size,
                               void (*free)(void *opaque, uint8_t *data),
                               void *opaque, int flags)
@@ -89,6 +108,82 @@ AVBufferRef *av_buffer_allocz(int size)
     return ret;
 }
 
+#if HAVE_MMAP && defined(MAP_ANONYMOUS)
+/* opaque is the length of the mapping, its low bit is set if it was counted */
+static void hugepages_free(void *opaque, uint8_t *data)
+{
+    size_t len = (uintptr_t)opaque & ~(uintptr_t)1;
+
+    munmap(data, len);
+    if ((uintptr_t)opaque & 1)
+        ff_mem_unaccount(AV_CLASS_CATEGORY_NA, len);
+}
+
+static uint8_t *map_hugepages(size_t len)
+{
+    uint8_t *data;
+    size_t head;
+
+#ifdef MAP_HUGETLB
+    /* only succeeds if huge pages were reserved, e.g. in /proc/sys/vm/nr_hugepages */
+    data = mmap(NULL, len, PROT_READ | PROT_WRITE,
+                MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+    if (data != MAP_FAILED)
+        return data;
+#endif
+
+    /* transparent huge pages need an aligned mapping, so map one more page
+     * and trim the unaligned head and the tail */
+    data = mmap(NULL, len + HUGEPAGE_SIZE, PROT_READ | PROT_WRITE,
+                MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (data == MAP_FAILED)
+        return NULL;
+
+    head = FFALIGN((uintptr_t)data, HUGEPAGE_SIZE) - (uintptr_t)data;
+    if (head)
+        munmap(data, head);
+    munmap(data + head + len, HUGEPAGE_SIZE - head);
+    data += head;
+
+#ifdef MADV_HUGEPAGE
+    madvise(data, len, MADV_HUGEPAGE);
+#endif
+    return data;
+}
+#endif
+
+AVBufferRef *av_buffer_alloc_hugepages(int size)
+{
+#if HAVE_MMAP && defined(MAP_ANONYMOUS)
+    if (size >= HUGEPAGE_SIZE) {
+        size_t len = FFALIGN((size_t)size, HUGEPAGE_SIZE);
+        uint8_t *data = map_hugepages(len);
+        AVBufferRef *ret;
+
+        if (data) {
+            void *opaque = (void *)(uintptr_t)(len | ff_mem_account(AV_CLASS_CATEGORY_NA, len));
+
+            ret = av_buffer_create(data, size, hugepages_free, opaque, 0);
+            if (!ret)
+                hugepages_free(opaque, data);
+            return ret;
+        }
+    }
+#endif
+
+    return av_buffer_alloc(size);
+}
+
+void av_buffer_set_frame_allocator(AVBufferRef *(*alloc)(int size))
+{
+    frame_allocator = alloc;
+}
+
+AVBufferRef *(*av_buffer_get_frame_allocator(void))(int size)
+{
+    return frame_allocator;
+}
+
 AVBufferRef *av_buffer_ref(AVBufferRef *buf)
 {
     AVBufferRef *ret = av_mallocz(sizeof(*ret));
@@ -214,7 +309,8 @@ int av_buffer_realloc(AVBufferRef **pbuf, int size)
     return 0;
 }
 
-AVBufferPool *av_buffer_pool_init(int size, AVBufferRef* (*alloc)(int size))
+AVBufferPool *av_buffer_pool_init_flags(int size, AVBufferRef* (*alloc)(int size),
+                                        int flags)
 {
     AVBufferPool *pool = av_mallocz(sizeof(*pool));
     if (!pool)
@@ -224,25 +320,79 @@ AVBufferPool *av_buffer_pool_init(int size, AVBufferRef* (*alloc)(int size))
 
     pool->size     = size;
     pool->alloc    = alloc ? alloc : av_buffer_alloc;
+    pool->flags    = flags;
+
+#if !USE_ATOMICS
+    if (flags & AV_BUFFER_POOL_FLAG_THREAD_CACHE) {
+        int nb_caches = 1;
+
+        while (nb_caches < 2 * av_cpu_count() && nb_caches < MAX_POOL_CACHES)
+            nb_caches <<= 1;
+
+        pool->caches = av_mallocz_array(nb_caches, sizeof(*pool->caches));
+        if (!pool->caches) {
+            ff_mutex_destroy(&pool->mutex);
+            av_freep(&pool);
+            return NULL;
+        }
+        pool->nb_caches = nb_caches;
+    }
+#endif
 
     avpriv_atomic_int_set(&pool->refcount, 1);
 
     return pool;
 }
 
+AVBufferPool *av_buffer_pool_init(int size, AVBufferRef* (*alloc)(int size))
+{
+    return av_buffer_pool_init_flags(size, alloc, 0);
+}
+
+void av_buffer_pool_set_category(AVBufferPool *pool, int category)
+{
+    pool->category = category;
+}
+
+/* the total is already accounted by av_malloc() */
+static void pool_account(BufferPoolEntry *buf)
+{
+    AVBufferPool *pool = buf->pool;
+
+    if (pool->category != AV_CLASS_CATEGORY_NA)
+        buf->accounted = ff_mem_account(pool->category, pool->size);
+}
+
+static void free_pool_entry(BufferPoolEntry *buf)
+{
+    if (buf->accounted)
+        ff_mem_unaccount(buf->pool->category, buf->pool->size);
+    buf->free(buf->opaque, buf->data);
+    av_free(buf);
+}
+
+static void free_pool_entries(BufferPoolEntry *buf)
+{
+    while (buf) {
+        BufferPoolEntry *next = buf->next;
+
+        free_pool_entry(buf);
+        buf = next;
+    }
+}
+
 /*
  * This function gets called when the pool has been uninited and
  * all the buffers returned to it.
  */
 static void buffer_pool_free(AVBufferPool *pool)
 {
-    while (pool->pool) {
-        BufferPoolEntry *buf = pool->pool;
-        pool->pool = buf->next;
+    int i;
 
-        buf->free(buf->opaque, buf->data);
-        av_freep(&buf);
-    }
+    free_pool_entries(pool->pool);
+    for (i = 0; i < pool->nb_caches; i++)
+        free_pool_entries(pool->caches[i].pool);
+    av_freep(&pool->caches);
     ff_mutex_destroy(&pool->mutex);
     av_freep(&pool);
 }
@@ -298,22 +448,111 @@ static void add_to_pool(BufferPoolEntry *buf)
 }
 #endif
 
+#if !USE_ATOMICS
+/* map the calling thread to one of the caches of the pool */
+static BufferPoolCache *get_thread_cache(AVBufferPool *pool)
+{
+    unsigned hash = 0;
+#if HAVE_PTHREADS
+    pthread_t self = pthread_self();
+    const uint8_t *p = (const uint8_t *)&self;
+    int i;
+
+    for (i = 0; i < sizeof(self); i++)
+        hash = hash * 31 + p[i];
+    hash ^= hash >> 16;
+    hash *= 0x45d9f3b;
+    hash ^= hash >> 16;
+#elif HAVE_W32THREADS
+    hash = GetCurrentThreadId();
+#endif
+
+    return &pool->caches[hash & (pool->nb_caches - 1)];
+}
+
+/* remove the whole buffer list from the cache and return it */
+static BufferPoolEntry *cache_take(BufferPoolCache *cache)
+{
+    BufferPoolEntry *cur = *(void * volatile *)&cache->pool, *last = NULL;
+
+    while (cur != last) {
+        last = cur;
+        cur = avpriv_atomic_ptr_cas((void * volatile *)&cache->pool, last, NULL);
+        if (!cur)
+            return NULL;
+    }
+
+    return cur;
+}
+
+/* push the list first..last to the front of the cache */
+static void cache_add(BufferPoolCache *cache, BufferPoolEntry *first,
+                      BufferPoolEntry *last)
+{
+    BufferPoolEntry *cur = *(void * volatile *)&cache->pool, *prev;
+
+    do {
+        prev       = cur;
+        last->next = prev;
+        cur = avpriv_atomic_ptr_cas((void * volatile *)&cache->pool, prev, first);
+    } while (cur != prev);
+}
+
+/*
+ * Take all the buffers of our cache, or if it is empty of the first non-empty
+ * cache of another thread. Keep one of them and move the rest to our cache.
+ */
+static BufferPoolEntry *cache_get(AVBufferPool *pool, BufferPoolCache *cache)
+{
+    int idx = cache - pool->caches;
+    BufferPoolEntry *buf = cache_take(cache), *last;
+    int i;
+
+    for (i = 1; !buf && i < pool->nb_caches; i++)
+        buf = cache_take(&pool->caches[(idx + i) & (pool->nb_caches - 1)]);
+    if (!buf)
+        return NULL;
+
+    if (buf->next) {
+        for (last = buf->next; last->next; last = last->next)
+            ;
+        cache_add(cache, buf->next, last);
+    }
+    buf->next = NULL;
+
+    return buf;
+}
+#endif
+
 static void pool_release_buffer(void *opaque, uint8_t *data)
 {
     BufferPoolEntry *buf = opaque;
     AVBufferPool *pool = buf->pool;
 
-    if(CONFIG_MEMORY_POISONING)
-        memset(buf->data, FF_MEMORY_POISON, pool->size);
+    if (ff_mem_over_soft_limit()) {
+        /* shrink the pool instead of keeping the buffer around */
+        free_pool_entry(buf);
+        avpriv_atomic_int_add_and_fetch(&pool->nb_allocated, -1);
+#if USE_ATOMICS
+        avpriv_atomic_int_add_and_fetch(&pool->refcount, -1);
+#endif
+    } else {
+        if(CONFIG_MEMORY_POISONING)
+            memset(buf->data, FF_MEMORY_POISON, pool->size);
 
 #if USE_ATOMICS
-    add_to_pool(buf);
+        add_to_pool(buf);
 #else
-    ff_mutex_lock(&pool->mutex);
-    buf->next = pool->pool;
-    pool->pool = buf;
-    ff_mutex_unlock(&pool->mutex);
+        if (pool->caches) {
+            cache_add(get_thread_cache(pool), buf, buf);
+        } else {
+            ff_mutex_lock(&pool->mutex);
+            buf->next = pool->pool;
+            pool->pool = buf;
+            ff_mutex_unlock(&pool->mutex);
+        }
 #endif
+    }
 
     if (!avpriv_atomic_int_add_and_fetch(&pool->refcount, -1))
         buffer_pool_free(pool);
@@ -346,11 +585,50 @@ static AVBufferRef *pool_alloc_buffer(AVBufferPool *pool)
 
 #if USE_ATOMICS
     avpriv_atomic_int_add_and_fetch(&pool->refcount, 1);
-    avpriv_atomic_int_add_and_fetch(&pool->nb_allocated, 1);
 #endif
+    avpriv_atomic_int_add_and_fetch(&pool->nb_allocated, 1);
+    pool_account(buf);
+
+    return ret;
+}
+
+static void pool_count_miss(AVBufferPool *pool)
+{
+    int64_t allocated = avpriv_atomic_int_get(&pool->nb_allocated);
+    int64_t mark      = avpriv_atomic_int64_get(&pool->high_water_mark);
+    int64_t prev;
+
+    avpriv_atomic_int64_add_and_fetch(&pool->misses, 1);
+    while (mark < allocated &&
+           (prev = avpriv_atomic_int64_cas(&pool->high_water_mark, mark, allocated)) != mark)
+        mark = prev;
+}
+
+#if !USE_ATOMICS
+static AVBufferRef *pool_get_cached(AVBufferPool *pool)
+{
+    BufferPoolCache *cache = get_thread_cache(pool);
+    BufferPoolEntry *buf   = cache_get(pool, cache);
+    AVBufferRef *ret;
+
+    if (!buf) {
+        ret = pool_alloc_buffer(pool);
+        if (ret)
+            pool_count_miss(pool);
+        return ret;
+    }
+
+    ret = av_buffer_create(buf->data, pool->size, pool_release_buffer,
+                           buf, 0);
+    if (!ret) {
+        cache_add(cache, buf, buf);
+        return NULL;
+    }
+    avpriv_atomic_int64_add_and_fetch(&cache->hits, 1);
 
     return ret;
 }
+#endif
 
 AVBufferRef *av_buffer_pool_get(AVBufferPool *pool)
 {
@@ -366,8 +644,13 @@ AVBufferRef *av_buffer_pool_get(AVBufferPool *pool)
             buf = get_pool(pool);
     }
 
-    if (!buf)
-        return pool_alloc_buffer(pool);
+    if (!buf) {
+        ret = pool_alloc_buffer(pool);
+        if (ret)
+            pool_count_miss(pool);
+        return ret;
+    }
+    avpriv_atomic_int64_add_and_fetch(&pool->hits, 1);
 
     /* keep the first entry, return the rest of the list to the pool */
     add_to_pool(buf->next);
@@ -380,19 +663,26 @@ AVBufferRef *av_buffer_pool_get(AVBufferPool *pool)
         return NULL;
     }
 #else
-    ff_mutex_lock(&pool->mutex);
-    buf = pool->pool;
-    if (buf) {
-        ret = av_buffer_create(buf->data, pool->size, pool_release_buffer,
-                               buf, 0);
-        if (ret) {
-            pool->pool = buf->next;
-            buf->next = NULL;
-        }
+    if (pool->caches) {
+        ret = pool_get_cached(pool);
     } else {
-        ret = pool_alloc_buffer(pool);
+        ff_mutex_lock(&pool->mutex);
+        buf = pool->pool;
+        if (buf) {
+            ret = av_buffer_create(buf->data, pool->size, pool_release_buffer,
+                                   buf, 0);
+            if (ret) {
+                pool->pool = buf->next;
+                buf->next = NULL;
+                avpriv_atomic_int64_add_and_fetch(&pool->hits, 1);
+            }
+        } else {
+            ret = pool_alloc_buffer(pool);
+            if (ret)
+                pool_count_miss(pool);
+        }
+        ff_mutex_unlock(&pool->mutex);
     }
-    ff_mutex_unlock(&pool->mutex);
 #endif
 
     if (ret)
@@ -400,3 +690,192 @@ AVBufferRef *av_buffer_pool_get(AVBufferPool *pool)
 
     return ret;
 }
+
+void av_buffer_pool_get_stats(AVBufferPool *pool, AVBufferPoolStats *stats)
+{
+    int i;
+
+    stats->hits            = avpriv_atomic_int64_get(&pool->hits);
+    stats->misses          = avpriv_atomic_int64_get(&pool->misses);
+    stats->high_water_mark = avpriv_atomic_int64_get(&pool->high_water_mark);
+
+    for (i = 0; i < pool->nb_caches; i++)
+        stats->hits += avpriv_atomic_int64_get(&pool->caches[i].hits);
+
+    /* the pool holds one reference itself, with atomics every allocated
+     * buffer holds another one */
+    stats->nb_in_use    = avpriv_atomic_int_get(&pool->refcount) - 1;
+    stats->nb_allocated = avpriv_atomic_int_get(&pool->nb_allocated);
+    if (USE_ATOMICS)
+        stats->nb_in_use -= stats->nb_allocated;
+}
+
+#ifdef TEST
+#include <stdio.h>
+
+#include "avassert.h"
+
+#define NB_BUFFERS 8
+#define NB_THREADS 4
+
+static void print_stats(const char *name, AVBufferPool *pool)
+{
+    AVBufferPoolStats stats;
+
+    av_buffer_pool_get_stats(pool, &stats);
+    printf("%s: hits %"PRId64" misses %"PRId64" in use %d allocated %d high water mark %"PRId64"\n",
+           name, stats.hits, stats.misses, stats.nb_in_use, stats.nb_allocated,
+           stats.high_water_mark);
+}
+
+static void test_pool(int flags)
+{
+    AVBufferPool *pool = av_buffer_pool_init_flags(1024, NULL, flags);
+    AVBufferRef *bufs[NB_BUFFERS];
+    AVBufferPoolStats stats;
+    int i;
+
+    av_assert0(pool);
+    for (i = 0; i < NB_BUFFERS; i++) {
+        bufs[i] = av_buffer_pool_get(pool);
+        av_assert0(bufs[i]);
+    }
+    av_buffer_pool_get_stats(pool, &stats);
+    av_assert0(stats.hits == 0 && stats.misses == NB_BUFFERS);
+    av_assert0(stats.nb_in_use == NB_BUFFERS);
+    av_assert0(stats.high_water_mark == NB_BUFFERS);
+    print_stats("get", pool);
+
+    for (i = 0; i < NB_BUFFERS; i++)
+        av_buffer_unref(&bufs[i]);
+    print_stats("release", pool);
+    for (i = 0; i < NB_BUFFERS / 2; i++) {
+        bufs[i] = av_buffer_pool_get(pool);
+        av_assert0(bufs[i]);
+    }
+    av_buffer_pool_get_stats(pool, &stats);
+    av_assert0(stats.hits == NB_BUFFERS / 2 && stats.misses == NB_BUFFERS);
+    av_assert0(stats.nb_in_use == NB_BUFFERS / 2);
+    av_assert0(stats.high_water_mark == NB_BUFFERS);
+    print_stats("reuse", pool);
+
+    /* the pool must only be freed once the last buffer is released */
+    av_buffer_pool_uninit(&pool);
+    for (i = 0; i < NB_BUFFERS / 2; i++)
+        av_buffer_unref(&bufs[i]);
+}
+
+static void test_hugepages(void)
+{
+    static const int sizes[] = { 1024, HUGEPAGE_SIZE, 3 * HUGEPAGE_SIZE + 1 };
+    int i;
+
+    for (i = 0; i < FF_ARRAY_ELEMS(sizes); i++) {
+        AVBufferRef *buf = av_buffer_alloc_hugepages(sizes[i]);
+
+        av_assert0(buf && buf->size == sizes[i]);
+        memset(buf->data, i, buf->size);
+        av_buffer_unref(&buf);
+    }
+}
+
+static void test_pool_soft_limit(void)
+{
+    AVBufferPool *pool = av_buffer_pool_init(1024, NULL);
+    AVBufferRef *bufs[NB_BUFFERS];
+    AVBufferPoolStats stats;
+    AVMemUsage usage;
+    int i;
+
+    av_assert0(pool);
+    av_buffer_pool_set_category(pool, AV_CLASS_CATEGORY_DECODER);
+    for (i = 0; i < NB_BUFFERS; i++) {
+        bufs[i] = av_buffer_pool_get(pool);
+        av_assert0(bufs[i]);
+    }
+    av_mem_get_usage(AV_CLASS_CATEGORY_DECODER, &usage);
+    av_assert0(usage.current == NB_BUFFERS * 1024);
+
+    /* released buffers are freed while over the limit */
+    av_mem_set_soft_limit(1);
+    for (i = 0; i < NB_BUFFERS / 2; i++)
+        av_buffer_unref(&bufs[i]);
+    av_mem_set_soft_limit(0);
+    for (; i < NB_BUFFERS; i++)
+        av_buffer_unref(&bufs[i]);
+
+    av_buffer_pool_get_stats(pool, &stats);
+    av_assert0(stats.nb_allocated == NB_BUFFERS / 2);
+    av_assert0(stats.high_water_mark == NB_BUFFERS);
+    av_mem_get_usage(AV_CLASS_CATEGORY_DECODER, &usage);
+    av_assert0(usage.current == NB_BUFFERS / 2 * 1024);
+    av_assert0(usage.peak    == NB_BUFFERS * 1024);
+
+    av_buffer_pool_uninit(&pool);
+    av_mem_get_usage(AV_CLASS_CATEGORY_DECODER, &usage);
+    av_assert0(usage.current == 0);
+}
+
+#if HAVE_PTHREADS
+static void *test_thread(void *arg)
+{
+    AVBufferPool *pool = arg;
+    AVBufferRef *bufs[NB_BUFFERS];
+    int i, j;
+
+    for (i = 0; i < 1000; i++) {
+        for (j = 0; j < NB_BUFFERS; j++) {
+            bufs[j] = av_buffer_pool_get(pool);
+            av_assert0(bufs[j]);
+            memset(bufs[j]->data, j, bufs[j]->size);
+        }
+        for (j = 0; j < NB_BUFFERS; j++)
+            av_buffer_unref(&bufs[j]);
+    }
+    return NULL;
+}
+
+static void test_pool_threads(int flags)
+{
+    AVBufferPool *pool = av_buffer_pool_init_flags(1024, NULL, flags);
+    AVBufferPoolStats stats;
+    pthread_t threads[NB_THREADS];
+    int i;
+
+    av_assert0(pool);
+    for (i = 0; i < NB_THREADS; i++)
+        av_assert0(!pthread_create(&threads[i], NULL, test_thread, pool));
+    for (i = 0; i < NB_THREADS; i++)
+        pthread_join(threads[i], NULL);
+
+    av_buffer_pool_get_stats(pool, &stats);
+    av_assert0(stats.hits + stats.misses == NB_THREADS * 1000 * NB_BUFFERS);
+    av_assert0(stats.misses == stats.high_water_mark);
+    av_assert0(stats.nb_in_use == 0);
+    printf("threads: gets %"PRId64" in use %d\n",
+           stats.hits + stats.misses, stats.nb_in_use);
+    av_buffer_pool_uninit(&pool);
+}
+#endif
+
+int main(void)
+{
+    int accounting = av_mem_set_accounting(1) >= 0;
+
+    printf("Testing the shared list\n");
+    test_pool(0);
+    printf("Testing the thread caches\n");
+    test_pool(AV_BUFFER_POOL_FLAG_THREAD_CACHE);
+    test_hugepages();
+#if HAVE_PTHREADS
+    printf("Testing the shared list with %d threads\n", NB_THREADS);
+    test_pool_threads(0);
+    printf("Testing the thread caches with %d threads\n", NB_THREADS);
+    test_pool_threads(AV_BUFFER_POOL_FLAG_THREAD_CACHE);
+#endif
+    if (accounting)
+        test_pool_soft_limit();
+
+    return 0;
+}
+#endif
@@ -106,6 +106,39 @@ AVBufferRef *av_buffer_alloc(int size);
  */
 AVBufferRef *av_buffer_allocz(int size);
 
+/**
+ * Allocate an AVBuffer of the given size, backed by huge pages when it is
+ * large enough to span one. Explicitly reserved huge pages (MAP_HUGETLB) are
+ * used when available, transparent huge pages otherwise. Smaller buffers and
+ * systems without huge page support fall back to av_buffer_alloc().
+ *
+ * As with av_buffer_alloc(), the data is not guaranteed to be initialized.
+ *
+ * @return an AVBufferRef of given size or NULL when out of memory
+ */
+AVBufferRef *av_buffer_alloc_hugepages(int size);
+
+/**
+ * Set the function used by the AVBufferPools of the default get_buffer2()
+ * callback of libavcodec to allocate the data planes of video frames. This
+ * lets large decoded frames be placed in a dedicated memory region, e.g.
+ * with av_buffer_alloc_hugepages(), without every application implementing
+ * its own get_buffer2(). Unpooled allocations, such as av_frame_get_buffer(),
+ * always use av_buffer_alloc().
+ *
+ * This function is not thread-safe and should be called before any frame is
+ * allocated. Buffers already allocated are not affected.
+ *
+ * @param alloc allocation function, NULL to restore the default allocator
+ */
+void av_buffer_set_frame_allocator(AVBufferRef *(*alloc)(int size));
+
+/**
+ * @return the function set with av_buffer_set_frame_allocator(), or NULL if
+ *         the default allocator is in use
+ */
+AVBufferRef *(*av_buffer_get_frame_allocator(void))(int size);
+
 /**
  * Always treat the buffer as read-only, even when it has only one
  * reference.
@@ -248,6 +281,29 @@ typedef struct AVBufferPool AVBufferPool;
  */
 AVBufferPool *av_buffer_pool_init(int size, AVBufferRef* (*alloc)(int size));
 
+/**
+ * Give every thread its own cache of free buffers. Buffers are returned to the
+ * cache of the thread releasing them, and a thread whose cache is empty takes
+ * the buffers of the cache of another thread before allocating a new one. The
+ * caches are lock-free. This avoids contention on a single list when many
+ * threads get and release buffers from the same pool at a high rate, e.g. with
+ * frame threading. Without thread support this flag has no effect.
+ */
+#define AV_BUFFER_POOL_FLAG_THREAD_CACHE (1 << 0)
+
+/**
+ * Allocate and initialize a buffer pool with additional flags.
+ *
+ * @param size size of each buffer in this pool
+ * @param alloc a function that will be used to allocate new buffers when the
+ * pool is empty. May be NULL, then the default allocator will be used
+ * (av_buffer_alloc()).
+ * @param flags a combination of AV_BUFFER_POOL_FLAG_*
+ * @return newly created buffer pool on success, NULL on error.
+ */
+AVBufferPool *av_buffer_pool_init_flags(int size, AVBufferRef* (*alloc)(int size),
+                                        int flags);
+
 /**
  * Mark the pool as being available for freeing. It will actually be freed only
  * once all the allocated buffers associated with the pool are released. Thus it
@@ -259,6 +315,16 @@ AVBufferPool *av_buffer_pool_init(int size, AVBufferRef* (*alloc)(int size));
  */
 void av_buffer_pool_uninit(AVBufferPool **pool);
 
+/**
+ * Set the category the memory allocated by the pool is accounted to, as
+ * reported by av_mem_get_usage(). This must be called before the first
+ * av_buffer_pool_get() on the pool.
+ *
+ * @param category an AVClassCategory, e.g. AV_CLASS_CATEGORY_DECODER for a
+ *                 pool of decoded frames
+ */
+void av_buffer_pool_set_category(AVBufferPool *pool, int category);
+
 /**
  * Allocate a new AVBuffer, reusing an old buffer from the pool when available.
  * This function may be called simultaneously from multiple threads.
@@ -267,6 +333,45 @@ void av_buffer_pool_uninit(AVBufferPool **pool);
  */
 AVBufferRef *av_buffer_pool_get(AVBufferPool *pool);
 
+/**
+ * Usage statistics of a buffer pool.
+ * New fields may be added to the end with minor version bumps.
+ */
+typedef struct AVBufferPoolStats {
+    /**
+     * Number of av_buffer_pool_get() calls served with a buffer from the pool.
+     */
+    int64_t hits;
+    /**
+     * Number of av_buffer_pool_get() calls for which a new buffer had to be
+     * allocated.
+     */
+    int64_t misses;
+    /**
+     * Number of buffers currently handed out by the pool.
+     */
+    int nb_in_use;
+    /**
+     * Highest number of buffers allocated by the pool at the same time.
+     */
+    int high_water_mark;
+    /**
+     * Number of buffers currently allocated by the pool, in use or not.
+     * Buffers are only freed when the pool is freed, or on release while the
+     * soft limit set with av_mem_set_soft_limit() is exceeded.
+     */
+    int nb_allocated;
+} AVBufferPoolStats;
+
+/**
+ * Retrieve the usage statistics of a buffer pool.
+ * This function may be called simultaneously with av_buffer_pool_get() and
+ * the release of buffers, the values are then a snapshot.
+ *
+ * @param stats filled with the statistics of pool
+ */
+void av_buffer_pool_get_stats(AVBufferPool *pool, AVBufferPoolStats *stats);
+
 /**
  * @}
  */
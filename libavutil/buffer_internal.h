@@ -70,12 +70,48 @@ typedef struct BufferPoolEntry {
 
     AVBufferPool *pool;
     struct BufferPoolEntry *next;
+
+    /* set if the buffer was counted in the usage of the pool's category */
+    int accounted;
 } BufferPoolEntry;
 
+/*
+ * A cache of free buffers, used by AV_BUFFER_POOL_FLAG_THREAD_CACHE pools.
+ * Each thread is mapped to one cache, so that threads using the pool
+ * concurrently do not contend on the same list. The caches are lock-free:
+ * buffers are only ever pushed to the front of a list or the whole list is
+ * taken at once, both with a single compare-and-swap.
+ */
+typedef struct BufferPoolCache {
+    BufferPoolEntry * volatile pool;
+
+    volatile int64_t hits;
+
+    /* keep the caches of different threads on different cache lines */
+    uint8_t padding[64];
+} BufferPoolCache;
+
 struct AVBufferPool {
     AVMutex mutex;
     BufferPoolEntry *pool;
 
+    int flags;
+
+    /*
+     * Per thread caches, only allocated with AV_BUFFER_POOL_FLAG_THREAD_CACHE.
+     * nb_caches is a power of two.
+     */
+    BufferPoolCache *caches;
+    int nb_caches;
+
+    /* statistics, updated atomically; hits only count the shared list */
+    volatile int64_t hits;
+    volatile int64_t misses;
+    volatile int64_t high_water_mark;
+
+    /* AVClassCategory the memory of the pool is accounted to */
+    int category;
+
     /*
      * This is used to track when the pool is to be freed.
      * The pointer to the pool itself held by the caller is considered to
@@ -36,6 +36,7 @@
 #include <malloc.h>
 #endif
 
+#include "atomic.h"
 #include "avassert.h"
 #include "avutil.h"
 #include "common.h"
@@ -74,6 +75,119 @@ void av_max_alloc(size_t max){
     max_alloc_size = max;
 }
 
+#define HAVE_MEM_ACCOUNTING (CONFIG_MEMORY_ACCOUNTING && !CONFIG_MEMALIGN_HACK)
+
+#if HAVE_MEM_ACCOUNTING
+/* Every block starts with a header that records how many bytes were counted
+ * for it, so that blocks allocated while accounting was disabled are never
+ * subtracted. Its size keeps the data aligned. */
+#define MEM_HDR_SIZE ALIGN
+
+typedef struct MemHeader {
+    size_t accounted;
+} MemHeader;
+#else
+#define MEM_HDR_SIZE 0
+#endif
+
+static int mem_accounting;
+static volatile int64_t mem_soft_limit;
+
+/* The counters are updated on every allocation while accounting is enabled,
+ * so each one is a separate atomic rather than sharing a lock. */
+static struct {
+    volatile int64_t current;
+    volatile int64_t peak;
+} mem_usage[AV_CLASS_CATEGORY_NB];
+
+int av_mem_set_accounting(int enable)
+{
+#if HAVE_MEM_ACCOUNTING
+    mem_accounting = !!enable;
+    return 0;
+#else
+    return enable ? AVERROR(ENOSYS) : 0;
+#endif
+}
+
+static void mem_usage_add(int category, int64_t size)
+{
+    int64_t current, peak, prev;
+
+    current = avpriv_atomic_int64_add_and_fetch(&mem_usage[category].current, size);
+    if (size < 0)
+        return;
+    peak = avpriv_atomic_int64_get(&mem_usage[category].peak);
+    while (peak < current &&
+           (prev = avpriv_atomic_int64_cas(&mem_usage[category].peak, peak, current)) != peak)
+        peak = prev;
+}
+
+int ff_mem_account(int category, int64_t size)
+{
+    if (!mem_accounting || size <= 0 || (unsigned)category >= AV_CLASS_CATEGORY_NB)
+        return 0;
+
+    mem_usage_add(category, size);
+    return 1;
+}
+
+void ff_mem_unaccount(int category, int64_t size)
+{
+    if ((unsigned)category < AV_CLASS_CATEGORY_NB)
+        mem_usage_add(category, -size);
+}
+
+#if HAVE_MEM_ACCOUNTING
+/* set up the header of a new block of size bytes, return the data pointer */
+static void *mem_hdr_init(void *base, size_t size)
+{
+    MemHeader *hdr = base;
+
+    hdr->accounted = 0;
+    if (ff_mem_account(AV_CLASS_CATEGORY_NA, size + MEM_HDR_SIZE))
+        hdr->accounted = size + MEM_HDR_SIZE;
+
+    return (uint8_t *)base + MEM_HDR_SIZE;
+}
+
+/* subtract a block if it was counted, return the pointer to free */
+static void *mem_hdr_release(void *ptr)
+{
+    MemHeader *hdr = (MemHeader *)((uint8_t *)ptr - MEM_HDR_SIZE);
+
+    if (hdr->accounted)
+        ff_mem_unaccount(AV_CLASS_CATEGORY_NA, hdr->accounted);
+    return hdr;
+}
+#endif
+
+void av_mem_get_usage(int category, AVMemUsage *usage)
+{
+    memset(usage, 0, sizeof(*usage));
+    if ((unsigned)category >= AV_CLASS_CATEGORY_NB)
+        return;
+
+    usage->current = avpriv_atomic_int64_get(&mem_usage[category].current);
+    usage->peak    = avpriv_atomic_int64_get(&mem_usage[category].peak);
+}
+
+void av_mem_set_soft_limit(int64_t limit)
+{
+    avpriv_atomic_int64_set(&mem_soft_limit, FFMAX(limit, 0));
+}
+
+int ff_mem_over_soft_limit(void)
+{
+    int64_t limit;
+
+    if (!mem_accounting)
+        return 0;
+
+    limit = avpriv_atomic_int64_get(&mem_soft_limit);
+    return limit && avpriv_atomic_int64_get(&mem_usage[AV_CLASS_CATEGORY_NA].current) > limit;
+}
+
 void *av_malloc(size_t size)
 {
     void *ptr = NULL;
@@ -94,15 +208,15 @@ void *av_malloc(size_t size)
     ((char *)ptr)[-1] = diff;
 #elif HAVE_POSIX_MEMALIGN
     if (size) //OS X on SDK 10.6 has a broken posix_memalign implementation
-    if (posix_memalign(&ptr, ALIGN, size))
+    if (posix_memalign(&ptr, ALIGN, size + MEM_HDR_SIZE))
         ptr = NULL;
 #elif HAVE_ALIGNED_MALLOC
-    ptr = _aligned_malloc(size, ALIGN);
+    ptr = _aligned_malloc(size + MEM_HDR_SIZE, ALIGN);
 #elif HAVE_MEMALIGN
 #ifndef __DJGPP__
-    ptr = memalign(ALIGN, size);
+    ptr = memalign(ALIGN, size + MEM_HDR_SIZE);
 #else
-    ptr = memalign(size, ALIGN);
+    ptr = memalign(size + MEM_HDR_SIZE, ALIGN);
 #endif
     /* Why 64?
      * Indeed, we should align it:
@@ -129,7 +243,11 @@ void *av_malloc(size_t size)
      * BTW, malloc seems to do 8-byte alignment by default here.
      */
 #else
-    ptr = malloc(size);
+    ptr = malloc(size + MEM_HDR_SIZE);
+#endif
+#if HAVE_MEM_ACCOUNTING
+    if (ptr)
+        ptr = mem_hdr_init(ptr, size);
 #endif
     if(!ptr && !size) {
         size = 1;
@@ -162,6 +280,22 @@ void *av_realloc(void *ptr, size_t size)
     if (ptr)
         ptr = (char *)ptr + diff;
     return ptr;
+#elif HAVE_MEM_ACCOUNTING
+    {
+        MemHeader *hdr = ptr ? (MemHeader *)((uint8_t *)ptr - MEM_HDR_SIZE) : NULL;
+        size_t accounted = hdr ? hdr->accounted : 0;
+
+#if HAVE_ALIGNED_MALLOC
+        hdr = _aligned_realloc(hdr, size + MEM_HDR_SIZE, ALIGN);
+#else
+        hdr = realloc(hdr, size + MEM_HDR_SIZE);
+#endif
+        if (!hdr)
+            return NULL;
+        if (accounted)
+            ff_mem_unaccount(AV_CLASS_CATEGORY_NA, accounted);
+        return mem_hdr_init(hdr, size);
+    }
 #elif HAVE_ALIGNED_MALLOC
     return _aligned_realloc(ptr, size + !size, ALIGN);
 #else
@@ -233,11 +367,17 @@ void av_free(void *ptr)
         av_assert0(v>0 && v<=ALIGN);
         free((char *)ptr - v);
     }
-#elif HAVE_ALIGNED_MALLOC
+#else
+#if HAVE_MEM_ACCOUNTING
+    if (ptr)
+        ptr = mem_hdr_release(ptr);
+#endif
+#if HAVE_ALIGNED_MALLOC
     _aligned_free(ptr);
 #else
     free(ptr);
 #endif
+#endif
 }
 
 void av_freep(void *arg)
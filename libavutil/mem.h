@@ -382,6 +382,57 @@ void *av_fast_realloc(void *ptr, unsigned int *size, size_t min_size);
  */
 void av_fast_malloc(void *ptr, unsigned int *size, size_t min_size);
 
+/**
+ * Memory usage counters, in bytes.
+ */
+typedef struct AVMemUsage {
+    int64_t current;    ///< currently allocated
+    int64_t peak;       ///< maximum of current since accounting was enabled
+} AVMemUsage;
+
+/**
+ * Enable or disable accounting of the memory allocated through av_malloc()
+ * and friends. This adds a small cost to every allocation and so is
+ * disabled by default. It is only available if FFmpeg was configured with
+ * --enable-memory-accounting.
+ *
+ * Accounting should be enabled before any other libav* call. Blocks
+ * allocated while it is disabled are never counted, blocks counted are
+ * subtracted when they are freed even if it was disabled in between.
+ *
+ * @return 0 on success, AVERROR(ENOSYS) if accounting is not supported by
+ *         this build
+ */
+int av_mem_set_accounting(int enable);
+
+/**
+ * Get the memory usage for a category.
+ *
+ * AV_CLASS_CATEGORY_NA returns the total of all blocks allocated by
+ * av_malloc() and friends. Other categories return the size of the
+ * buffer pool memory attributed to them with
+ * av_buffer_pool_set_category(), e.g. AV_CLASS_CATEGORY_DECODER for
+ * frames allocated by decoders or AV_CLASS_CATEGORY_FILTER for the video
+ * frames allocated by libavfilter.
+ *
+ * All counters are zero unless accounting is enabled.
+ *
+ * @param category an AVClassCategory
+ */
+void av_mem_get_usage(int category, AVMemUsage *usage);
+
+/**
+ * Set a soft limit on the total memory usage. While the total reported by
+ * av_mem_get_usage(AV_CLASS_CATEGORY_NA) exceeds this limit, buffer pools
+ * free released buffers instead of keeping them for reuse.
+ *
+ * Allocations never fail because of this limit. It requires accounting to be
+ * enabled with av_mem_set_accounting().
+ *
+ * @param limit limit in bytes, 0 for no limit
+ */
+void av_mem_set_soft_limit(int64_t limit);
+
 /**
  * @}
  */
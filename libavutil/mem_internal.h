@@ -42,4 +42,25 @@ static inline int ff_fast_malloc(void *ptr, unsigned int *size, size_t min_size,
     *size = min_size;
     return 1;
 }
+
+/**
+ * Add size bytes to the usage counters of category if memory accounting is
+ * enabled.
+ *
+ * @return 1 if the bytes were counted, 0 otherwise. Only counted bytes may
+ *         be subtracted again with ff_mem_unaccount().
+ */
+int ff_mem_account(int category, int64_t size);
+
+/**
+ * Subtract size bytes counted by ff_mem_account() from the usage counters
+ * of category, whether accounting is still enabled or not.
+ */
+void ff_mem_unaccount(int category, int64_t size);
+
+/**
+ * @return 1 if a soft limit is set and the total memory usage exceeds it
+ */
+int ff_mem_over_soft_limit(void);
+
 #endif /* AVUTIL_MEM_INTERNAL_H */
@@ -122,6 +122,9 @@ static const AVOption options[]={
 
 { "kaiser_beta"         , "set swr Kaiser Window Beta"  , OFFSET(kaiser_beta)    , AV_OPT_TYPE_INT  , {.i64=9                     }, 2      , 16        , PARAM },
 
+{ "threads"             , "set number of threads used to resample channels in parallel (0 for automatic)"
+                                                        , OFFSET(threads)        , AV_OPT_TYPE_INT  , {.i64=1                     }, 0      , INT_MAX   , PARAM },
+
 { "output_sample_bits"  , "set swr number of output sample bits", OFFSET(dither.output_sample_bits), AV_OPT_TYPE_INT  , {.i64=0   }, 0      , 64        , PARAM },
 {0}
 };
@@ -386,10 +386,12 @@ av_cold int swri_rematrix_init(SwrContext *s){
         if (maxsum <= 32768) {
             s->mix_1_1_f = (mix_1_1_func_type*)copy_s16;
             s->mix_2_1_f = (mix_2_1_func_type*)sum2_s16;
+            s->mix_n_1_f = (mix_n_1_func_type*)sumN_s16;
             s->mix_any_f = (mix_any_func_type*)get_mix_any_func_s16(s);
         } else {
             s->mix_1_1_f = (mix_1_1_func_type*)copy_clip_s16;
             s->mix_2_1_f = (mix_2_1_func_type*)sum2_clip_s16;
+            s->mix_n_1_f = (mix_n_1_func_type*)sumN_s16;
             s->mix_any_f = (mix_any_func_type*)get_mix_any_func_clip_s16(s);
         }
     }else if(s->midbuf.fmt == AV_SAMPLE_FMT_FLTP){
@@ -403,6 +405,7 @@ av_cold int swri_rematrix_init(SwrContext *s){
         *((float*)s->native_one) = 1.0;
         s->mix_1_1_f = (mix_1_1_func_type*)copy_float;
         s->mix_2_1_f = (mix_2_1_func_type*)sum2_float;
+        s->mix_n_1_f = (mix_n_1_func_type*)sumN_float;
         s->mix_any_f = (mix_any_func_type*)get_mix_any_func_float(s);
     }else if(s->midbuf.fmt == AV_SAMPLE_FMT_DBLP){
         s->native_matrix = av_calloc(nb_in * nb_out, sizeof(double));
@@ -415,6 +418,7 @@ av_cold int swri_rematrix_init(SwrContext *s){
         *((double*)s->native_one) = 1.0;
         s->mix_1_1_f = (mix_1_1_func_type*)copy_double;
         s->mix_2_1_f = (mix_2_1_func_type*)sum2_double;
+        s->mix_n_1_f = (mix_n_1_func_type*)sumN_double;
         s->mix_any_f = (mix_any_func_type*)get_mix_any_func_double(s);
     }else if(s->midbuf.fmt == AV_SAMPLE_FMT_S32P){
         // Only for dithering currently
@@ -428,6 +432,7 @@ av_cold int swri_rematrix_init(SwrContext *s){
         *((int*)s->native_one) = 32768;
         s->mix_1_1_f = (mix_1_1_func_type*)copy_s32;
         s->mix_2_1_f = (mix_2_1_func_type*)sum2_s32;
+        s->mix_n_1_f = (mix_n_1_func_type*)sumN_s32;
         s->mix_any_f = (mix_any_func_type*)get_mix_any_func_s32(s);
     }else
         av_assert0(0);
@@ -456,7 +461,7 @@ av_cold void swri_rematrix_free(SwrContext *s){
 }
 
 int swri_rematrix(SwrContext *s, AudioData *out, AudioData *in, int len, int mustcopy){
-    int out_i, in_i, i, j;
+    int out_i, in_i;
     int len1 = 0;
     int off = 0;
 
@@ -465,7 +470,7 @@ int swri_rematrix(SwrContext *s, AudioData *out, AudioData *in, int len, int mus
         return 0;
     }
 
-    if(s->mix_2_1_simd || s->mix_1_1_simd){
+    if(s->mix_2_1_simd || s->mix_1_1_simd || s->mix_n_1_simd){
         len1= len&~15;
         off = len1 * out->bps;
     }
@@ -502,35 +507,25 @@ int swri_rematrix(SwrContext *s, AudioData *out, AudioData *in, int len, int mus
             if(len != len1)
                 s->mix_2_1_f   (out->ch[out_i]+off, in->ch[in_i1]+off, in->ch[in_i2]+off, s->native_matrix, in->ch_count*out_i + in_i1, in->ch_count*out_i + in_i2, len-len1);
             break;}
-        default:
-            if(s->int_sample_fmt == AV_SAMPLE_FMT_FLTP){
-                for(i=0; i<len; i++){
-                    float v=0;
-                    for(j=0; j<s->matrix_ch[out_i][0]; j++){
-                        in_i= s->matrix_ch[out_i][1+j];
-                        v+= ((float*)in->ch[in_i])[i] * s->matrix[out_i][in_i];
-                    }
-                    ((float*)out->ch[out_i])[i]= v;
-                }
-            }else if(s->int_sample_fmt == AV_SAMPLE_FMT_DBLP){
-                for(i=0; i<len; i++){
-                    double v=0;
-                    for(j=0; j<s->matrix_ch[out_i][0]; j++){
-                        in_i= s->matrix_ch[out_i][1+j];
-                        v+= ((double*)in->ch[in_i])[i] * s->matrix[out_i][in_i];
-                    }
-                    ((double*)out->ch[out_i])[i]= v;
-                }
-            }else{
-                for(i=0; i<len; i++){
-                    int v=0;
-                    for(j=0; j<s->matrix_ch[out_i][0]; j++){
-                        in_i= s->matrix_ch[out_i][1+j];
-                        v+= ((int16_t*)in->ch[in_i])[i] * s->matrix32[out_i][in_i];
-                    }
-                    ((int16_t*)out->ch[out_i])[i]= (v + 16384)>>15;
+        default: {
+            /* float and double use the native matrix, integer formats the
+             * 17.15 fixed point one; both are indexed by input channel */
+            const void *coeffp;
+            if(s->int_sample_fmt == AV_SAMPLE_FMT_FLTP || s->int_sample_fmt == AV_SAMPLE_FMT_DBLP)
+                coeffp = s->native_matrix + in->ch_count*out_i*out->bps;
+            else
+                coeffp = s->matrix32[out_i];
+            if(s->mix_n_1_simd && len1){
+                const uint8_t *in_tail[SWR_CH_MAX];
+                s->mix_n_1_simd(out->ch[out_i], (const uint8_t **)in->ch, coeffp, s->matrix_ch[out_i], len1);
+                if(len != len1){
+                    for(in_i=0; in_i<in->ch_count; in_i++)
+                        in_tail[in_i] = in->ch[in_i] + off;
+                    s->mix_n_1_f(out->ch[out_i]+off, in_tail, coeffp, s->matrix_ch[out_i], len-len1);
                 }
-            }
+            }else
+                s->mix_n_1_f(out->ch[out_i], (const uint8_t **)in->ch, coeffp, s->matrix_ch[out_i], len);
+            break;}
         }
     }
     return 0;
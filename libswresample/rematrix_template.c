@@ -87,6 +87,40 @@ static void RENAME(mix8to2)(SAMPLE **out, const SAMPLE **in, COEFF *coeffp, inte
     }
 }
 
+#ifndef TEMPLATE_CLIP
+#define BLOCK_SIZE 256
+
+/* Mix an arbitrary number of input channels into one output channel.
+ * The samples are processed in blocks, for each block the contribution of
+ * every input channel is accumulated by a simple multiply-add loop over the
+ * block. The products and the accumulator have the same types as in the per
+ * sample loop and the channels are added in the same order, so the result is
+ * identical. Like that loop, the s16 version does not clip. */
+static void RENAME(sumN)(SAMPLE *out, const SAMPLE **in, const COEFF *coeffp, const uint8_t *ch, integer len){
+    INTER acc[BLOCK_SIZE];
+    int i, j, off;
+
+    for(off=0; off<len; off+=BLOCK_SIZE){
+        int n = FFMIN(BLOCK_SIZE, len - off);
+        const SAMPLE *src = in[ch[1]] + off;
+        INTER coeff = coeffp[ch[1]];
+
+        for(i=0; i<n; i++)
+            acc[i] = coeff*src[i];
+        for(j=2; j<=ch[0]; j++){
+            src   = in[ch[j]] + off;
+            coeff = coeffp[ch[j]];
+            for(i=0; i<n; i++)
+                acc[i] += coeff*src[i];
+        }
+        for(i=0; i<n; i++)
+            out[off + i] = R(acc[i]);
+    }
+}
+
+#undef BLOCK_SIZE
+#endif
+
 static RENAME(mix_any_func_type) *RENAME(get_mix_any_func)(SwrContext *s){
     if(   s->out_ch_layout == AV_CH_LAYOUT_STEREO && (s->in_ch_layout == AV_CH_LAYOUT_5POINT1 || s->in_ch_layout == AV_CH_LAYOUT_5POINT1_BACK)
        && s->matrix[0][2] == s->matrix[1][2] && s->matrix[0][3] == s->matrix[1][3]
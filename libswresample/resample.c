@@ -175,13 +175,16 @@ static void resample_free(ResampleContext **cc){
     ResampleContext *c = *cc;
     if(!c)
         return;
+#if HAVE_THREADS
+    swri_thread_free(&c->thread);
+#endif
     av_freep(&c->filter_bank);
     av_freep(cc);
 }
 
 static ResampleContext *resample_init(ResampleContext *c, int out_rate, int in_rate, int filter_size, int phase_shift, int linear,
                                     double cutoff0, enum AVSampleFormat format, enum SwrFilterType filter_type, int kaiser_beta,
-                                    double precision, int cheby)
+                                    double precision, int cheby, int nb_threads)
 {
     double cutoff = cutoff0? cutoff0 : 0.97;
     double factor= FFMIN(out_rate * cutoff / in_rate, 1.0);
@@ -253,8 +256,20 @@ static ResampleContext *resample_init(ResampleContext *c, int out_rate, int in_r
 
     swri_resample_dsp_init(c);
 
+#if HAVE_THREADS
+    if (c->nb_threads != nb_threads || (nb_threads != 1 && !c->thread)) {
+        swri_thread_free(&c->thread);
+        if (swri_thread_init(&c->thread, nb_threads) < 0)
+            goto error;
+        c->nb_threads = nb_threads;
+    }
+#endif
+
     return c;
 error:
+#if HAVE_THREADS
+    swri_thread_free(&c->thread);
+#endif
     av_freep(&c->filter_bank);
     av_free(c);
     return NULL;
@@ -311,6 +326,38 @@ static int swri_resample(ResampleContext *c,
     return dst_size;
 }
 
+#if HAVE_THREADS
+typedef struct ResampleThreadArg {
+    ResampleContext *c;
+    AudioData *dst, *src;
+    int dst_size, src_size;
+    int need_emms;
+    int ret, consumed, index, frac;
+} ResampleThreadArg;
+
+/* Every job works on a private copy of the context, so that updating the
+ * phase after the last channel cannot race with the other channels. The
+ * output is therefore identical to the single threaded path. */
+static void resample_channel(void *opaque, int ch, int ch_count)
+{
+    ResampleThreadArg *arg = opaque;
+    ResampleContext c = *arg->c;
+    int consumed, ret;
+
+    ret = swri_resample(&c, arg->dst->ch[ch], arg->src->ch[ch],
+                        &consumed, arg->src_size, arg->dst_size, ch+1 == ch_count);
+    if (arg->need_emms)
+        emms_c();
+
+    if (ch+1 == ch_count) {
+        arg->ret      = ret;
+        arg->consumed = consumed;
+        arg->index    = c.index;
+        arg->frac     = c.frac;
+    }
+}
+#endif
+
 static int multiple_resample(ResampleContext *c, AudioData *dst, int dst_size, AudioData *src, int src_size, int *consumed){
     int i, ret= -1;
     int av_unused mm_flags = av_get_cpu_flags();
@@ -322,12 +369,31 @@ static int multiple_resample(ResampleContext *c, AudioData *dst, int dst_size, A
         dst_size = FFMIN(dst_size, c->compensation_distance);
     src_size = FFMIN(src_size, max_src_size);
 
+#if HAVE_THREADS
+    if (c->thread && dst->ch_count > 1) {
+        ResampleThreadArg arg = {
+            .c         = c,
+            .dst       = dst,
+            .src       = src,
+            .dst_size  = dst_size,
+            .src_size  = src_size,
+            .need_emms = need_emms,
+        };
+        swri_thread_execute(c->thread, resample_channel, &arg, dst->ch_count);
+        c->index  = arg.index;
+        c->frac   = arg.frac;
+        *consumed = arg.consumed;
+        ret       = arg.ret;
+    } else
+#endif
+    {
     for(i=0; i<dst->ch_count; i++){
         ret= swri_resample(c, dst->ch[i], src->ch[i],
                            consumed, src_size, dst_size, i+1==dst->ch_count);
     }
     if(need_emms)
         emms_c();
+    }
 
     if (c->compensation_distance) {
         c->compensation_distance -= ret;
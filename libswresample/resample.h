@@ -26,6 +26,7 @@
 #include "libavutil/samplefmt.h"
 
 #include "swresample_internal.h"
+#include "thread.h"
 
 typedef struct ResampleContext {
     const AVClass *av_class;
@@ -49,6 +50,8 @@ typedef struct ResampleContext {
     enum AVSampleFormat format;
     int felem_size;
     int filter_shift;
+    int nb_threads;
+    SwrThreadContext *thread;
 
     struct {
         void (*resample_one)(void *dst, const void *src,
@@ -23,6 +23,8 @@
 #include "libavutil/channel_layout.h"
 #include "libavutil/common.h"
 #include "libavutil/opt.h"
+#include "libavutil/samplefmt.h"
+#include "libavutil/time.h"
 #include "swresample.h"
 
 #undef time
@@ -221,6 +223,96 @@ static void audiogen(void *data, enum AVSampleFormat sample_fmt,
     }
 }
 
+static struct SwrContext *bench_alloc(int ch_count, int in_sample_rate, int out_sample_rate, int threads){
+    struct SwrContext *s = swr_alloc();
+    if (!s)
+        return NULL;
+    av_opt_set_int(s, "ich", ch_count, 0);
+    av_opt_set_int(s, "och", ch_count, 0);
+    av_opt_set_int(s, "isr", in_sample_rate, 0);
+    av_opt_set_int(s, "osr", out_sample_rate, 0);
+    av_opt_set_sample_fmt(s, "isf", AV_SAMPLE_FMT_FLTP, 0);
+    av_opt_set_sample_fmt(s, "osf", AV_SAMPLE_FMT_FLTP, 0);
+    av_opt_set_int(s, "filter_size", 256, 0);
+    av_opt_set_int(s, "threads", threads, 0);
+    if (swr_init(s) < 0)
+        swr_free(&s);
+    return s;
+}
+
+/* Resample FLTP 44100->48000 with a long filter for increasing channel counts,
+ * report the throughput and verify that the output matches the single
+ * threaded output bit for bit. */
+static int bench(int threads){
+    static const int ch_counts[] = { 2, 8, 16, 32, 64 };
+    const int in_sample_rate = 44100, out_sample_rate = 48000;
+    const int in_count = 4096;
+    int i, ch, j, ret = 0;
+
+    for (i = 0; i < FF_ARRAY_ELEMS(ch_counts); i++) {
+        int ch_count = ch_counts[i];
+        struct SwrContext *ref = bench_alloc(ch_count, in_sample_rate, out_sample_rate, 1);
+        struct SwrContext *s   = bench_alloc(ch_count, in_sample_rate, out_sample_rate, threads);
+        uint8_t **in = NULL, **out = NULL, **out_ref = NULL;
+        int out_count = av_rescale_rnd(in_count, out_sample_rate, in_sample_rate, AV_ROUND_UP) + 256;
+        int64_t samples = 0, start, elapsed;
+        int ref_count, new_count;
+
+        if (!ref || !s ||
+            av_samples_alloc_array_and_samples(&in,      NULL, ch_count, in_count,  AV_SAMPLE_FMT_FLTP, 0) < 0 ||
+            av_samples_alloc_array_and_samples(&out,     NULL, ch_count, out_count, AV_SAMPLE_FMT_FLTP, 0) < 0 ||
+            av_samples_alloc_array_and_samples(&out_ref, NULL, ch_count, out_count, AV_SAMPLE_FMT_FLTP, 0) < 0) {
+            fprintf(stderr, "Failed to allocate benchmark context\n");
+            ret = 1;
+            goto end;
+        }
+
+        for (ch = 0; ch < ch_count; ch++)
+            for (j = 0; j < in_count; j++)
+                ((float *)in[ch])[j] = sin(j * (ch + 1) * 0.01) * 0.5;
+
+        ref_count = swr_convert(ref, out_ref, out_count, (const uint8_t **)in, in_count);
+        new_count = swr_convert(s,   out,     out_count, (const uint8_t **)in, in_count);
+        if (ref_count != new_count) {
+            fprintf(stderr, "BENCH: %d channels: sample count mismatch %d != %d\n", ch_count, new_count, ref_count);
+            ret = 1;
+        }
+        for (ch = 0; ch < ch_count && ref_count == new_count; ch++) {
+            if (memcmp(out[ch], out_ref[ch], ref_count * sizeof(float))) {
+                fprintf(stderr, "BENCH: %d channels: output of channel %d differs from single threaded output\n", ch_count, ch);
+                ret = 1;
+                break;
+            }
+        }
+
+        start = av_gettime_relative();
+        do {
+            swr_convert(s, out, out_count, (const uint8_t **)in, in_count);
+            samples += in_count;
+            elapsed = av_gettime_relative() - start;
+        } while (elapsed < 1000000);
+
+        fprintf(stderr, "BENCH: %2d channels, %d threads: %10.0f samples/s per channel, %12.0f samples/s total\n",
+                ch_count, threads, samples * 1000000.0 / elapsed, samples * 1000000.0 * ch_count / elapsed);
+
+end:
+        if (in)
+            av_freep(&in[0]);
+        if (out)
+            av_freep(&out[0]);
+        if (out_ref)
+            av_freep(&out_ref[0]);
+        av_freep(&in);
+        av_freep(&out);
+        av_freep(&out_ref);
+        swr_free(&ref);
+        swr_free(&s);
+        if (ret)
+            break;
+    }
+    return ret;
+}
+
 int main(int argc, char **argv){
     int in_sample_rate, out_sample_rate, ch ,i, flush_count;
     uint64_t in_ch_layout, out_ch_layout;
@@ -247,9 +339,13 @@ int main(int argc, char **argv){
     if (argc > 1) {
         if (!strcmp(argv[1], "-h") || !strcmp(argv[1], "--help")) {
             av_log(NULL, AV_LOG_INFO, "Usage: swresample-test [<num_tests>[ <test>]]  \n"
-                   "num_tests           Default is %d\n", num_tests);
+                   "       swresample-test -bench [<threads>]\n"
+                   "num_tests           Default is %d\n"
+                   "threads             Number of resampling threads, default is 0 (automatic)\n", num_tests);
             return 0;
         }
+        if (!strcmp(argv[1], "-bench"))
+            return bench(argc > 2 ? strtol(argv[2], NULL, 0) : 0);
         num_tests = strtol(argv[1], NULL, 0);
         if(num_tests < 0) {
             num_tests = -num_tests;
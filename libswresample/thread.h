@@ -0,0 +1,44 @@
+/*
+ * This file is part of libswresample
+ *
+ * libswresample is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * libswresample is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with libswresample; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+
+#ifndef SWRESAMPLE_THREAD_H
+#define SWRESAMPLE_THREAD_H
+
+typedef struct SwrThreadContext SwrThreadContext;
+
+typedef void (swri_thread_func)(void *arg, int jobnr, int nb_jobs);
+
+/**
+ * Create a pool of worker threads.
+ *
+ * @param nb_threads number of threads, 0 for automatic
+ * @return the number of threads in the pool, 1 if no pool was created
+ *         (in which case *pc is left NULL), or a negative AVERROR code
+ */
+int swri_thread_init(SwrThreadContext **pc, int nb_threads);
+
+void swri_thread_free(SwrThreadContext **pc);
+
+/**
+ * Run func(arg, jobnr, nb_jobs) for jobnr in [0, nb_jobs) on the pool and
+ * wait for all jobs to complete.
+ */
+void swri_thread_execute(SwrThreadContext *c, swri_thread_func *func,
+                         void *arg, int nb_jobs);
+
+#endif /* SWRESAMPLE_THREAD_H */
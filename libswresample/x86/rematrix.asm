@@ -24,6 +24,7 @@
 SECTION_RODATA 32
 dw1: times 8  dd 1
 w1 : times 16 dw 1
+pd_16384: times 8 dd 16384
 
 SECTION .text
 
@@ -222,6 +223,110 @@ mix_2_1_int16_u_int %+ SUFFIX:
 %endif
 %endmacro
 
+%if ARCH_X86_64
+; void mix_n_1_float(float *out, const float **in, const float *coeffp,
+;                    const uint8_t *ch, integer len)
+; ch[0] is the number of input channels, ch[1..ch[0]] their indexes. The
+; products are added in the order of ch, like the C version does.
+%macro MIXN_FLT 0
+cglobal mix_n_1_float, 5, 9, 4, out, in, coeffp, ch, len, pos, src, idx, cnt
+    shl          lenq, 2
+    xor          posd, posd
+.next:
+    movzx        idxd, byte [chq + 1]
+    mov          srcq, [inq + idxq*gprsize]
+    VBROADCASTSS   m2, [coeffpq + 4*idxq]
+    movu           m0, [srcq + posq         ]
+    movu           m1, [srcq + posq + mmsize]
+    mulps          m0, m2
+    mulps          m1, m2
+    mov          cntd, 2
+.channel:
+    movzx        idxd, byte [chq]
+    cmp          cntd, idxd
+        jg .store
+    movzx        idxd, byte [chq + cntq]
+    mov          srcq, [inq + idxq*gprsize]
+    VBROADCASTSS   m2, [coeffpq + 4*idxq]
+    movu           m3, [srcq + posq         ]
+    mulps          m3, m2
+    addps          m0, m3
+    movu           m3, [srcq + posq + mmsize]
+    mulps          m3, m2
+    addps          m1, m3
+    inc          cntd
+    jmp .channel
+.store:
+    movu  [outq + posq         ], m0
+    movu  [outq + posq + mmsize], m1
+    add          posq, mmsize*2
+    cmp          posq, lenq
+        jl .next
+    REP_RET
+%endmacro
+
+; void mix_n_1_int16(int16_t *out, const int16_t **in, const int *coeffp,
+;                    const uint8_t *ch, integer len)
+; 32 bit products and sums like the C version, the result is truncated to
+; 16 bits without clipping.
+%macro MIXN_INT16 0
+cglobal mix_n_1_int16, 5, 9, 5, out, in, coeffp, ch, len, pos, src, idx, cnt
+    add          lenq, lenq
+    xor          posd, posd
+.next:
+    movzx        idxd, byte [chq + 1]
+    mov          srcq, [inq + idxq*gprsize]
+%if cpuflag(avx2)
+    vpbroadcastd   m2, [coeffpq + 4*idxq]
+%else
+    movd           m2, [coeffpq + 4*idxq]
+    pshufd         m2, m2, 0
+%endif
+    pmovsxwd       m0, [srcq + posq           ]
+    pmovsxwd       m1, [srcq + posq + mmsize/2]
+    pmulld         m0, m2
+    pmulld         m1, m2
+    mov          cntd, 2
+.channel:
+    movzx        idxd, byte [chq]
+    cmp          cntd, idxd
+        jg .store
+    movzx        idxd, byte [chq + cntq]
+    mov          srcq, [inq + idxq*gprsize]
+%if cpuflag(avx2)
+    vpbroadcastd   m2, [coeffpq + 4*idxq]
+%else
+    movd           m2, [coeffpq + 4*idxq]
+    pshufd         m2, m2, 0
+%endif
+    pmovsxwd       m3, [srcq + posq           ]
+    pmovsxwd       m4, [srcq + posq + mmsize/2]
+    pmulld         m3, m2
+    pmulld         m4, m2
+    paddd          m0, m3
+    paddd          m1, m4
+    inc          cntd
+    jmp .channel
+.store:
+    paddd          m0, [pd_16384]
+    paddd          m1, [pd_16384]
+    psrad          m0, 15
+    psrad          m1, 15
+    pslld          m0, 16
+    pslld          m1, 16
+    psrad          m0, 16
+    psrad          m1, 16
+    packssdw       m0, m1
+%if cpuflag(avx2)
+    vpermq         m0, m0, q3120
+%endif
+    movu  [outq + posq], m0
+    add          posq, mmsize
+    cmp          posq, lenq
+        jl .next
+    REP_RET
+%endmacro
+%endif
 
 INIT_MMX mmx
 MIX1_INT16 u
@@ -234,6 +339,9 @@ MIX2_FLT u
 MIX2_FLT a
 MIX1_FLT u
 MIX1_FLT a
+%if ARCH_X86_64
+MIXN_FLT
+%endif
 
 INIT_XMM sse2
 MIX1_INT16 u
@@ -247,4 +355,16 @@ MIX2_FLT u
 MIX2_FLT a
 MIX1_FLT u
 MIX1_FLT a
+%if ARCH_X86_64
+MIXN_FLT
+%endif
+%endif
+
+%if ARCH_X86_64
+INIT_XMM sse4
+MIXN_INT16
+%if HAVE_AVX2_EXTERNAL
+INIT_YMM avx2
+MIXN_INT16
+%endif
 %endif
@@ -0,0 +1,111 @@
+/*
+ * This file is part of FFmpeg.
+ *
+ * FFmpeg is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * FFmpeg is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with FFmpeg; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include <string.h>
+#include "checkasm.h"
+#include "libavutil/common.h"
+#include "libavutil/internal.h"
+#include "libavcodec/aacenc.h"
+#include "libavcodec/aacenc_utils.h"
+
+#define BUF_SIZE 1024
+
+static void randomize_float(float *buf, int len)
+{
+    int i;
+    for (i = 0; i < len; i++)
+        buf[i] = ((int)(rnd() & 0xffff) - 0x8000) / 64.0f;
+}
+
+static void check_abs_pow34(void (*abs_pow34)(float *out, const float *in,
+                                              const int size))
+{
+    LOCAL_ALIGNED_16(float, in,   [BUF_SIZE]);
+    LOCAL_ALIGNED_16(float, out0, [BUF_SIZE]);
+    LOCAL_ALIGNED_16(float, out1, [BUF_SIZE]);
+    int size;
+
+    declare_func(void, float *out, const float *in, const int size);
+
+    if (check_func(abs_pow34, "abs_pow34")) {
+        /* the band widths are multiples of 4, test the tail anyway */
+        for (size = 1; size <= BUF_SIZE; size += 1 + (size >> 2)) {
+            randomize_float(in, BUF_SIZE);
+            memset(out0, 0, BUF_SIZE * sizeof(*out0));
+            memset(out1, 0, BUF_SIZE * sizeof(*out1));
+            call_ref(out0, in, size);
+            call_new(out1, in, size);
+            if (!float_near_ulp_array(out0, out1, 1, BUF_SIZE))
+                fail();
+        }
+        bench_new(out1, in, BUF_SIZE);
+    }
+}
+
+static void check_quant_bands(void (*quant_bands)(int *out, const float *in,
+                                                  const float *scaled, int size,
+                                                  float Q34, int is_signed,
+                                                  int maxval, const float rounding))
+{
+    LOCAL_ALIGNED_16(float, in,     [BUF_SIZE]);
+    LOCAL_ALIGNED_16(float, scaled, [BUF_SIZE]);
+    LOCAL_ALIGNED_16(int,   out0,   [BUF_SIZE]);
+    LOCAL_ALIGNED_16(int,   out1,   [BUF_SIZE]);
+    static const int maxvals[] = { 1, 2, 4, 7, 12, 16, 8191 };
+    static const float roundings[] = { ROUND_STANDARD, ROUND_TO_ZERO };
+    int i, size;
+
+    declare_func(void, int *out, const float *in, const float *scaled, int size,
+                 float Q34, int is_signed, int maxval, const float rounding);
+
+    if (check_func(quant_bands, "quantize_bands")) {
+        for (size = 1; size <= BUF_SIZE; size += 1 + (size >> 2)) {
+            int is_signed = size & 1;
+            int maxval    = maxvals[rnd() % FF_ARRAY_ELEMS(maxvals)];
+            float rounding = roundings[size & 2 ? 1 : 0];
+            float Q34     = (rnd() & 0xffff) / 4096.0f;
+
+            randomize_float(in, BUF_SIZE);
+            for (i = 0; i < BUF_SIZE; i++)
+                scaled[i] = sqrtf(fabsf(in[i]) * sqrtf(fabsf(in[i])));
+            memset(out0, 0, BUF_SIZE * sizeof(*out0));
+            memset(out1, 0, BUF_SIZE * sizeof(*out1));
+            call_ref(out0, in, scaled, size, Q34, is_signed, maxval, rounding);
+            call_new(out1, in, scaled, size, Q34, is_signed, maxval, rounding);
+            if (memcmp(out0, out1, BUF_SIZE * sizeof(*out0)))
+                fail();
+        }
+        bench_new(out1, in, scaled, BUF_SIZE, 1.0f, 1, 8191, ROUND_STANDARD);
+    }
+}
+
+void checkasm_check_aacencdsp(void)
+{
+    static AACEncContext s;
+
+    s.abs_pow34   = abs_pow34_v;
+    s.quant_bands = quantize_bands;
+    if (ARCH_X86)
+        ff_aac_dsp_init_x86(&s);
+
+    check_abs_pow34(s.abs_pow34);
+    report("abs_pow34");
+
+    check_quant_bands(s.quant_bands);
+    report("quantize_bands");
+}
@@ -20,6 +20,7 @@
  * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
  */
 
+#include <math.h>
 #include <stdarg.h>
 #include <stdio.h>
 #include <stdlib.h>
@@ -27,6 +28,7 @@
 #include "checkasm.h"
 #include "libavutil/common.h"
 #include "libavutil/cpu.h"
+#include "libavutil/intfloat.h"
 #include "libavutil/random_seed.h"
 
 #if HAVE_IO_H
@@ -57,15 +59,70 @@ static const struct {
     const char *name;
     void (*func)(void);
 } tests[] = {
+#if CONFIG_AAC_ENCODER
+    { "aacencdsp", checkasm_check_aacencdsp },
+#endif
 #if CONFIG_BSWAPDSP
     { "bswapdsp", checkasm_check_bswapdsp },
 #endif
+#if CONFIG_DIRAC_DECODER
+    { "dirac_dwt", checkasm_check_dirac_dwt },
+#endif
+#if CONFIG_FFV1_DECODER || CONFIG_FFV1_ENCODER
+    { "ffv1dsp", checkasm_check_ffv1dsp },
+#endif
+#if CONFIG_FMTCONVERT
+    { "fmtconvert", checkasm_check_fmtconvert },
+#endif
 #if CONFIG_H264PRED
     { "h264pred", checkasm_check_h264pred },
 #endif
 #if CONFIG_H264QPEL
     { "h264qpel", checkasm_check_h264qpel },
 #endif
+#if CONFIG_HEVC_DECODER
+    { "hevc_add_res", checkasm_check_hevc_add_res },
+    { "hevc_deblock", checkasm_check_hevc_deblock },
+    { "hevc_idct", checkasm_check_hevc_idct },
+    { "hevc_mc", checkasm_check_hevc_mc },
+    { "hevc_sao", checkasm_check_hevc_sao },
+#endif
+#if CONFIG_IMDCT15
+    { "imdct15", checkasm_check_imdct15 },
+#endif
+#if CONFIG_ME_CMP
+    { "me_cmp", checkasm_check_me_cmp },
+#endif
+#if CONFIG_OPUS_DECODER
+    { "opusdsp", checkasm_check_opusdsp },
+#endif
+#if CONFIG_PNG_ENCODER || CONFIG_APNG_ENCODER
+    { "pngencdsp", checkasm_check_pngencdsp },
+#endif
+#if CONFIG_VP9_DECODER
+    { "vp9dsp", checkasm_check_vp9dsp },
+#endif
+#if CONFIG_AVFILTER
+#if CONFIG_PSNR_FILTER
+    { "vf_psnr", checkasm_check_vf_psnr },
+#endif
+#if CONFIG_REMOVEGRAIN_FILTER
+    { "vf_removegrain", checkasm_check_vf_removegrain },
+#endif
+#if CONFIG_SSIM_FILTER
+    { "vf_ssim", checkasm_check_vf_ssim },
+#endif
+#if CONFIG_YADIF_FILTER
+    { "vf_yadif", checkasm_check_vf_yadif },
+#endif
+#endif
+#if CONFIG_SWRESAMPLE
+    { "sw_resample", checkasm_check_sw_resample },
+#endif
+#if CONFIG_SWSCALE
+    { "sw_scale", checkasm_check_sw_scale },
+#endif
+    { "float_dsp", checkasm_check_float_dsp },
     { NULL }
 };
 
@@ -143,6 +200,72 @@ static struct {
 /* PRNG state */
 AVLFG checkasm_lfg;
 
+static int is_negative(union av_intfloat32 u)
+{
+    return u.i >> 31;
+}
+
+int float_near_ulp(float a, float b, unsigned max_ulp)
+{
+    union av_intfloat32 x, y;
+
+    x.f = a;
+    y.f = b;
+
+    if (is_negative(x) != is_negative(y)) {
+        // handle -0.0 == +0.0
+        return a == b;
+    }
+
+    return llabs((int64_t)x.i - y.i) <= max_ulp;
+}
+
+int float_near_ulp_array(const float *a, const float *b, unsigned max_ulp,
+                         unsigned len)
+{
+    unsigned i;
+
+    for (i = 0; i < len; i++) {
+        if (!float_near_ulp(a[i], b[i], max_ulp))
+            return 0;
+    }
+    return 1;
+}
+
+int float_near_abs_eps(float a, float b, float eps)
+{
+    return fabsf(a - b) < eps;
+}
+
+int float_near_abs_eps_array(const float *a, const float *b, float eps,
+                             unsigned len)
+{
+    unsigned i;
+
+    for (i = 0; i < len; i++) {
+        if (!float_near_abs_eps(a[i], b[i], eps))
+            return 0;
+    }
+    return 1;
+}
+
+int double_near_abs_eps(double a, double b, double eps)
+{
+    return fabs(a - b) < eps;
+}
+
+int double_near_abs_eps_array(const double *a, const double *b, double eps,
+                              unsigned len)
+{
+    unsigned i;
+
+    for (i = 0; i < len; i++) {
+        if (!double_near_abs_eps(a[i], b[i], eps))
+            return 0;
+    }
+    return 1;
+}
+
 /* Print colored text to stderr if the terminal supports it */
 static void color_printf(int color, const char *fmt, ...)
 {
@@ -29,9 +29,30 @@
 #include "libavutil/lfg.h"
 #include "libavutil/timer.h"
 
+void checkasm_check_aacencdsp(void);
 void checkasm_check_bswapdsp(void);
+void checkasm_check_dirac_dwt(void);
+void checkasm_check_ffv1dsp(void);
+void checkasm_check_float_dsp(void);
+void checkasm_check_fmtconvert(void);
 void checkasm_check_h264pred(void);
 void checkasm_check_h264qpel(void);
+void checkasm_check_hevc_add_res(void);
+void checkasm_check_hevc_deblock(void);
+void checkasm_check_hevc_idct(void);
+void checkasm_check_hevc_mc(void);
+void checkasm_check_hevc_sao(void);
+void checkasm_check_imdct15(void);
+void checkasm_check_me_cmp(void);
+void checkasm_check_opusdsp(void);
+void checkasm_check_pngencdsp(void);
+void checkasm_check_sw_resample(void);
+void checkasm_check_sw_scale(void);
+void checkasm_check_vf_psnr(void);
+void checkasm_check_vf_removegrain(void);
+void checkasm_check_vf_ssim(void);
+void checkasm_check_vf_yadif(void);
+void checkasm_check_vp9dsp(void);
 
 void *checkasm_check_func(void *func, const char *name, ...) av_printf_format(2, 3);
 int checkasm_bench_func(void);
@@ -42,6 +63,18 @@ void checkasm_report(const char *name, ...) av_printf_format(1, 2);
 extern AVLFG checkasm_lfg;
 #define rnd() av_lfg_get(&checkasm_lfg)
 
+/* Approximate comparisons of floating point outputs, for SIMD versions
+ * that may round differently than the C code */
+int float_near_ulp(float a, float b, unsigned max_ulp);
+int float_near_abs_eps(float a, float b, float eps);
+int double_near_abs_eps(double a, double b, double eps);
+int float_near_ulp_array(const float *a, const float *b, unsigned max_ulp,
+                         unsigned len);
+int float_near_abs_eps_array(const float *a, const float *b, float eps,
+                             unsigned len);
+int double_near_abs_eps_array(const double *a, const double *b, double eps,
+                              unsigned len);
+
 static av_unused void *func_ref, *func_new;
 
 #define BENCH_RUNS 1000 /* Trade-off between accuracy and speed */
@@ -0,0 +1,156 @@
+/*
+ * This file is part of FFmpeg.
+ *
+ * FFmpeg is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * FFmpeg is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with FFmpeg; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include <string.h>
+#include "checkasm.h"
+#include "libavcodec/dirac_dwt.h"
+#include "libavutil/common.h"
+#include "libavutil/internal.h"
+
+#define WIDTH 512
+#define PAD   16
+
+static const struct {
+    enum dwt_type type;
+    const char *name;
+} wavelets[] = {
+    { DWT_DIRAC_DD9_7,     "dd97"   },
+    { DWT_DIRAC_LEGALL5_3, "legall" },
+    { DWT_DIRAC_DD13_7,    "dd137"  },
+    { DWT_DIRAC_HAAR0,     "haar0"  },
+    { DWT_DIRAC_HAAR1,     "haar1"  },
+    { DWT_DIRAC_FIDELITY,  "fidelity" },
+    { DWT_DIRAC_DAUB9_7,   "daub97" },
+};
+
+/* The SIMD versions do the lifting in 16 bits while the C code widens to
+ * int, so keep the coefficients in a range where no step overflows, as in
+ * real streams. */
+static void randomize_buffer(IDWTELEM *buf, int len)
+{
+    int i;
+    for (i = 0; i < len; i++)
+        buf[i] = (int)(rnd() & 0x3ff) - 512;
+}
+
+/* Runs a vertical lifting step over rows of increasing width. All the
+ * taps are read from random data, only one of the rows is written. */
+#define CHECK_VERTICAL(taps, ...)                                           \
+    do {                                                                    \
+        LOCAL_ALIGNED_32(IDWTELEM, ref, [5 * WIDTH]);                       \
+        LOCAL_ALIGNED_32(IDWTELEM, new, [5 * WIDTH]);                       \
+        IDWTELEM *r[5], *n[5];                                              \
+        int i, w;                                                           \
+                                                                            \
+        declare_func(void, __VA_ARGS__);                                    \
+                                                                            \
+        for (i = 0; i < 5; i++) {                                           \
+            r[i] = ref + i * WIDTH;                                         \
+            n[i] = new + i * WIDTH;                                         \
+        }                                                                   \
+        for (w = 1; w <= WIDTH; w += 1 + (w >> 2)) {                        \
+            randomize_buffer(ref, 5 * WIDTH);                               \
+            memcpy(new, ref, 5 * WIDTH * sizeof(*ref));                     \
+            call_ref(taps(r), w);                                           \
+            call_new(taps(n), w);                                           \
+            if (memcmp(ref, new, 5 * WIDTH * sizeof(*ref)))                 \
+                fail();                                                     \
+        }                                                                   \
+        bench_new(taps(n), WIDTH);                                          \
+    } while (0)
+
+#define TAPS2(b) b[0], b[1]
+#define TAPS3(b) b[0], b[1], b[2]
+#define TAPS5(b) b[0], b[1], b[2], b[3], b[4]
+
+static void check_vertical(void (*vertical)(void), int taps, const char *name,
+                           const char *wavelet)
+{
+    if (!vertical || !check_func(vertical, "dirac_vertical_compose_%s_%s", name, wavelet))
+        return;
+
+    if (taps == 2)
+        CHECK_VERTICAL(TAPS2, IDWTELEM *b0, IDWTELEM *b1, int width);
+    else if (taps == 3)
+        CHECK_VERTICAL(TAPS3, IDWTELEM *b0, IDWTELEM *b1, IDWTELEM *b2, int width);
+    else
+        CHECK_VERTICAL(TAPS5, IDWTELEM *b0, IDWTELEM *b1, IDWTELEM *b2,
+                       IDWTELEM *b3, IDWTELEM *b4, int width);
+}
+
+static void check_horizontal(void (*horizontal)(IDWTELEM *b, IDWTELEM *tmp, int w),
+                             const char *wavelet)
+{
+    LOCAL_ALIGNED_32(IDWTELEM, ref, [WIDTH + 2 * PAD]);
+    LOCAL_ALIGNED_32(IDWTELEM, new, [WIDTH + 2 * PAD]);
+    LOCAL_ALIGNED_32(IDWTELEM, tmp, [WIDTH + 2 * PAD]);
+    int w;
+
+    declare_func(void, IDWTELEM *b, IDWTELEM *tmp, int w);
+
+    if (!check_func(horizontal, "dirac_horizontal_compose_%s", wavelet))
+        return;
+
+    /* the decoder passes even widths and a temp buffer with 8 elements of
+     * margin on both sides */
+    for (w = 2; w <= WIDTH; w += 2 + 2 * (w >> 3)) {
+        randomize_buffer(ref, WIDTH + 2 * PAD);
+        memcpy(new, ref, (WIDTH + 2 * PAD) * sizeof(*ref));
+        call_ref(ref + PAD, tmp + PAD, w);
+        call_new(new + PAD, tmp + PAD, w);
+        if (memcmp(ref, new, (WIDTH + 2 * PAD) * sizeof(*ref)))
+            fail();
+    }
+    bench_new(new + PAD, tmp + PAD, WIDTH);
+}
+
+void checkasm_check_dirac_dwt(void)
+{
+    IDWTELEM buf[4 * 4], tmp[4 + 16];
+    DWTContext d;
+    int i;
+
+    for (i = 0; i < FF_ARRAY_ELEMS(wavelets); i++) {
+        enum dwt_type type = wavelets[i].type;
+        int dd = type == DWT_DIRAC_DD9_7 || type == DWT_DIRAC_DD13_7;
+
+        memset(&d, 0, sizeof(d));
+        if (ff_spatial_idwt_init2(&d, buf, 4, 4, 4, type, 1, tmp) < 0)
+            continue;
+
+        /* the 9 tap filters of the fidelity wavelet are not tested */
+        if (type == DWT_DIRAC_HAAR0 || type == DWT_DIRAC_HAAR1) {
+            check_vertical(d.vertical_compose, 2, "haar", wavelets[i].name);
+        } else if (type != DWT_DIRAC_FIDELITY) {
+            check_vertical(d.vertical_compose_l0, type == DWT_DIRAC_DD13_7 ? 5 : 3,
+                           "l0", wavelets[i].name);
+            check_vertical(d.vertical_compose_h0, dd ? 5 : 3, "h0", wavelets[i].name);
+            check_vertical(d.vertical_compose_l1, 3, "l1", wavelets[i].name);
+            check_vertical(d.vertical_compose_h1, 3, "h1", wavelets[i].name);
+        }
+    }
+    report("vertical_compose");
+
+    for (i = 0; i < FF_ARRAY_ELEMS(wavelets); i++) {
+        memset(&d, 0, sizeof(d));
+        if (ff_spatial_idwt_init2(&d, buf, 4, 4, 4, wavelets[i].type, 1, tmp) < 0)
+            continue;
+        check_horizontal(d.horizontal_compose, wavelets[i].name);
+    }
+    report("horizontal_compose");
+}
@@ -0,0 +1,135 @@
+/*
+ * This file is part of FFmpeg.
+ *
+ * FFmpeg is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * FFmpeg is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with FFmpeg; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include <string.h>
+#include "checkasm.h"
+#include "libavcodec/ffv1dsp.h"
+#include "libavutil/common.h"
+#include "libavutil/internal.h"
+
+#define MAX_WIDTH 1024
+#define PAD       16
+
+/* lines of 16-bit samples with the left and right neighbours valid */
+static void randomize_line(int16_t *line, int mask)
+{
+    int i;
+    for (i = 0; i < MAX_WIDTH + 2 * PAD; i++)
+        line[i] = (int16_t)(rnd() & mask);
+}
+
+/* q[256] is read by the SIMD versions, as in the context tables */
+static void randomize_quant_table(int16_t (*q)[256], int rows)
+{
+    int i;
+    for (i = 0; i < rows * 256 + 16; i++)
+        q[0][i] = (int16_t)(rnd() % 512) - 256;
+}
+
+static void check_context(const FFV1DSPContext *c, int16_t (*quant_table)[256])
+{
+    LOCAL_ALIGNED_32(int16_t, src,   [MAX_WIDTH + 2 * PAD]);
+    LOCAL_ALIGNED_32(int16_t, last,  [MAX_WIDTH + 2 * PAD]);
+    LOCAL_ALIGNED_32(int16_t, last2, [MAX_WIDTH + 2 * PAD]);
+    LOCAL_ALIGNED_32(int32_t, ctx0,  [MAX_WIDTH]);
+    LOCAL_ALIGNED_32(int32_t, ctx1,  [MAX_WIDTH]);
+    int large, w;
+
+    declare_func(void, int32_t *context, const int16_t *a, const int16_t *b,
+                 int16_t (*quant_table)[256], int w, int large);
+
+    for (large = 0; large < 2; large++) {
+        if (check_func(c->context_top, "context_top%s", large ? "_large" : "")) {
+            for (w = 1; w <= MAX_WIDTH; w += 1 + (w >> 2)) {
+                int mask = w & 1 ? 0xFFFF : 0x1FF;
+
+                randomize_line(last,  mask);
+                randomize_line(last2, mask);
+                memset(ctx0, 0, MAX_WIDTH * sizeof(*ctx0));
+                memset(ctx1, 0, MAX_WIDTH * sizeof(*ctx1));
+                call_ref(ctx0, last + PAD, last2 + PAD, quant_table, w, large);
+                call_new(ctx1, last + PAD, last2 + PAD, quant_table, w, large);
+                if (memcmp(ctx0, ctx1, MAX_WIDTH * sizeof(*ctx0)))
+                    fail();
+            }
+            bench_new(ctx1, last + PAD, last2 + PAD, quant_table, MAX_WIDTH, large);
+        }
+
+        if (check_func(c->context_left, "context_left%s", large ? "_large" : "")) {
+            for (w = 1; w <= MAX_WIDTH; w += 1 + (w >> 2)) {
+                int mask = w & 1 ? 0xFFFF : 0x1FF;
+                int i;
+
+                randomize_line(src,  mask);
+                randomize_line(last, mask);
+                for (i = 0; i < MAX_WIDTH; i++)
+                    ctx0[i] = ctx1[i] = rnd() % 1024;
+                call_ref(ctx0, src + PAD, last + PAD, quant_table, w, large);
+                call_new(ctx1, src + PAD, last + PAD, quant_table, w, large);
+                if (memcmp(ctx0, ctx1, MAX_WIDTH * sizeof(*ctx0)))
+                    fail();
+            }
+            bench_new(ctx1, src + PAD, last + PAD, quant_table, MAX_WIDTH, large);
+        }
+    }
+}
+
+static void check_predict_residual(const FFV1DSPContext *c)
+{
+    LOCAL_ALIGNED_32(int16_t, src,   [MAX_WIDTH + 2 * PAD]);
+    LOCAL_ALIGNED_32(int16_t, last,  [MAX_WIDTH + 2 * PAD]);
+    LOCAL_ALIGNED_32(int32_t, diff0, [MAX_WIDTH]);
+    LOCAL_ALIGNED_32(int32_t, diff1, [MAX_WIDTH]);
+    int w;
+
+    declare_func(void, int32_t *diff, const int16_t *src, const int16_t *last,
+                 int w);
+
+    if (check_func(c->predict_residual, "predict_residual")) {
+        for (w = 1; w <= MAX_WIDTH; w += 1 + (w >> 2)) {
+            /* small ranges hit the comparisons of the median more often */
+            int mask = w & 1 ? 0xFFFF : 0x7;
+
+            randomize_line(src,  mask);
+            randomize_line(last, mask);
+            memset(diff0, 0, MAX_WIDTH * sizeof(*diff0));
+            memset(diff1, 0, MAX_WIDTH * sizeof(*diff1));
+            call_ref(diff0, src + PAD, last + PAD, w);
+            call_new(diff1, src + PAD, last + PAD, w);
+            if (memcmp(diff0, diff1, MAX_WIDTH * sizeof(*diff0)))
+                fail();
+        }
+        bench_new(diff1, src + PAD, last + PAD, MAX_WIDTH);
+    }
+}
+
+void checkasm_check_ffv1dsp(void)
+{
+    /* 5 tables as in the FFV1 contexts, plus room for the overread */
+    LOCAL_ALIGNED_32(int16_t, quant_table, [5 + 1][256]);
+    FFV1DSPContext c;
+
+    ff_ffv1dsp_init(&c);
+    randomize_quant_table(quant_table, 5);
+
+    check_context(&c, quant_table);
+    report("context");
+
+    check_predict_residual(&c);
+    report("predict_residual");
+}
@@ -0,0 +1,87 @@
+/*
+ * This file is part of FFmpeg.
+ *
+ * FFmpeg is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * FFmpeg is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with FFmpeg; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include <string.h>
+#include "checkasm.h"
+#include "libavcodec/avcodec.h"
+#include "libavcodec/fmtconvert.h"
+#include "libavutil/internal.h"
+
+#define BUF_SIZE 1024
+
+static void randomize_ints(int32_t *buf, int len)
+{
+    int i;
+
+    for (i = 0; i < len; i++)
+        buf[i] = (int32_t)rnd() >> 8;
+}
+
+static float random_scale(void)
+{
+    return (float)(int)(rnd() % 2001 - 1000) / (1 << 23);
+}
+
+void checkasm_check_fmtconvert(void)
+{
+    LOCAL_ALIGNED_32(int32_t, src, [BUF_SIZE]);
+    LOCAL_ALIGNED_32(float, dst0, [BUF_SIZE]);
+    LOCAL_ALIGNED_32(float, dst1, [BUF_SIZE]);
+    LOCAL_ALIGNED_32(float, mul, [BUF_SIZE / 8]);
+    static const int lens[] = { 8, 16, 64, 256, BUF_SIZE };
+    AVCodecContext avctx = { 0 };
+    FmtConvertContext c;
+    int i;
+
+    ff_fmt_convert_init(&c, &avctx);
+
+    randomize_ints(src, BUF_SIZE);
+    for (i = 0; i < BUF_SIZE / 8; i++)
+        mul[i] = random_scale();
+
+    if (check_func(c.int32_to_float_fmul_scalar, "int32_to_float_fmul_scalar")) {
+        declare_func(void, float *dst, const int32_t *src, float mul, int len);
+
+        for (i = 0; i < FF_ARRAY_ELEMS(lens); i++) {
+            memset(dst0, 0, BUF_SIZE * sizeof(*dst0));
+            memset(dst1, 0, BUF_SIZE * sizeof(*dst1));
+            call_ref(dst0, src, mul[i], lens[i]);
+            call_new(dst1, src, mul[i], lens[i]);
+            if (!float_near_ulp_array(dst0, dst1, 1, BUF_SIZE))
+                fail();
+        }
+        bench_new(dst1, src, mul[0], BUF_SIZE);
+    }
+    report("int32_to_float_fmul_scalar");
+
+    if (check_func(c.int32_to_float_fmul_array8, "int32_to_float_fmul_array8")) {
+        declare_func(void, FmtConvertContext *c, float *dst, const int32_t *src,
+                     const float *mul, int len);
+
+        for (i = 0; i < FF_ARRAY_ELEMS(lens); i++) {
+            memset(dst0, 0, BUF_SIZE * sizeof(*dst0));
+            memset(dst1, 0, BUF_SIZE * sizeof(*dst1));
+            call_ref(&c, dst0, src, mul, lens[i]);
+            call_new(&c, dst1, src, mul, lens[i]);
+            if (!float_near_ulp_array(dst0, dst1, 1, BUF_SIZE))
+                fail();
+        }
+        bench_new(&c, dst1, src, mul, BUF_SIZE);
+    }
+    report("int32_to_float_fmul_array8");
+}
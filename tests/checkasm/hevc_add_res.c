@@ -0,0 +1,76 @@
+/*
+ * This file is part of FFmpeg.
+ *
+ * FFmpeg is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * FFmpeg is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with FFmpeg; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include <string.h>
+#include "checkasm.h"
+#include "libavcodec/hevcdsp.h"
+#include "libavutil/common.h"
+#include "libavutil/internal.h"
+#include "libavutil/intreadwrite.h"
+
+static const uint32_t pixel_mask[3] = { 0xffffffff, 0x03ff03ff, 0x0fff0fff };
+
+#define SIZEOF_PIXEL ((bit_depth + 7) / 8)
+
+#define randomize_buffers()                                 \
+    do {                                                    \
+        uint32_t mask = pixel_mask[(bit_depth - 8) >> 1];   \
+        int k;                                              \
+        for (k = 0; k < 32 * 32; k++)                       \
+            coeffs[k] = (int16_t)rnd() >> 3;                \
+        for (k = 0; k < 32 * 32 * 2; k += 4) {              \
+            uint32_t r = rnd() & mask;                      \
+            AV_WN32A(dst0 + k, r);                          \
+            AV_WN32A(dst1 + k, r);                          \
+        }                                                   \
+    } while (0)
+
+static void check_add_res(HEVCDSPContext *h, int bit_depth)
+{
+    LOCAL_ALIGNED_32(int16_t, coeffs, [32 * 32]);
+    LOCAL_ALIGNED_32(uint8_t, dst0, [32 * 32 * 2]);
+    LOCAL_ALIGNED_32(uint8_t, dst1, [32 * 32 * 2]);
+    int i;
+    declare_func(void, uint8_t *dst, int16_t *coeffs, ptrdiff_t stride);
+
+    for (i = 0; i < 4; i++) {
+        int block_size = 4 << i;
+        ptrdiff_t stride = block_size * SIZEOF_PIXEL;
+
+        if (check_func(h->transform_add[i], "hevc_add_res_%dx%d_%d", block_size, block_size, bit_depth)) {
+            randomize_buffers();
+            call_ref(dst0, coeffs, stride);
+            call_new(dst1, coeffs, stride);
+            if (memcmp(dst0, dst1, sizeof(dst0[0]) * 32 * 32 * 2))
+                fail();
+            bench_new(dst1, coeffs, stride);
+        }
+    }
+}
+
+void checkasm_check_hevc_add_res(void)
+{
+    HEVCDSPContext h;
+    int bit_depth;
+
+    for (bit_depth = 8; bit_depth <= 12; bit_depth += 2) {
+        ff_hevc_dsp_init(&h, bit_depth);
+        check_add_res(&h, bit_depth);
+    }
+    report("add_res");
+}
@@ -0,0 +1,153 @@
+/*
+ * This file is part of FFmpeg.
+ *
+ * FFmpeg is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * FFmpeg is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with FFmpeg; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include <string.h>
+#include "checkasm.h"
+#include "libavcodec/hevcdsp.h"
+#include "libavutil/common.h"
+#include "libavutil/internal.h"
+#include "libavutil/intreadwrite.h"
+
+#define SIZEOF_PIXEL ((bit_depth + 7) / 8)
+#define BUF_STRIDE   (16 * 2)
+#define BUF_SIZE     (BUF_STRIDE * 16)
+
+/* 16x16 pixels with an edge in the middle, made of segments of 4 lines
+ * with a random step across the edge and a little noise, so that every
+ * decision of the filters (none, normal, strong) gets exercised */
+static void randomize_edge(uint8_t *buf0, uint8_t *buf1, int bit_depth, int vertical)
+{
+    int scale = 1 << (bit_depth - 8);
+    int base = 0, step = 0, noise = 0;
+    int line, i;
+
+    memset(buf0, 0, BUF_SIZE);
+    memset(buf1, 0, BUF_SIZE);
+    for (line = 0; line < 16; line++) {
+        if (!(line & 3)) {
+            base  = 64 + rnd() % 128;
+            step  = (int)(rnd() % 33) - 16;
+            noise = rnd() % 3;
+        }
+        for (i = 0; i < 16; i++) {
+            int v   = (base + (i >= 8 ? step : 0) + (int)(rnd() % (2 * noise + 1)) - noise) * scale;
+            int pos = vertical ? line * BUF_STRIDE + i * SIZEOF_PIXEL
+                               : i * BUF_STRIDE + line * SIZEOF_PIXEL;
+            if (bit_depth == 8) {
+                buf0[pos] = buf1[pos] = v;
+            } else {
+                AV_WN16A(buf0 + pos, v);
+                AV_WN16A(buf1 + pos, v);
+            }
+        }
+    }
+}
+
+/* The SIMD versions ignore no_p and no_q; the decoder calls the C
+ * functions directly when PCM or transquant bypass blocks need them. */
+static void randomize_params(int32_t *tc, uint8_t *no_p, uint8_t *no_q)
+{
+    int j;
+
+    for (j = 0; j < 2; j++) {
+        tc[j]   = rnd() % 25;
+        no_p[j] = 0;
+        no_q[j] = 0;
+    }
+}
+
+static void check_deblock_luma(HEVCDSPContext *h, int bit_depth)
+{
+    LOCAL_ALIGNED_32(uint8_t, buf0, [BUF_SIZE]);
+    LOCAL_ALIGNED_32(uint8_t, buf1, [BUF_SIZE]);
+    int32_t tc[2];
+    uint8_t no_p[2], no_q[2];
+    int vertical, k;
+    declare_func(void, uint8_t *pix, ptrdiff_t stride, int beta, int32_t *tc,
+                 uint8_t *no_p, uint8_t *no_q);
+
+    for (vertical = 0; vertical < 2; vertical++) {
+        void (*func)(uint8_t *, ptrdiff_t, int, int32_t *, uint8_t *, uint8_t *) =
+            vertical ? h->hevc_v_loop_filter_luma : h->hevc_h_loop_filter_luma;
+        /* the first pixel of the q side, 8 lines along the edge */
+        int offset = vertical ? 4 * BUF_STRIDE + 8 * SIZEOF_PIXEL
+                              : 8 * BUF_STRIDE + 4 * SIZEOF_PIXEL;
+
+        if (check_func(func, "hevc_%c_loop_filter_luma_%d", vertical ? 'v' : 'h', bit_depth)) {
+            for (k = 0; k < 16; k++) {
+                int beta = rnd() % 65;
+
+                randomize_edge(buf0, buf1, bit_depth, vertical);
+                randomize_params(tc, no_p, no_q);
+                call_ref(buf0 + offset, BUF_STRIDE, beta, tc, no_p, no_q);
+                call_new(buf1 + offset, BUF_STRIDE, beta, tc, no_p, no_q);
+                if (memcmp(buf0, buf1, BUF_SIZE))
+                    fail();
+            }
+            bench_new(buf1 + offset, BUF_STRIDE, 64, tc, no_p, no_q);
+        }
+    }
+}
+
+static void check_deblock_chroma(HEVCDSPContext *h, int bit_depth)
+{
+    LOCAL_ALIGNED_32(uint8_t, buf0, [BUF_SIZE]);
+    LOCAL_ALIGNED_32(uint8_t, buf1, [BUF_SIZE]);
+    int32_t tc[2];
+    uint8_t no_p[2], no_q[2];
+    int vertical, k;
+    declare_func(void, uint8_t *pix, ptrdiff_t stride, int32_t *tc,
+                 uint8_t *no_p, uint8_t *no_q);
+
+    for (vertical = 0; vertical < 2; vertical++) {
+        void (*func)(uint8_t *, ptrdiff_t, int32_t *, uint8_t *, uint8_t *) =
+            vertical ? h->hevc_v_loop_filter_chroma : h->hevc_h_loop_filter_chroma;
+        int offset = vertical ? 4 * BUF_STRIDE + 8 * SIZEOF_PIXEL
+                              : 8 * BUF_STRIDE + 4 * SIZEOF_PIXEL;
+
+        if (check_func(func, "hevc_%c_loop_filter_chroma_%d", vertical ? 'v' : 'h', bit_depth)) {
+            for (k = 0; k < 16; k++) {
+                randomize_edge(buf0, buf1, bit_depth, vertical);
+                randomize_params(tc, no_p, no_q);
+                call_ref(buf0 + offset, BUF_STRIDE, tc, no_p, no_q);
+                call_new(buf1 + offset, BUF_STRIDE, tc, no_p, no_q);
+                if (memcmp(buf0, buf1, BUF_SIZE))
+                    fail();
+            }
+            bench_new(buf1 + offset, BUF_STRIDE, tc, no_p, no_q);
+        }
+    }
+}
+
+void checkasm_check_hevc_deblock(void)
+{
+    HEVCDSPContext h;
+    int bit_depth;
+
+    for (bit_depth = 8; bit_depth <= 12; bit_depth += 2) {
+        ff_hevc_dsp_init(&h, bit_depth);
+        check_deblock_luma(&h, bit_depth);
+    }
+    report("luma");
+
+    for (bit_depth = 8; bit_depth <= 12; bit_depth += 2) {
+        ff_hevc_dsp_init(&h, bit_depth);
+        check_deblock_chroma(&h, bit_depth);
+    }
+    report("chroma");
+}
@@ -0,0 +1,96 @@
+/*
+ * This file is part of FFmpeg.
+ *
+ * FFmpeg is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * FFmpeg is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with FFmpeg; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include <string.h>
+#include "checkasm.h"
+#include "libavcodec/hevcdsp.h"
+#include "libavutil/common.h"
+#include "libavutil/internal.h"
+#include "libavutil/intreadwrite.h"
+
+#define randomize_buffers(buf, size)        \
+    do {                                    \
+        int k;                              \
+        for (k = 0; k < size; k++)          \
+            buf[k] = (int16_t)rnd();        \
+    } while (0)
+
+static void check_idct(HEVCDSPContext *h, int bit_depth)
+{
+    LOCAL_ALIGNED_32(int16_t, coeffs0, [32 * 32]);
+    LOCAL_ALIGNED_32(int16_t, coeffs1, [32 * 32]);
+    int i;
+    declare_func(void, int16_t *coeffs, int col_limit);
+
+    for (i = 0; i < 4; i++) {
+        int block_size = 4 << i;
+        int size       = block_size * block_size;
+
+        if (check_func(h->idct[i], "hevc_idct_%dx%d_%d", block_size, block_size, bit_depth)) {
+            randomize_buffers(coeffs0, size);
+            memcpy(coeffs1, coeffs0, size * sizeof(*coeffs0));
+            /* a col_limit of block_size disables the zero coefficient shortcuts */
+            call_ref(coeffs0, block_size);
+            call_new(coeffs1, block_size);
+            if (memcmp(coeffs0, coeffs1, size * sizeof(*coeffs0)))
+                fail();
+            bench_new(coeffs1, block_size);
+        }
+    }
+}
+
+static void check_idct_dc(HEVCDSPContext *h, int bit_depth)
+{
+    LOCAL_ALIGNED_32(int16_t, coeffs0, [32 * 32]);
+    LOCAL_ALIGNED_32(int16_t, coeffs1, [32 * 32]);
+    int i;
+    declare_func(void, int16_t *coeffs);
+
+    for (i = 0; i < 4; i++) {
+        int block_size = 4 << i;
+        int size       = block_size * block_size;
+
+        if (check_func(h->idct_dc[i], "hevc_idct_%dx%d_dc_%d", block_size, block_size, bit_depth)) {
+            randomize_buffers(coeffs0, size);
+            memcpy(coeffs1, coeffs0, size * sizeof(*coeffs0));
+            call_ref(coeffs0);
+            call_new(coeffs1);
+            if (memcmp(coeffs0, coeffs1, size * sizeof(*coeffs0)))
+                fail();
+            bench_new(coeffs1);
+        }
+    }
+}
+
+void checkasm_check_hevc_idct(void)
+{
+    HEVCDSPContext h;
+    int bit_depth;
+
+    for (bit_depth = 8; bit_depth <= 12; bit_depth += 2) {
+        ff_hevc_dsp_init(&h, bit_depth);
+        check_idct(&h, bit_depth);
+    }
+    report("idct");
+
+    for (bit_depth = 8; bit_depth <= 12; bit_depth += 2) {
+        ff_hevc_dsp_init(&h, bit_depth);
+        check_idct_dc(&h, bit_depth);
+    }
+    report("idct_dc");
+}
@@ -0,0 +1,281 @@
+/*
+ * This file is part of FFmpeg.
+ *
+ * FFmpeg is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * FFmpeg is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with FFmpeg; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include <string.h>
+#include "checkasm.h"
+#include "libavcodec/hevcdsp.h"
+#include "libavutil/common.h"
+#include "libavutil/internal.h"
+#include "libavutil/intreadwrite.h"
+
+static const uint32_t pixel_mask[3] = { 0xffffffff, 0x03ff03ff, 0x0fff0fff };
+static const int widths[10] = { 2, 4, 6, 8, 12, 16, 24, 32, 48, 64 };
+
+#define SIZEOF_PIXEL ((bit_depth + 7) / 8)
+#define SRC_STRIDE   (2 * (MAX_PB_SIZE + 32))
+#define SRC_BUF_SIZE (SRC_STRIDE * (MAX_PB_SIZE + 9))
+/* room for the 3 lines/pixels before the block read by the qpel filters */
+#define SRC_OFFSET   (3 * SRC_STRIDE + 16)
+#define DST_STRIDE   (2 * MAX_PB_SIZE)
+#define DST_BUF_SIZE (DST_STRIDE * MAX_PB_SIZE)
+
+#define randomize_buffers(buf, size, mask)      \
+    do {                                        \
+        int k;                                  \
+        for (k = 0; k < size; k += 4)           \
+            AV_WN32A(buf + k, rnd() & mask);    \
+    } while (0)
+
+static void randomize_src2(int16_t *src2, int bit_depth)
+{
+    int k;
+
+    for (k = 0; k < MAX_PB_SIZE * MAX_PB_SIZE; k++)
+        src2[k] = (rnd() & ((1 << bit_depth) - 1)) << (14 - bit_depth);
+}
+
+#define FRAC(maxfrac, j) ((j) ? 1 + rnd() % (maxfrac) : 0)
+
+static void check_put(void (*func[10][2][2])(int16_t *dst, uint8_t *src, ptrdiff_t srcstride,
+                                             int height, intptr_t mx, intptr_t my, int width),
+                      const char *filter, int maxfrac, int bit_depth)
+{
+    LOCAL_ALIGNED_32(uint8_t, src, [SRC_BUF_SIZE]);
+    LOCAL_ALIGNED_32(int16_t, dst0, [MAX_PB_SIZE * MAX_PB_SIZE]);
+    LOCAL_ALIGNED_32(int16_t, dst1, [MAX_PB_SIZE * MAX_PB_SIZE]);
+    int idx, i, j;
+    declare_func(void, int16_t *dst, uint8_t *src, ptrdiff_t srcstride,
+                 int height, intptr_t mx, intptr_t my, int width);
+
+    for (idx = 0; idx < 10; idx++) {
+        int w = widths[idx];
+        for (j = 0; j < 2; j++) {
+            for (i = 0; i < 2; i++) {
+                if (check_func(func[idx][j][i], "put_hevc_%s_%s%s%d_%d",
+                               filter, j ? "v" : "", i ? "h" : "", w, bit_depth)) {
+                    intptr_t mx = FRAC(maxfrac, i), my = FRAC(maxfrac, j);
+
+                    randomize_buffers(src, SRC_BUF_SIZE, pixel_mask[(bit_depth - 8) >> 1]);
+                    memset(dst0, 0, MAX_PB_SIZE * MAX_PB_SIZE * sizeof(*dst0));
+                    memset(dst1, 0, MAX_PB_SIZE * MAX_PB_SIZE * sizeof(*dst1));
+                    call_ref(dst0, src + SRC_OFFSET, SRC_STRIDE, w, mx, my, w);
+                    call_new(dst1, src + SRC_OFFSET, SRC_STRIDE, w, mx, my, w);
+                    if (memcmp(dst0, dst1, MAX_PB_SIZE * MAX_PB_SIZE * sizeof(*dst0)))
+                        fail();
+                    bench_new(dst1, src + SRC_OFFSET, SRC_STRIDE, w, mx, my, w);
+                }
+            }
+        }
+    }
+}
+
+static void check_put_uni(void (*func[10][2][2])(uint8_t *dst, ptrdiff_t dststride,
+                                                 uint8_t *src, ptrdiff_t srcstride,
+                                                 int height, intptr_t mx, intptr_t my, int width),
+                          const char *filter, int maxfrac, int bit_depth)
+{
+    LOCAL_ALIGNED_32(uint8_t, src, [SRC_BUF_SIZE]);
+    LOCAL_ALIGNED_32(uint8_t, dst0, [DST_BUF_SIZE]);
+    LOCAL_ALIGNED_32(uint8_t, dst1, [DST_BUF_SIZE]);
+    int idx, i, j;
+    declare_func(void, uint8_t *dst, ptrdiff_t dststride, uint8_t *src, ptrdiff_t srcstride,
+                 int height, intptr_t mx, intptr_t my, int width);
+
+    for (idx = 0; idx < 10; idx++) {
+        int w = widths[idx];
+        for (j = 0; j < 2; j++) {
+            for (i = 0; i < 2; i++) {
+                if (check_func(func[idx][j][i], "put_hevc_%s_uni_%s%s%d_%d",
+                               filter, j ? "v" : "", i ? "h" : "", w, bit_depth)) {
+                    intptr_t mx = FRAC(maxfrac, i), my = FRAC(maxfrac, j);
+
+                    randomize_buffers(src, SRC_BUF_SIZE, pixel_mask[(bit_depth - 8) >> 1]);
+                    memset(dst0, 0, DST_BUF_SIZE);
+                    memset(dst1, 0, DST_BUF_SIZE);
+                    call_ref(dst0, DST_STRIDE, src + SRC_OFFSET, SRC_STRIDE, w, mx, my, w);
+                    call_new(dst1, DST_STRIDE, src + SRC_OFFSET, SRC_STRIDE, w, mx, my, w);
+                    if (memcmp(dst0, dst1, DST_BUF_SIZE))
+                        fail();
+                    bench_new(dst1, DST_STRIDE, src + SRC_OFFSET, SRC_STRIDE, w, mx, my, w);
+                }
+            }
+        }
+    }
+}
+
+static void check_put_uni_w(void (*func[10][2][2])(uint8_t *dst, ptrdiff_t dststride,
+                                                   uint8_t *src, ptrdiff_t srcstride,
+                                                   int height, int denom, int wx, int ox,
+                                                   intptr_t mx, intptr_t my, int width),
+                            const char *filter, int maxfrac, int bit_depth)
+{
+    LOCAL_ALIGNED_32(uint8_t, src, [SRC_BUF_SIZE]);
+    LOCAL_ALIGNED_32(uint8_t, dst0, [DST_BUF_SIZE]);
+    LOCAL_ALIGNED_32(uint8_t, dst1, [DST_BUF_SIZE]);
+    int idx, i, j;
+    declare_func(void, uint8_t *dst, ptrdiff_t dststride, uint8_t *src, ptrdiff_t srcstride,
+                 int height, int denom, int wx, int ox, intptr_t mx, intptr_t my, int width);
+
+    for (idx = 0; idx < 10; idx++) {
+        int w = widths[idx];
+        for (j = 0; j < 2; j++) {
+            for (i = 0; i < 2; i++) {
+                if (check_func(func[idx][j][i], "put_hevc_%s_uni_w_%s%s%d_%d",
+                               filter, j ? "v" : "", i ? "h" : "", w, bit_depth)) {
+                    intptr_t mx = FRAC(maxfrac, i), my = FRAC(maxfrac, j);
+                    int denom = rnd() % 8;
+                    int wx    = (int)(rnd() % 256) - 128;
+                    int ox    = (int)(rnd() % 256) - 128;
+
+                    randomize_buffers(src, SRC_BUF_SIZE, pixel_mask[(bit_depth - 8) >> 1]);
+                    memset(dst0, 0, DST_BUF_SIZE);
+                    memset(dst1, 0, DST_BUF_SIZE);
+                    call_ref(dst0, DST_STRIDE, src + SRC_OFFSET, SRC_STRIDE, w, denom, wx, ox, mx, my, w);
+                    call_new(dst1, DST_STRIDE, src + SRC_OFFSET, SRC_STRIDE, w, denom, wx, ox, mx, my, w);
+                    if (memcmp(dst0, dst1, DST_BUF_SIZE))
+                        fail();
+                    bench_new(dst1, DST_STRIDE, src + SRC_OFFSET, SRC_STRIDE, w, denom, wx, ox, mx, my, w);
+                }
+            }
+        }
+    }
+}
+
+static void check_put_bi(void (*func[10][2][2])(uint8_t *dst, ptrdiff_t dststride,
+                                                uint8_t *src, ptrdiff_t srcstride, int16_t *src2,
+                                                int height, intptr_t mx, intptr_t my, int width),
+                         const char *filter, int maxfrac, int bit_depth)
+{
+    LOCAL_ALIGNED_32(uint8_t, src, [SRC_BUF_SIZE]);
+    LOCAL_ALIGNED_32(int16_t, src2, [MAX_PB_SIZE * MAX_PB_SIZE]);
+    LOCAL_ALIGNED_32(uint8_t, dst0, [DST_BUF_SIZE]);
+    LOCAL_ALIGNED_32(uint8_t, dst1, [DST_BUF_SIZE]);
+    int idx, i, j;
+    declare_func(void, uint8_t *dst, ptrdiff_t dststride, uint8_t *src, ptrdiff_t srcstride,
+                 int16_t *src2, int height, intptr_t mx, intptr_t my, int width);
+
+    for (idx = 0; idx < 10; idx++) {
+        int w = widths[idx];
+        for (j = 0; j < 2; j++) {
+            for (i = 0; i < 2; i++) {
+                if (check_func(func[idx][j][i], "put_hevc_%s_bi_%s%s%d_%d",
+                               filter, j ? "v" : "", i ? "h" : "", w, bit_depth)) {
+                    intptr_t mx = FRAC(maxfrac, i), my = FRAC(maxfrac, j);
+
+                    randomize_buffers(src, SRC_BUF_SIZE, pixel_mask[(bit_depth - 8) >> 1]);
+                    randomize_src2(src2, bit_depth);
+                    memset(dst0, 0, DST_BUF_SIZE);
+                    memset(dst1, 0, DST_BUF_SIZE);
+                    call_ref(dst0, DST_STRIDE, src + SRC_OFFSET, SRC_STRIDE, src2, w, mx, my, w);
+                    call_new(dst1, DST_STRIDE, src + SRC_OFFSET, SRC_STRIDE, src2, w, mx, my, w);
+                    if (memcmp(dst0, dst1, DST_BUF_SIZE))
+                        fail();
+                    bench_new(dst1, DST_STRIDE, src + SRC_OFFSET, SRC_STRIDE, src2, w, mx, my, w);
+                }
+            }
+        }
+    }
+}
+
+static void check_put_bi_w(void (*func[10][2][2])(uint8_t *dst, ptrdiff_t dststride,
+                                                  uint8_t *src, ptrdiff_t srcstride, int16_t *src2,
+                                                  int height, int denom, int wx0, int wx1,
+                                                  int ox0, int ox1, intptr_t mx, intptr_t my,
+                                                  int width),
+                           const char *filter, int maxfrac, int bit_depth)
+{
+    LOCAL_ALIGNED_32(uint8_t, src, [SRC_BUF_SIZE]);
+    LOCAL_ALIGNED_32(int16_t, src2, [MAX_PB_SIZE * MAX_PB_SIZE]);
+    LOCAL_ALIGNED_32(uint8_t, dst0, [DST_BUF_SIZE]);
+    LOCAL_ALIGNED_32(uint8_t, dst1, [DST_BUF_SIZE]);
+    int idx, i, j;
+    declare_func(void, uint8_t *dst, ptrdiff_t dststride, uint8_t *src, ptrdiff_t srcstride,
+                 int16_t *src2, int height, int denom, int wx0, int wx1,
+                 int ox0, int ox1, intptr_t mx, intptr_t my, int width);
+
+    for (idx = 0; idx < 10; idx++) {
+        int w = widths[idx];
+        for (j = 0; j < 2; j++) {
+            for (i = 0; i < 2; i++) {
+                if (check_func(func[idx][j][i], "put_hevc_%s_bi_w_%s%s%d_%d",
+                               filter, j ? "v" : "", i ? "h" : "", w, bit_depth)) {
+                    intptr_t mx = FRAC(maxfrac, i), my = FRAC(maxfrac, j);
+                    int denom = rnd() % 8;
+                    int wx0   = (int)(rnd() % 256) - 128;
+                    int wx1   = (int)(rnd() % 256) - 128;
+                    int ox0   = (int)(rnd() % 256) - 128;
+                    int ox1   = (int)(rnd() % 256) - 128;
+
+                    randomize_buffers(src, SRC_BUF_SIZE, pixel_mask[(bit_depth - 8) >> 1]);
+                    randomize_src2(src2, bit_depth);
+                    memset(dst0, 0, DST_BUF_SIZE);
+                    memset(dst1, 0, DST_BUF_SIZE);
+                    call_ref(dst0, DST_STRIDE, src + SRC_OFFSET, SRC_STRIDE, src2,
+                             w, denom, wx0, wx1, ox0, ox1, mx, my, w);
+                    call_new(dst1, DST_STRIDE, src + SRC_OFFSET, SRC_STRIDE, src2,
+                             w, denom, wx0, wx1, ox0, ox1, mx, my, w);
+                    if (memcmp(dst0, dst1, DST_BUF_SIZE))
+                        fail();
+                    bench_new(dst1, DST_STRIDE, src + SRC_OFFSET, SRC_STRIDE, src2,
+                              w, denom, wx0, wx1, ox0, ox1, mx, my, w);
+                }
+            }
+        }
+    }
+}
+
+void checkasm_check_hevc_mc(void)
+{
+    HEVCDSPContext h;
+    int bit_depth;
+
+    for (bit_depth = 8; bit_depth <= 12; bit_depth += 2) {
+        ff_hevc_dsp_init(&h, bit_depth);
+        check_put(h.put_hevc_qpel, "qpel", 3, bit_depth);
+        check_put(h.put_hevc_epel, "epel", 7, bit_depth);
+    }
+    report("put");
+
+    for (bit_depth = 8; bit_depth <= 12; bit_depth += 2) {
+        ff_hevc_dsp_init(&h, bit_depth);
+        check_put_uni(h.put_hevc_qpel_uni, "qpel", 3, bit_depth);
+        check_put_uni(h.put_hevc_epel_uni, "epel", 7, bit_depth);
+    }
+    report("put_uni");
+
+    for (bit_depth = 8; bit_depth <= 12; bit_depth += 2) {
+        ff_hevc_dsp_init(&h, bit_depth);
+        check_put_uni_w(h.put_hevc_qpel_uni_w, "qpel", 3, bit_depth);
+        check_put_uni_w(h.put_hevc_epel_uni_w, "epel", 7, bit_depth);
+    }
+    report("put_uni_w");
+
+    for (bit_depth = 8; bit_depth <= 12; bit_depth += 2) {
+        ff_hevc_dsp_init(&h, bit_depth);
+        check_put_bi(h.put_hevc_qpel_bi, "qpel", 3, bit_depth);
+        check_put_bi(h.put_hevc_epel_bi, "epel", 7, bit_depth);
+    }
+    report("put_bi");
+
+    for (bit_depth = 8; bit_depth <= 12; bit_depth += 2) {
+        ff_hevc_dsp_init(&h, bit_depth);
+        check_put_bi_w(h.put_hevc_qpel_bi_w, "qpel", 3, bit_depth);
+        check_put_bi_w(h.put_hevc_epel_bi_w, "epel", 7, bit_depth);
+    }
+    report("put_bi_w");
+}
@@ -0,0 +1,130 @@
+/*
+ * This file is part of FFmpeg.
+ *
+ * FFmpeg is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * FFmpeg is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with FFmpeg; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include <string.h>
+#include "checkasm.h"
+#include "libavcodec/avcodec.h"
+#include "libavcodec/hevcdsp.h"
+#include "libavutil/common.h"
+#include "libavutil/internal.h"
+#include "libavutil/intreadwrite.h"
+
+static const uint32_t pixel_mask[3] = { 0xffffffff, 0x03ff03ff, 0x0fff0fff };
+static const int sao_size[5] = { 8, 16, 32, 48, 64 };
+
+/* the stride of the source of sao_edge_filter(), in bytes */
+#define SAO_STRIDE (2 * MAX_PB_SIZE + AV_INPUT_BUFFER_PADDING_SIZE)
+#define BUF_SIZE   (SAO_STRIDE * (MAX_PB_SIZE + 3))
+/* first source pixel: one row and a padding worth of bytes into the buffer */
+#define SRC_OFFSET (SAO_STRIDE + AV_INPUT_BUFFER_PADDING_SIZE)
+
+#define randomize_buffers()                                 \
+    do {                                                    \
+        uint32_t mask = pixel_mask[(bit_depth - 8) >> 1];   \
+        int k;                                              \
+        for (k = 0; k < BUF_SIZE; k += 4) {                 \
+            uint32_t r = rnd() & mask;                      \
+            AV_WN32A(src + k, r);                           \
+            r = rnd();                                      \
+            AV_WN32A(dst0 + k, r);                          \
+            AV_WN32A(dst1 + k, r);                          \
+        }                                                   \
+    } while (0)
+
+/* SaoOffsetVal, offset_val[0] being the "no offset" entry */
+static void randomize_offsets(int16_t *offset_val, int bit_depth)
+{
+    int max = (1 << (FFMIN(bit_depth, 10) - 5)) - 1;
+    int k;
+
+    offset_val[0] = 0;
+    for (k = 1; k < 5; k++)
+        offset_val[k] = (int)(rnd() % (2 * max + 1)) - max;
+}
+
+static void check_sao_band(HEVCDSPContext *h, int bit_depth)
+{
+    LOCAL_ALIGNED_32(uint8_t, src,  [BUF_SIZE]);
+    LOCAL_ALIGNED_32(uint8_t, dst0, [BUF_SIZE]);
+    LOCAL_ALIGNED_32(uint8_t, dst1, [BUF_SIZE]);
+    int16_t offset_val[5];
+    int i;
+    declare_func(void, uint8_t *dst, uint8_t *src, ptrdiff_t stride_dst, ptrdiff_t stride_src,
+                 int16_t *sao_offset_val, int sao_left_class, int width, int height);
+
+    for (i = 0; i < 5; i++) {
+        int block_size = sao_size[i];
+
+        if (check_func(h->sao_band_filter[i], "hevc_sao_band_%d_%d", block_size, bit_depth)) {
+            int left_class = rnd() & 31;
+
+            randomize_buffers();
+            randomize_offsets(offset_val, bit_depth);
+            call_ref(dst0, src, SAO_STRIDE, SAO_STRIDE, offset_val, left_class, block_size, block_size);
+            call_new(dst1, src, SAO_STRIDE, SAO_STRIDE, offset_val, left_class, block_size, block_size);
+            if (memcmp(dst0, dst1, BUF_SIZE))
+                fail();
+            bench_new(dst1, src, SAO_STRIDE, SAO_STRIDE, offset_val, left_class, block_size, block_size);
+        }
+    }
+}
+
+static void check_sao_edge(HEVCDSPContext *h, int bit_depth)
+{
+    LOCAL_ALIGNED_32(uint8_t, src,  [BUF_SIZE]);
+    LOCAL_ALIGNED_32(uint8_t, dst0, [BUF_SIZE]);
+    LOCAL_ALIGNED_32(uint8_t, dst1, [BUF_SIZE]);
+    int16_t offset_val[5];
+    int i, eo;
+    declare_func(void, uint8_t *dst, uint8_t *src, ptrdiff_t stride_dst,
+                 int16_t *sao_offset_val, int eo, int width, int height);
+
+    for (i = 0; i < 5; i++) {
+        int block_size = sao_size[i];
+
+        if (check_func(h->sao_edge_filter[i], "hevc_sao_edge_%d_%d", block_size, bit_depth)) {
+            for (eo = 0; eo < 4; eo++) {
+                randomize_buffers();
+                randomize_offsets(offset_val, bit_depth);
+                call_ref(dst0, src + SRC_OFFSET, SAO_STRIDE, offset_val, eo, block_size, block_size);
+                call_new(dst1, src + SRC_OFFSET, SAO_STRIDE, offset_val, eo, block_size, block_size);
+                if (memcmp(dst0, dst1, BUF_SIZE))
+                    fail();
+            }
+            bench_new(dst1, src + SRC_OFFSET, SAO_STRIDE, offset_val, 0, block_size, block_size);
+        }
+    }
+}
+
+void checkasm_check_hevc_sao(void)
+{
+    HEVCDSPContext h;
+    int bit_depth;
+
+    for (bit_depth = 8; bit_depth <= 12; bit_depth += 2) {
+        ff_hevc_dsp_init(&h, bit_depth);
+        check_sao_band(&h, bit_depth);
+    }
+    report("sao_band");
+
+    for (bit_depth = 8; bit_depth <= 12; bit_depth += 2) {
+        ff_hevc_dsp_init(&h, bit_depth);
+        check_sao_edge(&h, bit_depth);
+    }
+    report("sao_edge");
+}
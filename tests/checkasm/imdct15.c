@@ -0,0 +1,94 @@
+/*
+ * This file is part of FFmpeg.
+ *
+ * FFmpeg is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * FFmpeg is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with FFmpeg; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include <string.h>
+#include "checkasm.h"
+#include "libavcodec/imdct15.h"
+#include "libavutil/internal.h"
+
+/* CELT uses 15 * 2^N with N = 3..6, i.e. 2.5 ms to 20 ms frames */
+#define MIN_N    3
+#define MAX_N    6
+#define MAX_LEN2 (15 << MAX_N)
+
+/* the FMA3 versions fuse the products */
+#define EPS 1e-5
+
+#define randomize_buffer(buf, len)                                  \
+    do {                                                            \
+        int i;                                                      \
+        for (i = 0; i < 2 * (len); i++)                             \
+            ((float *)buf)[i] = (rnd() & 0xFFFF) * (2.0f / 0xFFFF) - 1.0f; \
+    } while (0)
+
+static void check_fft_butterflies(IMDCT15Context *s, int n)
+{
+    /* the last step of the 15 * 2^(n - 1) point FFT */
+    int len2 = 15 << (n - 2);
+    LOCAL_ALIGNED_32(FFTComplex, out0, [MAX_LEN2]);
+    LOCAL_ALIGNED_32(FFTComplex, out1, [MAX_LEN2]);
+    declare_func(void, FFTComplex *out, const FFTComplex *exptab, int len2);
+
+    if (check_func(s->fft_butterflies, "imdct15_fft_butterflies_%d", 2 * len2)) {
+        randomize_buffer(out0, 2 * len2);
+        memcpy(out1, out0, 2 * len2 * sizeof(*out0));
+
+        call_ref(out0, s->exptab[n - 1], len2);
+        call_new(out1, s->exptab[n - 1], len2);
+        if (!float_near_abs_eps_array((float *)out0, (float *)out1, EPS, 4 * len2))
+            fail();
+        bench_new(out1, s->exptab[n - 1], len2);
+    }
+}
+
+static void check_postrotate(IMDCT15Context *s)
+{
+    int len8 = s->len4 / 2;
+    LOCAL_ALIGNED_32(FFTComplex, z0, [MAX_LEN2 / 2]);
+    LOCAL_ALIGNED_32(FFTComplex, z1, [MAX_LEN2 / 2]);
+    declare_func(void, FFTComplex *z, const FFTComplex *exptab, float scale,
+                 int len8);
+
+    if (check_func(s->postrotate, "imdct15_postrotate_%d", s->len2)) {
+        float scale = 1.0f / 32768;
+
+        randomize_buffer(z0, 2 * len8);
+        memcpy(z1, z0, 2 * len8 * sizeof(*z0));
+
+        call_ref(z0, s->twiddle_exptab, scale, len8);
+        call_new(z1, s->twiddle_exptab, scale, len8);
+        if (!float_near_abs_eps_array((float *)z0, (float *)z1, EPS * scale, 4 * len8))
+            fail();
+        bench_new(z1, s->twiddle_exptab, scale, len8);
+    }
+}
+
+void checkasm_check_imdct15(void)
+{
+    IMDCT15Context *s;
+    int n;
+
+    for (n = MIN_N; n <= MAX_N; n++) {
+        if (ff_imdct15_init(&s, n) < 0)
+            return;
+        check_fft_butterflies(s, n);
+        check_postrotate(s);
+        ff_imdct15_uninit(&s);
+    }
+    report("imdct15");
+}
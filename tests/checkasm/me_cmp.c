@@ -0,0 +1,129 @@
+/*
+ * This file is part of FFmpeg.
+ *
+ * FFmpeg is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * FFmpeg is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with FFmpeg; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include <string.h>
+#include "checkasm.h"
+#include "libavcodec/avcodec.h"
+#include "libavcodec/me_cmp.h"
+#include "libavutil/common.h"
+#include "libavutil/internal.h"
+
+#define STRIDE 64
+#define HEIGHT 32
+
+static void randomize_buffer(uint8_t *buf, int len, int mask)
+{
+    int i;
+    for (i = 0; i < len; i++)
+        buf[i] = rnd() & mask;
+}
+
+static void check_cmp(me_cmp_func cmp, const char *name)
+{
+    LOCAL_ALIGNED_16(uint8_t, pix1, [STRIDE * HEIGHT]);
+    LOCAL_ALIGNED_16(uint8_t, pix2, [STRIDE * HEIGHT]);
+    int i, h;
+
+    declare_func(int, struct MpegEncContext *c, uint8_t *blk1, uint8_t *blk2,
+                 ptrdiff_t stride, int h);
+
+    for (h = 8; h <= 16; h += 8) {
+        if (!check_func(cmp, "%s_16x%d", name, h))
+            continue;
+        for (i = 0; i < 32; i++) {
+            /* alternate between small and full range differences */
+            int mask = i & 1 ? 0xff : 0x0f;
+            int off  = rnd() % 16;
+
+            randomize_buffer(pix1, STRIDE * HEIGHT, mask);
+            randomize_buffer(pix2, STRIDE * HEIGHT, mask);
+            if (i == 31) {
+                /* largest possible differences */
+                memset(pix1, 0xff, STRIDE * HEIGHT);
+                memset(pix2, 0x00, STRIDE * HEIGHT);
+            }
+            if (call_ref(NULL, pix1, pix2 + off, STRIDE, h) !=
+                call_new(NULL, pix1, pix2 + off, STRIDE, h))
+                fail();
+        }
+        bench_new(NULL, pix1, pix2 + 1, STRIDE, h);
+    }
+}
+
+static void check_cmp_x4(me_cmp_x4_func cmp, const char *name)
+{
+    LOCAL_ALIGNED_16(uint8_t, pix1, [STRIDE * HEIGHT]);
+    LOCAL_ALIGNED_16(uint8_t, pix2, [STRIDE * HEIGHT]);
+    int scores0[4], scores1[4];
+    int i, h;
+
+    declare_func(void, struct MpegEncContext *c, uint8_t *blk1,
+                 uint8_t *const blk2[4], ptrdiff_t stride, int h,
+                 int scores[4]);
+
+    for (h = 8; h <= 16; h += 8) {
+        if (!check_func(cmp, "%s_16x%d", name, h))
+            continue;
+        for (i = 0; i < 32; i++) {
+            uint8_t *const cand[4] = {
+                pix2 + rnd() % 32, pix2 + rnd() % 32,
+                pix2 + rnd() % 32 + STRIDE, pix2 + rnd() % 32 + STRIDE,
+            };
+
+            randomize_buffer(pix1, STRIDE * HEIGHT, 0xff);
+            randomize_buffer(pix2, STRIDE * HEIGHT, 0xff);
+            call_ref(NULL, pix1, cand, STRIDE, h, scores0);
+            call_new(NULL, pix1, cand, STRIDE, h, scores1);
+            if (memcmp(scores0, scores1, sizeof(scores0)))
+                fail();
+        }
+        {
+            uint8_t *const cand[4] = { pix2, pix2 + 1, pix2 + 2, pix2 + 3 };
+            bench_new(NULL, pix1, cand, STRIDE, h, scores1);
+        }
+    }
+}
+
+void checkasm_check_me_cmp(void)
+{
+    AVCodecContext avctx = { 0 };
+    MECmpContext c;
+    static const char *const pix_abs_names[4] = {
+        "pix_abs", "pix_abs_x2", "pix_abs_y2", "pix_abs_xy2"
+    };
+    int i;
+
+    /* the approximate xy2 SAD versions are only used without bitexact */
+    avctx.flags |= AV_CODEC_FLAG_BITEXACT;
+    ff_me_cmp_init_static();
+    ff_me_cmp_init(&c, &avctx);
+
+    for (i = 0; i < 4; i++)
+        check_cmp(c.pix_abs[0][i], pix_abs_names[i]);
+    report("pix_abs");
+
+    check_cmp(c.sad[0], "sad");
+    check_cmp_x4(c.sad_x4[0], "sad_x4");
+    report("sad");
+
+    check_cmp(c.sse[0], "sse");
+    report("sse");
+
+    check_cmp(c.hadamard8_diff[0], "hadamard8_diff");
+    report("hadamard8_diff");
+}
@@ -0,0 +1,158 @@
+/*
+ * This file is part of FFmpeg.
+ *
+ * FFmpeg is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * FFmpeg is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with FFmpeg; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include <string.h>
+#include "checkasm.h"
+#include "libavcodec/opus.h"
+#include "libavcodec/opusdsp.h"
+#include "libavutil/internal.h"
+
+/* the postfilter runs on frame->buf + 1024 + 2 * CELT_OVERLAP with up to
+ * 1024 samples of history, on at most 960 - 2 * CELT_OVERLAP samples */
+#define MAX_PERIOD 1024
+#define MAX_LEN    (CELT_MAX_FRAME_SIZE - 2 * CELT_OVERLAP)
+#define BUF_SIZE   (MAX_PERIOD + 2 + MAX_LEN + 2)
+
+/* the FMA3 version fuses the products, and later outputs read back earlier
+ * ones for short periods */
+#define EPS 1e-5
+
+#define randomize_buffer(buf)                                       \
+    do {                                                            \
+        int i;                                                      \
+        for (i = 0; i < BUF_SIZE; i++)                              \
+            buf[i] = (rnd() & 0xFFFF) * (2.0f / 0xFFFF) - 1.0f;     \
+    } while (0)
+
+static void check_postfilter(void)
+{
+    /* the gains the decoder can produce, see parse_postfilter() */
+    static const float postfilter_taps[3][3] = {
+        { 0.3066406250f, 0.2170410156f, 0.1296386719f },
+        { 0.4638671875f, 0.2680664062f, 0.0           },
+        { 0.7998046875f, 0.1000976562f, 0.0           }
+    };
+    /* 10 ms and 20 ms frames, plus odd lengths for the scalar tail */
+    static const int lens[] = { 480 - 2 * CELT_OVERLAP, MAX_LEN, 37, 5 };
+    LOCAL_ALIGNED_32(float, data0, [BUF_SIZE]);
+    LOCAL_ALIGNED_32(float, data1, [BUF_SIZE]);
+    OpusDSPContext dsp;
+    float gains[3], gain;
+    int i, j, tapset;
+    declare_func(void, float *data, int period, const float *gains, int len);
+
+    ff_opus_dsp_init(&dsp);
+
+    if (check_func(dsp.postfilter, "postfilter")) {
+        for (i = 0; i < FF_ARRAY_ELEMS(lens); i++) {
+            int period = CELT_POSTFILTER_MINPERIOD + rnd() % (MAX_PERIOD - 2 - CELT_POSTFILTER_MINPERIOD);
+            float *dst0 = data0 + MAX_PERIOD + 2;
+            float *dst1 = data1 + MAX_PERIOD + 2;
+
+            if (i == 0)
+                period = CELT_POSTFILTER_MINPERIOD;
+            gain   = 0.09375f * (rnd() % 8 + 1);
+            tapset = rnd() % 3;
+            for (j = 0; j < 3; j++)
+                gains[j] = gain * postfilter_taps[tapset][j];
+
+            randomize_buffer(data0);
+            memcpy(data1, data0, BUF_SIZE * sizeof(*data0));
+
+            call_ref(dst0, period, gains, lens[i]);
+            call_new(dst1, period, gains, lens[i]);
+            if (!float_near_abs_eps_array(data0, data1, EPS, BUF_SIZE))
+                fail();
+            bench_new(dst1, period, gains, lens[i]);
+        }
+    }
+
+    report("postfilter");
+}
+
+/* the longest CELT band, 22 bins at 20 ms, and lengths with a scalar tail */
+static const int band_lens[] = { 176, 96, 37, 8, 3, 1 };
+#define MAX_BAND 176
+
+static void check_normalize_residual(void)
+{
+    LOCAL_ALIGNED_16(float, X0, [MAX_BAND]);
+    LOCAL_ALIGNED_16(float, X1, [MAX_BAND]);
+    LOCAL_ALIGNED_16(int,   iy, [MAX_BAND]);
+    OpusDSPContext dsp;
+    int i, j;
+    declare_func(void, float *X, const int *iy, float g, int N);
+
+    ff_opus_dsp_init(&dsp);
+
+    if (check_func(dsp.normalize_residual, "normalize_residual")) {
+        for (i = 0; i < FF_ARRAY_ELEMS(band_lens); i++) {
+            float g = (rnd() & 0xFFFF) * (1.0f / 0xFFFF) + 0.01f;
+
+            for (j = 0; j < MAX_BAND; j++)
+                iy[j] = (int)(rnd() % 257) - 128;
+            memset(X0, 0, sizeof(*X0) * MAX_BAND);
+            memset(X1, 0, sizeof(*X1) * MAX_BAND);
+
+            call_ref(X0, iy, g, band_lens[i]);
+            call_new(X1, iy, g, band_lens[i]);
+            if (memcmp(X0, X1, sizeof(*X0) * MAX_BAND))
+                fail();
+            bench_new(X1, iy, g, band_lens[i]);
+        }
+    }
+
+    report("normalize_residual");
+}
+
+static void check_scale_band(void)
+{
+    LOCAL_ALIGNED_16(float, X0, [MAX_BAND + 1]);
+    LOCAL_ALIGNED_16(float, X1, [MAX_BAND + 1]);
+    OpusDSPContext dsp;
+    int i, j;
+    declare_func(void, float *X, float g, int N);
+
+    ff_opus_dsp_init(&dsp);
+
+    if (check_func(dsp.scale_band, "scale_band")) {
+        for (i = 0; i < FF_ARRAY_ELEMS(band_lens); i++) {
+            float g = (rnd() & 0xFFFF) * (64.0f / 0xFFFF);
+
+            for (j = 0; j < MAX_BAND + 1; j++)
+                X0[j] = (rnd() & 0xFFFF) * (2.0f / 0xFFFF) - 1.0f;
+            memcpy(X1, X0, sizeof(*X0) * (MAX_BAND + 1));
+
+            /* the bands start at any bin */
+            call_ref(X0 + 1, g, band_lens[i]);
+            call_new(X1 + 1, g, band_lens[i]);
+            if (memcmp(X0, X1, sizeof(*X0) * (MAX_BAND + 1)))
+                fail();
+            bench_new(X1 + 1, g, band_lens[i]);
+        }
+    }
+
+    report("scale_band");
+}
+
+void checkasm_check_opusdsp(void)
+{
+    check_postfilter();
+    check_normalize_residual();
+    check_scale_band();
+}
@@ -0,0 +1,105 @@
+/*
+ * This file is part of FFmpeg.
+ *
+ * FFmpeg is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * FFmpeg is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with FFmpeg; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include <string.h>
+#include "checkasm.h"
+#include "libavcodec/pngencdsp.h"
+#include "libavutil/common.h"
+#include "libavutil/internal.h"
+#include "libavutil/intreadwrite.h"
+
+#define BUF_SIZE 1024
+#define PAD      16
+
+static void randomize_buffer(uint8_t *buf, int len, int mask)
+{
+    int i;
+    for (i = 0; i < len; i++)
+        buf[i] = rnd() & mask;
+}
+
+static void check_prediction(void (*pred)(uint8_t *dst, const uint8_t *src,
+                                          const uint8_t *top, int w, int bpp),
+                             const char *name)
+{
+    LOCAL_ALIGNED_16(uint8_t, src, [BUF_SIZE + PAD]);
+    LOCAL_ALIGNED_16(uint8_t, top, [BUF_SIZE + PAD]);
+    LOCAL_ALIGNED_16(uint8_t, dst0, [BUF_SIZE]);
+    LOCAL_ALIGNED_16(uint8_t, dst1, [BUF_SIZE]);
+    static const int bpps[] = { 1, 2, 3, 4, 6, 8 };
+    int i, w;
+
+    declare_func(void, uint8_t *dst, const uint8_t *src,
+                 const uint8_t *top, int w, int bpp);
+
+    for (i = 0; i < FF_ARRAY_ELEMS(bpps); i++) {
+        int bpp = bpps[i];
+
+        if (!check_func(pred, "%s_%d", name, bpp))
+            continue;
+        for (w = 1; w < BUF_SIZE; w += 1 + (w >> 3)) {
+            /* small ranges hit the comparisons of the Paeth predictor
+             * more often than full range noise */
+            int mask = w & 1 ? 0xff : 0x07;
+
+            randomize_buffer(src, BUF_SIZE + PAD, mask);
+            randomize_buffer(top, BUF_SIZE + PAD, mask);
+            memset(dst0, 0, BUF_SIZE);
+            memset(dst1, 0, BUF_SIZE);
+            call_ref(dst0, src + PAD, top + PAD, w, bpp);
+            call_new(dst1, src + PAD, top + PAD, w, bpp);
+            if (memcmp(dst0, dst1, BUF_SIZE))
+                fail();
+        }
+        bench_new(dst1, src + PAD, top + PAD, BUF_SIZE - PAD, bpp);
+    }
+}
+
+static void check_filter_cost(int (*cost)(const uint8_t *buf, int size))
+{
+    LOCAL_ALIGNED_16(uint8_t, buf, [BUF_SIZE + 1]);
+    int size;
+
+    declare_func(int, const uint8_t *buf, int size);
+
+    if (check_func(cost, "filter_cost")) {
+        for (size = 0; size <= BUF_SIZE; size += 1 + (size >> 3)) {
+            randomize_buffer(buf, BUF_SIZE + 1, 0xff);
+            /* the filter type byte comes first, so buf + 1 is aligned */
+            if (call_ref(buf + 1, size) != call_new(buf + 1, size))
+                fail();
+        }
+        bench_new(buf + 1, BUF_SIZE);
+    }
+}
+
+void checkasm_check_pngencdsp(void)
+{
+    PNGEncDSPContext c;
+
+    ff_pngencdsp_init(&c);
+
+    check_prediction(c.sub_avg_prediction, "sub_avg_prediction");
+    report("sub_avg_prediction");
+
+    check_prediction(c.sub_paeth_prediction, "sub_paeth_prediction");
+    report("sub_paeth_prediction");
+
+    check_filter_cost(c.filter_cost);
+    report("filter_cost");
+}
@@ -0,0 +1,289 @@
+/*
+ * This file is part of FFmpeg.
+ *
+ * FFmpeg is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * FFmpeg is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with FFmpeg; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+
+#include <float.h>
+#include <string.h>
+#include "checkasm.h"
+#include "libavutil/channel_layout.h"
+#include "libavutil/common.h"
+#include "libavutil/internal.h"
+#include "libavutil/mem.h"
+#include "libavutil/opt.h"
+#include "libswresample/swresample.h"
+#include "libswresample/swresample_internal.h"
+#include "libswresample/resample.h"
+
+#define LEN     256
+#define SRC_LEN (2 * LEN + 128)
+
+static const enum AVSampleFormat sample_fmts[] = {
+    AV_SAMPLE_FMT_S16P, AV_SAMPLE_FMT_FLTP, AV_SAMPLE_FMT_DBLP,
+};
+
+static SwrContext *alloc_swr(enum AVSampleFormat fmt,
+                             int64_t out_layout, int out_rate,
+                             int64_t in_layout, int in_rate, int linear)
+{
+    SwrContext *s = swr_alloc_set_opts(NULL, out_layout, fmt, out_rate,
+                                       in_layout, fmt, in_rate, 0, NULL);
+    if (!s)
+        return NULL;
+    av_opt_set_sample_fmt(s, "internal_sample_fmt", fmt, 0);
+    av_opt_set_int(s, "linear_interp", linear, 0);
+    if (swr_init(s) < 0)
+        swr_free(&s);
+    return s;
+}
+
+static void randomize_samples(uint8_t *buf, enum AVSampleFormat fmt, int len)
+{
+    int i;
+
+    for (i = 0; i < len; i++) {
+        switch (fmt) {
+        case AV_SAMPLE_FMT_S16P:
+            ((int16_t *)buf)[i] = rnd();
+            break;
+        case AV_SAMPLE_FMT_FLTP:
+            ((float *)buf)[i]   = (int)(rnd() % 65536 - 32768) / 32768.0f;
+            break;
+        case AV_SAMPLE_FMT_DBLP:
+            ((double *)buf)[i]  = (int)(rnd() % 65536 - 32768) / 32768.0;
+            break;
+        }
+    }
+}
+
+static int samples_near(const uint8_t *a, const uint8_t *b,
+                        enum AVSampleFormat fmt, int max_diff, int len)
+{
+    int i;
+
+    switch (fmt) {
+    case AV_SAMPLE_FMT_S16P:
+        for (i = 0; i < len; i++)
+            if (FFABS(((const int16_t *)a)[i] - ((const int16_t *)b)[i]) > max_diff)
+                return 0;
+        return 1;
+    case AV_SAMPLE_FMT_FLTP:
+        return float_near_abs_eps_array((const float *)a, (const float *)b,
+                                        FLT_EPSILON * 64, len);
+    case AV_SAMPLE_FMT_DBLP:
+        return double_near_abs_eps_array((const double *)a, (const double *)b,
+                                         DBL_EPSILON * 64, len);
+    }
+    return 0;
+}
+
+/* The SIMD mix functions read their coefficients from native_simd_matrix,
+ * which has a different layout than the C native_matrix; route the reference
+ * through the context the C functions belong to. */
+static SwrContext *mix_ctx;
+
+static void mix_1_1_c(void *out, const void *in, void *coeffp,
+                      integer index, integer len)
+{
+    mix_ctx->mix_1_1_f(out, in, mix_ctx->native_matrix, index, len);
+}
+
+static void mix_2_1_c(void *out, const void *in1, const void *in2,
+                      void *coeffp, integer index1, integer index2, integer len)
+{
+    mix_ctx->mix_2_1_f(out, in1, in2, mix_ctx->native_matrix,
+                       index1, index2, len);
+}
+
+static void check_rematrix(void)
+{
+    LOCAL_ALIGNED_32(uint8_t, in1, [LEN * sizeof(double)]);
+    LOCAL_ALIGNED_32(uint8_t, in2, [LEN * sizeof(double)]);
+    LOCAL_ALIGNED_32(uint8_t, inn, [8], [LEN * sizeof(double)]);
+    LOCAL_ALIGNED_32(uint8_t, dst0, [LEN * sizeof(double)]);
+    LOCAL_ALIGNED_32(uint8_t, dst1, [LEN * sizeof(double)]);
+    int i;
+
+    for (i = 0; i < FF_ARRAY_ELEMS(sample_fmts); i++) {
+        enum AVSampleFormat fmt = sample_fmts[i];
+        const char *name = av_get_sample_fmt_name(fmt);
+        int bps = av_get_bytes_per_sample(fmt);
+        /* the int16 SIMD matrix is requantized to 16-bit coefficients */
+        int max_diff = fmt == AV_SAMPLE_FMT_S16P;
+        SwrContext *s = alloc_swr(fmt, AV_CH_LAYOUT_STEREO, 48000,
+                                  AV_CH_LAYOUT_5POINT1, 48000, 0);
+        int num, index1, index2;
+
+        if (!s) {
+            fail();
+            continue;
+        }
+        mix_ctx = s;
+        num     = 6 * 2;
+        index1  = rnd() % num;
+        index2  = rnd() % num;
+
+        randomize_samples(in1, fmt, LEN);
+        randomize_samples(in2, fmt, LEN);
+
+        if (check_func(s->mix_1_1_simd ? s->mix_1_1_simd : mix_1_1_c,
+                       "mix_1_1_%s", name)) {
+            declare_func(void, void *out, const void *in, void *coeffp,
+                         integer index, integer len);
+
+            memset(dst0, 0, LEN * bps);
+            memset(dst1, 0, LEN * bps);
+            call_ref(dst0, in1, s->native_simd_matrix, index1, LEN);
+            call_new(dst1, in1, s->native_simd_matrix, index1, LEN);
+            if (!samples_near(dst0, dst1, fmt, max_diff, LEN))
+                fail();
+            bench_new(dst1, in1, s->native_simd_matrix, index1, LEN);
+        }
+
+        if (check_func(s->mix_2_1_simd ? s->mix_2_1_simd : mix_2_1_c,
+                       "mix_2_1_%s", name)) {
+            declare_func(void, void *out, const void *in1, const void *in2,
+                         void *coeffp, integer index1, integer index2,
+                         integer len);
+
+            memset(dst0, 0, LEN * bps);
+            memset(dst1, 0, LEN * bps);
+            call_ref(dst0, in1, in2, s->native_simd_matrix, index1, index2, LEN);
+            call_new(dst1, in1, in2, s->native_simd_matrix, index1, index2, LEN);
+            if (!samples_near(dst0, dst1, fmt, max_diff, LEN))
+                fail();
+            bench_new(dst1, in1, in2, s->native_simd_matrix, index1, index2, LEN);
+        }
+
+        swr_free(&s);
+    }
+
+    /* mono downmix of 7.1, every output sample sums more than 2 inputs */
+    for (i = 0; i < FF_ARRAY_ELEMS(sample_fmts); i++) {
+        enum AVSampleFormat fmt = sample_fmts[i];
+        const char *name = av_get_sample_fmt_name(fmt);
+        int bps = av_get_bytes_per_sample(fmt);
+        SwrContext *s = alloc_swr(fmt, AV_CH_LAYOUT_MONO, 48000,
+                                  AV_CH_LAYOUT_7POINT1, 48000, 0);
+        const uint8_t *in[8];
+        const void *coeffp;
+        int ch;
+
+        if (!s) {
+            fail();
+            continue;
+        }
+        if (fmt == AV_SAMPLE_FMT_S16P)
+            coeffp = s->matrix32[0];
+        else
+            coeffp = s->native_matrix;
+        for (ch = 0; ch < 8; ch++) {
+            randomize_samples(inn[ch], fmt, LEN);
+            in[ch] = inn[ch];
+        }
+
+        if (check_func(s->mix_n_1_simd ? s->mix_n_1_simd : s->mix_n_1_f,
+                       "mix_n_1_%s", name)) {
+            declare_func(void, void *out, const uint8_t **in,
+                         const void *coeffp, const uint8_t *ch, integer len);
+
+            memset(dst0, 0, LEN * bps);
+            memset(dst1, 0, LEN * bps);
+            call_ref(dst0, in, coeffp, s->matrix_ch[0], LEN);
+            call_new(dst1, in, coeffp, s->matrix_ch[0], LEN);
+            if (memcmp(dst0, dst1, LEN * bps))
+                fail();
+            bench_new(dst1, in, coeffp, s->matrix_ch[0], LEN);
+        }
+
+        swr_free(&s);
+    }
+    report("rematrix");
+}
+
+static void check_resample(void)
+{
+    LOCAL_ALIGNED_32(uint8_t, src, [SRC_LEN * sizeof(double)]);
+    LOCAL_ALIGNED_32(uint8_t, dst0, [LEN * sizeof(double)]);
+    LOCAL_ALIGNED_32(uint8_t, dst1, [LEN * sizeof(double)]);
+    static const int rates[][2] = {
+        { 44100, 48000 }, { 48000, 32000 },
+    };
+    int i, j, linear;
+
+    for (linear = 0; linear < 2; linear++) {
+        for (i = 0; i < FF_ARRAY_ELEMS(sample_fmts); i++) {
+            enum AVSampleFormat fmt = sample_fmts[i];
+            const char *name = av_get_sample_fmt_name(fmt);
+            int bps = av_get_bytes_per_sample(fmt);
+
+            randomize_samples(src, fmt, SRC_LEN);
+
+            for (j = 0; j < FF_ARRAY_ELEMS(rates); j++) {
+                SwrContext *s = alloc_swr(fmt, AV_CH_LAYOUT_MONO, rates[j][1],
+                                          AV_CH_LAYOUT_MONO, rates[j][0],
+                                          linear);
+                ResampleContext *c;
+
+                if (!s || !s->resample) {
+                    fail();
+                    swr_free(&s);
+                    continue;
+                }
+                c = s->resample;
+                /* swr starts with a negative index and relies on the delay
+                 * samples it keeps in front of src; there are none here */
+                c->index = 0;
+                c->frac  = 0;
+
+                if (check_func(c->dsp.resample, "resample_%s_%s_%d_%d",
+                               linear ? "linear" : "common", name,
+                               rates[j][0], rates[j][1])) {
+                    declare_func(int, ResampleContext *c, void *dst,
+                                 const void *src, int n, int update_ctx);
+                    int ret0, ret1, index0, frac0;
+
+                    /* the asm only returns the consumed sample count when
+                     * it updates the context, so compare that state too */
+                    memset(dst0, 0, LEN * bps);
+                    memset(dst1, 0, LEN * bps);
+                    ret0   = call_ref(c, dst0, src, LEN, 1);
+                    index0 = c->index;
+                    frac0  = c->frac;
+                    c->index = 0;
+                    c->frac  = 0;
+                    ret1 = call_new(c, dst1, src, LEN, 1);
+                    if (ret0 != ret1 || index0 != c->index || frac0 != c->frac ||
+                        !samples_near(dst0, dst1, fmt, 0, LEN))
+                        fail();
+                    c->index = 0;
+                    c->frac  = 0;
+                    bench_new(c, dst1, src, LEN, 0);
+                }
+
+                swr_free(&s);
+            }
+        }
+        report(linear ? "resample_linear" : "resample_common");
+    }
+}
+
+void checkasm_check_sw_resample(void)
+{
+    check_rematrix();
+    check_resample();
+}
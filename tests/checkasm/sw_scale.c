@@ -0,0 +1,218 @@
+/*
+ * This file is part of FFmpeg.
+ *
+ * FFmpeg is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * FFmpeg is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with FFmpeg; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include <string.h>
+#include "checkasm.h"
+#include "libavutil/common.h"
+#include "libavutil/internal.h"
+#include "libavutil/intreadwrite.h"
+#include "libavutil/mem.h"
+#include "libavutil/pixdesc.h"
+#include "libswscale/swscale.h"
+#include "libswscale/swscale_internal.h"
+
+#define WIDTH 1920
+/* SWS_ACCURATE_RND keeps the output functions bit-exact with the C code;
+ * SWS_FULL_CHR_H_INP gives the full resolution chroma input functions */
+#define SWS_FLAGS (SWS_BILINEAR | SWS_ACCURATE_RND | SWS_FULL_CHR_H_INP)
+
+static const int widths[] = { 8, 24, 123, 512, WIDTH };
+
+static const uint8_t dither[8] = { 0, 48, 12, 60, 3, 51, 15, 63 };
+
+/* 15-bit intermediates, or 19-bit ones for 16-bit output */
+static void randomize_intermediate(int16_t *buf, int len, int bpc)
+{
+    int i;
+
+    for (i = 0; i < len; i++) {
+        if (bpc > 14)
+            ((int32_t *)buf)[i] = rnd() & 0x7ffff;
+        else
+            buf[i] = rnd() & 0x7fff;
+    }
+}
+
+static void check_yuv2plane1(SwsContext *c, const char *fmt)
+{
+    LOCAL_ALIGNED_32(int16_t, src, [WIDTH * 2]);
+    LOCAL_ALIGNED_32(uint8_t, dst0, [WIDTH * 2]);
+    LOCAL_ALIGNED_32(uint8_t, dst1, [WIDTH * 2]);
+    int i, offset;
+    declare_func(void, const int16_t *src, uint8_t *dest, int dstW,
+                 const uint8_t *dither, int offset);
+
+    if (!check_func(c->yuv2plane1, "yuv2plane1_%s", fmt))
+        return;
+
+    randomize_intermediate(src, WIDTH, c->dstBpc);
+    for (i = 0; i < FF_ARRAY_ELEMS(widths); i++) {
+        for (offset = 0; offset < 8; offset += 3) {
+            memset(dst0, 0, WIDTH * 2);
+            memset(dst1, 0, WIDTH * 2);
+            call_ref(src, dst0, widths[i], dither, offset);
+            call_new(src, dst1, widths[i], dither, offset);
+            if (memcmp(dst0, dst1, WIDTH * 2))
+                fail();
+        }
+    }
+    bench_new(src, dst1, WIDTH, dither, 0);
+}
+
+static void check_yuv2planeX(SwsContext *c, const char *fmt)
+{
+    static const int filter_sizes[] = { 2, 3, 4, 8, 16 };
+    LOCAL_ALIGNED_32(int16_t, lines, [16 * WIDTH * 2]);
+    LOCAL_ALIGNED_32(int16_t, filter, [16]);
+    LOCAL_ALIGNED_32(uint8_t, dst0, [WIDTH * 2]);
+    LOCAL_ALIGNED_32(uint8_t, dst1, [WIDTH * 2]);
+    const int16_t *src[16];
+    int i, j, k;
+    declare_func(void, const int16_t *filter, int filterSize,
+                 const int16_t **src, uint8_t *dest, int dstW,
+                 const uint8_t *dither, int offset);
+
+    if (!check_func(c->yuv2planeX, "yuv2planeX_%s", fmt))
+        return;
+
+    randomize_intermediate(lines, 16 * WIDTH, c->dstBpc);
+    for (j = 0; j < 16; j++)
+        src[j] = lines + j * WIDTH * (c->dstBpc > 14 ? 2 : 1);
+
+    for (k = 0; k < FF_ARRAY_ELEMS(filter_sizes); k++) {
+        int size = filter_sizes[k], sum = 0;
+
+        /* 12-bit coefficients summing up to 4096, as initFilter() makes them */
+        for (j = 0; j < size - 1; j++) {
+            filter[j] = (int)(rnd() % (2 * 4096 / size)) - 4096 / (2 * size);
+            sum += filter[j];
+        }
+        filter[size - 1] = 4096 - sum;
+
+        for (i = 0; i < FF_ARRAY_ELEMS(widths); i++) {
+            memset(dst0, 0, WIDTH * 2);
+            memset(dst1, 0, WIDTH * 2);
+            call_ref(filter, size, src, dst0, widths[i], dither, 0);
+            call_new(filter, size, src, dst1, widths[i], dither, 0);
+            if (memcmp(dst0, dst1, WIDTH * 2))
+                fail();
+        }
+    }
+    bench_new(filter, 4, src, dst1, WIDTH, dither, 0);
+}
+
+static void check_output(void)
+{
+    static const enum AVPixelFormat dst_fmts[] = {
+        AV_PIX_FMT_YUV420P, AV_PIX_FMT_YUV420P9LE,
+        AV_PIX_FMT_YUV420P10LE, AV_PIX_FMT_YUV420P16LE,
+    };
+    int i;
+
+    for (i = 0; i < FF_ARRAY_ELEMS(dst_fmts); i++) {
+        const char *fmt = av_get_pix_fmt_name(dst_fmts[i]);
+        SwsContext *c = sws_getContext(WIDTH, 16, AV_PIX_FMT_YUV420P,
+                                       WIDTH, 16, dst_fmts[i],
+                                       SWS_FLAGS, NULL, NULL, NULL);
+        if (!c) {
+            fprintf(stderr, "sw_scale: cannot create a context for %s\n", fmt);
+            continue;
+        }
+        check_yuv2plane1(c, fmt);
+        check_yuv2planeX(c, fmt);
+        sws_freeContext(c);
+    }
+    report("output");
+}
+
+static void check_input(void)
+{
+    static const enum AVPixelFormat src_fmts[] = {
+        AV_PIX_FMT_YUYV422, AV_PIX_FMT_UYVY422, AV_PIX_FMT_NV12, AV_PIX_FMT_NV21,
+        AV_PIX_FMT_RGB24, AV_PIX_FMT_BGR24, AV_PIX_FMT_RGBA, AV_PIX_FMT_BGRA,
+        AV_PIX_FMT_ARGB, AV_PIX_FMT_ABGR,
+    };
+    LOCAL_ALIGNED_32(uint8_t, src, [WIDTH * 8]);
+    LOCAL_ALIGNED_32(uint8_t, dst0, [WIDTH * 4]);
+    LOCAL_ALIGNED_32(uint8_t, dst1, [WIDTH * 4]);
+    LOCAL_ALIGNED_32(uint8_t, dst2, [WIDTH * 4]);
+    LOCAL_ALIGNED_32(uint8_t, dst3, [WIDTH * 4]);
+    int i, j;
+
+    for (i = 0; i < WIDTH * 8; i++)
+        src[i] = rnd();
+
+    for (i = 0; i < FF_ARRAY_ELEMS(src_fmts); i++) {
+        const char *fmt = av_get_pix_fmt_name(src_fmts[i]);
+        SwsContext *c = sws_getContext(WIDTH, 16, src_fmts[i],
+                                       WIDTH, 16, AV_PIX_FMT_YUV444P,
+                                       SWS_FLAGS, NULL, NULL, NULL);
+        uint32_t *pal;
+        /* packed YUV and NV12 give 8-bit samples, RGB 15-bit ones; the SIMD
+         * versions may write whole vectors past the width */
+        int bps = isAnyRGB(src_fmts[i]) ? 2 : 1;
+
+        if (!c) {
+            fprintf(stderr, "sw_scale: cannot create a context for %s\n", fmt);
+            continue;
+        }
+        /* the same table the scaler passes to the input functions */
+        pal = usePal(c->srcFormat) ? c->pal_yuv : (uint32_t *)c->input_rgb2yuv_table;
+
+        if (c->lumToYV12 && check_func(c->lumToYV12, "%s_to_y", fmt)) {
+            declare_func(void, uint8_t *dst, const uint8_t *src, const uint8_t *src2,
+                         const uint8_t *src3, int width, uint32_t *pal);
+
+            for (j = 0; j < FF_ARRAY_ELEMS(widths); j++) {
+                memset(dst0, 0, WIDTH * 4);
+                memset(dst1, 0, WIDTH * 4);
+                call_ref(dst0, src, src, src, widths[j], pal);
+                call_new(dst1, src, src, src, widths[j], pal);
+                if (memcmp(dst0, dst1, widths[j] * bps))
+                    fail();
+            }
+            bench_new(dst1, src, src, src, WIDTH, pal);
+        }
+
+        if (c->chrToYV12 && check_func(c->chrToYV12, "%s_to_uv", fmt)) {
+            declare_func(void, uint8_t *dstU, uint8_t *dstV, const uint8_t *src1,
+                         const uint8_t *src2, const uint8_t *src3, int width, uint32_t *pal);
+
+            for (j = 0; j < FF_ARRAY_ELEMS(widths); j++) {
+                memset(dst0, 0, WIDTH * 4);
+                memset(dst1, 0, WIDTH * 4);
+                memset(dst2, 0, WIDTH * 4);
+                memset(dst3, 0, WIDTH * 4);
+                call_ref(dst0, dst2, src, src, src, widths[j], pal);
+                call_new(dst1, dst3, src, src, src, widths[j], pal);
+                if (memcmp(dst0, dst1, widths[j] * bps) ||
+                    memcmp(dst2, dst3, widths[j] * bps))
+                    fail();
+            }
+            bench_new(dst1, dst3, src, src, src, WIDTH, pal);
+        }
+        sws_freeContext(c);
+    }
+    report("input");
+}
+
+void checkasm_check_sw_scale(void)
+{
+    check_output();
+    check_input();
+}
@@ -0,0 +1,62 @@
+/*
+ * This file is part of FFmpeg.
+ *
+ * FFmpeg is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * FFmpeg is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with FFmpeg; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include <string.h>
+#include "checkasm.h"
+#include "libavfilter/psnr.h"
+#include "libavutil/internal.h"
+#include "libavutil/intreadwrite.h"
+
+#define WIDTH 1920
+
+static void randomize_line(uint8_t *buf, int bpp)
+{
+    int i;
+
+    for (i = 0; i < WIDTH; i++) {
+        if (bpp == 8)
+            buf[i] = rnd();
+        else
+            AV_WN16A(buf + 2 * i, rnd() & ((1 << bpp) - 1));
+    }
+}
+
+void checkasm_check_vf_psnr(void)
+{
+    static const int bpps[] = { 8, 10, 16 };
+    static const int widths[] = { 1, 7, 16, 33, 100, WIDTH };
+    LOCAL_ALIGNED_32(uint8_t, buf, [WIDTH * 2]);
+    LOCAL_ALIGNED_32(uint8_t, ref, [WIDTH * 2]);
+    PSNRDSPContext dsp;
+    int i, j;
+    declare_func(uint64_t, const uint8_t *buf, const uint8_t *ref, int w);
+
+    for (i = 0; i < FF_ARRAY_ELEMS(bpps); i++) {
+        ff_psnr_init(&dsp, bpps[i]);
+        if (check_func(dsp.sse_line, "sse_line_%d", bpps[i])) {
+            randomize_line(buf, bpps[i]);
+            randomize_line(ref, bpps[i]);
+            for (j = 0; j < FF_ARRAY_ELEMS(widths); j++) {
+                if (call_ref(buf, ref, widths[j]) != call_new(buf, ref, widths[j]))
+                    fail();
+            }
+            bench_new(buf, ref, WIDTH);
+        }
+    }
+    report("sse_line");
+}
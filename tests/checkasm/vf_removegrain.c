@@ -0,0 +1,74 @@
+/*
+ * This file is part of FFmpeg.
+ *
+ * FFmpeg is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * FFmpeg is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with FFmpeg; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include <string.h>
+#include "checkasm.h"
+#include "libavfilter/removegrain.h"
+#include "libavutil/internal.h"
+
+#define WIDTH  1024
+#define STRIDE (WIDTH + 32)
+
+static int (*rg_ref)(int c, int a1, int a2, int a3, int a4, int a5, int a6, int a7, int a8);
+
+/* The filter only has per-pixel C functions; apply them to a line the way
+ * filter_slice() does, as the reference for the line functions. */
+static void removegrain_line_c(uint8_t *dst, uint8_t *src, ptrdiff_t stride, int pixels)
+{
+    int x;
+
+    for (x = 0; x < pixels; x++) {
+        dst[x] = rg_ref(src[x],
+                        src[x - stride - 1], src[x - stride], src[x - stride + 1],
+                        src[x - 1], src[x + 1],
+                        src[x + stride - 1], src[x + stride], src[x + stride + 1]);
+    }
+}
+
+void checkasm_check_vf_removegrain(void)
+{
+    LOCAL_ALIGNED_32(uint8_t, src,  [STRIDE * 3]);
+    LOCAL_ALIGNED_32(uint8_t, dst0, [STRIDE]);
+    LOCAL_ALIGNED_32(uint8_t, dst1, [STRIDE]);
+    RemoveGrainContext s = { 0 };
+    int mode, i;
+    declare_func(void, uint8_t *dst, uint8_t *src, ptrdiff_t stride, int pixels);
+
+    for (i = 0; i < STRIDE * 3; i++)
+        src[i] = rnd();
+
+    s.nb_planes = 1;
+    for (mode = 1; mode <= 24; mode++) {
+        s.mode[0] = mode;
+        s.fl[0]   = NULL;
+        ff_removegrain_init(&s);
+        rg_ref = s.rg[0];
+
+        /* pixel 1 of the middle line, as filter_slice() passes it */
+        if (check_func(s.fl[0] ? s.fl[0] : removegrain_line_c, "rg_fl_mode_%d", mode)) {
+            memset(dst0, 0, STRIDE);
+            memset(dst1, 0, STRIDE);
+            call_ref(dst0 + 1, src + STRIDE + 1, STRIDE, WIDTH - 16);
+            call_new(dst1 + 1, src + STRIDE + 1, STRIDE, WIDTH - 16);
+            if (memcmp(dst0, dst1, STRIDE))
+                fail();
+            bench_new(dst1 + 1, src + STRIDE + 1, STRIDE, WIDTH - 16);
+        }
+    }
+    report("fl");
+}
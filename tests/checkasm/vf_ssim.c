@@ -0,0 +1,87 @@
+/*
+ * This file is part of FFmpeg.
+ *
+ * FFmpeg is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * FFmpeg is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with FFmpeg; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include <string.h>
+#include "checkasm.h"
+#include "libavfilter/ssim.h"
+#include "libavutil/common.h"
+#include "libavutil/internal.h"
+
+#define WIDTH  1920
+#define STRIDE (WIDTH + 32)
+
+/* a reference plane and a slightly distorted copy of it */
+static void randomize_planes(uint8_t *buf, uint8_t *ref)
+{
+    int i;
+
+    for (i = 0; i < STRIDE * 8; i++) {
+        ref[i]  = rnd();
+        buf[i] = av_clip_uint8(ref[i] + (int)(rnd() % 17) - 8);
+    }
+}
+
+void checkasm_check_vf_ssim(void)
+{
+    static const int widths[] = { 1, 3, 8, 17, WIDTH / 4 };
+    LOCAL_ALIGNED_32(uint8_t, buf, [STRIDE * 8]);
+    LOCAL_ALIGNED_32(uint8_t, ref,  [STRIDE * 8]);
+    LOCAL_ALIGNED_32(int, sums0, [(WIDTH / 4 + 3) * 4]);
+    LOCAL_ALIGNED_32(int, sums1, [(WIDTH / 4 + 3) * 4]);
+    SSIMDSPContext dsp;
+    int i;
+
+    ff_ssim_init(&dsp);
+    randomize_planes(buf, ref);
+
+    if (check_func(dsp.ssim_4x4_line, "ssim_4x4_line")) {
+        declare_func(void, const uint8_t *buf, ptrdiff_t buf_stride,
+                     const uint8_t *ref, ptrdiff_t ref_stride,
+                     int (*sums)[4], int w);
+
+        for (i = 0; i < FF_ARRAY_ELEMS(widths); i++) {
+            memset(sums0, 0, sizeof(*sums0) * (WIDTH / 4 + 3) * 4);
+            memset(sums1, 0, sizeof(*sums1) * (WIDTH / 4 + 3) * 4);
+            call_ref(buf, STRIDE, ref, STRIDE, (int (*)[4])sums0, widths[i]);
+            call_new(buf, STRIDE, ref, STRIDE, (int (*)[4])sums1, widths[i]);
+            /* the SIMD versions may write a few blocks past w */
+            if (memcmp(sums0, sums1, sizeof(*sums0) * widths[i] * 4))
+                fail();
+        }
+        bench_new(buf, STRIDE, ref, STRIDE, (int (*)[4])sums1, WIDTH / 4);
+    }
+    report("ssim_4x4_line");
+
+    if (check_func(dsp.ssim_end_line, "ssim_end_line")) {
+        declare_func(float, const int (*sum0)[4], const int (*sum1)[4], int w);
+
+        /* sums of two consecutive rows of 4x4 blocks, as the filter uses them */
+        dsp.ssim_4x4_line(buf, STRIDE, ref, STRIDE, (int (*)[4])sums0, WIDTH / 4);
+        dsp.ssim_4x4_line(buf + 4 * STRIDE, STRIDE, ref + 4 * STRIDE, STRIDE,
+                          (int (*)[4])sums1, WIDTH / 4);
+        for (i = 0; i < FF_ARRAY_ELEMS(widths); i++) {
+            int w = FFMAX(widths[i] - 1, 1);
+            float ssim0 = call_ref((const int (*)[4])sums0, (const int (*)[4])sums1, w);
+            float ssim1 = call_new((const int (*)[4])sums0, (const int (*)[4])sums1, w);
+            if (!float_near_abs_eps(ssim0, ssim1, 1e-5 * w))
+                fail();
+        }
+        bench_new((const int (*)[4])sums0, (const int (*)[4])sums1, WIDTH / 4 - 1);
+    }
+    report("ssim_end_line");
+}
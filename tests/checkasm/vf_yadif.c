@@ -0,0 +1,94 @@
+/*
+ * This file is part of FFmpeg.
+ *
+ * FFmpeg is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * FFmpeg is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with FFmpeg; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include <string.h>
+#include "checkasm.h"
+#include "libavfilter/yadif.h"
+#include "libavutil/internal.h"
+#include "libavutil/intreadwrite.h"
+#include "libavutil/pixdesc.h"
+
+#define WIDTH    512
+#define MAX_ALIGN 8
+/* 5 lines, the one being interpolated in the middle */
+#define BUF_SIZE (5 * WIDTH * 2)
+
+static void randomize_frame(uint8_t *buf, int depth)
+{
+    int i;
+
+    for (i = 0; i < 5 * WIDTH; i++) {
+        if (depth == 8)
+            buf[i] = rnd();
+        else
+            AV_WN16A(buf + 2 * i, rnd() & ((1 << depth) - 1));
+    }
+}
+
+void checkasm_check_vf_yadif(void)
+{
+    static const enum AVPixelFormat pix_fmts[] = {
+        AV_PIX_FMT_YUV420P, AV_PIX_FMT_YUV420P10, AV_PIX_FMT_YUV420P16
+    };
+    LOCAL_ALIGNED_32(uint8_t, prev, [BUF_SIZE]);
+    LOCAL_ALIGNED_32(uint8_t, cur,  [BUF_SIZE]);
+    LOCAL_ALIGNED_32(uint8_t, next, [BUF_SIZE]);
+    LOCAL_ALIGNED_32(uint8_t, dst0, [WIDTH * 2]);
+    LOCAL_ALIGNED_32(uint8_t, dst1, [WIDTH * 2]);
+    YADIFContext s = { 0 };
+    int i, mode, parity;
+    declare_func(void, void *dst, void *prev, void *cur, void *next,
+                 int w, int prefs, int mrefs, int parity, int mode);
+
+    for (i = 0; i < FF_ARRAY_ELEMS(pix_fmts); i++) {
+        s.csp = av_pix_fmt_desc_get(pix_fmts[i]);
+        ff_yadif_init(&s);
+
+        if (check_func(s.filter_line, "yadif_filter_line_%d", s.csp->comp[0].depth_minus1 + 1)) {
+            int depth = s.csp->comp[0].depth_minus1 + 1;
+            int df    = (depth + 7) / 8;
+            int refs  = WIDTH * df;
+            /* the same offsets and width as the filter itself uses */
+            int pix_3 = 3 * df;
+            int line  = 2 * refs + pix_3;
+            int w     = WIDTH - (3 + MAX_ALIGN / df - 1);
+
+            randomize_frame(prev, depth);
+            randomize_frame(cur,  depth);
+            randomize_frame(next, depth);
+
+            for (mode = 0; mode < 4; mode++) {
+                for (parity = 0; parity < 2; parity++) {
+                    memset(dst0, 0, WIDTH * 2);
+                    memset(dst1, 0, WIDTH * 2);
+                    call_ref(dst0 + pix_3, prev + line, cur + line, next + line,
+                             w, refs, -refs, parity, mode);
+                    call_new(dst1 + pix_3, prev + line, cur + line, next + line,
+                             w, refs, -refs, parity, mode);
+                    /* the SIMD versions write whole vectors past w; the
+                     * filter overwrites those pixels with filter_edges */
+                    if (memcmp(dst0 + pix_3, dst1 + pix_3, w * df))
+                        fail();
+                }
+            }
+            bench_new(dst1 + pix_3, prev + line, cur + line, next + line,
+                      w, refs, -refs, 0, 0);
+        }
+    }
+    report("filter_line");
+}
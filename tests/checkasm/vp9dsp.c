@@ -0,0 +1,387 @@
+/*
+ * This file is part of FFmpeg.
+ *
+ * FFmpeg is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * FFmpeg is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with FFmpeg; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include <math.h>
+#include <string.h>
+#include "checkasm.h"
+#include "libavcodec/vp9dsp.h"
+#include "libavutil/common.h"
+#include "libavutil/internal.h"
+#include "libavutil/intreadwrite.h"
+#include "libavutil/mathematics.h"
+
+static const uint32_t pixel_mask[3] = { 0xffffffff, 0x03ff03ff, 0x0fff0fff };
+#define SIZEOF_PIXEL ((bit_depth + 7) / 8)
+
+#define randomize_buffers(buf, size, mask)      \
+    do {                                        \
+        int k;                                  \
+        for (k = 0; k < size; k += 4)           \
+            AV_WN32A(buf + k, rnd() & mask);    \
+    } while (0)
+
+static void set_pixel(uint8_t *buf, int pos, int v, int bit_depth)
+{
+    if (bit_depth == 8)
+        buf[pos] = v;
+    else
+        AV_WN16A(buf + pos * 2, v);
+}
+
+static void check_ipred(void)
+{
+    static const char *const mode_names[N_INTRA_PRED_MODES] = {
+        [VERT_PRED]            = "vert",
+        [HOR_PRED]             = "hor",
+        [DC_PRED]              = "dc",
+        [DIAG_DOWN_LEFT_PRED]  = "diag_downleft",
+        [DIAG_DOWN_RIGHT_PRED] = "diag_downright",
+        [VERT_RIGHT_PRED]      = "vert_right",
+        [HOR_DOWN_PRED]        = "hor_down",
+        [VERT_LEFT_PRED]       = "vert_left",
+        [HOR_UP_PRED]          = "hor_up",
+        [TM_VP8_PRED]          = "tm",
+        [LEFT_DC_PRED]         = "dc_left",
+        [TOP_DC_PRED]          = "dc_top",
+        [DC_128_PRED]          = "dc_128",
+        [DC_127_PRED]          = "dc_127",
+        [DC_129_PRED]          = "dc_129",
+    };
+    LOCAL_ALIGNED_32(uint8_t, edges, [2 * 64 * 2 + 64]);
+    LOCAL_ALIGNED_32(uint8_t, dst0, [32 * 32 * 2]);
+    LOCAL_ALIGNED_32(uint8_t, dst1, [32 * 32 * 2]);
+    VP9DSPContext dsp;
+    int bit_depth, tx, mode;
+    declare_func(void, uint8_t *dst, ptrdiff_t stride,
+                 const uint8_t *left, const uint8_t *top);
+
+    for (bit_depth = 8; bit_depth <= 12; bit_depth += 2) {
+        /* left: 2 * 32 pixels, then top[-1] and top: 2 * 32 pixels */
+        const uint8_t *left = edges;
+        const uint8_t *top  = edges + 64 * 2 + 64;
+
+        ff_vp9dsp_init(&dsp, bit_depth);
+        for (tx = 0; tx < N_TXFM_SIZES; tx++) {
+            int size = 4 << tx;
+            ptrdiff_t stride = 32 * SIZEOF_PIXEL;
+
+            for (mode = 0; mode < N_INTRA_PRED_MODES; mode++) {
+                if (check_func(dsp.intra_pred[tx][mode], "vp9_%s_%dx%d_%d",
+                               mode_names[mode], size, size, bit_depth)) {
+                    randomize_buffers(edges, sizeof(edges[0]) * (2 * 64 * 2 + 64),
+                                      pixel_mask[(bit_depth - 8) >> 1]);
+                    randomize_buffers(dst0, 32 * 32 * 2, pixel_mask[(bit_depth - 8) >> 1]);
+                    memcpy(dst1, dst0, 32 * 32 * 2);
+                    call_ref(dst0, stride, left, top);
+                    call_new(dst1, stride, left, top);
+                    if (memcmp(dst0, dst1, 32 * 32 * 2))
+                        fail();
+                    bench_new(dst1, stride, left, top);
+                }
+            }
+        }
+    }
+    report("ipred");
+}
+
+/* inverse basis functions of the VP9 transforms, with the gain of the
+ * integer implementations */
+static double basis(int adst, int n, int k, int size)
+{
+    if (!adst)
+        return (k ? 1.0 : M_SQRT1_2) * cos(M_PI * (2 * n + 1) * k / (2.0 * size));
+    if (size == 4)
+        return 2.0 * M_SQRT2 / 3.0 * sin(M_PI * (n + 1) * (2 * k + 1) / 9.0);
+    return sin(M_PI * (2 * n + 1) * (2 * k + 1) / (4.0 * size));
+}
+
+/* forward transform of a random residual, so that the coefficients are
+ * in the range a real bitstream would produce */
+static void random_coeffs(int32_t *coef, int tx, int txtp, int bit_depth)
+{
+    static const int bits[N_TXFM_SIZES] = { 4, 5, 6, 6 };
+    int size = 4 << tx;
+    double res[32][32], tmp[32][32];
+    double scale = (1 << bits[tx]) * (2.0 / size) * (2.0 / size);
+    int range = 1 << (bit_depth - 1);
+    int x, y, m, k;
+
+    for (y = 0; y < size; y++)
+        for (x = 0; x < size; x++)
+            res[y][x] = (int)(rnd() % (2 * range + 1)) - range;
+
+    /* horizontal frequencies are the first index of the block */
+    for (y = 0; y < size; y++)
+        for (m = 0; m < size; m++) {
+            double sum = 0;
+            for (x = 0; x < size; x++)
+                sum += basis(txtp & 1, x, m, size) * res[y][x];
+            tmp[y][m] = sum;
+        }
+    for (m = 0; m < size; m++)
+        for (k = 0; k < size; k++) {
+            double sum = 0;
+            for (y = 0; y < size; y++)
+                sum += basis(txtp & 2, y, k, size) * tmp[y][m];
+            coef[m * size + k] = lrint(sum * scale);
+        }
+}
+
+static void copy_coeffs(int16_t *dst, const int32_t *src, int n, int bit_depth)
+{
+    int i;
+
+    for (i = 0; i < n; i++) {
+        if (bit_depth == 8)
+            dst[i] = av_clip_int16(src[i]);
+        else
+            ((int32_t *)dst)[i] = src[i];
+    }
+}
+
+static void check_itxfm(void)
+{
+    static const char *const txtp_names[N_TXFM_TYPES] = {
+        "dct_dct", "idct_iadst", "iadst_idct", "iadst_iadst"
+    };
+    LOCAL_ALIGNED_32(int32_t, coef, [32 * 32]);
+    LOCAL_ALIGNED_32(int16_t, block0, [32 * 32 * 2]);
+    LOCAL_ALIGNED_32(int16_t, block1, [32 * 32 * 2]);
+    LOCAL_ALIGNED_32(uint8_t, dst0, [32 * 32 * 2]);
+    LOCAL_ALIGNED_32(uint8_t, dst1, [32 * 32 * 2]);
+    VP9DSPContext dsp;
+    int bit_depth, tx, txtp, dconly;
+    declare_func(void, uint8_t *dst, ptrdiff_t stride, int16_t *block, int eob);
+
+    for (bit_depth = 8; bit_depth <= 12; bit_depth += 2) {
+        int coef_size = bit_depth == 8 ? 2 : 4;
+
+        ff_vp9dsp_init(&dsp, bit_depth);
+        for (tx = 0; tx <= N_TXFM_SIZES; tx++) {
+            int size = tx == N_TXFM_SIZES ? 4 : 4 << tx;
+            ptrdiff_t stride = 32 * SIZEOF_PIXEL;
+            /* 32x32 and lossless use the same transform for every type */
+            int nb_txtp = tx >= TX_32X32 ? 1 : N_TXFM_TYPES;
+
+            for (txtp = 0; txtp < nb_txtp; txtp++) {
+                if (!check_func(dsp.itxfm_add[tx][txtp], "vp9_inv_%s_%dx%d_add_%d",
+                                tx == N_TXFM_SIZES ? "wht_wht" : txtp_names[txtp],
+                                size, size, bit_depth))
+                    continue;
+
+                for (dconly = 0; dconly < 2; dconly++) {
+                    int eob = dconly ? 1 : size * size;
+                    int i;
+
+                    if (tx == N_TXFM_SIZES) {
+                        int range = 1 << (bit_depth - 2);
+                        for (i = 0; i < 16; i++)
+                            coef[i] = (int)(rnd() % (2 * range + 1)) - range;
+                    } else {
+                        random_coeffs(coef, tx, txtp, bit_depth);
+                    }
+                    if (dconly)
+                        memset(coef + 1, 0, (size * size - 1) * sizeof(*coef));
+
+                    copy_coeffs(block0, coef, size * size, bit_depth);
+                    memcpy(block1, block0, size * size * coef_size);
+                    randomize_buffers(dst0, 32 * 32 * 2, pixel_mask[(bit_depth - 8) >> 1]);
+                    memcpy(dst1, dst0, 32 * 32 * 2);
+                    call_ref(dst0, stride, block0, eob);
+                    call_new(dst1, stride, block1, eob);
+                    if (memcmp(dst0, dst1, 32 * 32 * 2) ||
+                        memcmp(block0, block1, size * size * coef_size))
+                        fail();
+                }
+
+                copy_coeffs(block1, coef, size * size, bit_depth);
+                bench_new(dst1, stride, block1, size * size);
+            }
+        }
+    }
+    report("itxfm");
+}
+
+/* 32x32 pixels around an edge in the middle, made of lines with a random
+ * step across the edge and a little noise, so that the flat, hev and
+ * normal paths of the filters are all taken */
+static void randomize_loopfilter_buffers(uint8_t *buf0, uint8_t *buf1,
+                                         int bit_depth, int dir)
+{
+    int scale = 1 << (bit_depth - 8);
+    int base = 0, step = 0, noise = 0;
+    int line, i;
+
+    for (line = 0; line < 32; line++) {
+        if (!(line & 3)) {
+            base  = 64 + rnd() % 128;
+            step  = (int)(rnd() % 33) - 16;
+            noise = rnd() % 3;
+        }
+        for (i = 0; i < 32; i++) {
+            int v   = (base + (i >= 16 ? step : 0) + (int)(rnd() % (2 * noise + 1)) - noise) * scale;
+            int pos = dir ? i * 32 + line : line * 32 + i;
+            set_pixel(buf0, pos, v, bit_depth);
+            set_pixel(buf1, pos, v, bit_depth);
+        }
+    }
+}
+
+static void check_loopfilter(void)
+{
+    static const char *const dir_names[2] = { "h", "v" };
+    static const int wd_list[3] = { 4, 8, 16 };
+    LOCAL_ALIGNED_32(uint8_t, buf0, [32 * 32 * 2]);
+    LOCAL_ALIGNED_32(uint8_t, buf1, [32 * 32 * 2]);
+    VP9DSPContext dsp;
+    int bit_depth, dir, wd, wd2, k;
+    declare_func(void, uint8_t *dst, ptrdiff_t stride, int E, int I, int H);
+
+    for (bit_depth = 8; bit_depth <= 12; bit_depth += 2) {
+        ptrdiff_t stride = 32 * SIZEOF_PIXEL;
+
+        ff_vp9dsp_init(&dsp, bit_depth);
+        for (dir = 0; dir < 2; dir++) {
+            /* the first pixel of the q side of the edge */
+            int offset = dir ? 16 * stride : 16 * SIZEOF_PIXEL;
+
+            for (wd = 0; wd < 3; wd++) {
+                if (check_func(dsp.loop_filter_8[wd][dir], "vp9_loop_filter_%s_%d_8_%d",
+                               dir_names[dir], wd_list[wd], bit_depth)) {
+                    for (k = 0; k < 8; k++) {
+                        int I = 1 + rnd() % 63;
+                        int E = 2 * (2 + rnd() % 64) + I;
+                        int H = rnd() % 4;
+
+                        randomize_loopfilter_buffers(buf0, buf1, bit_depth, dir);
+                        call_ref(buf0 + offset, stride, E, I, H);
+                        call_new(buf1 + offset, stride, E, I, H);
+                        if (memcmp(buf0, buf1, 32 * 32 * SIZEOF_PIXEL))
+                            fail();
+                    }
+                    bench_new(buf1 + offset, stride, 193, 63, 3);
+                }
+            }
+
+            if (check_func(dsp.loop_filter_16[dir], "vp9_loop_filter_%s_16_16_%d",
+                           dir_names[dir], bit_depth)) {
+                for (k = 0; k < 8; k++) {
+                    int I = 1 + rnd() % 63;
+                    int E = 2 * (2 + rnd() % 64) + I;
+                    int H = rnd() % 4;
+
+                    randomize_loopfilter_buffers(buf0, buf1, bit_depth, dir);
+                    call_ref(buf0 + offset, stride, E, I, H);
+                    call_new(buf1 + offset, stride, E, I, H);
+                    if (memcmp(buf0, buf1, 32 * 32 * SIZEOF_PIXEL))
+                        fail();
+                }
+                bench_new(buf1 + offset, stride, 193, 63, 3);
+            }
+
+            for (wd = 0; wd < 2; wd++) {
+                for (wd2 = 0; wd2 < 2; wd2++) {
+                    if (check_func(dsp.loop_filter_mix2[wd][wd2][dir], "vp9_loop_filter_mix2_%s_%d%d_16_%d",
+                                   dir_names[dir], wd_list[wd], wd_list[wd2], bit_depth)) {
+                        for (k = 0; k < 8; k++) {
+                            int I0 = 1 + rnd() % 63, I1 = 1 + rnd() % 63;
+                            int E0 = 2 * (2 + rnd() % 64) + I0;
+                            int E1 = 2 * (2 + rnd() % 64) + I1;
+                            int I  = I0 | (I1 << 8);
+                            int E  = E0 | (E1 << 8);
+                            int H  = (rnd() % 4) | ((rnd() % 4) << 8);
+
+                            randomize_loopfilter_buffers(buf0, buf1, bit_depth, dir);
+                            call_ref(buf0 + offset, stride, E, I, H);
+                            call_new(buf1 + offset, stride, E, I, H);
+                            if (memcmp(buf0, buf1, 32 * 32 * SIZEOF_PIXEL))
+                                fail();
+                        }
+                        bench_new(buf1 + offset, stride, 193 | (193 << 8), 63 | (63 << 8), 3 | (3 << 8));
+                    }
+                }
+            }
+        }
+    }
+    report("loopfilter");
+}
+
+#define SRC_STRIDE   (2 * (64 + 16))
+#define SRC_BUF_SIZE (SRC_STRIDE * (64 + 8))
+/* room for the 3 lines/pixels before the block read by the 8-tap filters */
+#define SRC_OFFSET   (3 * SRC_STRIDE + 8)
+#define DST_BUF_SIZE (64 * 64 * 2)
+
+static void check_mc(void)
+{
+    static const char *const filter_names[4] = { "smooth", "regular", "sharp", "bilin" };
+    static const char *const subpel_names[2][2] = { { "", "h" }, { "v", "hv" } };
+    LOCAL_ALIGNED_32(uint8_t, src, [SRC_BUF_SIZE]);
+    LOCAL_ALIGNED_32(uint8_t, dst0, [DST_BUF_SIZE]);
+    LOCAL_ALIGNED_32(uint8_t, dst1, [DST_BUF_SIZE]);
+    VP9DSPContext dsp;
+    int bit_depth, hsize, filter, op, dx, dy;
+    declare_func(void, uint8_t *dst, ptrdiff_t dst_stride,
+                 const uint8_t *ref, ptrdiff_t ref_stride, int h, int mx, int my);
+
+    for (bit_depth = 8; bit_depth <= 12; bit_depth += 2) {
+        ff_vp9dsp_init(&dsp, bit_depth);
+        for (hsize = 0; hsize < 5; hsize++) {
+            int size = 64 >> hsize;
+            ptrdiff_t dst_stride = size * SIZEOF_PIXEL;
+
+            for (filter = 0; filter < 4; filter++) {
+                for (op = 0; op < 2; op++) {
+                    for (dx = 0; dx < 2; dx++) {
+                        for (dy = 0; dy < 2; dy++) {
+                            int mx = dx ? 1 + rnd() % 15 : 0;
+                            int my = dy ? 1 + rnd() % 15 : 0;
+
+                            /* full-pel copies are the same for every filter */
+                            if (!dx && !dy && filter)
+                                continue;
+
+                            if (check_func(dsp.mc[hsize][filter][op][dx][dy],
+                                           "vp9_%s%d%s%s%s_%d", op ? "avg" : "put", size,
+                                           subpel_names[dy][dx], dx || dy ? "_" : "",
+                                           dx || dy ? filter_names[filter] : "", bit_depth)) {
+                                randomize_buffers(src, SRC_BUF_SIZE, pixel_mask[(bit_depth - 8) >> 1]);
+                                randomize_buffers(dst0, DST_BUF_SIZE, pixel_mask[(bit_depth - 8) >> 1]);
+                                memcpy(dst1, dst0, DST_BUF_SIZE);
+                                call_ref(dst0, dst_stride, src + SRC_OFFSET, SRC_STRIDE, size, mx, my);
+                                call_new(dst1, dst_stride, src + SRC_OFFSET, SRC_STRIDE, size, mx, my);
+                                if (memcmp(dst0, dst1, DST_BUF_SIZE))
+                                    fail();
+                                bench_new(dst1, dst_stride, src + SRC_OFFSET, SRC_STRIDE, size, mx, my);
+                            }
+                        }
+                    }
+                }
+            }
+        }
+    }
+    report("mc");
+}
+
+void checkasm_check_vp9dsp(void)
+{
+    check_ipred();
+    check_itxfm();
+    check_loopfilter();
+    check_mc();
+}
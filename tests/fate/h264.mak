@@ -193,6 +193,14 @@ FATE_H264  := $(FATE_H264:%=fate-h264-conformance-%)                    \
               fate-h264-extreme-plane-pred                              \
               fate-h264-lossless                                        \
 
+# Pipelining CABAC decoding and reconstruction must give the same output as
+# the serial slice decoding, so these share the conformance references.
+FATE_H264_CABAC_PIPELINE_TESTS := caba3_sva_b                           \
+                                  caba3_toshiba_e                       \
+                                  cabast3_sony_e                        \
+
+FATE_H264 += $(FATE_H264_CABAC_PIPELINE_TESTS:%=fate-h264-cabac-pipeline-%)
+
 FATE_H264-$(call DEMDEC, H264, H264) += $(FATE_H264)
 FATE_H264-$(call DEMDEC,  MOV, H264) += fate-h264-crop-to-container
 FATE_H264-$(call DEMDEC,  MOV, H264) += fate-h264-interlace-crop
@@ -395,3 +403,14 @@ fate-h264-lossless:                               CMD = framecrc -i $(TARGET_SAM
 fate-h264-direct-bff:                             CMD = framecrc -i $(TARGET_SAMPLES)/h264/direct-bff.mkv
 
 fate-h264-reinit-%:                               CMD = framecrc -i $(TARGET_SAMPLES)/h264/$(@:fate-h264-%=%).h264 -vf format=yuv444p10le,scale=w=352:h=288
+
+define FATE_H264_CABAC_PIPELINE_TEST
+fate-h264-cabac-pipeline-$(1): THREADS = 4
+fate-h264-cabac-pipeline-$(1): THREAD_TYPE = slice
+fate-h264-cabac-pipeline-$(1): CMD = framecrc -vsync drop -cabac_pipeline 1 -i $(TARGET_SAMPLES)/h264-conformance/$(2)
+fate-h264-cabac-pipeline-$(1): REF = $(SRC_PATH)/tests/ref/fate/h264-conformance-$(1)
+endef
+
+$(eval $(call FATE_H264_CABAC_PIPELINE_TEST,caba3_sva_b,CABA3_SVA_B.264))
+$(eval $(call FATE_H264_CABAC_PIPELINE_TEST,caba3_toshiba_e,CABA3_TOSHIBA_E.264))
+$(eval $(call FATE_H264_CABAC_PIPELINE_TEST,cabast3_sony_e,CABAST3_Sony_E.jsv))
@@ -222,6 +222,29 @@ $(foreach N,$(HEVC_SAMPLES_422_10BIN),$(eval $(call FATE_HEVC_TEST_422_10BIN,$(N
 $(foreach N,$(HEVC_SAMPLES_444_8BIT),$(eval $(call FATE_HEVC_TEST_444_8BIT,$(N))))
 $(foreach N,$(HEVC_SAMPLES_444_12BIT),$(eval $(call FATE_HEVC_TEST_444_12BIT,$(N))))
 
+# Tiled pictures must decode the same with any number of slice threads,
+# so these share the reference of the single threaded conformance test.
+define FATE_HEVC_TILES_THREADS_TEST
+FATE_HEVC += fate-hevc-tiles-threads-$(2)-$(1)
+fate-hevc-tiles-threads-$(2)-$(1): THREADS = $(2)
+fate-hevc-tiles-threads-$(2)-$(1): THREAD_TYPE = slice
+fate-hevc-tiles-threads-$(2)-$(1): CMD = framecrc -flags unaligned -vsync drop -i $(TARGET_SAMPLES)/hevc-conformance/$(1).bit
+fate-hevc-tiles-threads-$(2)-$(1): REF = $(SRC_PATH)/tests/ref/fate/hevc-conformance-$(1)
+endef
+
+$(foreach N,TILES_A_Cisco_2 TILES_B_Cisco_1,$(foreach T,1 2 4,$(eval $(call FATE_HEVC_TILES_THREADS_TEST,$(N),$(T)))))
+
+# The pipelined loop filter thread must not change the output either.
+define FATE_HEVC_FILTER_THREAD_TEST
+FATE_HEVC += fate-hevc-filter-thread-$(1)
+fate-hevc-filter-thread-$(1): THREADS = 4
+fate-hevc-filter-thread-$(1): THREAD_TYPE = slice
+fate-hevc-filter-thread-$(1): CMD = framecrc -flags unaligned -vsync drop -filter_thread 1 -i $(TARGET_SAMPLES)/hevc-conformance/$(1).bit
+fate-hevc-filter-thread-$(1): REF = $(SRC_PATH)/tests/ref/fate/hevc-conformance-$(1)
+endef
+
+$(foreach N,ENTP_A_Qualcomm_1 SLIST_A_Sony_4 TILES_A_Cisco_2 WPP_A_ericsson_MAIN_2,$(eval $(call FATE_HEVC_FILTER_THREAD_TEST,$(N))))
+
 fate-hevc-paramchange-yuv420p-yuv420p10: CMD = framecrc -vsync 0 -i $(TARGET_SAMPLES)/hevc/paramchange_yuv420p_yuv420p10.hevc -sws_flags area+accurate_rnd+bitexact
 FATE_HEVC += fate-hevc-paramchange-yuv420p-yuv420p10
 
@@ -39,6 +39,10 @@ FATE_LIBAVUTIL += fate-bprint
 fate-bprint: libavutil/bprint-test$(EXESUF)
 fate-bprint: CMD = run libavutil/bprint-test
 
+FATE_LIBAVUTIL += fate-buffer
+fate-buffer: libavutil/buffer-test$(EXESUF)
+fate-buffer: CMD = run libavutil/buffer-test
+
 FATE_LIBAVUTIL += fate-cpu
 fate-cpu: libavutil/cpu-test$(EXESUF)
 fate-cpu: CMD = runecho libavutil/cpu-test $(CPUFLAGS:%=-c%) $(THREADS:%=-t%)
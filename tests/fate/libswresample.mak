@@ -394,6 +394,34 @@ $(call CROSS_TEST,$(SAMPLERATES_NN),ARESAMPLE_ASYNC,s16p,s16le,s16)
 $(call CROSS_TEST,$(SAMPLERATES_NN),ARESAMPLE_ASYNC,fltp,f32le,s16)
 
 
+# Resampling the channels in parallel must give the same output as the
+# default single threaded path, so all thread counts share one reference.
+define ARESAMPLE_THREADS
+FATE_SWR_RESAMPLE += fate-swr-resample_threads-$(1)-$(2)
+fate-swr-resample_threads-$(1)-$(2): tests/data/asynth-44100-6.wav
+fate-swr-resample_threads-$(1)-$(2): CMD = framecrc -i $(TARGET_PATH)/tests/data/asynth-44100-6.wav -af atrim=end_sample=10240,aresample=48000:internal_sample_fmt=$(1):threads=$(2),aformat=$(1) -acodec $(3)
+fate-swr-resample_threads-$(1)-$(2): REF = $(SRC_PATH)/tests/ref/fate/swr-resample_threads-$(1)
+endef
+
+$(foreach T,1 2 4,$(eval $(call ARESAMPLE_THREADS,s16p,$(T),pcm_s16le)))
+
+# float resampling is not bit exact between the C and SIMD versions, so
+# compare the round trip against the input like the tests above
+define ARESAMPLE_THREADS_FLT
+FATE_SWR_RESAMPLE += fate-swr-resample_threads-fltp-$(1)
+fate-swr-resample_threads-fltp-$(1): tests/data/asynth-44100-6.wav
+fate-swr-resample_threads-fltp-$(1): CMD = ffmpeg -i $(TARGET_PATH)/tests/data/asynth-44100-6.wav -af atrim=end_sample=10240,aresample=48000:internal_sample_fmt=fltp:threads=$(1),aformat=fltp,aresample=44100:internal_sample_fmt=fltp:threads=$(1) -f wav -acodec pcm_s16le -
+
+fate-swr-resample_threads-fltp-$(1): CMP = stddev
+fate-swr-resample_threads-fltp-$(1): CMP_UNIT = s16
+fate-swr-resample_threads-fltp-$(1): FUZZ = 0.1
+fate-swr-resample_threads-fltp-$(1): REF = tests/data/asynth-44100-6.wav
+fate-swr-resample_threads-fltp-$(1): CMP_TARGET = 9.70
+fate-swr-resample_threads-fltp-$(1): SIZE_TOLERANCE = 3175200 - 122892
+endef
+
+$(foreach T,1 2 4,$(eval $(call ARESAMPLE_THREADS_FLT,$(T))))
+
 FATE_SWR_RESAMPLE-$(call FILTERDEMDECENCMUX, ARESAMPLE, WAV, PCM_S16LE, PCM_S16LE, WAV) += $(FATE_SWR_RESAMPLE)
 fate-swr-resample: $(FATE_SWR_RESAMPLE-yes)
 FATE_SWR += $(FATE_SWR_RESAMPLE-yes)
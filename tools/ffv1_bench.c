@@ -0,0 +1,259 @@
+/*
+ * This file is part of FFmpeg.
+ *
+ * FFmpeg is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * FFmpeg is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with FFmpeg; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+
+/*
+ * FFV1 throughput benchmark: encodes and decodes synthetic frames for a
+ * list of slice counts and reports MB/s of raw video for both directions.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "config.h"
+#include "libavutil/imgutils.h"
+#include "libavutil/mem.h"
+#include "libavutil/opt.h"
+#include "libavutil/parseutils.h"
+#include "libavutil/pixdesc.h"
+#include "libavutil/time.h"
+#include "libavcodec/avcodec.h"
+
+#if HAVE_UNISTD_H
+#include <unistd.h> /* for getopt */
+#endif
+#if !HAVE_GETOPT
+#include "compat/getopt.c"
+#endif
+
+#define MAX_FRAMES 256
+
+static int width = 1920, height = 1080;
+static enum AVPixelFormat pix_fmt = AV_PIX_FMT_YUV420P;
+static int nb_frames = 10, coder = 1, context = 0, threads = 0;
+
+static void usage(const char *name)
+{
+    printf("Usage: %s [-s WxH] [-p pix_fmt] [-n frames] [-c coder] [-C context] "
+           "[-t threads] [slices...]\n"
+           "Encode and decode synthetic frames with FFV1 and print the throughput "
+           "for each slice count (default 1 4 6 9 12 16 24). A single slice is "
+           "coded as version 1, more as version 3.\n",
+           name);
+}
+
+/* smooth gradients with a bit of noise, roughly as compressible as camera
+ * material and identical on every run */
+static void fill_frame(AVFrame *frame, int n)
+{
+    const AVPixFmtDescriptor *desc = av_pix_fmt_desc_get(frame->format);
+    int depth    = desc->comp[0].depth_minus1 + 1;
+    int max      = (1 << FFMIN(depth, 8 + 8 * (depth > 8))) - 1;
+    unsigned seed = 0x12345678 + n;
+    int p, x, y;
+
+    for (p = 0; p < 4 && frame->data[p]; p++) {
+        int shift = p == 1 || p == 2 ? desc->log2_chroma_h : 0;
+        int h     = FF_CEIL_RSHIFT(frame->height, shift);
+        int w     = av_image_get_linesize(frame->format, frame->width, p) /
+                    (depth > 8 ? 2 : 1);
+
+        for (y = 0; y < h; y++) {
+            uint8_t  *line8  = frame->data[p] + y * frame->linesize[p];
+            uint16_t *line16 = (uint16_t *)line8;
+
+            for (x = 0; x < w; x++) {
+                int v = ((x * (p + 1) + y * 2 + n * 3) & 0x1FF) * max / 0x1FF;
+
+                seed = seed * 1664525 + 1013904223;
+                v   += ((int)(seed >> 29) - 4) * (max >> 8 | 1);
+                v    = av_clip(v, 0, max);
+                if (depth > 8)
+                    line16[x] = v;
+                else
+                    line8[x]  = v;
+            }
+        }
+    }
+}
+
+static AVCodecContext *open_codec(AVCodec *codec, int slices, AVCodecContext *enc)
+{
+    AVCodecContext *avctx = avcodec_alloc_context3(codec);
+
+    if (!avctx)
+        return NULL;
+
+    avctx->width        = width;
+    avctx->height       = height;
+    avctx->pix_fmt      = pix_fmt;
+    avctx->time_base    = (AVRational){ 1, 25 };
+    avctx->thread_count = threads;
+    avctx->thread_type  = FF_THREAD_SLICE;
+    avctx->level        = slices > 1 ? 3 : 1;
+    avctx->slices       = slices;
+    av_opt_set_int(avctx, "coder",   coder,   0);
+    av_opt_set_int(avctx, "context", context, 0);
+
+    if (enc && enc->extradata_size) {
+        avctx->extradata = av_mallocz(enc->extradata_size + AV_INPUT_BUFFER_PADDING_SIZE);
+        if (!avctx->extradata)
+            goto fail;
+        memcpy(avctx->extradata, enc->extradata, enc->extradata_size);
+        avctx->extradata_size = enc->extradata_size;
+    }
+
+    if (avcodec_open2(avctx, codec, NULL) < 0)
+        goto fail;
+    return avctx;
+fail:
+    avcodec_free_context(&avctx);
+    return NULL;
+}
+
+static int run(int slices, AVFrame **frames, double frame_size)
+{
+    AVCodec *encoder = avcodec_find_encoder(AV_CODEC_ID_FFV1);
+    AVCodec *decoder = avcodec_find_decoder(AV_CODEC_ID_FFV1);
+    AVCodecContext *enc = NULL, *dec = NULL;
+    AVPacket pkt[MAX_FRAMES] = { { 0 } };
+    AVFrame *out = av_frame_alloc();
+    int64_t t0, t1, t2, bytes = 0;
+    int i, got, ret = -1;
+
+    if (!out)
+        goto end;
+    if (!(enc = open_codec(encoder, slices, NULL))) {
+        fprintf(stderr, "Cannot open the encoder with %d slices\n", slices);
+        goto end;
+    }
+    if (!(dec = open_codec(decoder, slices, enc))) {
+        fprintf(stderr, "Cannot open the decoder\n");
+        goto end;
+    }
+
+    t0 = av_gettime_relative();
+    for (i = 0; i < nb_frames; i++) {
+        av_init_packet(&pkt[i]);
+        frames[i]->pts = i;
+        if (avcodec_encode_video2(enc, &pkt[i], frames[i], &got) < 0 || !got) {
+            fprintf(stderr, "Encoding failed\n");
+            goto end;
+        }
+        bytes += pkt[i].size;
+    }
+    t1 = av_gettime_relative();
+    for (i = 0; i < nb_frames; i++) {
+        if (avcodec_decode_video2(dec, out, &got, &pkt[i]) < 0 || !got) {
+            fprintf(stderr, "Decoding failed\n");
+            goto end;
+        }
+    }
+    t2 = av_gettime_relative();
+
+    printf("slices %3d: ratio %5.3f  encode %8.2f MB/s  decode %8.2f MB/s\n",
+           enc->slices, bytes / (frame_size * nb_frames),
+           frame_size * nb_frames / FFMAX(t1 - t0, 1),
+           frame_size * nb_frames / FFMAX(t2 - t1, 1));
+    ret = 0;
+end:
+    for (i = 0; i < nb_frames; i++)
+        av_packet_unref(&pkt[i]);
+    av_frame_free(&out);
+    avcodec_free_context(&enc);
+    avcodec_free_context(&dec);
+    return ret;
+}
+
+int main(int argc, char **argv)
+{
+    static const int default_slices[] = { 1, 4, 6, 9, 12, 16, 24 };
+    AVFrame *frames[MAX_FRAMES] = { NULL };
+    double frame_size;
+    int i, opt, ret = 1;
+
+    while ((opt = getopt(argc, argv, "hs:p:n:c:C:t:")) != -1) {
+        switch (opt) {
+        case 's':
+            if (av_parse_video_size(&width, &height, optarg) < 0) {
+                fprintf(stderr, "Invalid frame size %s\n", optarg);
+                return 1;
+            }
+            break;
+        case 'p':
+            pix_fmt = av_get_pix_fmt(optarg);
+            if (pix_fmt == AV_PIX_FMT_NONE) {
+                fprintf(stderr, "Unknown pixel format %s\n", optarg);
+                return 1;
+            }
+            break;
+        case 'n':
+            nb_frames = av_clip(atoi(optarg), 1, MAX_FRAMES);
+            break;
+        case 'c':
+            coder = atoi(optarg);
+            break;
+        case 'C':
+            context = atoi(optarg);
+            break;
+        case 't':
+            threads = atoi(optarg);
+            break;
+        case 'h':
+            usage(argv[0]);
+            return 0;
+        default:
+            usage(argv[0]);
+            return 1;
+        }
+    }
+
+    avcodec_register_all();
+
+    frame_size = av_image_get_buffer_size(pix_fmt, width, height, 1);
+    for (i = 0; i < nb_frames; i++) {
+        frames[i] = av_frame_alloc();
+        if (!frames[i])
+            goto end;
+        frames[i]->width  = width;
+        frames[i]->height = height;
+        frames[i]->format = pix_fmt;
+        if (av_frame_get_buffer(frames[i], 32) < 0)
+            goto end;
+        fill_frame(frames[i], i);
+    }
+
+    printf("%dx%d %s, %d frames, coder %d, context %d, threads %d\n",
+           width, height, av_get_pix_fmt_name(pix_fmt), nb_frames, coder,
+           context, threads);
+
+    if (optind < argc) {
+        for (i = optind; i < argc; i++)
+            if (run(atoi(argv[i]), frames, frame_size) < 0)
+                goto end;
+    } else {
+        for (i = 0; i < FF_ARRAY_ELEMS(default_slices); i++)
+            if (run(default_slices[i], frames, frame_size) < 0)
+                goto end;
+    }
+    ret = 0;
+end:
+    for (i = 0; i < nb_frames; i++)
+        av_frame_free(&frames[i]);
+    return ret;
+}
@@ -0,0 +1,206 @@
+/*
+ * This file is part of FFmpeg.
+ *
+ * FFmpeg is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * FFmpeg is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with FFmpeg; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ */
+
+/*
+ * Opus multistream decoding benchmark: decodes synthetic 20 ms packets of a
+ * 5.1 or 7.1 stream with a list of slice thread counts and reports the time
+ * per packet, i.e. what decoding the sub-packets in parallel buys.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "config.h"
+#include "libavutil/lfg.h"
+#include "libavutil/mem.h"
+#include "libavutil/time.h"
+#include "libavcodec/avcodec.h"
+
+#if HAVE_UNISTD_H
+#include <unistd.h> /* for getopt */
+#endif
+#if !HAVE_GETOPT
+#include "compat/getopt.c"
+#endif
+
+#define MAX_PACKETS 4096
+
+/* 20 ms TOC configurations, see RFC 6716 section 3.1 */
+static const int configs[][4] = {
+    { 1,  5,  9,  9 },  /* SILK NB, MB, WB */
+    { 13, 15, 13, 15 }, /* hybrid SWB, FB */
+    { 19, 23, 27, 31 }, /* CELT NB, WB, SWB, FB */
+};
+
+static const uint8_t head_51[] = {
+    'O', 'p', 'u', 's', 'H', 'e', 'a', 'd', 1, 6, 0, 0, 0x80, 0xBB, 0, 0, 0, 0,
+    1, 4, 2, 0, 4, 1, 2, 3, 5
+};
+static const uint8_t head_71[] = {
+    'O', 'p', 'u', 's', 'H', 'e', 'a', 'd', 1, 8, 0, 0, 0x80, 0xBB, 0, 0, 0, 0,
+    1, 5, 3, 0, 6, 1, 2, 3, 4, 5, 7
+};
+
+static int channels = 6, nb_packets = 1000, mode = -1, bytes = 160;
+
+static void usage(const char *name)
+{
+    printf("Usage: %s [-c channels] [-n packets] [-m mode] [-b bytes] [threads...]\n"
+           "Decode synthetic 20 ms Opus multistream packets (6 or 8 channels) "
+           "and print the time per packet for each slice thread count "
+           "(default 1 2 4 8). The mode is 0 for SILK, 1 for hybrid, 2 for "
+           "CELT, the default mixes all of them. The packets carry random "
+           "payloads of about the given size per stream.\n",
+           name);
+}
+
+static int make_packets(AVPacket *pkt, int nb_streams, int nb_coupled)
+{
+    AVLFG lfg;
+    int p, s, i, m, cfg;
+
+    av_lfg_init(&lfg, 0x12345678);
+    for (p = 0; p < nb_packets; p++) {
+        uint8_t *buf;
+        int size = 0;
+
+        if (av_new_packet(&pkt[p], nb_streams * (2 * bytes + 2)) < 0)
+            return AVERROR(ENOMEM);
+        buf = pkt[p].data;
+        /* an encoder uses the same mode and bandwidth for all the streams */
+        m   = mode < 0 ? av_lfg_get(&lfg) % 3 : mode;
+        cfg = configs[m][av_lfg_get(&lfg) % 4];
+        for (s = 0; s < nb_streams; s++) {
+            int len = bytes / 2 + av_lfg_get(&lfg) % (bytes + 1);
+
+            /* the coupled streams come first */
+            buf[size++] = cfg << 3 | (s < nb_coupled) << 2;
+            /* all but the last sub-packet are self-delimited */
+            if (s < nb_streams - 1)
+                buf[size++] = len;
+            /* SILK: voice activity without LBRR frames for both channels,
+             * the decoder does not support those */
+            buf[size] = 0xA8;
+            for (i = m != 2; i < len; i++)
+                buf[size + i] = av_lfg_get(&lfg);
+            size += len;
+        }
+        av_shrink_packet(&pkt[p], size);
+    }
+    return 0;
+}
+
+static int run(int threads, AVPacket *pkt)
+{
+    const uint8_t *head = channels == 8 ? head_71 : head_51;
+    int head_size       = channels == 8 ? sizeof(head_71) : sizeof(head_51);
+    AVCodecContext *avctx = avcodec_alloc_context3(avcodec_find_decoder(AV_CODEC_ID_OPUS));
+    AVFrame *frame = av_frame_alloc();
+    int64_t t0, t1;
+    int p, got, errors = 0, ret = -1;
+
+    if (!avctx || !frame)
+        goto end;
+    avctx->extradata = av_mallocz(head_size + AV_INPUT_BUFFER_PADDING_SIZE);
+    if (!avctx->extradata)
+        goto end;
+    memcpy(avctx->extradata, head, head_size);
+    avctx->extradata_size = head_size;
+    avctx->thread_count   = threads;
+    avctx->thread_type    = FF_THREAD_SLICE;
+    if (avcodec_open2(avctx, avctx->codec, NULL) < 0) {
+        fprintf(stderr, "Cannot open the decoder\n");
+        goto end;
+    }
+
+    t0 = av_gettime_relative();
+    for (p = 0; p < nb_packets; p++)
+        if (avcodec_decode_audio4(avctx, frame, &got, &pkt[p]) < 0 || !got)
+            errors++;
+    t1 = av_gettime_relative();
+
+    printf("threads %2d: %8.2f us/packet, %6.1fx realtime, %d errors\n",
+           avctx->thread_count, (double)(t1 - t0) / nb_packets,
+           nb_packets * 20000.0 / FFMAX(t1 - t0, 1), errors);
+    ret = 0;
+end:
+    av_frame_free(&frame);
+    avcodec_free_context(&avctx);
+    return ret;
+}
+
+int main(int argc, char **argv)
+{
+    static const int default_threads[] = { 1, 2, 4, 8 };
+    AVPacket *pkt = NULL;
+    int i, opt, ret = 1;
+
+    while ((opt = getopt(argc, argv, "hc:n:m:b:")) != -1) {
+        switch (opt) {
+        case 'c':
+            channels = atoi(optarg);
+            if (channels != 6 && channels != 8) {
+                fprintf(stderr, "Only 6 and 8 channels are supported\n");
+                return 1;
+            }
+            break;
+        case 'n':
+            nb_packets = av_clip(atoi(optarg), 1, MAX_PACKETS);
+            break;
+        case 'm':
+            mode = av_clip(atoi(optarg), -1, 2);
+            break;
+        case 'b':
+            bytes = av_clip(atoi(optarg), 2, 166);
+            break;
+        case 'h':
+            usage(argv[0]);
+            return 0;
+        default:
+            usage(argv[0]);
+            return 1;
+        }
+    }
+
+    avcodec_register_all();
+
+    pkt = av_mallocz_array(nb_packets, sizeof(*pkt));
+    if (!pkt || make_packets(pkt, channels == 8 ? 5 : 4, channels == 8 ? 3 : 2) < 0)
+        goto end;
+
+    printf("%d channels, %d packets of 20 ms, mode %d, ~%d bytes per stream\n",
+           channels, nb_packets, mode, bytes);
+
+    if (optind < argc) {
+        for (i = optind; i < argc; i++)
+            if (run(atoi(argv[i]), pkt) < 0)
+                goto end;
+    } else {
+        for (i = 0; i < FF_ARRAY_ELEMS(default_threads); i++)
+            if (run(default_threads[i], pkt) < 0)
+                goto end;
+    }
+    ret = 0;
+end:
+    if (pkt)
+        for (i = 0; i < nb_packets; i++)
+            av_packet_unref(&pkt[i]);
+    av_free(pkt);
+    return ret;
+}